@@ -0,0 +1,105 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "AsyncFile.hpp"
+#include "Exception.hpp"
+#include <MCFCRT/env/mcfwin.h>
+#include <ntdef.h>
+#include <ntstatus.h>
+
+extern "C" {
+
+typedef struct _IO_STATUS_BLOCK {
+	union {
+		NTSTATUS Status;
+		PVOID Pointer;
+	};
+	ULONG_PTR Information;
+} IO_STATUS_BLOCK, *PIO_STATUS_BLOCK;
+
+typedef void (NTAPI *PIO_APC_ROUTINE)(void *pContext, IO_STATUS_BLOCK *pIoStatus, ULONG dwUnknown);
+
+__attribute__((__dllimport__, __stdcall__))
+extern NTSTATUS NtReadFile(HANDLE hFile, HANDLE hEvent, PIO_APC_ROUTINE pfnApcRoutine, void *pApcContext, IO_STATUS_BLOCK *pIoStatus, void *pBuffer, ULONG ulLength, const LARGE_INTEGER *pliOffset, const ULONG *pulKey) noexcept;
+__attribute__((__dllimport__, __stdcall__))
+extern NTSTATUS NtWriteFile(HANDLE hFile, HANDLE hEvent, PIO_APC_ROUTINE pfnApcRoutine, void *pApcContext, IO_STATUS_BLOCK *pIoStatus, const void *pBuffer, ULONG ulLength, const LARGE_INTEGER *pliOffset, const ULONG *pulKey) noexcept;
+__attribute__((__dllimport__, __stdcall__))
+extern NTSTATUS NtCancelIoFile(HANDLE hFile, IO_STATUS_BLOCK *pIoStatus) noexcept;
+
+__attribute__((__dllimport__, __stdcall__))
+extern ULONG WINAPI RtlNtStatusToDosError(NTSTATUS lStatus) noexcept;
+
+}
+
+namespace MCF {
+
+AsyncFile::AsyncFile(File vFile, IoCompletionQueue &vQueue)
+	: x_vFile(std::move(vFile)), x_pQueue(&vQueue)
+{
+	if(!x_vFile){
+		MCF_THROW(Exception, ERROR_INVALID_HANDLE, Rcntws::View(L"AsyncFile: 尚未打开任何文件。"));
+	}
+	x_pQueue->Associate(x_vFile.GetHandle());
+}
+
+void AsyncFile::X_SubmitRead(UniquePtr<IoCompletionQueue::Operation> pOperation, void *pBuffer, std::size_t uBytesToRead, std::uint64_t u64Offset){
+	ULONG ulBytesToRead;
+	if(uBytesToRead <= ULONG_MAX){
+		ulBytesToRead = static_cast<ULONG>(uBytesToRead);
+	} else {
+		ulBytesToRead = ULONG_MAX;
+	}
+
+	if(u64Offset >= static_cast<std::uint64_t>(INT64_MAX)){
+		MCF_THROW(Exception, ERROR_SEEK, Rcntws::View(L"AsyncFile: 文件偏移量太大。"));
+	}
+
+	const auto pIoStatus = static_cast<::IO_STATUS_BLOCK *>(pOperation->GetIoStatusBlock());
+	pIoStatus->Information = 0;
+
+	::LARGE_INTEGER liOffset;
+	liOffset.QuadPart = static_cast<std::int64_t>(u64Offset);
+	const auto pContext = x_pQueue->BeginOperation(std::move(pOperation));
+	const auto lStatus = ::NtReadFile(x_vFile.GetHandle(), nullptr, nullptr, pContext, pIoStatus, pBuffer, ulBytesToRead, &liOffset, nullptr);
+	if(lStatus == STATUS_END_OF_FILE){
+		// 同步失败的请求不会产生完成通知。读取到文件末尾不是错误，所以我们自己投递一个。
+		x_pQueue->PostOperation(x_pQueue->AbandonOperation(pContext), 0, 0);
+		return;
+	}
+	if(!NT_SUCCESS(lStatus)){
+		x_pQueue->AbandonOperation(pContext);
+		MCF_THROW(Exception, ::RtlNtStatusToDosError(lStatus), Rcntws::View(L"AsyncFile: NtReadFile() 失败。"));
+	}
+}
+void AsyncFile::X_SubmitWrite(UniquePtr<IoCompletionQueue::Operation> pOperation, std::uint64_t u64Offset, const void *pBuffer, std::size_t uBytesToWrite){
+	ULONG ulBytesToWrite;
+	if(uBytesToWrite <= ULONG_MAX){
+		ulBytesToWrite = static_cast<ULONG>(uBytesToWrite);
+	} else {
+		ulBytesToWrite = ULONG_MAX;
+	}
+
+	if(u64Offset >= static_cast<std::uint64_t>(INT64_MAX)){
+		MCF_THROW(Exception, ERROR_SEEK, Rcntws::View(L"AsyncFile: 文件偏移量太大。"));
+	}
+
+	const auto pIoStatus = static_cast<::IO_STATUS_BLOCK *>(pOperation->GetIoStatusBlock());
+	pIoStatus->Information = 0;
+
+	::LARGE_INTEGER liOffset;
+	liOffset.QuadPart = static_cast<std::int64_t>(u64Offset);
+	const auto pContext = x_pQueue->BeginOperation(std::move(pOperation));
+	const auto lStatus = ::NtWriteFile(x_vFile.GetHandle(), nullptr, nullptr, pContext, pIoStatus, pBuffer, ulBytesToWrite, &liOffset, nullptr);
+	if(!NT_SUCCESS(lStatus)){
+		x_pQueue->AbandonOperation(pContext);
+		MCF_THROW(Exception, ::RtlNtStatusToDosError(lStatus), Rcntws::View(L"AsyncFile: NtWriteFile() 失败。"));
+	}
+}
+
+void AsyncFile::Cancel() noexcept {
+	::IO_STATUS_BLOCK vIoStatus;
+	::NtCancelIoFile(x_vFile.GetHandle(), &vIoStatus);
+}
+
+}
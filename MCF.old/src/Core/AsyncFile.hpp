@@ -0,0 +1,59 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_CORE_ASYNC_FILE_HPP_
+#define MCF_CORE_ASYNC_FILE_HPP_
+
+#include "File.hpp"
+#include "../Thread/IoCompletionQueue.hpp"
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace MCF {
+
+// 异步文件。文件必须以 File::kOverlapped 打开，请求完成之后回调函数在 IoCompletionQueue 的线程中执行。
+// 一个文件上可以同时有多个未完成的请求。在回调函数执行之前，缓冲区必须保持有效。
+class AsyncFile {
+private:
+	File x_vFile;
+	IoCompletionQueue *x_pQueue;
+
+private:
+	void X_SubmitRead(UniquePtr<IoCompletionQueue::Operation> pOperation, void *pBuffer, std::size_t uBytesToRead, std::uint64_t u64Offset);
+	void X_SubmitWrite(UniquePtr<IoCompletionQueue::Operation> pOperation, std::uint64_t u64Offset, const void *pBuffer, std::size_t uBytesToWrite);
+
+public:
+	AsyncFile(File vFile, IoCompletionQueue &vQueue);
+
+	AsyncFile(const AsyncFile &) = delete;
+	AsyncFile &operator=(const AsyncFile &) = delete;
+
+public:
+	const File &GetFile() const noexcept {
+		return x_vFile;
+	}
+	IoCompletionQueue &GetQueue() const noexcept {
+		return *x_pQueue;
+	}
+
+	// 回调函数的参数是 (unsigned long ulErrorCode, std::size_t uBytesTransferred)。
+	// 读取到文件末尾不是错误，这时 uBytesTransferred 小于请求的大小。
+	// 如果请求无法提交，这两个函数抛出异常，回调函数不会被调用。
+	template<typename CallbackT>
+	void Read(void *pBuffer, std::size_t uBytesToRead, std::uint64_t u64Offset, CallbackT &&fnCallback){
+		X_SubmitRead(Impl_IoCompletionQueue::MakeOperation(std::forward<CallbackT>(fnCallback)), pBuffer, uBytesToRead, u64Offset);
+	}
+	template<typename CallbackT>
+	void Write(std::uint64_t u64Offset, const void *pBuffer, std::size_t uBytesToWrite, CallbackT &&fnCallback){
+		X_SubmitWrite(Impl_IoCompletionQueue::MakeOperation(std::forward<CallbackT>(fnCallback)), u64Offset, pBuffer, uBytesToWrite);
+	}
+
+	// 取消这个线程在这个文件上发起的所有请求。被取消的请求的回调函数仍然会被调用，错误码是 ERROR_OPERATION_ABORTED。
+	void Cancel() noexcept;
+};
+
+}
+
+#endif
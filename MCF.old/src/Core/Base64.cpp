@@ -0,0 +1,371 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "Base64.hpp"
+#include <MCFCRT/env/cpu.h>
+#include <immintrin.h>
+#include <cstring>
+
+namespace MCF {
+
+namespace {
+	constexpr char kStandardAlphabet[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	constexpr char kUrlSafeAlphabet[65]  = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+	// 解码表中，小于 64 的值是字母表中的字符。
+	enum : unsigned char {
+		kCharPadding    = 0x40,
+		kCharWhitespace = 0x41,
+		kCharInvalid    = 0xFF,
+	};
+
+	struct DecodingTable {
+		unsigned char abyValues[256];
+	};
+
+	constexpr DecodingTable MakeDecodingTable(const char *pchAlphabet) noexcept {
+		DecodingTable vTable = { };
+		for(unsigned uChar = 0; uChar < 256; ++uChar){
+			vTable.abyValues[uChar] = kCharInvalid;
+		}
+		for(unsigned uValue = 0; uValue < 64; ++uValue){
+			vTable.abyValues[static_cast<unsigned char>(pchAlphabet[uValue])] = static_cast<unsigned char>(uValue);
+		}
+		vTable.abyValues[static_cast<unsigned char>('=')]  = kCharPadding;
+		vTable.abyValues[static_cast<unsigned char>(' ')]  = kCharWhitespace;
+		vTable.abyValues[static_cast<unsigned char>('\t')] = kCharWhitespace;
+		vTable.abyValues[static_cast<unsigned char>('\r')] = kCharWhitespace;
+		vTable.abyValues[static_cast<unsigned char>('\n')] = kCharWhitespace;
+		return vTable;
+	}
+
+	constexpr DecodingTable kStandardTable = MakeDecodingTable(kStandardAlphabet);
+	constexpr DecodingTable kUrlSafeTable  = MakeDecodingTable(kUrlSafeAlphabet);
+
+	// 把每 3 个字节拆分成 4 个 6 位的值，每个值占一个字节。输入的最后 4 个字节被忽略。
+	inline __m128i SplitSextets(__m128i xmmBytes) noexcept {
+		const auto xmmShuffled = _mm_shuffle_epi8(xmmBytes, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+		const auto xmmT0 = _mm_mulhi_epu16(_mm_and_si128(xmmShuffled, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+		const auto xmmT1 = _mm_mullo_epi16(_mm_and_si128(xmmShuffled, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+		return _mm_or_si128(xmmT0, xmmT1);
+	}
+	// 6 位的值被分为 5 段：[0, 26) [26, 52) [52, 62) 62 63。先把值映射到段的序号，再查表得到这一段的字符与值的差。
+	inline __m128i MakeShiftTable(const char *pchAlphabet) noexcept {
+		return _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+			static_cast<char>(pchAlphabet[62] - 62), static_cast<char>(pchAlphabet[63] - 63), 'A', 0, 0);
+	}
+	inline __m128i SextetsToChars(__m128i xmmSextets, __m128i xmmShiftTable) noexcept {
+		auto xmmIndices = _mm_subs_epu8(xmmSextets, _mm_set1_epi8(51));
+		xmmIndices = _mm_or_si128(xmmIndices, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), xmmSextets), _mm_set1_epi8(13)));
+		return _mm_add_epi8(xmmSextets, _mm_shuffle_epi8(xmmShiftTable, xmmIndices));
+	}
+
+	// 把字符转换为 6 位的值。根据字符的高低两个半字节查表，两个结果按位与不为零的字符不在字母表中。
+	// '+' 和 '/' 的高半字节相同，'/' 需要单独处理。URL 安全的字母表先被替换成标准字母表。
+	inline bool CharsToSextets(__m128i &xmmSextets, __m128i xmmChars, bool bUrlSafe) noexcept {
+		if(bUrlSafe){
+			const auto xmmPlusOrSlash = _mm_or_si128(_mm_cmpeq_epi8(xmmChars, _mm_set1_epi8('+')), _mm_cmpeq_epi8(xmmChars, _mm_set1_epi8('/')));
+			if(_mm_movemask_epi8(xmmPlusOrSlash) != 0){
+				return false;
+			}
+			xmmChars = _mm_xor_si128(xmmChars, _mm_and_si128(_mm_cmpeq_epi8(xmmChars, _mm_set1_epi8('-')), _mm_set1_epi8('-' ^ '+')));
+			xmmChars = _mm_xor_si128(xmmChars, _mm_and_si128(_mm_cmpeq_epi8(xmmChars, _mm_set1_epi8('_')), _mm_set1_epi8('_' ^ '/')));
+		}
+		const auto xmmHighNibbles = _mm_and_si128(_mm_srli_epi32(xmmChars, 4), _mm_set1_epi8(0x0F));
+		const auto xmmLowNibbles = _mm_and_si128(xmmChars, _mm_set1_epi8(0x0F));
+		const auto xmmHighBits = _mm_shuffle_epi8(_mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10), xmmHighNibbles);
+		const auto xmmLowBits = _mm_shuffle_epi8(_mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A), xmmLowNibbles);
+		if(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(xmmHighBits, xmmLowBits), _mm_setzero_si128())) != 0xFFFF){
+			return false;
+		}
+		const auto xmmIndices = _mm_add_epi8(_mm_cmpeq_epi8(xmmChars, _mm_set1_epi8('/')), xmmHighNibbles);
+		xmmSextets = _mm_add_epi8(xmmChars, _mm_shuffle_epi8(_mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0), xmmIndices));
+		return true;
+	}
+	// 把每 4 个 6 位的值合并成 3 个字节，结果在低 12 个字节中。
+	inline __m128i MergeSextets(__m128i xmmSextets) noexcept {
+		const auto xmmPairs = _mm_maddubs_epi16(xmmSextets, _mm_set1_epi32(0x01400140));
+		const auto xmmTriples = _mm_madd_epi16(xmmPairs, _mm_set1_epi32(0x00011000));
+		return _mm_shuffle_epi8(xmmTriples, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+	}
+	inline void Store12(unsigned char *pbyWrite, __m128i xmmBytes) noexcept {
+		_mm_storel_epi64(reinterpret_cast<__m128i *>(pbyWrite), xmmBytes);
+		const auto u32High = static_cast<std::uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(xmmBytes, 8)));
+		std::memcpy(pbyWrite + 8, &u32High, 4);
+	}
+
+	__attribute__((__target__("avx2")))
+	void EncodeBlocksAvx2(char *&pchWrite, const unsigned char *&pbyRead, const unsigned char *pbyEnd, const char *pchAlphabet) noexcept {
+		const auto ymmShuffle = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10, 1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+		const auto ymmShiftTable = _mm256_broadcastsi128_si256(MakeShiftTable(pchAlphabet));
+		// 每次编码 24 个字节，两个 128 位的通道各 12 个。
+		while(pbyEnd - pbyRead >= 28){
+			const auto ymmBytes = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pbyRead))),
+				_mm_loadu_si128(reinterpret_cast<const __m128i *>(pbyRead + 12)), 1);
+			const auto ymmShuffled = _mm256_shuffle_epi8(ymmBytes, ymmShuffle);
+			const auto ymmT0 = _mm256_mulhi_epu16(_mm256_and_si256(ymmShuffled, _mm256_set1_epi32(0x0FC0FC00)), _mm256_set1_epi32(0x04000040));
+			const auto ymmT1 = _mm256_mullo_epi16(_mm256_and_si256(ymmShuffled, _mm256_set1_epi32(0x003F03F0)), _mm256_set1_epi32(0x01000010));
+			const auto ymmSextets = _mm256_or_si256(ymmT0, ymmT1);
+			auto ymmIndices = _mm256_subs_epu8(ymmSextets, _mm256_set1_epi8(51));
+			ymmIndices = _mm256_or_si256(ymmIndices, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), ymmSextets), _mm256_set1_epi8(13)));
+			const auto ymmChars = _mm256_add_epi8(ymmSextets, _mm256_shuffle_epi8(ymmShiftTable, ymmIndices));
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(pchWrite), ymmChars);
+			pbyRead += 24;
+			pchWrite += 32;
+		}
+	}
+	__attribute__((__target__("avx2")))
+	void DecodeBlocksAvx2(unsigned char *&pbyWrite, const char *&pchRead, const char *pchEnd, bool bUrlSafe) noexcept {
+		const auto ymmHighTable = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+		                                           0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+		const auto ymmLowTable = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+		                                          0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+		const auto ymmRollTable = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+		                                           0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+		const auto ymmMerge = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1, 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+		// 每次解码 32 个字符，两个 128 位的通道各输出 12 个字节。
+		while(pchEnd - pchRead >= 32){
+			auto ymmChars = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pchRead));
+			if(bUrlSafe){
+				const auto ymmPlusOrSlash = _mm256_or_si256(_mm256_cmpeq_epi8(ymmChars, _mm256_set1_epi8('+')), _mm256_cmpeq_epi8(ymmChars, _mm256_set1_epi8('/')));
+				if(_mm256_movemask_epi8(ymmPlusOrSlash) != 0){
+					break;
+				}
+				ymmChars = _mm256_xor_si256(ymmChars, _mm256_and_si256(_mm256_cmpeq_epi8(ymmChars, _mm256_set1_epi8('-')), _mm256_set1_epi8('-' ^ '+')));
+				ymmChars = _mm256_xor_si256(ymmChars, _mm256_and_si256(_mm256_cmpeq_epi8(ymmChars, _mm256_set1_epi8('_')), _mm256_set1_epi8('_' ^ '/')));
+			}
+			const auto ymmHighNibbles = _mm256_and_si256(_mm256_srli_epi32(ymmChars, 4), _mm256_set1_epi8(0x0F));
+			const auto ymmLowNibbles = _mm256_and_si256(ymmChars, _mm256_set1_epi8(0x0F));
+			const auto ymmBits = _mm256_and_si256(_mm256_shuffle_epi8(ymmHighTable, ymmHighNibbles), _mm256_shuffle_epi8(ymmLowTable, ymmLowNibbles));
+			if(!_mm256_testz_si256(ymmBits, ymmBits)){
+				break;
+			}
+			const auto ymmIndices = _mm256_add_epi8(_mm256_cmpeq_epi8(ymmChars, _mm256_set1_epi8('/')), ymmHighNibbles);
+			const auto ymmSextets = _mm256_add_epi8(ymmChars, _mm256_shuffle_epi8(ymmRollTable, ymmIndices));
+			const auto ymmPairs = _mm256_maddubs_epi16(ymmSextets, _mm256_set1_epi32(0x01400140));
+			const auto ymmBytes = _mm256_shuffle_epi8(_mm256_madd_epi16(ymmPairs, _mm256_set1_epi32(0x00011000)), ymmMerge);
+			Store12(pbyWrite, _mm256_castsi256_si128(ymmBytes));
+			Store12(pbyWrite + 12, _mm256_extracti128_si256(ymmBytes, 1));
+			pchRead += 32;
+			pbyWrite += 24;
+		}
+	}
+
+	// 编码 uCount 个完整的三字节组，返回输出的末尾。
+	char *EncodeTriples(char *pchWrite, const unsigned char *pbyRead, std::size_t uCount, const char *pchAlphabet) noexcept {
+		const auto pbyEnd = pbyRead + uCount * 3;
+		if(_MCFCRT_CpuHasFeature(_MCFCRT_kCpuFeatureAvx2)){
+			EncodeBlocksAvx2(pchWrite, pbyRead, pbyEnd, pchAlphabet);
+		}
+		// 每次读取 16 个字节，编码其中的 12 个。
+		const auto xmmShiftTable = MakeShiftTable(pchAlphabet);
+		while(pbyEnd - pbyRead >= 16){
+			const auto xmmBytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pbyRead));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pchWrite), SextetsToChars(SplitSextets(xmmBytes), xmmShiftTable));
+			pbyRead += 12;
+			pchWrite += 16;
+		}
+		while(pbyRead != pbyEnd){
+			const auto u32Bits = (static_cast<std::uint32_t>(pbyRead[0]) << 16) | (static_cast<std::uint32_t>(pbyRead[1]) << 8) | pbyRead[2];
+			pchWrite[0] = pchAlphabet[(u32Bits >> 18) & 0x3F];
+			pchWrite[1] = pchAlphabet[(u32Bits >> 12) & 0x3F];
+			pchWrite[2] = pchAlphabet[(u32Bits >>  6) & 0x3F];
+			pchWrite[3] = pchAlphabet[ u32Bits        & 0x3F];
+			pbyRead += 3;
+			pchWrite += 4;
+		}
+		return pchWrite;
+	}
+	// 解码尽可能多的完整的块，遇到不在字母表中的字符时停下，剩下的部分由调用者逐个字符处理。
+	void DecodeBlocks(unsigned char *&pbyWrite, const char *&pchRead, const char *pchEnd, bool bUrlSafe) noexcept {
+		if(_MCFCRT_CpuHasFeature(_MCFCRT_kCpuFeatureAvx2)){
+			DecodeBlocksAvx2(pbyWrite, pchRead, pchEnd, bUrlSafe);
+		}
+		while(pchEnd - pchRead >= 16){
+			__m128i xmmSextets;
+			if(!CharsToSextets(xmmSextets, _mm_loadu_si128(reinterpret_cast<const __m128i *>(pchRead)), bUrlSafe)){
+				break;
+			}
+			Store12(pbyWrite, MergeSextets(xmmSextets));
+			pchRead += 16;
+			pbyWrite += 12;
+		}
+	}
+	// 输出不足 4 个的 6 位的值中的完整字节。严格模式下，剩下的比特必须为零。
+	bool FlushSextets(unsigned char *&pbyWrite, std::uint32_t u32Bits, unsigned uSextetCount, bool bStrict) noexcept {
+		switch(uSextetCount){
+		case 0:
+			return true;
+		case 2:
+			if(bStrict && ((u32Bits & 0x0F) != 0)){
+				return false;
+			}
+			pbyWrite[0] = static_cast<unsigned char>(u32Bits >> 4);
+			pbyWrite += 1;
+			return true;
+		case 3:
+			if(bStrict && ((u32Bits & 0x03) != 0)){
+				return false;
+			}
+			pbyWrite[0] = static_cast<unsigned char>(u32Bits >> 10);
+			pbyWrite[1] = static_cast<unsigned char>(u32Bits >> 2);
+			pbyWrite += 2;
+			return true;
+		default:
+			return false;
+		}
+	}
+}
+
+std::size_t Base64Encoder::Update(char *pchOut, const void *pData, std::size_t uSize) noexcept {
+	const auto pchAlphabet = x_bUrlSafe ? kUrlSafeAlphabet : kStandardAlphabet;
+	auto pchWrite = pchOut;
+	auto pbyRead = static_cast<const unsigned char *>(pData);
+	auto uBytesRemaining = uSize;
+	if(x_uCarrySize != 0){
+		const auto uBytesToCopy = 3 - x_uCarrySize;
+		if(uBytesRemaining < uBytesToCopy){
+			std::memcpy(x_abyCarry + x_uCarrySize, pbyRead, uBytesRemaining);
+			x_uCarrySize += static_cast<unsigned>(uBytesRemaining);
+			return 0;
+		}
+		unsigned char abyTriple[3];
+		std::memcpy(abyTriple, x_abyCarry, x_uCarrySize);
+		std::memcpy(abyTriple + x_uCarrySize, pbyRead, uBytesToCopy);
+		pbyRead += uBytesToCopy;
+		uBytesRemaining -= uBytesToCopy;
+		x_uCarrySize = 0;
+		pchWrite = EncodeTriples(pchWrite, abyTriple, 1, pchAlphabet);
+	}
+	const auto uTripleCount = uBytesRemaining / 3;
+	pchWrite = EncodeTriples(pchWrite, pbyRead, uTripleCount, pchAlphabet);
+	pbyRead += uTripleCount * 3;
+	uBytesRemaining -= uTripleCount * 3;
+	if(uBytesRemaining != 0){
+		std::memcpy(x_abyCarry, pbyRead, uBytesRemaining);
+		x_uCarrySize = static_cast<unsigned>(uBytesRemaining);
+	}
+	return static_cast<std::size_t>(pchWrite - pchOut);
+}
+std::size_t Base64Encoder::Finalize(char *pchOut) noexcept {
+	const auto pchAlphabet = x_bUrlSafe ? kUrlSafeAlphabet : kStandardAlphabet;
+	auto pchWrite = pchOut;
+	if(x_uCarrySize != 0){
+		std::uint32_t u32Bits = static_cast<std::uint32_t>(x_abyCarry[0]) << 16;
+		if(x_uCarrySize > 1){
+			u32Bits |= static_cast<std::uint32_t>(x_abyCarry[1]) << 8;
+		}
+		*(pchWrite++) = pchAlphabet[(u32Bits >> 18) & 0x3F];
+		*(pchWrite++) = pchAlphabet[(u32Bits >> 12) & 0x3F];
+		if(x_uCarrySize > 1){
+			*(pchWrite++) = pchAlphabet[(u32Bits >> 6) & 0x3F];
+		} else if(x_bPadding){
+			*(pchWrite++) = '=';
+		}
+		if(x_bPadding){
+			*(pchWrite++) = '=';
+		}
+		x_uCarrySize = 0;
+	}
+	return static_cast<std::size_t>(pchWrite - pchOut);
+}
+
+std::size_t Base64Encoder::Encode(char *pchOut, const void *pData, std::size_t uSize, bool bUrlSafe, bool bPadding) noexcept {
+	Base64Encoder vEncoder(bUrlSafe, bPadding);
+	const auto uCharsWritten = vEncoder.Update(pchOut, pData, uSize);
+	return uCharsWritten + vEncoder.Finalize(pchOut + uCharsWritten);
+}
+
+std::size_t Base64Decoder::Update(void *pOut, const char *pchIn, std::size_t uSize) noexcept {
+	const auto &vTable = x_bUrlSafe ? kUrlSafeTable : kStandardTable;
+	const bool bStrict = x_eMode == kModeStrict;
+	auto pbyWrite = static_cast<unsigned char *>(pOut);
+	auto pchRead = pchIn;
+	const auto pchEnd = pchIn + uSize;
+	while(pchRead != pchEnd){
+		if((x_uSextetCount == 0) && !x_bEnded){
+			DecodeBlocks(pbyWrite, pchRead, pchEnd, x_bUrlSafe);
+			if(pchRead == pchEnd){
+				break;
+			}
+		}
+		// 逐个处理字符，直到可以重新开始按块解码。
+		do {
+			const unsigned uValue = vTable.abyValues[static_cast<unsigned char>(*pchRead)];
+			++pchRead;
+			if(uValue < 64){
+				if(x_bEnded){
+					return SIZE_MAX;
+				}
+				x_u32Bits = (x_u32Bits << 6) | uValue;
+				++x_uSextetCount;
+				if(x_uSextetCount == 4){
+					pbyWrite[0] = static_cast<unsigned char>(x_u32Bits >> 16);
+					pbyWrite[1] = static_cast<unsigned char>(x_u32Bits >> 8);
+					pbyWrite[2] = static_cast<unsigned char>(x_u32Bits);
+					pbyWrite += 3;
+					x_u32Bits = 0;
+					x_uSextetCount = 0;
+				}
+			} else if(uValue == kCharPadding){
+				if(!x_bEnded){
+					// 两个 6 位的值之后有两个填充字符，三个之后有一个。
+					if(x_uSextetCount < 2){
+						return SIZE_MAX;
+					}
+					if(!FlushSextets(pbyWrite, x_u32Bits, x_uSextetCount, bStrict)){
+						return SIZE_MAX;
+					}
+					x_uPaddingExpected = 3 - x_uSextetCount;
+					x_u32Bits = 0;
+					x_uSextetCount = 0;
+					x_bEnded = true;
+				} else {
+					if(x_uPaddingExpected == 0){
+						return SIZE_MAX;
+					}
+					--x_uPaddingExpected;
+				}
+			} else if((uValue == kCharWhitespace) && !bStrict){
+				// 忽略空白字符。
+			} else {
+				return SIZE_MAX;
+			}
+		} while((pchRead != pchEnd) && ((x_uSextetCount != 0) || x_bEnded || (vTable.abyValues[static_cast<unsigned char>(*pchRead)] >= 64)));
+	}
+	return static_cast<std::size_t>(pbyWrite - static_cast<unsigned char *>(pOut));
+}
+std::size_t Base64Decoder::Finalize(void *pOut) noexcept {
+	const bool bStrict = x_eMode == kModeStrict;
+	auto pbyWrite = static_cast<unsigned char *>(pOut);
+	if(x_bEnded){
+		if(bStrict && (x_uPaddingExpected != 0)){
+			return SIZE_MAX;
+		}
+	} else if(x_uSextetCount != 0){
+		if(bStrict){
+			return SIZE_MAX;
+		}
+		if(!FlushSextets(pbyWrite, x_u32Bits, x_uSextetCount, bStrict)){
+			return SIZE_MAX;
+		}
+	}
+	Reset();
+	return static_cast<std::size_t>(pbyWrite - static_cast<unsigned char *>(pOut));
+}
+
+std::size_t Base64Decoder::Decode(void *pOut, const char *pchIn, std::size_t uSize, Mode eMode, bool bUrlSafe) noexcept {
+	Base64Decoder vDecoder(eMode, bUrlSafe);
+	const auto uBytesWritten = vDecoder.Update(pOut, pchIn, uSize);
+	if(uBytesWritten == SIZE_MAX){
+		return SIZE_MAX;
+	}
+	const auto uBytesFlushed = vDecoder.Finalize(static_cast<unsigned char *>(pOut) + uBytesWritten);
+	if(uBytesFlushed == SIZE_MAX){
+		return SIZE_MAX;
+	}
+	return uBytesWritten + uBytesFlushed;
+}
+
+}
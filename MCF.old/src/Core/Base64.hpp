@@ -0,0 +1,117 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_CORE_BASE64_HPP_
+#define MCF_CORE_BASE64_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace MCF {
+
+// https://tools.ietf.org/html/rfc4648
+// http://0x80.pl/notesen/2016-01-12-sse-base64-encoding.html
+// http://0x80.pl/notesen/2016-01-17-sse-base64-decoding.html
+// 标准字母表的最后两个字符是 '+' 和 '/'，URL 安全的字母表中是 '-' 和 '_'。
+
+class Base64Encoder {
+private:
+	bool x_bUrlSafe;
+	bool x_bPadding;
+	unsigned char x_abyCarry[2];
+	unsigned x_uCarrySize;
+
+public:
+	explicit Base64Encoder(bool bUrlSafe = false, bool bPadding = true) noexcept
+		: x_bUrlSafe(bUrlSafe), x_bPadding(bPadding)
+		, x_uCarrySize(0)
+	{ }
+
+public:
+	// 编码 uSize 字节的数据最多输出的字符数。
+	static constexpr std::size_t GetMaxEncodedSize(std::size_t uSize) noexcept {
+		return (uSize + 2) / 3 * 4;
+	}
+
+	bool IsUrlSafe() const noexcept {
+		return x_bUrlSafe;
+	}
+	bool IsPaddingEnabled() const noexcept {
+		return x_bPadding;
+	}
+	// 返回保存下来还没有编码的字节数。
+	std::size_t GetPendingSize() const noexcept {
+		return x_uCarrySize;
+	}
+
+	void Reset() noexcept {
+		x_uCarrySize = 0;
+	}
+	// 返回写入的字符数。pchOut 至少要能容纳 GetMaxEncodedSize(uSize) 个字符。
+	// 不足三个字节的部分被保存下来，和下一次输入的数据一起编码。
+	std::size_t Update(char *pchOut, const void *pData, std::size_t uSize) noexcept;
+	// 编码保存的字节并输出填充，返回写入的字符数，最多为 4。之后可以开始编码新的数据。
+	std::size_t Finalize(char *pchOut) noexcept;
+
+	// 一次性编码。
+	static std::size_t Encode(char *pchOut, const void *pData, std::size_t uSize, bool bUrlSafe = false, bool bPadding = true) noexcept;
+};
+
+class Base64Decoder {
+public:
+	enum Mode : unsigned {
+		// 只接受规范的编码：必须有正确的填充，不能有空白字符，最后一个字符中未使用的比特必须为零。
+		kModeStrict  = 0,
+		// 忽略空白字符，填充是可选的，未使用的比特被忽略。
+		kModeLenient = 1,
+	};
+
+private:
+	Mode x_eMode;
+	bool x_bUrlSafe;
+	std::uint32_t x_u32Bits;
+	unsigned x_uSextetCount;
+	bool x_bEnded;
+	unsigned x_uPaddingExpected;
+
+public:
+	explicit Base64Decoder(Mode eMode = kModeStrict, bool bUrlSafe = false) noexcept
+		: x_eMode(eMode), x_bUrlSafe(bUrlSafe)
+	{
+		Reset();
+	}
+
+public:
+	// 解码 uSize 个字符最多输出的字节数。
+	static constexpr std::size_t GetMaxDecodedSize(std::size_t uSize) noexcept {
+		return (uSize + 3) / 4 * 3;
+	}
+
+	Mode GetMode() const noexcept {
+		return x_eMode;
+	}
+	bool IsUrlSafe() const noexcept {
+		return x_bUrlSafe;
+	}
+
+	void Reset() noexcept {
+		x_u32Bits = 0;
+		x_uSextetCount = 0;
+		x_bEnded = false;
+		x_uPaddingExpected = 0;
+	}
+	// 返回写入的字节数。pOut 至少要能容纳 GetMaxDecodedSize(uSize) 个字节。
+	// 如果数据无效则返回 SIZE_MAX，此时必须调用 Reset() 才能继续使用。
+	std::size_t Update(void *pOut, const char *pchIn, std::size_t uSize) noexcept;
+	// 检查数据是否完整并输出剩下的字节，返回写入的字节数，最多为 2。如果数据无效则返回 SIZE_MAX。
+	// 成功之后可以开始解码新的数据。
+	std::size_t Finalize(void *pOut) noexcept;
+
+	// 一次性解码。返回写入的字节数，如果数据无效则返回 SIZE_MAX。
+	static std::size_t Decode(void *pOut, const char *pchIn, std::size_t uSize, Mode eMode = kModeStrict, bool bUrlSafe = false) noexcept;
+};
+
+}
+
+#endif
@@ -7,6 +7,7 @@
 #include "String.hpp"
 #include "BinaryOperations.hpp"
 #include "Defer.hpp"
+#include "MinMax.hpp"
 #include <MCFCRT/env/mcfwin.h>
 #include <ntdef.h>
 #include <ntstatus.h>
@@ -125,6 +126,8 @@ extern NTSTATUS NtReadFile(HANDLE hFile, HANDLE hEvent, PIO_APC_ROUTINE pfnApcRo
 __attribute__((__dllimport__, __stdcall__))
 extern NTSTATUS NtWriteFile(HANDLE hFile, HANDLE hEvent, PIO_APC_ROUTINE pfnApcRoutine, void *pApcContext, IO_STATUS_BLOCK *pIoStatus, const void *pBuffer, ULONG ulLength, const LARGE_INTEGER *pliOffset, const ULONG *pulKey) noexcept;
 __attribute__((__dllimport__, __stdcall__))
+extern NTSTATUS NtWaitForSingleObject(HANDLE hObject, BOOLEAN bAlertable, const LARGE_INTEGER *pliTimeout) noexcept;
+__attribute__((__dllimport__, __stdcall__))
 extern NTSTATUS NtFlushBuffersFile(HANDLE hFile, IO_STATUS_BLOCK *pIoStatus) noexcept;
 
 __attribute__((__dllimport__, __stdcall__))
@@ -236,7 +239,10 @@ File::File(const WideStringView &wsvPath, std::uint32_t u32Flags){
 		dwCreateDisposition = FILE_OPEN;
 	}
 
-	DWORD dwCreateOptions = FILE_SYNCHRONOUS_IO_NONALERT | FILE_NON_DIRECTORY_FILE | FILE_RANDOM_ACCESS;
+	DWORD dwCreateOptions = FILE_NON_DIRECTORY_FILE | FILE_RANDOM_ACCESS;
+	if(!(u32Flags & kOverlapped)){
+		dwCreateOptions |= FILE_SYNCHRONOUS_IO_NONALERT;
+	}
 	if(u32Flags & kNoBuffering){
 		dwCreateOptions |= FILE_NO_INTERMEDIATE_BUFFERING;
 	}
@@ -327,7 +333,15 @@ std::size_t File::Read(void *pBuffer, std::size_t uBytesToRead, std::uint64_t u6
 
 	::LARGE_INTEGER liOffset;
 	liOffset.QuadPart = static_cast<std::int64_t>(u64Offset);
-	const auto lStatus = ::NtReadFile(x_hFile.Get(), nullptr, nullptr, nullptr, &vIoStatus, pBuffer, ulBytesToRead, &liOffset, nullptr);
+	auto lStatus = ::NtReadFile(x_hFile.Get(), nullptr, nullptr, nullptr, &vIoStatus, pBuffer, ulBytesToRead, &liOffset, nullptr);
+	if(lStatus == STATUS_PENDING){
+		// 以 kOverlapped 打开的文件。请求完成时文件对象被触发。
+		const auto lWaitStatus = ::NtWaitForSingleObject(x_hFile.Get(), false, nullptr);
+		if(!NT_SUCCESS(lWaitStatus)){
+			MCF_THROW(Exception, ::RtlNtStatusToDosError(lWaitStatus), Rcntws::View(L"File: NtWaitForSingleObject() 失败。"));
+		}
+		lStatus = vIoStatus.Status;
+	}
 	if((lStatus != STATUS_END_OF_FILE) && !NT_SUCCESS(lStatus)){
 		MCF_THROW(Exception, ::RtlNtStatusToDosError(lStatus), Rcntws::View(L"File: NtReadFile() 失败。"));
 	}
@@ -354,12 +368,90 @@ std::size_t File::Write(std::uint64_t u64Offset, const void *pBuffer, std::size_
 
 	::LARGE_INTEGER liOffset;
 	liOffset.QuadPart = static_cast<std::int64_t>(u64Offset);
-	const auto lStatus = ::NtWriteFile(x_hFile.Get(), nullptr, nullptr, nullptr, &vIoStatus, pBuffer, ulBytesToWrite, &liOffset, nullptr);
+	auto lStatus = ::NtWriteFile(x_hFile.Get(), nullptr, nullptr, nullptr, &vIoStatus, pBuffer, ulBytesToWrite, &liOffset, nullptr);
+	if(lStatus == STATUS_PENDING){
+		// 以 kOverlapped 打开的文件。请求完成时文件对象被触发。
+		const auto lWaitStatus = ::NtWaitForSingleObject(x_hFile.Get(), false, nullptr);
+		if(!NT_SUCCESS(lWaitStatus)){
+			MCF_THROW(Exception, ::RtlNtStatusToDosError(lWaitStatus), Rcntws::View(L"File: NtWaitForSingleObject() 失败。"));
+		}
+		lStatus = vIoStatus.Status;
+	}
 	if(!NT_SUCCESS(lStatus)){
 		MCF_THROW(Exception, ::RtlNtStatusToDosError(lStatus), Rcntws::View(L"File: NtWriteFile() 失败。"));
 	}
 	return vIoStatus.Information;
 }
+std::size_t File::ReadScatter(StreamBuffer &sbufData, std::size_t uBytesToRead, std::uint64_t u64Offset) const {
+	enum : std::size_t { kMinChunkSize = 0x400 };
+
+	std::size_t uBytesTotal = 0;
+	for(;;){
+		const auto uBytesRemaining = uBytesToRead - uBytesTotal;
+		if(uBytesRemaining == 0){
+			break;
+		}
+		// 直接读到 StreamBuffer 的块中，不经过中间缓冲区。
+		void *pChunk;
+		const auto uChunkSize = Min(sbufData.Reserve(&pChunk, Min(uBytesRemaining, static_cast<std::size_t>(kMinChunkSize))), uBytesRemaining);
+		const auto uBytesRead = Read(pChunk, uChunkSize, u64Offset + uBytesTotal);
+		sbufData.Commit(uBytesRead);
+		uBytesTotal += uBytesRead;
+		if(uBytesRead < uChunkSize){
+			break;
+		}
+	}
+	return uBytesTotal;
+}
+std::size_t File::WriteGather(std::uint64_t u64Offset, const StreamBuffer &sbufData){
+	// NtWriteFileGather() 要求每个缓冲区都是按页对齐的整页，并且文件必须以无缓冲的重叠 I/O 方式打开，StreamBuffer 的块无法满足这些要求。
+	// 这里把相邻的小块合并到暂存缓冲区中，大块直接写入，尽量减少系统调用的次数，同时避免 Squash() 那样复制所有数据。
+	enum : std::size_t {
+		kStagingSize = 0x4000,
+		kMaxStagedChunkSize = kStagingSize / 4,
+	};
+
+	unsigned char abyStaging[kStagingSize];
+	std::size_t uStaged = 0;
+	std::size_t uBytesTotal = 0;
+
+	const auto fnWriteAll = [&](const void *pData, std::size_t uSize){
+		std::size_t uBytesWrittenTotal = 0;
+		while(uBytesWrittenTotal < uSize){
+			const auto uBytesWritten = Write(u64Offset + uBytesTotal, static_cast<const unsigned char *>(pData) + uBytesWrittenTotal, uSize - uBytesWrittenTotal);
+			if(uBytesWritten == 0){
+				break;
+			}
+			uBytesWrittenTotal += uBytesWritten;
+			uBytesTotal += uBytesWritten;
+		}
+		return uBytesWrittenTotal == uSize;
+	};
+
+	StreamBuffer::EnumerationCookie vCookie;
+	const void *pChunk;
+	std::size_t uChunkSize;
+	while(sbufData.EnumerateChunk(&pChunk, &uChunkSize, vCookie)){
+		if((uStaged != 0) && ((uChunkSize > kMaxStagedChunkSize) || (uChunkSize > kStagingSize - uStaged))){
+			if(!fnWriteAll(abyStaging, uStaged)){
+				return uBytesTotal;
+			}
+			uStaged = 0;
+		}
+		if(uChunkSize <= kMaxStagedChunkSize){
+			std::memcpy(abyStaging + uStaged, pChunk, uChunkSize);
+			uStaged += uChunkSize;
+			continue;
+		}
+		if(!fnWriteAll(pChunk, uChunkSize)){
+			return uBytesTotal;
+		}
+	}
+	if(uStaged != 0){
+		fnWriteAll(abyStaging, uStaged);
+	}
+	return uBytesTotal;
+}
 void File::Flush(){
 	if(!x_hFile){
 		MCF_THROW(Exception, ERROR_INVALID_HANDLE, Rcntws::View(L"File: 尚未打开任何文件。"));
@@ -7,6 +7,7 @@
 
 #include "_KernelObjectBase.hpp"
 #include "StringView.hpp"
+#include "StreamBuffer.hpp"
 #include <cstddef>
 #include <cstdint>
 
@@ -33,6 +34,7 @@ public:
 		kWriteThrough     = 0x00020000,
 		kDeleteOnClose    = 0x00040000,
 		kDontTruncate     = 0x00080000, // 默认情况下使用 kToWrite 打开文件会清空现有内容。
+		kOverlapped       = 0x00100000, // 以异步方式打开，用于 AsyncFile。同步的读写仍然可用，但是不能和异步请求同时进行。
 	};
 
 private:
@@ -60,6 +62,10 @@ public:
 
 	std::size_t Read(void *pBuffer, std::size_t uBytesToRead, std::uint64_t u64Offset) const;
 	std::size_t Write(std::uint64_t u64Offset, const void *pBuffer, std::size_t uBytesToWrite);
+	// 读取的数据追加到 sbufData 末尾。遇到文件末尾时返回的数目小于 uBytesToRead。
+	std::size_t ReadScatter(StreamBuffer &sbufData, std::size_t uBytesToRead, std::uint64_t u64Offset) const;
+	// 写入 sbufData 中的所有块，不会修改它。返回的数目小于 sbufData.GetSize() 表示写入不完整。
+	std::size_t WriteGather(std::uint64_t u64Offset, const StreamBuffer &sbufData);
 	void Flush();
 
 	void Swap(File &vOther) noexcept {
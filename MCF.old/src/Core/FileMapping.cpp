@@ -0,0 +1,205 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "FileMapping.hpp"
+#include "Exception.hpp"
+#include "MinMax.hpp"
+#include "Assert.hpp"
+#include <MCFCRT/env/mcfwin.h>
+#include <ntdef.h>
+#include <ntstatus.h>
+
+extern "C" {
+
+typedef struct _IO_STATUS_BLOCK {
+	union {
+		NTSTATUS Status;
+		PVOID Pointer;
+	};
+	ULONG_PTR Information;
+} IO_STATUS_BLOCK, *PIO_STATUS_BLOCK;
+
+typedef enum _SECTION_INHERIT {
+	ViewShare = 1,
+	ViewUnmap = 2,
+} SECTION_INHERIT;
+
+__attribute__((__dllimport__, __stdcall__))
+extern NTSTATUS NtCreateSection(HANDLE *pSection, ACCESS_MASK dwDesiredAccess, const OBJECT_ATTRIBUTES *pObjectAttributes, const LARGE_INTEGER *pliMaximumSize, ULONG ulSectionPageProtection, ULONG ulAllocationAttributes, HANDLE hFile) noexcept;
+__attribute__((__dllimport__, __stdcall__))
+extern NTSTATUS NtMapViewOfSection(HANDLE hSection, HANDLE hProcess, void **ppBaseAddress, ULONG_PTR ulZeroBits, SIZE_T uCommitSize, LARGE_INTEGER *pliSectionOffset, SIZE_T *puViewSize, SECTION_INHERIT eInheritDisposition, ULONG ulAllocationType, ULONG ulWin32Protect) noexcept;
+__attribute__((__dllimport__, __stdcall__))
+extern NTSTATUS NtUnmapViewOfSection(HANDLE hProcess, void *pBaseAddress) noexcept;
+__attribute__((__dllimport__, __stdcall__))
+extern NTSTATUS NtFlushVirtualMemory(HANDLE hProcess, void **ppBaseAddress, SIZE_T *puSize, IO_STATUS_BLOCK *pIoStatus) noexcept;
+
+__attribute__((__dllimport__, __stdcall__))
+extern ULONG WINAPI RtlNtStatusToDosError(NTSTATUS lStatus) noexcept;
+
+}
+
+#define GetCurrentProcess()  ((HANDLE)-1)
+
+namespace MCF {
+
+namespace {
+	// 和 WIN32_MEMORY_RANGE_ENTRY 的布局相同。
+	struct PrefetchRange {
+		void *pAddress;
+		SIZE_T uSize;
+	};
+
+	using PrefetchVirtualMemoryProc = BOOL (WINAPI *)(HANDLE hProcess, ULONG_PTR uNumberOfEntries, PrefetchRange *pVirtualAddresses, ULONG ulFlags);
+
+	// PrefetchVirtualMemory() 从 Windows 8 开始才有，在更早的系统上预读不做任何事情。
+	PrefetchVirtualMemoryProc GetPrefetchVirtualMemory() noexcept {
+		static const auto s_pfnPrefetchVirtualMemory = []() noexcept {
+			const auto hKernel32 = ::GetModuleHandleW(L"KERNEL32.DLL");
+			if(!hKernel32){
+				return PrefetchVirtualMemoryProc();
+			}
+			return reinterpret_cast<PrefetchVirtualMemoryProc>(reinterpret_cast<void (*)()>(::GetProcAddress(hKernel32, "PrefetchVirtualMemory")));
+		}();
+		return s_pfnPrefetchVirtualMemory;
+	}
+}
+
+FileMapping::FileMapping(const File &vFile, Access eAccess){
+	if(!vFile){
+		MCF_THROW(Exception, ERROR_INVALID_HANDLE, Rcntws::View(L"FileMapping: 尚未打开任何文件。"));
+	}
+
+	const auto u64Size = vFile.GetSize();
+	x_u64Size = u64Size;
+	x_eAccess = eAccess;
+	// 空文件无法创建映射对象，它的所有视图都是空的。
+	if(u64Size == 0){
+		return;
+	}
+
+	::ACCESS_MASK dwDesiredAccess;
+	ULONG ulProtect;
+	switch(eAccess){
+	case kReadOnly:
+		dwDesiredAccess = SECTION_QUERY | SECTION_MAP_READ;
+		ulProtect = PAGE_READONLY;
+		break;
+	case kCopyOnWrite:
+		dwDesiredAccess = SECTION_QUERY | SECTION_MAP_READ;
+		ulProtect = PAGE_WRITECOPY;
+		break;
+	case kReadWrite:
+		dwDesiredAccess = SECTION_QUERY | SECTION_MAP_READ | SECTION_MAP_WRITE;
+		ulProtect = PAGE_READWRITE;
+		break;
+	default:
+		MCF_THROW(Exception, ERROR_INVALID_PARAMETER, Rcntws::View(L"FileMapping: 访问方式无效。"));
+	}
+
+	HANDLE hTemp;
+	const auto lStatus = ::NtCreateSection(&hTemp, dwDesiredAccess, nullptr, nullptr, ulProtect, SEC_COMMIT, vFile.GetHandle());
+	if(!NT_SUCCESS(lStatus)){
+		MCF_THROW(Exception, ::RtlNtStatusToDosError(lStatus), Rcntws::View(L"FileMapping: NtCreateSection() 失败。"));
+	}
+	x_hSection.Reset(hTemp);
+}
+
+void FileMapping::Open(const File &vFile, Access eAccess){
+	FileMapping(vFile, eAccess).Swap(*this);
+}
+void FileMapping::Close() noexcept {
+	FileMapping().Swap(*this);
+}
+
+FileMapping::View FileMapping::MapView(std::uint64_t u64Offset, std::size_t uSize) const {
+	if(u64Offset > x_u64Size){
+		MCF_THROW(Exception, ERROR_SEEK, Rcntws::View(L"FileMapping: 偏移量超出文件末尾。"));
+	}
+	const auto u64Remaining = x_u64Size - u64Offset;
+	if(uSize == 0){
+		if(u64Remaining > SIZE_MAX){
+			MCF_THROW(Exception, ERROR_NOT_ENOUGH_MEMORY, Rcntws::View(L"FileMapping: 文件太大，无法映射到文件末尾。"));
+		}
+		uSize = static_cast<std::size_t>(u64Remaining);
+	} else {
+		uSize = static_cast<std::size_t>(Min(uSize, u64Remaining));
+	}
+	if(uSize == 0){
+		return View();
+	}
+
+	const auto u64AlignedOffset = u64Offset & ~static_cast<std::uint64_t>(kAllocationGranularity - 1);
+	const auto uPadding = static_cast<std::size_t>(u64Offset - u64AlignedOffset);
+	if(uSize > SIZE_MAX - uPadding){
+		MCF_THROW(Exception, ERROR_NOT_ENOUGH_MEMORY, Rcntws::View(L"FileMapping: 视图太大。"));
+	}
+
+	ULONG ulProtect;
+	switch(x_eAccess){
+	case kCopyOnWrite:
+		ulProtect = PAGE_WRITECOPY;
+		break;
+	case kReadWrite:
+		ulProtect = PAGE_READWRITE;
+		break;
+	default:
+		ulProtect = PAGE_READONLY;
+		break;
+	}
+
+	void *pBase = nullptr;
+	::LARGE_INTEGER liOffset;
+	liOffset.QuadPart = static_cast<std::int64_t>(u64AlignedOffset);
+	SIZE_T uViewSize = uPadding + uSize;
+	const auto lStatus = ::NtMapViewOfSection(x_hSection.Get(), GetCurrentProcess(), &pBase, 0, 0, &liOffset, &uViewSize, ViewUnmap, 0, ulProtect);
+	if(!NT_SUCCESS(lStatus)){
+		MCF_THROW(Exception, ::RtlNtStatusToDosError(lStatus), Rcntws::View(L"FileMapping: NtMapViewOfSection() 失败。"));
+	}
+	return View(pBase, static_cast<unsigned char *>(pBase) + uPadding, uSize, u64Offset);
+}
+
+FileMapping::View::~View(){
+	Unmap();
+}
+
+void FileMapping::View::Unmap() noexcept {
+	const auto pBase = std::exchange(x_pBase, nullptr);
+	if(!pBase){
+		return;
+	}
+	x_pbyData = nullptr;
+	x_uSize = 0;
+	x_u64Offset = 0;
+
+	const auto lStatus = ::NtUnmapViewOfSection(GetCurrentProcess(), pBase);
+	MCF_ASSERT_MSG(NT_SUCCESS(lStatus), L"NtUnmapViewOfSection() 失败。");
+}
+
+void FileMapping::View::Prefetch(std::size_t uOffset, std::size_t uSize) const noexcept {
+	if(uOffset >= x_uSize){
+		return;
+	}
+	const auto pfnPrefetchVirtualMemory = GetPrefetchVirtualMemory();
+	if(!pfnPrefetchVirtualMemory){
+		return;
+	}
+	PrefetchRange vRange;
+	vRange.pAddress = x_pbyData + uOffset;
+	vRange.uSize    = Min(uSize, x_uSize - uOffset);
+	(*pfnPrefetchVirtualMemory)(GetCurrentProcess(), 1, &vRange, 0);
+}
+void FileMapping::View::Flush(std::size_t uOffset, std::size_t uSize) const {
+	if(uOffset >= x_uSize){
+		return;
+	}
+	void *pAddress = x_pbyData + uOffset;
+	SIZE_T uSizeToFlush = Min(uSize, x_uSize - uOffset);
+	::IO_STATUS_BLOCK vIoStatus;
+	const auto lStatus = ::NtFlushVirtualMemory(GetCurrentProcess(), &pAddress, &uSizeToFlush, &vIoStatus);
+	if(!NT_SUCCESS(lStatus)){
+		MCF_THROW(Exception, ::RtlNtStatusToDosError(lStatus), Rcntws::View(L"FileMapping: NtFlushVirtualMemory() 失败。"));
+	}
+}
+
+}
@@ -0,0 +1,141 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_CORE_FILE_MAPPING_HPP_
+#define MCF_CORE_FILE_MAPPING_HPP_
+
+#include "File.hpp"
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace MCF {
+
+// 文件映射对象。映射对象创建之后，原来的 File 可以被关闭。
+class FileMapping {
+public:
+	enum Access : unsigned {
+		kReadOnly    = 0,
+		kCopyOnWrite = 1, // 视图可写，但是修改不会写回文件，也不会被其他视图看到。
+		kReadWrite   = 2,
+	};
+
+	enum : std::size_t {
+		// 视图的起始偏移量必须是这个值的整数倍。
+		kAllocationGranularity = 0x10000,
+	};
+
+	class View;
+
+private:
+	Impl_UniqueNtHandle::UniqueNtHandle x_hSection;
+	std::uint64_t x_u64Size = 0;
+	Access x_eAccess = kReadOnly;
+
+public:
+	constexpr FileMapping() noexcept { }
+	FileMapping(const File &vFile, Access eAccess);
+
+public:
+	bool IsOpen() const noexcept {
+		return !!x_hSection;
+	}
+	std::uint64_t GetSize() const noexcept {
+		return x_u64Size;
+	}
+	Access GetAccess() const noexcept {
+		return x_eAccess;
+	}
+
+	void Open(const File &vFile, Access eAccess);
+	void Close() noexcept;
+
+	// 映射 [u64Offset, u64Offset + uSize) 的内容，不要求对齐。uSize 为零表示映射到文件末尾。
+	View MapView(std::uint64_t u64Offset, std::size_t uSize) const;
+
+	void Swap(FileMapping &vOther) noexcept {
+		using std::swap;
+		swap(x_hSection, vOther.x_hSection);
+		swap(x_u64Size,  vOther.x_u64Size);
+		swap(x_eAccess,  vOther.x_eAccess);
+	}
+
+public:
+	explicit operator bool() const noexcept {
+		return IsOpen();
+	}
+
+	friend void swap(FileMapping &vSelf, FileMapping &vOther) noexcept {
+		vSelf.Swap(vOther);
+	}
+};
+
+class FileMapping::View {
+	friend FileMapping;
+
+private:
+	void *x_pBase = nullptr;
+	unsigned char *x_pbyData = nullptr;
+	std::size_t x_uSize = 0;
+	std::uint64_t x_u64Offset = 0;
+
+private:
+	View(void *pBase, unsigned char *pbyData, std::size_t uSize, std::uint64_t u64Offset) noexcept
+		: x_pBase(pBase), x_pbyData(pbyData), x_uSize(uSize), x_u64Offset(u64Offset)
+	{ }
+
+public:
+	constexpr View() noexcept { }
+	View(View &&vOther) noexcept {
+		Swap(vOther);
+	}
+	View &operator=(View &&vOther) noexcept {
+		View(std::move(vOther)).Swap(*this);
+		return *this;
+	}
+	~View();
+
+public:
+	bool IsMapped() const noexcept {
+		return !!x_pBase;
+	}
+	// 视图是否是只读的由创建它的 FileMapping 决定，写入只读的视图会导致访问违规。
+	void *GetData() const noexcept {
+		return x_pbyData;
+	}
+	std::size_t GetSize() const noexcept {
+		return x_uSize;
+	}
+	std::uint64_t GetOffset() const noexcept {
+		return x_u64Offset;
+	}
+
+	void Unmap() noexcept;
+
+	// 提示系统接下来要访问视图中的这一部分，系统可以提前把它们读入内存。仅仅是提示，失败也不会报错。
+	void Prefetch(std::size_t uOffset, std::size_t uSize) const noexcept;
+	// 把对视图的修改写回文件。
+	void Flush(std::size_t uOffset, std::size_t uSize) const;
+
+	void Swap(View &vOther) noexcept {
+		using std::swap;
+		swap(x_pBase,     vOther.x_pBase);
+		swap(x_pbyData,   vOther.x_pbyData);
+		swap(x_uSize,     vOther.x_uSize);
+		swap(x_u64Offset, vOther.x_u64Offset);
+	}
+
+public:
+	explicit operator bool() const noexcept {
+		return IsMapped();
+	}
+
+	friend void swap(View &vSelf, View &vOther) noexcept {
+		vSelf.Swap(vOther);
+	}
+};
+
+}
+
+#endif
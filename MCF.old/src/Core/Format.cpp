@@ -0,0 +1,336 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "Format.hpp"
+#include "Assert.hpp"
+#include "CountLeadingTrailingZeroes.hpp"
+#include <MCFCRT/ext/itoa.h>
+#include <cmath>
+
+namespace MCF {
+
+namespace Impl_Format {
+	namespace {
+		constexpr std::uint64_t kPowersOfTen[19] = {
+			1u,
+			10u,
+			100u,
+			1000u,
+			10000u,
+			100000u,
+			1000000u,
+			10000000u,
+			100000000u,
+			1000000000u,
+			10000000000u,
+			100000000000u,
+			1000000000000u,
+			10000000000000u,
+			100000000000000u,
+			1000000000000000u,
+			10000000000000000u,
+			100000000000000000u,
+			1000000000000000000u,
+		};
+
+		// _MCFCRT_itoa_*() 只接受 std::uintptr_t，在 32 位平台上更大的值需要拆开写。
+		char *WriteDecimal(char *pchBuffer, std::uint64_t u64Value, unsigned uMinDigits) noexcept {
+			if(static_cast<std::uintptr_t>(u64Value) == u64Value){
+				return ::_MCFCRT_itoa0u(pchBuffer, static_cast<std::uintptr_t>(u64Value), uMinDigits);
+			}
+			const auto pchWrite = WriteDecimal(pchBuffer, u64Value / 1000000000u, (uMinDigits > 9) ? (uMinDigits - 9) : 0);
+			return ::_MCFCRT_itoa0u(pchWrite, static_cast<std::uintptr_t>(u64Value % 1000000000u), 9);
+		}
+		char *WriteHexadecimal(char *pchBuffer, std::uint64_t u64Value, bool bUpperCase) noexcept {
+			if(static_cast<std::uintptr_t>(u64Value) == u64Value){
+				return (bUpperCase ? ::_MCFCRT_itoa_X : ::_MCFCRT_itoa_x)(pchBuffer, static_cast<std::uintptr_t>(u64Value));
+			}
+			const auto pchWrite = (bUpperCase ? ::_MCFCRT_itoa_X : ::_MCFCRT_itoa_x)(pchBuffer, static_cast<std::uintptr_t>(u64Value >> 32));
+			return (bUpperCase ? ::_MCFCRT_itoa0X : ::_MCFCRT_itoa0x)(pchWrite, static_cast<std::uintptr_t>(u64Value & 0xFFFFFFFFu), 8);
+		}
+
+		// 浮点数的十进制表示需要精确的计算，否则最后几位数字和舍入都可能是错的。
+		// 一个 double 的值是 m * 2^e，乘以 10 的幂之后的分子和分母都不会超过 1200 位。
+		class BigUnsigned {
+		public:
+			enum : unsigned {
+				kLimbCountMax = 40,
+			};
+
+		private:
+			std::uint32_t x_au32Limbs[kLimbCountMax]; // 低位在前。
+			unsigned x_uLimbCount;
+
+		public:
+			explicit BigUnsigned(std::uint64_t u64Value) noexcept
+				: x_uLimbCount(0)
+			{
+				while(u64Value != 0){
+					x_au32Limbs[x_uLimbCount++] = static_cast<std::uint32_t>(u64Value);
+					u64Value >>= 32;
+				}
+			}
+
+		public:
+			void MultiplySmall(std::uint32_t u32Multiplier) noexcept {
+				std::uint32_t u32Carry = 0;
+				for(unsigned uIndex = 0; uIndex < x_uLimbCount; ++uIndex){
+					const auto u64Product = static_cast<std::uint64_t>(x_au32Limbs[uIndex]) * u32Multiplier + u32Carry;
+					x_au32Limbs[uIndex] = static_cast<std::uint32_t>(u64Product);
+					u32Carry = static_cast<std::uint32_t>(u64Product >> 32);
+				}
+				if(u32Carry != 0){
+					MCF_ASSERT(x_uLimbCount < kLimbCountMax);
+					x_au32Limbs[x_uLimbCount++] = u32Carry;
+				}
+			}
+			void MultiplyPowerOfTen(unsigned uExponent) noexcept {
+				while(uExponent >= 9){
+					MultiplySmall(1000000000u);
+					uExponent -= 9;
+				}
+				if(uExponent != 0){
+					MultiplySmall(static_cast<std::uint32_t>(kPowersOfTen[uExponent]));
+				}
+			}
+			void ShiftLeft(unsigned uBits) noexcept {
+				if(x_uLimbCount == 0){
+					return;
+				}
+				const auto uLimbShift = uBits / 32;
+				const auto uBitShift = uBits % 32;
+				MCF_ASSERT(x_uLimbCount + uLimbShift < kLimbCountMax);
+				x_au32Limbs[x_uLimbCount] = 0;
+				for(unsigned uIndex = x_uLimbCount + 1; uIndex != 0; --uIndex){
+					const auto uSrc = uIndex - 1;
+					auto u32Limb = x_au32Limbs[uSrc] << uBitShift;
+					if((uBitShift != 0) && (uSrc != 0)){
+						u32Limb |= x_au32Limbs[uSrc - 1] >> (32 - uBitShift);
+					}
+					x_au32Limbs[uSrc + uLimbShift] = u32Limb;
+				}
+				for(unsigned uIndex = 0; uIndex < uLimbShift; ++uIndex){
+					x_au32Limbs[uIndex] = 0;
+				}
+				x_uLimbCount += uLimbShift + 1;
+				X_Normalize();
+			}
+			void ShiftRightOne() noexcept {
+				for(unsigned uIndex = 0; uIndex < x_uLimbCount; ++uIndex){
+					auto u32Limb = x_au32Limbs[uIndex] >> 1;
+					if(uIndex + 1 < x_uLimbCount){
+						u32Limb |= x_au32Limbs[uIndex + 1] << 31;
+					}
+					x_au32Limbs[uIndex] = u32Limb;
+				}
+				X_Normalize();
+			}
+			unsigned GetBitLength() const noexcept {
+				if(x_uLimbCount == 0){
+					return 0;
+				}
+				return x_uLimbCount * 32 - CountLeadingZeroes(static_cast<unsigned>(x_au32Limbs[x_uLimbCount - 1]));
+			}
+			int Compare(const BigUnsigned &vOther) const noexcept {
+				if(x_uLimbCount != vOther.x_uLimbCount){
+					return (x_uLimbCount < vOther.x_uLimbCount) ? -1 : 1;
+				}
+				for(unsigned uIndex = x_uLimbCount; uIndex != 0; --uIndex){
+					const auto u32Self = x_au32Limbs[uIndex - 1];
+					const auto u32Other = vOther.x_au32Limbs[uIndex - 1];
+					if(u32Self != u32Other){
+						return (u32Self < u32Other) ? -1 : 1;
+					}
+				}
+				return 0;
+			}
+			// 调用者保证 *this >= vOther。
+			void Subtract(const BigUnsigned &vOther) noexcept {
+				std::uint32_t u32Borrow = 0;
+				for(unsigned uIndex = 0; uIndex < x_uLimbCount; ++uIndex){
+					const auto u64Subtrahend = static_cast<std::uint64_t>((uIndex < vOther.x_uLimbCount) ? vOther.x_au32Limbs[uIndex] : 0) + u32Borrow;
+					u32Borrow = x_au32Limbs[uIndex] < u64Subtrahend;
+					x_au32Limbs[uIndex] = static_cast<std::uint32_t>(x_au32Limbs[uIndex] - u64Subtrahend);
+				}
+				MCF_ASSERT(u32Borrow == 0);
+				X_Normalize();
+			}
+
+		private:
+			void X_Normalize() noexcept {
+				while((x_uLimbCount != 0) && (x_au32Limbs[x_uLimbCount - 1] == 0)){
+					--x_uLimbCount;
+				}
+			}
+		};
+
+		// 计算 u64Mantissa * 2^nExp2 * 10^nExp10 四舍六入五成双之后的整数值，调用者保证结果小于 2^64。
+		std::uint64_t ScaleAndRound(std::uint64_t u64Mantissa, int nExp2, int nExp10) noexcept {
+			BigUnsigned vNumerator(u64Mantissa);
+			BigUnsigned vDenominator(1);
+			if(nExp10 >= 0){
+				vNumerator.MultiplyPowerOfTen(static_cast<unsigned>(nExp10));
+			} else {
+				vDenominator.MultiplyPowerOfTen(static_cast<unsigned>(-nExp10));
+			}
+			if(nExp2 >= 0){
+				vNumerator.ShiftLeft(static_cast<unsigned>(nExp2));
+			} else {
+				vDenominator.ShiftLeft(static_cast<unsigned>(-nExp2));
+			}
+			// 商小于 2^64，按位做长除法，从商可能的最高位开始。
+			const auto uNumeratorBits = vNumerator.GetBitLength();
+			const auto uDenominatorBits = vDenominator.GetBitLength();
+			const auto uQuotientBits = (uNumeratorBits >= uDenominatorBits) ? Min(uNumeratorBits - uDenominatorBits + 1, 64u) : 0u;
+			std::uint64_t u64Quotient = 0;
+			auto vShifted = vDenominator;
+			if(uQuotientBits != 0){
+				vShifted.ShiftLeft(uQuotientBits - 1);
+			}
+			for(unsigned uBit = uQuotientBits; uBit != 0; --uBit){
+				u64Quotient <<= 1;
+				if(vNumerator.Compare(vShifted) >= 0){
+					vNumerator.Subtract(vShifted);
+					u64Quotient |= 1;
+				}
+				vShifted.ShiftRightOne();
+			}
+			// 现在 vNumerator 是余数，把它和除数的一半比较。
+			vNumerator.ShiftLeft(1);
+			const int nHalf = vNumerator.Compare(vDenominator);
+			if((nHalf > 0) || ((nHalf == 0) && ((u64Quotient & 1) != 0))){
+				++u64Quotient;
+			}
+			return u64Quotient;
+		}
+		// 把一个有限的正数分解为 u64Mantissa * 2^nExp2，其中 u64Mantissa 不超过 53 位。
+		void Decompose(std::uint64_t &u64Mantissa, int &nExp2, double fValue) noexcept {
+			int nExponent;
+			const auto fFraction = std::frexp(fValue, &nExponent);
+			u64Mantissa = static_cast<std::uint64_t>(std::ldexp(fFraction, 53));
+			nExp2 = nExponent - 53;
+		}
+
+		char *WriteFixed(char *pchBuffer, double fValue, unsigned uPrecision) noexcept {
+			auto pchWrite = pchBuffer;
+			// 整数部分小于 1e18，它和小数部分都可以被精确地表示。
+			const auto fIntegral = std::floor(fValue);
+			auto u64Integral = static_cast<std::uint64_t>(fIntegral);
+			const auto fFraction = fValue - fIntegral;
+			std::uint64_t u64Fraction = 0;
+			if(uPrecision == 0){
+				// 舍入到偶数需要知道整数部分的奇偶性。这里的比较是精确的。
+				if((fFraction > 0.5) || ((fFraction == 0.5) && ((u64Integral & 1) != 0))){
+					++u64Integral;
+				}
+			} else if(fFraction != 0){
+				std::uint64_t u64Mantissa;
+				int nExp2;
+				Decompose(u64Mantissa, nExp2, fFraction);
+				u64Fraction = ScaleAndRound(u64Mantissa, nExp2, static_cast<int>(uPrecision));
+			}
+			if(u64Fraction >= kPowersOfTen[uPrecision]){
+				u64Fraction -= kPowersOfTen[uPrecision];
+				++u64Integral;
+			}
+			pchWrite = WriteDecimal(pchWrite, u64Integral, 1);
+			if(uPrecision != 0){
+				*(pchWrite++) = '.';
+				pchWrite = WriteDecimal(pchWrite, u64Fraction, uPrecision);
+			}
+			return pchWrite;
+		}
+		char *WriteExponent(char *pchBuffer, double fValue, unsigned uPrecision) noexcept {
+			auto pchWrite = pchBuffer;
+			int nExponent = 0;
+			std::uint64_t u64Digits = 0;
+			if(fValue != 0){
+				std::uint64_t u64Mantissa;
+				int nExp2;
+				Decompose(u64Mantissa, nExp2, fValue);
+				// 指数的估计值最多差一，根据舍入之后的位数修正。
+				nExponent = static_cast<int>(std::floor(std::log10(fValue)));
+				for(;;){
+					u64Digits = ScaleAndRound(u64Mantissa, nExp2, static_cast<int>(uPrecision) - nExponent);
+					if(u64Digits >= kPowersOfTen[uPrecision + 1]){
+						++nExponent;
+					} else if(u64Digits < kPowersOfTen[uPrecision]){
+						--nExponent;
+					} else {
+						break;
+					}
+				}
+				if(u64Digits == kPowersOfTen[uPrecision]){
+					// 如果指数估计大了，比 10 的幂略小的数会被向上舍入到这里，用小一的指数再试一次。
+					const auto u64Smaller = ScaleAndRound(u64Mantissa, nExp2, static_cast<int>(uPrecision) - nExponent + 1);
+					if(u64Smaller < kPowersOfTen[uPrecision + 1]){
+						u64Digits = u64Smaller;
+						--nExponent;
+					}
+				}
+			}
+			*(pchWrite++) = static_cast<char>('0' + u64Digits / kPowersOfTen[uPrecision]);
+			if(uPrecision != 0){
+				*(pchWrite++) = '.';
+				pchWrite = WriteDecimal(pchWrite, u64Digits % kPowersOfTen[uPrecision], uPrecision);
+			}
+			*(pchWrite++) = 'e';
+			if(nExponent < 0){
+				*(pchWrite++) = '-';
+				nExponent = -nExponent;
+			} else {
+				*(pchWrite++) = '+';
+			}
+			return WriteDecimal(pchWrite, static_cast<std::uint64_t>(nExponent), 2);
+		}
+	}
+
+	char *WriteUnsigned(char *pchBuffer, std::uint64_t u64Value, char chType) noexcept {
+		switch(chType){
+		case 'x':
+			return WriteHexadecimal(pchBuffer, u64Value, false);
+		case 'X':
+			return WriteHexadecimal(pchBuffer, u64Value, true);
+		default:
+			return WriteDecimal(pchBuffer, u64Value, 1);
+		}
+	}
+	char *WriteSigned(char *pchBuffer, std::int64_t n64Value, char chType) noexcept {
+		auto pchWrite = pchBuffer;
+		auto u64Value = static_cast<std::uint64_t>(n64Value);
+		if(n64Value < 0){
+			*(pchWrite++) = '-';
+			u64Value = -u64Value;
+		}
+		return WriteUnsigned(pchWrite, u64Value, chType);
+	}
+	char *WriteFloat(char *pchBuffer, double fValue, int nPrecision, char chType) noexcept {
+		auto pchWrite = pchBuffer;
+		const auto uPrecision = (nPrecision < 0) ? 6u : static_cast<unsigned>(nPrecision);
+		auto fAbsolute = fValue;
+		if(std::signbit(fValue)){
+			*(pchWrite++) = '-';
+			fAbsolute = -fValue;
+		}
+		if(std::isnan(fAbsolute)){
+			return CopyN(pchWrite, "nan", 3).first;
+		}
+		if(std::isinf(fAbsolute)){
+			return CopyN(pchWrite, "inf", 3).first;
+		}
+		// 整数部分放不进 std::uint64_t 的时候，即使要求定点格式也只能使用科学计数法。
+		if((chType != 'e') && (fAbsolute < 1e18)){
+			return WriteFixed(pchWrite, fAbsolute, uPrecision);
+		}
+		return WriteExponent(pchWrite, fAbsolute, uPrecision);
+	}
+	char *WritePointer(char *pchBuffer, const void *pValue) noexcept {
+		auto pchWrite = pchBuffer;
+		*(pchWrite++) = '0';
+		*(pchWrite++) = 'x';
+		return ::_MCFCRT_itoa0x(pchWrite, reinterpret_cast<std::uintptr_t>(pValue), sizeof(void *) * 2);
+	}
+}
+
+}
@@ -0,0 +1,529 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_CORE_FORMAT_HPP_
+#define MCF_CORE_FORMAT_HPP_
+
+#include "String.hpp"
+#include "StringView.hpp"
+#include "StreamBuffer.hpp"
+#include "CopyMoveFill.hpp"
+#include "MinMax.hpp"
+#include <type_traits>
+#include <utility>
+#include <tuple>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+// 格式字符串必须用这个宏包装，这样它才能在编译期被解析。例如：
+//   Format(strLog, MCF_FORMAT_STRING("{} items in {:.3f}s"), uCount, dSeconds);
+#define MCF_FORMAT_STRING(str_)	\
+	([]{	\
+		struct FormatString_ {	\
+			static constexpr decltype(auto) Get() noexcept {	\
+				return (str_);	\
+			}	\
+		};	\
+		return FormatString_();	\
+	}())
+
+namespace MCF {
+
+namespace Impl_Format {
+	// 格式说明的语法是 {[序号][:[对齐][0][宽度][.精度][类型]]}，其中：
+	//   对齐是 '<' 或 '>'，数字默认右对齐，其他的默认左对齐；
+	//   0 表示数字用零而不是空格填充；
+	//   类型是 d（十进制整数）、x 或 X（十六进制整数）、f（定点小数）、e（科学计数法）、c（字符）、s（字符串）或 p（指针）之一。
+	// 类型和精度必须适用于对应的参数，例如整数只接受 d、x 和 X，只有浮点数可以指定精度，否则会导致编译错误。
+	// {{ 和 }} 分别表示 { 和 }。
+	struct Spec {
+		char chAlign;
+		bool bZeroPad;
+		char chType;
+		std::size_t uWidth;
+		int nPrecision;
+	};
+
+	struct Segment {
+		bool bField;
+		std::size_t uBegin; // 对于字面量，是在格式字符串中的位置。
+		std::size_t uLength;
+		std::size_t uArgIndex;
+		Spec vSpec;
+	};
+
+	template<std::size_t kCountT>
+	struct SegmentList {
+		Segment aSegments[kCountT + 1];
+	};
+
+	enum : std::size_t {
+		kPrecisionMax = 17,
+	};
+
+	// 这个函数不是 constexpr 的，在编译期调用它会导致编译错误，错误信息中包含 pszMessage。
+	inline void BadFormatString(const char *pszMessage) noexcept {
+		(void)pszMessage;
+	}
+
+	template<typename CharT>
+	constexpr std::size_t ParseNumber(const CharT *pchFormat, std::size_t &uPos) noexcept {
+		std::size_t uValue = 0;
+		while((pchFormat[uPos] >= '0') && (pchFormat[uPos] <= '9')){
+			if(uValue > 100000){
+				BadFormatString("Number too large");
+			}
+			uValue = uValue * 10 + static_cast<std::size_t>(pchFormat[uPos] - '0');
+			++uPos;
+		}
+		return uValue;
+	}
+
+	// 解析下一个段，如果已经到达字符串的结尾则返回 false。
+	template<typename CharT>
+	constexpr bool ParseSegment(Segment &vSegment, const CharT *pchFormat, std::size_t &uPos, std::size_t &uNextArgIndex) noexcept {
+		if(pchFormat[uPos] == CharT()){
+			return false;
+		}
+		vSegment = Segment{ false, uPos, 0, 0, Spec{ 0, false, 0, 0, -1 } };
+		if((pchFormat[uPos] == '{') && (pchFormat[uPos + 1] != '{')){
+			++uPos;
+			vSegment.bField = true;
+			if((pchFormat[uPos] >= '0') && (pchFormat[uPos] <= '9')){
+				vSegment.uArgIndex = ParseNumber(pchFormat, uPos);
+			} else {
+				vSegment.uArgIndex = uNextArgIndex;
+			}
+			uNextArgIndex = vSegment.uArgIndex + 1;
+			if(pchFormat[uPos] == ':'){
+				++uPos;
+				auto &vSpec = vSegment.vSpec;
+				if((pchFormat[uPos] == '<') || (pchFormat[uPos] == '>')){
+					vSpec.chAlign = static_cast<char>(pchFormat[uPos]);
+					++uPos;
+				}
+				if(pchFormat[uPos] == '0'){
+					vSpec.bZeroPad = true;
+					++uPos;
+				}
+				vSpec.uWidth = ParseNumber(pchFormat, uPos);
+				if(pchFormat[uPos] == '.'){
+					++uPos;
+					if((pchFormat[uPos] < '0') || (pchFormat[uPos] > '9')){
+						BadFormatString("Precision expected after '.'");
+					}
+					const auto uPrecision = ParseNumber(pchFormat, uPos);
+					if(uPrecision > kPrecisionMax){
+						BadFormatString("Precision too large");
+					}
+					vSpec.nPrecision = static_cast<int>(uPrecision);
+				}
+				switch(pchFormat[uPos]){
+				case 'd': case 'x': case 'X': case 'f': case 'e': case 'c': case 's': case 'p':
+					vSpec.chType = static_cast<char>(pchFormat[uPos]);
+					++uPos;
+					break;
+				default:
+					break;
+				}
+			}
+			if(pchFormat[uPos] != '}'){
+				BadFormatString("Unterminated or invalid format specification");
+			}
+			++uPos;
+			return true;
+		}
+		for(;;){
+			const auto chCur = pchFormat[uPos];
+			if(chCur == CharT()){
+				break;
+			}
+			if((chCur == '{') || (chCur == '}')){
+				if(pchFormat[uPos + 1] == chCur){
+					// 保留第一个花括号，跳过第二个。
+					++uPos;
+					vSegment.uLength = uPos - vSegment.uBegin;
+					++uPos;
+					return true;
+				}
+				if(chCur == '{'){
+					break;
+				}
+				BadFormatString("Unmatched '}'");
+			}
+			++uPos;
+		}
+		vSegment.uLength = uPos - vSegment.uBegin;
+		return true;
+	}
+
+	template<typename CharT>
+	constexpr std::size_t CountSegments(const CharT *pchFormat) noexcept {
+		std::size_t uCount = 0;
+		std::size_t uPos = 0;
+		std::size_t uNextArgIndex = 0;
+		Segment vSegment = { };
+		while(ParseSegment(vSegment, pchFormat, uPos, uNextArgIndex)){
+			++uCount;
+		}
+		return uCount;
+	}
+	template<std::size_t kCountT, typename CharT>
+	constexpr SegmentList<kCountT> ParseSegments(const CharT *pchFormat) noexcept {
+		SegmentList<kCountT> vList = { };
+		std::size_t uPos = 0;
+		std::size_t uNextArgIndex = 0;
+		for(std::size_t uIndex = 0; uIndex < kCountT; ++uIndex){
+			ParseSegment(vList.aSegments[uIndex], pchFormat, uPos, uNextArgIndex);
+		}
+		return vList;
+	}
+	template<std::size_t kCountT>
+	constexpr std::size_t GetArgCount(const SegmentList<kCountT> &vList) noexcept {
+		std::size_t uCount = 0;
+		for(std::size_t uIndex = 0; uIndex < kCountT; ++uIndex){
+			const auto &vSegment = vList.aSegments[uIndex];
+			if(vSegment.bField){
+				uCount = Max(uCount, vSegment.uArgIndex + 1);
+			}
+		}
+		return uCount;
+	}
+
+	template<typename FormatStringT>
+	struct CompiledFormat {
+		using Char = std::remove_const_t<std::remove_reference_t<decltype(FormatStringT::Get()[0])>>;
+
+		static constexpr std::size_t kSegmentCount = CountSegments(FormatStringT::Get());
+		static constexpr SegmentList<kSegmentCount> kSegments = ParseSegments<kSegmentCount>(FormatStringT::Get());
+		static constexpr std::size_t kArgCount = GetArgCount(kSegments);
+	};
+
+	// 以下函数把数字以 ASCII 字符写入 pchBuffer，返回写入的字符之后的位置。
+	extern char *WriteUnsigned(char *pchBuffer, std::uint64_t u64Value, char chType) noexcept;
+	extern char *WriteSigned(char *pchBuffer, std::int64_t n64Value, char chType) noexcept;
+	extern char *WriteFloat(char *pchBuffer, double fValue, int nPrecision, char chType) noexcept;
+	extern char *WritePointer(char *pchBuffer, const void *pValue) noexcept;
+
+	enum : std::size_t {
+		kNumberLengthMax = 64,
+	};
+
+	// 所有参数都先被转换为以下几种之一。
+	struct IntegerArg {
+		std::uint64_t u64Value;
+		bool bSigned;
+	};
+	struct FloatArg {
+		double fValue;
+	};
+	struct BoolArg {
+		bool bValue;
+	};
+	struct PointerArg {
+		const void *pValue;
+	};
+	template<typename CharT>
+	struct CharArg {
+		CharT chValue;
+	};
+	template<typename CharT>
+	struct StringArg {
+		const CharT *pchBegin;
+		std::size_t uLength;
+	};
+
+	template<typename CharT>
+	struct ArgNormalizer {
+		template<typename T, std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value && !std::is_same<T, CharT>::value, int> = 0>
+		static IntegerArg Normalize(T vValue) noexcept {
+			return IntegerArg{ static_cast<std::uint64_t>(vValue), std::is_signed<T>::value };
+		}
+		template<typename T, std::enable_if_t<std::is_enum<T>::value, int> = 0>
+		static IntegerArg Normalize(T vValue) noexcept {
+			return Normalize(static_cast<std::underlying_type_t<T>>(vValue));
+		}
+		template<typename T, std::enable_if_t<std::is_floating_point<T>::value, int> = 0>
+		static FloatArg Normalize(T vValue) noexcept {
+			return FloatArg{ static_cast<double>(vValue) };
+		}
+		static BoolArg Normalize(bool bValue) noexcept {
+			return BoolArg{ bValue };
+		}
+		static CharArg<CharT> Normalize(CharT chValue) noexcept {
+			return CharArg<CharT>{ chValue };
+		}
+		static StringArg<CharT> Normalize(CharT *pszValue) noexcept {
+			return Normalize(static_cast<const CharT *>(pszValue));
+		}
+		static StringArg<CharT> Normalize(const CharT *pszValue) noexcept {
+			auto pchEnd = pszValue;
+			while(*pchEnd != CharT()){
+				++pchEnd;
+			}
+			return StringArg<CharT>{ pszValue, static_cast<std::size_t>(pchEnd - pszValue) };
+		}
+		template<Impl_StringTraits::Type kTypeT, std::enable_if_t<std::is_same<typename StringView<kTypeT>::Char, CharT>::value, int> = 0>
+		static StringArg<CharT> Normalize(const StringView<kTypeT> &svValue) noexcept {
+			return StringArg<CharT>{ svValue.GetBegin(), svValue.GetSize() };
+		}
+		template<Impl_StringTraits::Type kTypeT, std::enable_if_t<std::is_same<typename String<kTypeT>::Char, CharT>::value, int> = 0>
+		static StringArg<CharT> Normalize(const String<kTypeT> &strValue) noexcept {
+			return StringArg<CharT>{ strValue.GetBegin(), strValue.GetSize() };
+		}
+		template<typename T>
+		static PointerArg Normalize(T *pValue) noexcept {
+			return PointerArg{ pValue };
+		}
+		static PointerArg Normalize(std::nullptr_t) noexcept {
+			return PointerArg{ nullptr };
+		}
+	};
+
+	// 检查格式说明是否适用于这种参数。
+	template<typename ArgT>
+	struct SpecChecker;
+
+	template<>
+	struct SpecChecker<IntegerArg> {
+		static constexpr bool IsValid(const Spec &vSpec) noexcept {
+			return ((vSpec.chType == 0) || (vSpec.chType == 'd') || (vSpec.chType == 'x') || (vSpec.chType == 'X')) && (vSpec.nPrecision < 0);
+		}
+	};
+	template<>
+	struct SpecChecker<FloatArg> {
+		static constexpr bool IsValid(const Spec &vSpec) noexcept {
+			return (vSpec.chType == 0) || (vSpec.chType == 'f') || (vSpec.chType == 'e');
+		}
+	};
+	template<>
+	struct SpecChecker<BoolArg> {
+		static constexpr bool IsValid(const Spec &vSpec) noexcept {
+			return ((vSpec.chType == 0) || (vSpec.chType == 's')) && (vSpec.nPrecision < 0);
+		}
+	};
+	template<>
+	struct SpecChecker<PointerArg> {
+		static constexpr bool IsValid(const Spec &vSpec) noexcept {
+			return ((vSpec.chType == 0) || (vSpec.chType == 'p')) && (vSpec.nPrecision < 0);
+		}
+	};
+	template<typename CharT>
+	struct SpecChecker<CharArg<CharT>> {
+		static constexpr bool IsValid(const Spec &vSpec) noexcept {
+			return ((vSpec.chType == 0) || (vSpec.chType == 'c') || (vSpec.chType == 'd')) && (vSpec.nPrecision < 0);
+		}
+	};
+	template<typename CharT>
+	struct SpecChecker<StringArg<CharT>> {
+		static constexpr bool IsValid(const Spec &vSpec) noexcept {
+			return ((vSpec.chType == 0) || (vSpec.chType == 's')) && (vSpec.nPrecision < 0);
+		}
+	};
+
+	// 返回写入的字符数的上限。
+	inline std::size_t EstimateArg(const Spec &vSpec, const IntegerArg &) noexcept {
+		return Max(vSpec.uWidth, kNumberLengthMax);
+	}
+	inline std::size_t EstimateArg(const Spec &vSpec, const FloatArg &) noexcept {
+		return Max(vSpec.uWidth, kNumberLengthMax);
+	}
+	inline std::size_t EstimateArg(const Spec &vSpec, const BoolArg &) noexcept {
+		return Max(vSpec.uWidth, static_cast<std::size_t>(5));
+	}
+	inline std::size_t EstimateArg(const Spec &vSpec, const PointerArg &) noexcept {
+		return Max(vSpec.uWidth, kNumberLengthMax);
+	}
+	template<typename CharT>
+	std::size_t EstimateArg(const Spec &vSpec, const CharArg<CharT> &) noexcept {
+		return Max(vSpec.uWidth, (vSpec.chType == 'd') ? static_cast<std::size_t>(kNumberLengthMax) : static_cast<std::size_t>(1));
+	}
+	template<typename CharT>
+	std::size_t EstimateArg(const Spec &vSpec, const StringArg<CharT> &vArg) noexcept {
+		return Max(vSpec.uWidth, vArg.uLength);
+	}
+
+	// 把已经写入的 [pchBegin, pchEnd) 按照宽度和对齐方式补齐。
+	template<typename CharT>
+	CharT *Pad(CharT *pchBegin, CharT *pchEnd, const Spec &vSpec, bool bNumeric) noexcept {
+		const auto uLength = static_cast<std::size_t>(pchEnd - pchBegin);
+		if(uLength >= vSpec.uWidth){
+			return pchEnd;
+		}
+		const auto uPadding = vSpec.uWidth - uLength;
+		const bool bLeft = (vSpec.chAlign == '<') || ((vSpec.chAlign == 0) && !bNumeric);
+		if(bLeft){
+			return FillN(pchEnd, uPadding, CharT(' '));
+		}
+		auto pchDigits = pchBegin;
+		if(bNumeric && vSpec.bZeroPad && (pchDigits != pchEnd) && ((*pchDigits == '-') || (*pchDigits == '+'))){
+			++pchDigits;
+		}
+		std::memmove(pchDigits + uPadding, pchDigits, static_cast<std::size_t>(pchEnd - pchDigits) * sizeof(CharT));
+		FillN(pchDigits, uPadding, CharT((bNumeric && vSpec.bZeroPad) ? '0' : ' '));
+		return pchEnd + uPadding;
+	}
+	template<typename CharT>
+	CharT *WriteAscii(CharT *pchWrite, const Spec &vSpec, const char *pchBegin, const char *pchEnd, bool bNumeric) noexcept {
+		const auto pchFieldBegin = pchWrite;
+		while(pchBegin != pchEnd){
+			*pchWrite = static_cast<CharT>(*pchBegin);
+			++pchWrite;
+			++pchBegin;
+		}
+		return Pad(pchFieldBegin, pchWrite, vSpec, bNumeric);
+	}
+
+	template<typename CharT>
+	CharT *WriteArg(CharT *pchWrite, const Spec &vSpec, const IntegerArg &vArg) noexcept {
+		char achTemp[kNumberLengthMax];
+		const auto pchEnd = vArg.bSigned ? WriteSigned(achTemp, static_cast<std::int64_t>(vArg.u64Value), vSpec.chType) : WriteUnsigned(achTemp, vArg.u64Value, vSpec.chType);
+		return WriteAscii(pchWrite, vSpec, achTemp, pchEnd, true);
+	}
+	template<typename CharT>
+	CharT *WriteArg(CharT *pchWrite, const Spec &vSpec, const FloatArg &vArg) noexcept {
+		char achTemp[kNumberLengthMax];
+		const auto pchEnd = WriteFloat(achTemp, vArg.fValue, vSpec.nPrecision, vSpec.chType);
+		return WriteAscii(pchWrite, vSpec, achTemp, pchEnd, true);
+	}
+	template<typename CharT>
+	CharT *WriteArg(CharT *pchWrite, const Spec &vSpec, const BoolArg &vArg) noexcept {
+		static constexpr char kTrue[] = "true", kFalse[] = "false";
+		if(vArg.bValue){
+			return WriteAscii(pchWrite, vSpec, kTrue, kTrue + 4, false);
+		} else {
+			return WriteAscii(pchWrite, vSpec, kFalse, kFalse + 5, false);
+		}
+	}
+	template<typename CharT>
+	CharT *WriteArg(CharT *pchWrite, const Spec &vSpec, const PointerArg &vArg) noexcept {
+		char achTemp[kNumberLengthMax];
+		const auto pchEnd = WritePointer(achTemp, vArg.pValue);
+		return WriteAscii(pchWrite, vSpec, achTemp, pchEnd, true);
+	}
+	template<typename CharT>
+	CharT *WriteArg(CharT *pchWrite, const Spec &vSpec, const CharArg<CharT> &vArg) noexcept {
+		if(vSpec.chType == 'd'){
+			return WriteArg(pchWrite, vSpec, IntegerArg{ static_cast<std::uint64_t>(vArg.chValue), std::is_signed<CharT>::value });
+		}
+		*pchWrite = vArg.chValue;
+		return Pad(pchWrite, pchWrite + 1, vSpec, false);
+	}
+	template<typename CharT>
+	CharT *WriteArg(CharT *pchWrite, const Spec &vSpec, const StringArg<CharT> &vArg) noexcept {
+		std::memcpy(pchWrite, vArg.pchBegin, vArg.uLength * sizeof(CharT));
+		return Pad(pchWrite, pchWrite + vArg.uLength, vSpec, false);
+	}
+
+	template<typename FormatStringT, std::size_t kIndexT, typename ArgTupleT>
+	constexpr bool IsSegmentValid() noexcept {
+		using Compiled = CompiledFormat<FormatStringT>;
+		constexpr Segment kSegment = Compiled::kSegments.aSegments[kIndexT];
+		if constexpr(kSegment.bField && (kSegment.uArgIndex < std::tuple_size<ArgTupleT>::value)){
+			return SpecChecker<std::tuple_element_t<kSegment.uArgIndex, ArgTupleT>>::IsValid(kSegment.vSpec);
+		} else {
+			return true;
+		}
+	}
+	template<typename FormatStringT, std::size_t kIndexT, typename ArgTupleT>
+	std::size_t EstimateSegment(const ArgTupleT &vArgs) noexcept {
+		using Compiled = CompiledFormat<FormatStringT>;
+		constexpr Segment kSegment = Compiled::kSegments.aSegments[kIndexT];
+		if constexpr(kSegment.bField){
+			return EstimateArg(kSegment.vSpec, std::get<kSegment.uArgIndex>(vArgs));
+		} else {
+			return kSegment.uLength;
+		}
+	}
+	template<typename FormatStringT, std::size_t kIndexT, typename CharT, typename ArgTupleT>
+	CharT *WriteSegment(CharT *pchWrite, const ArgTupleT &vArgs) noexcept {
+		using Compiled = CompiledFormat<FormatStringT>;
+		constexpr Segment kSegment = Compiled::kSegments.aSegments[kIndexT];
+		if constexpr(kSegment.bField){
+			return WriteArg(pchWrite, kSegment.vSpec, std::get<kSegment.uArgIndex>(vArgs));
+		} else {
+			// 字面量的长度是编译期常量，memcpy 会被展开。
+			std::memcpy(pchWrite, FormatStringT::Get() + kSegment.uBegin, kSegment.uLength * sizeof(CharT));
+			return pchWrite + kSegment.uLength;
+		}
+	}
+
+	template<typename FormatStringT, typename ArgTupleT, std::size_t ...kIndicesT>
+	constexpr bool AreAllSegmentsValid(std::index_sequence<kIndicesT...>) noexcept {
+		return (true && ... && IsSegmentValid<FormatStringT, kIndicesT, ArgTupleT>());
+	}
+	template<typename FormatStringT, typename ArgTupleT, std::size_t ...kIndicesT>
+	std::size_t EstimateAll(const ArgTupleT &vArgs, std::index_sequence<kIndicesT...>) noexcept {
+		return (std::size_t(0) + ... + EstimateSegment<FormatStringT, kIndicesT>(vArgs));
+	}
+	template<typename FormatStringT, typename CharT, typename ArgTupleT, std::size_t ...kIndicesT>
+	CharT *WriteAll(CharT *pchWrite, const ArgTupleT &vArgs, std::index_sequence<kIndicesT...>) noexcept {
+		((pchWrite = WriteSegment<FormatStringT, kIndicesT>(pchWrite, vArgs)), ...);
+		return pchWrite;
+	}
+
+	// 返回写入的字符之后的位置。pchWrite 处至少要有 Estimate() 返回的空间。
+	template<typename FormatStringT, typename ...ArgsT>
+	struct Formatter {
+		using Compiled = CompiledFormat<FormatStringT>;
+		using Char = typename Compiled::Char;
+		using ArgTuple = std::tuple<decltype(ArgNormalizer<Char>::Normalize(std::declval<const ArgsT &>()))...>;
+
+		static_assert(Compiled::kArgCount <= sizeof...(ArgsT), "Too few arguments for this format string.");
+		static_assert(AreAllSegmentsValid<FormatStringT, ArgTuple>(std::make_index_sequence<Compiled::kSegmentCount>()), "A format specification does not apply to its argument.");
+
+		ArgTuple vArgs;
+
+		explicit Formatter(const ArgsT &...vArgs_) noexcept
+			: vArgs(ArgNormalizer<Char>::Normalize(vArgs_)...)
+		{ }
+
+		std::size_t Estimate() const noexcept {
+			return EstimateAll<FormatStringT>(vArgs, std::make_index_sequence<Compiled::kSegmentCount>());
+		}
+		Char *Write(Char *pchWrite) const noexcept {
+			return WriteAll<FormatStringT>(pchWrite, vArgs, std::make_index_sequence<Compiled::kSegmentCount>());
+		}
+	};
+}
+
+// 格式化参数，然后追加到 strDst 的末尾。格式字符串的字符类型必须和 strDst 的一致。
+// 格式字符串在编译期被解析，运行时只计算一次长度的上限，然后直接写入 strDst 的缓冲区。
+template<Impl_StringTraits::Type kTypeT, typename FormatStringT, typename ...ArgsT>
+String<kTypeT> &Format(String<kTypeT> &strDst, FormatStringT, const ArgsT &...vArgs){
+	using Formatter = Impl_Format::Formatter<FormatStringT, ArgsT...>;
+	static_assert(std::is_same<typename Formatter::Char, typename String<kTypeT>::Char>::value, "The format string has a different character type from the destination string.");
+
+	const Formatter vFormatter(vArgs...);
+	const auto uEstimated = vFormatter.Estimate();
+	const auto pchBegin = strDst.ResizeMore(uEstimated);
+	const auto pchEnd = vFormatter.Write(pchBegin);
+	strDst.Pop(uEstimated - static_cast<std::size_t>(pchEnd - pchBegin));
+	return strDst;
+}
+// 格式化参数，然后追加到 sbufDst 的末尾。格式字符串必须是窄字符串。
+template<typename FormatStringT, typename ...ArgsT>
+StreamBuffer &Format(StreamBuffer &sbufDst, FormatStringT, const ArgsT &...vArgs){
+	using Formatter = Impl_Format::Formatter<FormatStringT, ArgsT...>;
+	static_assert(std::is_same<typename Formatter::Char, char>::value, "Only narrow format strings can be written into a StreamBuffer.");
+
+	const Formatter vFormatter(vArgs...);
+	const auto uEstimated = vFormatter.Estimate();
+	char achStack[1024];
+	if(uEstimated <= sizeof(achStack)){
+		const auto pchEnd = vFormatter.Write(achStack);
+		sbufDst.Put(achStack, static_cast<std::size_t>(pchEnd - achStack));
+	} else {
+		NarrowString strTemp;
+		const auto pchBegin = strTemp.ResizeMore(uEstimated);
+		const auto pchEnd = vFormatter.Write(pchBegin);
+		sbufDst.Put(pchBegin, static_cast<std::size_t>(pchEnd - pchBegin));
+	}
+	return sbufDst;
+}
+
+}
+
+#endif
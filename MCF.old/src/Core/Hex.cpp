@@ -0,0 +1,203 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "Hex.hpp"
+#include <MCFCRT/env/cpu.h>
+#include <immintrin.h>
+
+namespace MCF {
+
+namespace {
+	alignas(16) constexpr char kLowerDigits[16] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' };
+	alignas(16) constexpr char kUpperDigits[16] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
+
+	// 解码表中，小于 16 的值是十六进制数字。
+	enum : unsigned char {
+		kCharWhitespace = 0x41,
+		kCharInvalid    = 0xFF,
+	};
+
+	struct DecodingTable {
+		unsigned char abyValues[256];
+	};
+
+	constexpr DecodingTable MakeDecodingTable() noexcept {
+		DecodingTable vTable = { };
+		for(unsigned uChar = 0; uChar < 256; ++uChar){
+			vTable.abyValues[uChar] = kCharInvalid;
+		}
+		for(unsigned uValue = 0; uValue < 16; ++uValue){
+			vTable.abyValues[static_cast<unsigned char>(kLowerDigits[uValue])] = static_cast<unsigned char>(uValue);
+			vTable.abyValues[static_cast<unsigned char>(kUpperDigits[uValue])] = static_cast<unsigned char>(uValue);
+		}
+		vTable.abyValues[static_cast<unsigned char>(' ')]  = kCharWhitespace;
+		vTable.abyValues[static_cast<unsigned char>('\t')] = kCharWhitespace;
+		vTable.abyValues[static_cast<unsigned char>('\r')] = kCharWhitespace;
+		vTable.abyValues[static_cast<unsigned char>('\n')] = kCharWhitespace;
+		return vTable;
+	}
+
+	constexpr DecodingTable kDecodingTable = MakeDecodingTable();
+
+	// 把 16 个字符转换为半字节。如果有字符不是十六进制数字则返回 false。
+	// '0' 到 '9' 减去 '0' 之后不大于 9；字母转换为小写之后减去 'a' 不大于 5。
+	inline bool CharsToNibbles(__m128i &xmmNibbles, __m128i xmmChars) noexcept {
+		const auto xmmDigits = _mm_sub_epi8(xmmChars, _mm_set1_epi8('0'));
+		const auto xmmIsDigit = _mm_cmpeq_epi8(_mm_min_epu8(xmmDigits, _mm_set1_epi8(9)), xmmDigits);
+		const auto xmmLetters = _mm_sub_epi8(_mm_or_si128(xmmChars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+		const auto xmmIsLetter = _mm_cmpeq_epi8(_mm_min_epu8(xmmLetters, _mm_set1_epi8(5)), xmmLetters);
+		if(_mm_movemask_epi8(_mm_or_si128(xmmIsDigit, xmmIsLetter)) != 0xFFFF){
+			return false;
+		}
+		xmmNibbles = _mm_or_si128(_mm_and_si128(xmmIsDigit, xmmDigits), _mm_and_si128(xmmIsLetter, _mm_add_epi8(xmmLetters, _mm_set1_epi8(10))));
+		return true;
+	}
+
+	__attribute__((__target__("avx2")))
+	void EncodeBlocksAvx2(char *&pchWrite, const unsigned char *&pbyRead, const unsigned char *pbyEnd, const char *pchDigits) noexcept {
+		const auto ymmDigits = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(pchDigits)));
+		while(pbyEnd - pbyRead >= 32){
+			const auto ymmBytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pbyRead));
+			const auto ymmHigh = _mm256_shuffle_epi8(ymmDigits, _mm256_and_si256(_mm256_srli_epi16(ymmBytes, 4), _mm256_set1_epi8(0x0F)));
+			const auto ymmLow = _mm256_shuffle_epi8(ymmDigits, _mm256_and_si256(ymmBytes, _mm256_set1_epi8(0x0F)));
+			// 交错是在每个 128 位的通道内进行的，需要把结果重新排列。
+			const auto ymmT0 = _mm256_unpacklo_epi8(ymmHigh, ymmLow);
+			const auto ymmT1 = _mm256_unpackhi_epi8(ymmHigh, ymmLow);
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(pchWrite) + 0, _mm256_permute2x128_si256(ymmT0, ymmT1, 0x20));
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(pchWrite) + 1, _mm256_permute2x128_si256(ymmT0, ymmT1, 0x31));
+			pbyRead += 32;
+			pchWrite += 64;
+		}
+	}
+	__attribute__((__target__("avx2")))
+	void DecodeBlocksAvx2(unsigned char *&pbyWrite, const char *&pchRead, const char *pchEnd) noexcept {
+		while(pchEnd - pchRead >= 64){
+			__m256i aymmNibbles[2];
+			bool bValid = true;
+			for(unsigned uIndex = 0; uIndex < 2; ++uIndex){
+				const auto ymmChars = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pchRead) + uIndex);
+				const auto ymmDigits = _mm256_sub_epi8(ymmChars, _mm256_set1_epi8('0'));
+				const auto ymmIsDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(ymmDigits, _mm256_set1_epi8(9)), ymmDigits);
+				const auto ymmLetters = _mm256_sub_epi8(_mm256_or_si256(ymmChars, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+				const auto ymmIsLetter = _mm256_cmpeq_epi8(_mm256_min_epu8(ymmLetters, _mm256_set1_epi8(5)), ymmLetters);
+				bValid &= _mm256_movemask_epi8(_mm256_or_si256(ymmIsDigit, ymmIsLetter)) == -1;
+				aymmNibbles[uIndex] = _mm256_or_si256(_mm256_and_si256(ymmIsDigit, ymmDigits), _mm256_and_si256(ymmIsLetter, _mm256_add_epi8(ymmLetters, _mm256_set1_epi8(10))));
+			}
+			if(!bValid){
+				break;
+			}
+			const auto ymmWords0 = _mm256_maddubs_epi16(aymmNibbles[0], _mm256_set1_epi16(0x0110));
+			const auto ymmWords1 = _mm256_maddubs_epi16(aymmNibbles[1], _mm256_set1_epi16(0x0110));
+			// 压缩是在每个 128 位的通道内进行的，需要把结果重新排列。
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(pbyWrite), _mm256_permute4x64_epi64(_mm256_packus_epi16(ymmWords0, ymmWords1), 0xD8));
+			pchRead += 64;
+			pbyWrite += 32;
+		}
+	}
+
+	// 解码尽可能多的完整的块，遇到不是十六进制数字的字符时停下，剩下的部分由调用者逐个字符处理。
+	void DecodeBlocks(unsigned char *&pbyWrite, const char *&pchRead, const char *pchEnd) noexcept {
+		if(_MCFCRT_CpuHasFeature(_MCFCRT_kCpuFeatureAvx2)){
+			DecodeBlocksAvx2(pbyWrite, pchRead, pchEnd);
+		}
+		while(pchEnd - pchRead >= 32){
+			__m128i xmmNibbles0, xmmNibbles1;
+			if(!CharsToNibbles(xmmNibbles0, _mm_loadu_si128(reinterpret_cast<const __m128i *>(pchRead) + 0))){
+				break;
+			}
+			if(!CharsToNibbles(xmmNibbles1, _mm_loadu_si128(reinterpret_cast<const __m128i *>(pchRead) + 1))){
+				break;
+			}
+			const auto xmmWords0 = _mm_maddubs_epi16(xmmNibbles0, _mm_set1_epi16(0x0110));
+			const auto xmmWords1 = _mm_maddubs_epi16(xmmNibbles1, _mm_set1_epi16(0x0110));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pbyWrite), _mm_packus_epi16(xmmWords0, xmmWords1));
+			pchRead += 32;
+			pbyWrite += 16;
+		}
+	}
+}
+
+std::size_t HexEncoder::Encode(char *pchOut, const void *pData, std::size_t uSize, bool bUpperCase) noexcept {
+	const auto pchDigits = bUpperCase ? kUpperDigits : kLowerDigits;
+	auto pchWrite = pchOut;
+	auto pbyRead = static_cast<const unsigned char *>(pData);
+	const auto pbyEnd = pbyRead + uSize;
+	if(_MCFCRT_CpuHasFeature(_MCFCRT_kCpuFeatureAvx2)){
+		EncodeBlocksAvx2(pchWrite, pbyRead, pbyEnd, pchDigits);
+	}
+	const auto xmmDigits = _mm_load_si128(reinterpret_cast<const __m128i *>(pchDigits));
+	while(pbyEnd - pbyRead >= 16){
+		const auto xmmBytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pbyRead));
+		const auto xmmHigh = _mm_shuffle_epi8(xmmDigits, _mm_and_si128(_mm_srli_epi16(xmmBytes, 4), _mm_set1_epi8(0x0F)));
+		const auto xmmLow = _mm_shuffle_epi8(xmmDigits, _mm_and_si128(xmmBytes, _mm_set1_epi8(0x0F)));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(pchWrite) + 0, _mm_unpacklo_epi8(xmmHigh, xmmLow));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(pchWrite) + 1, _mm_unpackhi_epi8(xmmHigh, xmmLow));
+		pbyRead += 16;
+		pchWrite += 32;
+	}
+	while(pbyRead != pbyEnd){
+		const unsigned uByte = *pbyRead;
+		pchWrite[0] = pchDigits[uByte >> 4];
+		pchWrite[1] = pchDigits[uByte & 0x0F];
+		++pbyRead;
+		pchWrite += 2;
+	}
+	return static_cast<std::size_t>(pchWrite - pchOut);
+}
+
+std::size_t HexDecoder::Update(void *pOut, const char *pchIn, std::size_t uSize) noexcept {
+	const bool bStrict = x_eMode == kModeStrict;
+	auto pbyWrite = static_cast<unsigned char *>(pOut);
+	auto pchRead = pchIn;
+	const auto pchEnd = pchIn + uSize;
+	while(pchRead != pchEnd){
+		if(!x_bHasHighNibble){
+			DecodeBlocks(pbyWrite, pchRead, pchEnd);
+			if(pchRead == pchEnd){
+				break;
+			}
+		}
+		// 逐个处理字符，直到可以重新开始按块解码。
+		do {
+			const unsigned uValue = kDecodingTable.abyValues[static_cast<unsigned char>(*pchRead)];
+			++pchRead;
+			if(uValue < 16){
+				if(x_bHasHighNibble){
+					*pbyWrite = static_cast<unsigned char>((x_uHighNibble << 4) | uValue);
+					++pbyWrite;
+					x_bHasHighNibble = false;
+				} else {
+					x_uHighNibble = uValue;
+					x_bHasHighNibble = true;
+				}
+			} else if((uValue == kCharWhitespace) && !bStrict){
+				// 忽略空白字符。
+			} else {
+				return SIZE_MAX;
+			}
+		} while((pchRead != pchEnd) && (x_bHasHighNibble || (kDecodingTable.abyValues[static_cast<unsigned char>(*pchRead)] >= 16)));
+	}
+	return static_cast<std::size_t>(pbyWrite - static_cast<unsigned char *>(pOut));
+}
+bool HexDecoder::Finalize() noexcept {
+	if(x_bHasHighNibble){
+		return false;
+	}
+	Reset();
+	return true;
+}
+
+std::size_t HexDecoder::Decode(void *pOut, const char *pchIn, std::size_t uSize, Mode eMode) noexcept {
+	HexDecoder vDecoder(eMode);
+	const auto uBytesWritten = vDecoder.Update(pOut, pchIn, uSize);
+	if(uBytesWritten == SIZE_MAX){
+		return SIZE_MAX;
+	}
+	if(!vDecoder.Finalize()){
+		return SIZE_MAX;
+	}
+	return uBytesWritten;
+}
+
+}
@@ -0,0 +1,89 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_CORE_HEX_HPP_
+#define MCF_CORE_HEX_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace MCF {
+
+// 每个字节被编码为两个十六进制数字，高半字节在前。
+
+class HexEncoder {
+private:
+	bool x_bUpperCase;
+
+public:
+	explicit HexEncoder(bool bUpperCase = false) noexcept
+		: x_bUpperCase(bUpperCase)
+	{ }
+
+public:
+	static constexpr std::size_t GetEncodedSize(std::size_t uSize) noexcept {
+		return uSize * 2;
+	}
+
+	bool IsUpperCase() const noexcept {
+		return x_bUpperCase;
+	}
+
+	// 返回写入的字符数，总是 uSize * 2。
+	std::size_t Update(char *pchOut, const void *pData, std::size_t uSize) const noexcept {
+		return Encode(pchOut, pData, uSize, x_bUpperCase);
+	}
+
+	// 一次性编码。
+	static std::size_t Encode(char *pchOut, const void *pData, std::size_t uSize, bool bUpperCase = false) noexcept;
+};
+
+class HexDecoder {
+public:
+	enum Mode : unsigned {
+		// 只接受十六进制数字，数字的个数必须是偶数。
+		kModeStrict  = 0,
+		// 忽略空白字符。两个数字之间也可以有空白字符。
+		kModeLenient = 1,
+	};
+
+private:
+	Mode x_eMode;
+	unsigned x_uHighNibble;
+	bool x_bHasHighNibble;
+
+public:
+	explicit HexDecoder(Mode eMode = kModeStrict) noexcept
+		: x_eMode(eMode)
+	{
+		Reset();
+	}
+
+public:
+	// 解码 uSize 个字符最多输出的字节数。
+	static constexpr std::size_t GetMaxDecodedSize(std::size_t uSize) noexcept {
+		return (uSize + 1) / 2;
+	}
+
+	Mode GetMode() const noexcept {
+		return x_eMode;
+	}
+
+	void Reset() noexcept {
+		x_uHighNibble = 0;
+		x_bHasHighNibble = false;
+	}
+	// 返回写入的字节数。pOut 至少要能容纳 GetMaxDecodedSize(uSize) 个字节。
+	// 如果数据无效则返回 SIZE_MAX，此时必须调用 Reset() 才能继续使用。
+	std::size_t Update(void *pOut, const char *pchIn, std::size_t uSize) noexcept;
+	// 检查是否有落单的数字。如果数据完整则返回 true 并且可以开始解码新的数据。
+	bool Finalize() noexcept;
+
+	// 一次性解码。返回写入的字节数，如果数据无效则返回 SIZE_MAX。
+	static std::size_t Decode(void *pOut, const char *pchIn, std::size_t uSize, Mode eMode = kModeStrict) noexcept;
+};
+
+}
+
+#endif
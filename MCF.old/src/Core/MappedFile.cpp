@@ -0,0 +1,84 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "MappedFile.hpp"
+#include "MinMax.hpp"
+
+namespace MCF {
+
+std::size_t MappedFile::X_GetWindowSize() const noexcept {
+	if(sizeof(void *) >= 8){
+		// 地址空间足够大，整个文件只需要映射一次。
+		return SIZE_MAX;
+	}
+	switch(x_eHint){
+	case kSequential:
+		return 0x4000000; // 64 MiB
+	case kRandom:
+		return 0x400000;  // 4 MiB
+	default:
+		return 0x1000000; // 16 MiB
+	}
+}
+bool MappedFile::X_Covers(std::uint64_t u64Offset, std::size_t uSize) const noexcept {
+	if(!x_vWindow){
+		return false;
+	}
+	if(X_GetWindowSize() == SIZE_MAX){
+		// 整个文件已经被映射，调用者保证了 u64Offset 在文件末尾之前。
+		return true;
+	}
+	const auto u64WindowBegin = x_vWindow.GetOffset();
+	return (u64Offset >= u64WindowBegin) && (u64Offset - u64WindowBegin <= x_vWindow.GetSize()) && (x_vWindow.GetSize() - (u64Offset - u64WindowBegin) >= uSize);
+}
+void MappedFile::X_MoveWindow(std::uint64_t u64Offset, std::size_t uSize){
+	const auto uWindowSize = X_GetWindowSize();
+	// 窗口的起点按分配粒度对齐，这样相邻的访问更可能落在同一个窗口中。整个文件被映射时窗口从文件开头开始。
+	const auto u64WindowBegin = (uWindowSize == SIZE_MAX) ? 0 : (u64Offset & ~static_cast<std::uint64_t>(FileMapping::kAllocationGranularity - 1));
+	const auto uPadding = static_cast<std::size_t>(u64Offset - u64WindowBegin);
+	// MapView() 会把大小截断到文件末尾。
+	const auto uWindowSizeWanted = Max(uWindowSize, (uSize <= SIZE_MAX - uPadding) ? (uPadding + uSize) : SIZE_MAX);
+	x_vWindow.Unmap();
+	x_vWindow = x_vMapping.MapView(u64WindowBegin, uWindowSizeWanted);
+	if(x_eHint == kSequential){
+		x_vWindow.Prefetch(uPadding, kSequentialPrefetchSize);
+	}
+}
+
+void MappedFile::Prefetch(std::uint64_t u64Offset, std::size_t uSize) const noexcept {
+	const auto u64WindowBegin = x_vWindow.GetOffset();
+	if(!x_vWindow || (u64Offset < u64WindowBegin) || (u64Offset - u64WindowBegin >= x_vWindow.GetSize())){
+		return;
+	}
+	x_vWindow.Prefetch(static_cast<std::size_t>(u64Offset - u64WindowBegin), uSize);
+}
+
+void *MappedFile::Map(std::uint64_t u64Offset, std::size_t *puSize){
+	const auto u64FileSize = x_vMapping.GetSize();
+	if(u64Offset >= u64FileSize){
+		*puSize = 0;
+		return nullptr;
+	}
+	const auto uSize = static_cast<std::size_t>(Min(*puSize, u64FileSize - u64Offset));
+	if(!X_Covers(u64Offset, uSize)){
+		X_MoveWindow(u64Offset, uSize);
+	}
+	*puSize = uSize;
+	return static_cast<unsigned char *>(x_vWindow.GetData()) + (u64Offset - x_vWindow.GetOffset());
+}
+void *MappedFile::MapAvailable(std::uint64_t u64Offset, std::size_t *puSize){
+	const auto u64FileSize = x_vMapping.GetSize();
+	if(u64Offset >= u64FileSize){
+		*puSize = 0;
+		return nullptr;
+	}
+	if(!X_Covers(u64Offset, 1)){
+		X_MoveWindow(u64Offset, 1);
+	}
+	const auto uDelta = static_cast<std::size_t>(u64Offset - x_vWindow.GetOffset());
+	*puSize = x_vWindow.GetSize() - uDelta;
+	return static_cast<unsigned char *>(x_vWindow.GetData()) + uDelta;
+}
+
+}
@@ -0,0 +1,88 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_CORE_MAPPED_FILE_HPP_
+#define MCF_CORE_MAPPED_FILE_HPP_
+
+#include "FileMapping.hpp"
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace MCF {
+
+// 通过一个滑动的视图窗口访问任意大小的文件，在 32 位平台上也可以访问超过地址空间大小的文件。
+// 在 64 位平台上整个文件被一次性映射，窗口不会移动。
+class MappedFile {
+public:
+	enum AccessHint : unsigned {
+		kNormal     = 0,
+		kSequential = 1, // 窗口较大，移动窗口时预读后面的内容。
+		kRandom     = 2, // 窗口较小，不预读。
+	};
+
+	enum : std::size_t {
+		kSequentialPrefetchSize = 0x400000,
+	};
+
+private:
+	FileMapping x_vMapping;
+	AccessHint x_eHint = kNormal;
+	FileMapping::View x_vWindow;
+
+private:
+	std::size_t X_GetWindowSize() const noexcept;
+	bool X_Covers(std::uint64_t u64Offset, std::size_t uSize) const noexcept;
+	void X_MoveWindow(std::uint64_t u64Offset, std::size_t uSize);
+
+public:
+	constexpr MappedFile() noexcept { }
+	explicit MappedFile(FileMapping vMapping, AccessHint eHint = kNormal) noexcept
+		: x_vMapping(std::move(vMapping)), x_eHint(eHint)
+	{ }
+	MappedFile(const File &vFile, FileMapping::Access eAccess, AccessHint eHint = kNormal)
+		: x_vMapping(vFile, eAccess), x_eHint(eHint)
+	{ }
+
+public:
+	const FileMapping &GetMapping() const noexcept {
+		return x_vMapping;
+	}
+	std::uint64_t GetSize() const noexcept {
+		return x_vMapping.GetSize();
+	}
+	AccessHint GetAccessHint() const noexcept {
+		return x_eHint;
+	}
+	void SetAccessHint(AccessHint eHint) noexcept {
+		x_eHint = eHint;
+	}
+
+	// 返回一段连续的内存，其中包含文件中 [u64Offset, u64Offset + *puSize) 的内容。
+	// 如果这段内容超出文件末尾，*puSize 会被截断。返回的指针在下一次调用 Map() 之前有效。
+	void *Map(std::uint64_t u64Offset, std::size_t *puSize);
+	// 同上，但是返回窗口中从 u64Offset 开始的所有内容，不需要移动窗口时不会截断到特定大小。
+	void *MapAvailable(std::uint64_t u64Offset, std::size_t *puSize);
+	// 预读当前窗口中的一部分，窗口之外的部分被忽略。
+	void Prefetch(std::uint64_t u64Offset, std::size_t uSize) const noexcept;
+	void Unmap() noexcept {
+		x_vWindow.Unmap();
+	}
+
+	void Swap(MappedFile &vOther) noexcept {
+		using std::swap;
+		swap(x_vMapping, vOther.x_vMapping);
+		swap(x_eHint,    vOther.x_eHint);
+		swap(x_vWindow,  vOther.x_vWindow);
+	}
+
+public:
+	friend void swap(MappedFile &vSelf, MappedFile &vOther) noexcept {
+		vSelf.Swap(vOther);
+	}
+};
+
+}
+
+#endif
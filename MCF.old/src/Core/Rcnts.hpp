@@ -6,6 +6,7 @@
 #define MCF_CORE_RCNTS_HPP_
 
 #include "_CheckedSizeArithmetic.hpp"
+#include "_Xxh3.hpp"
 #include "Atomic.hpp"
 #include "ConstructDestruct.hpp"
 #include <cstring>
@@ -14,11 +15,24 @@
 
 namespace MCF {
 
+template<typename CharT>
+class RcntsPool;
+
 template<typename CharT>
 class Rcnts {
+	template<typename>
+	friend class RcntsPool;
+
 public:
 	using Char = CharT;
 
+private:
+	struct X_Header {
+		Atomic<std::size_t> uRef;
+		std::size_t uHash;   // 仅对于被驻留的字符串有效。
+		std::size_t uPoolId; // 被驻留的字符串所在的池，零表示没有被驻留。
+	};
+
 private:
 	static const CharT *X_GetNullTerminator() noexcept {
 		static constexpr CharT kNull[1] = { };
@@ -37,6 +51,9 @@ private:
 		}
 	}
 	static int X_Compare(const Char *pszSelf, const Char *pszOther) noexcept {
+		if(pszSelf == pszOther){
+			return 0;
+		}
 		std::size_t uIndex = 0;
 		for(;;){
 			const auto chSelf = pszSelf[uIndex];
@@ -52,40 +69,66 @@ private:
 			++uIndex;
 		}
 	}
+	static std::size_t X_Hash(const Char *pchBegin, std::size_t uLength) noexcept {
+		// XXH3 的结果的每一位都是均匀的，截断到 32 位也没有问题。
+		return static_cast<std::size_t>(Impl_Xxh3::Xxh3::Hash64(pchBegin, sizeof(Char) * uLength));
+	}
+	static Rcnts X_Allocate(const Char *pchBegin, std::size_t uLength, std::size_t uHash, std::size_t uPoolId){
+		const auto uSizeToCopy = Impl_CheckedSizeArithmetic::Mul(sizeof(Char), uLength);
+		const auto uSizeToAlloc = Impl_CheckedSizeArithmetic::Add(sizeof(X_Header) + sizeof(Char), uSizeToCopy);
+		const auto pHeader = static_cast<X_Header *>(::operator new[](uSizeToAlloc));
+		Construct(&(pHeader->uRef), 1u);
+		pHeader->uHash = uHash;
+		pHeader->uPoolId = uPoolId;
+		const auto pszStr = static_cast<Char *>(std::memcpy(static_cast<void *>(pHeader + 1), pchBegin, uSizeToCopy));
+		pszStr[uLength] = Char();
+		return Rcnts(1, pHeader, pszStr);
+	}
 
 public:
 	static Rcnts Copy(const Char *pszBegin){
 		return Copy(pszBegin, X_Define(pszBegin));
 	}
 	static Rcnts Copy(const Char *pchBegin, std::size_t uLength){
-		const auto uSizeToCopy = Impl_CheckedSizeArithmetic::Mul(sizeof(Char), uLength);
-		const auto uSizeToAlloc = sizeof(Atomic<std::size_t>) + uSizeToCopy + sizeof(Char);
-		const auto puRef = static_cast<Atomic<std::size_t> *>(::operator new[](uSizeToAlloc));
-		Construct(puRef, 1u);
-		const auto pszStr = static_cast<Char *>(std::memcpy(puRef + 1, pchBegin, uSizeToCopy));
-		pszStr[uLength] = Char();
-		return Rcnts(1, puRef, pszStr);
+		return X_Allocate(pchBegin, uLength, 0, 0);
 	}
 	static Rcnts View(const Char *pszBegin) noexcept {
 		return Rcnts(1, nullptr, pszBegin);
 	}
 
 private:
-	Atomic<std::size_t> *x_puRef;
+	X_Header *x_pHeader;
 	const Char *x_pszStr;
 
 private:
-	Atomic<std::size_t> *X_Fork() const noexcept {
-		const auto puRef = x_puRef;
-		if(puRef){
-			puRef->Increment(kAtomicRelaxed);
+	X_Header *X_Fork() const noexcept {
+		const auto pHeader = x_pHeader;
+		if(pHeader){
+			pHeader->uRef.Increment(kAtomicRelaxed);
+		}
+		return pHeader;
+	}
+	bool X_Equals(const Rcnts &vOther) const noexcept {
+		if(x_pszStr == vOther.x_pszStr){
+			return true;
+		}
+		const auto pHeader = x_pHeader;
+		const auto pOtherHeader = vOther.x_pHeader;
+		if(pHeader && pOtherHeader && (pHeader->uPoolId != 0) && (pOtherHeader->uPoolId != 0)){
+			// 同一个池中的相等的字符串只有一个副本。
+			if(pHeader->uPoolId == pOtherHeader->uPoolId){
+				return false;
+			}
+			if(pHeader->uHash != pOtherHeader->uHash){
+				return false;
+			}
 		}
-		return puRef;
+		return X_Compare(x_pszStr, vOther.x_pszStr) == 0;
 	}
 
 private:
-	constexpr Rcnts(int, Atomic<std::size_t> *puRef, const Char *pszStr) noexcept
-		: x_puRef(puRef), x_pszStr(pszStr)
+	constexpr Rcnts(int, X_Header *pHeader, const Char *pszStr) noexcept
+		: x_pHeader(pHeader), x_pszStr(pszStr)
 	{ }
 
 public:
@@ -96,7 +139,7 @@ public:
 		: Rcnts(1, vOther.X_Fork(), vOther.x_pszStr)
 	{ }
 	Rcnts(Rcnts &&vOther) noexcept
-		: Rcnts(1, std::exchange(vOther.x_puRef, nullptr), std::exchange(vOther.x_pszStr, X_GetNullTerminator()))
+		: Rcnts(1, std::exchange(vOther.x_pHeader, nullptr), std::exchange(vOther.x_pszStr, X_GetNullTerminator()))
 	{ }
 	Rcnts &operator=(const Rcnts &vOther) noexcept {
 		Rcnts(vOther).Swap(*this);
@@ -107,15 +150,15 @@ public:
 		return *this;
 	}
 	~Rcnts(){
-		const auto puRef = x_puRef;
+		const auto pHeader = x_pHeader;
 #ifndef NDEBUG
-		__builtin_memset(&x_puRef,  0xAA, sizeof(x_puRef));
-		__builtin_memset(&x_pszStr, 0xBB, sizeof(x_pszStr));
+		__builtin_memset(&x_pHeader, 0xAA, sizeof(x_pHeader));
+		__builtin_memset(&x_pszStr,  0xBB, sizeof(x_pszStr));
 #endif
-		if(puRef){
-			if(puRef->Decrement(kAtomicRelaxed) == 0){
-				Destruct(puRef);
-				::operator delete[](puRef);
+		if(pHeader){
+			if(pHeader->uRef.Decrement(kAtomicRelaxed) == 0){
+				Destruct(&(pHeader->uRef));
+				::operator delete[](pHeader);
 			}
 		}
 	}
@@ -130,6 +173,18 @@ public:
 	void Clear() noexcept {
 		Rcnts().Swap(*this);
 	}
+	// 被驻留的字符串可以通过指针比较判断是否相等。参见 RcntsPool。
+	bool IsInterned() const noexcept {
+		const auto pHeader = x_pHeader;
+		return pHeader && (pHeader->uPoolId != 0);
+	}
+	std::size_t GetHash() const noexcept {
+		const auto pHeader = x_pHeader;
+		if(pHeader && (pHeader->uPoolId != 0)){
+			return pHeader->uHash;
+		}
+		return X_Hash(x_pszStr, X_Define(x_pszStr));
+	}
 
 	Rcnts &AssignCopy(const Char *pszBegin){
 		Copy(pszBegin).Swap(*this);
@@ -153,8 +208,8 @@ public:
 
 	void Swap(Rcnts &vOther) noexcept {
 		using std::swap;
-		swap(x_puRef,  vOther.x_puRef);
-		swap(x_pszStr, vOther.x_pszStr);
+		swap(x_pHeader, vOther.x_pHeader);
+		swap(x_pszStr,  vOther.x_pszStr);
 	}
 
 public:
@@ -166,7 +221,7 @@ public:
 	}
 
 	bool operator==(const Rcnts &vOther) const noexcept {
-		return X_Compare(GetStr(), vOther.GetStr()) == 0;
+		return X_Equals(vOther);
 	}
 	bool operator==(const Char *vOther) const noexcept {
 		return X_Compare(GetStr(), vOther) == 0;
@@ -176,7 +231,7 @@ public:
 	}
 
 	bool operator!=(const Rcnts &vOther) const noexcept {
-		return X_Compare(GetStr(), vOther.GetStr()) != 0;
+		return !X_Equals(vOther);
 	}
 	bool operator!=(const Char *vOther) const noexcept {
 		return X_Compare(GetStr(), vOther) != 0;
@@ -0,0 +1,484 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_CORE_ROPE_HPP_
+#define MCF_CORE_ROPE_HPP_
+
+#include "String.hpp"
+#include "StringView.hpp"
+#include "_CheckedSizeArithmetic.hpp"
+#include "Assert.hpp"
+#include "MinMax.hpp"
+#include "CopyMoveFill.hpp"
+#include <utility>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+namespace MCF {
+
+// 用于构造很长的字符串。
+// 字符存放在一系列块中，块按照位置组织成一棵 treap，插入和删除的期望复杂度是 O(log n)。
+// 追加的字符先写入一个不在树中的尾块，尾块写满之后才插入树中，因此 Append() 的均摊复杂度是 O(1)。
+template<Impl_StringTraits::Type kTypeT>
+class Rope {
+public:
+	using View = StringView<kTypeT>;
+	using Char = typename View::Char;
+
+	enum : std::size_t {
+		kMinChunkCapacity = 256,
+		kMaxChunkCapacity = 0x10000 / sizeof(Char),
+	};
+
+private:
+	struct X_Node {
+		X_Node *pLeft;
+		X_Node *pRight;
+		std::uint32_t u32Priority;
+		std::size_t uTotalSize; // 子树中字符的总数。
+		std::size_t uSize;
+		std::size_t uCapacity;
+		__extension__ Char achData[];
+	};
+
+	enum X_SplitMode {
+		kSplitCopyTail,   // 被拆开的块的后半部分被移到预先分配的节点中，放到右边。
+		kSplitDiscardTail, // 被拆开的块的后半部分被丢弃。
+		kSplitDiscardHead, // 被拆开的块的前半部分被丢弃。
+	};
+
+	static X_Node *X_CreateNode(std::size_t uCapacity, std::uint32_t u32Priority){
+		const auto pNode = static_cast<X_Node *>(::operator new(Impl_CheckedSizeArithmetic::Add(sizeof(X_Node), Impl_CheckedSizeArithmetic::Mul(sizeof(Char), uCapacity))));
+		pNode->pLeft       = nullptr;
+		pNode->pRight      = nullptr;
+		pNode->u32Priority = u32Priority;
+		pNode->uTotalSize  = 0;
+		pNode->uSize       = 0;
+		pNode->uCapacity   = uCapacity;
+		return pNode;
+	}
+	static void X_DestroyTree(X_Node *pRoot) noexcept {
+		while(pRoot){
+			X_DestroyTree(pRoot->pLeft);
+			const auto pRight = pRoot->pRight;
+			::operator delete(pRoot);
+			pRoot = pRight;
+		}
+	}
+
+	static std::size_t X_GetTotalSize(const X_Node *pNode) noexcept {
+		return pNode ? pNode->uTotalSize : 0;
+	}
+	static void X_Update(X_Node *pNode) noexcept {
+		pNode->uTotalSize = X_GetTotalSize(pNode->pLeft) + pNode->uSize + X_GetTotalSize(pNode->pRight);
+	}
+
+	static X_Node *X_Merge(X_Node *pLeft, X_Node *pRight) noexcept {
+		if(!pLeft){
+			return pRight;
+		}
+		if(!pRight){
+			return pLeft;
+		}
+		if(pLeft->u32Priority >= pRight->u32Priority){
+			pLeft->pRight = X_Merge(pLeft->pRight, pRight);
+			X_Update(pLeft);
+			return pLeft;
+		} else {
+			pRight->pLeft = X_Merge(pLeft, pRight->pLeft);
+			X_Update(pRight);
+			return pRight;
+		}
+	}
+	// 返回被丢弃的字符数。
+	static std::size_t X_Split(X_Node *pRoot, std::size_t uPosition, X_Node *&pLeft, X_Node *&pRight, X_SplitMode eMode, X_Node *&pSpare) noexcept {
+		if(!pRoot){
+			pLeft = nullptr;
+			pRight = nullptr;
+			return 0;
+		}
+		std::size_t uDiscarded;
+		const auto uLeftSize = X_GetTotalSize(pRoot->pLeft);
+		if(uPosition <= uLeftSize){
+			uDiscarded = X_Split(pRoot->pLeft, uPosition, pLeft, pRoot->pLeft, eMode, pSpare);
+			X_Update(pRoot);
+			pRight = pRoot;
+		} else if(uPosition >= uLeftSize + pRoot->uSize){
+			uDiscarded = X_Split(pRoot->pRight, uPosition - uLeftSize - pRoot->uSize, pRoot->pRight, pRight, eMode, pSpare);
+			X_Update(pRoot);
+			pLeft = pRoot;
+		} else {
+			// 分界点落在这个块的中间。
+			const auto uOffset = uPosition - uLeftSize;
+			const auto uTailSize = pRoot->uSize - uOffset;
+			switch(eMode){
+			case kSplitCopyTail: {
+				const auto pTail = pSpare;
+				MCF_DEBUG_CHECK(pTail && (pTail->uCapacity >= uTailSize));
+				pSpare = nullptr;
+				std::memcpy(pTail->achData, pRoot->achData + uOffset, uTailSize * sizeof(Char));
+				pTail->uSize = uTailSize;
+				// 新节点继承原节点的优先级，这样仍然满足堆的性质。
+				pTail->u32Priority = pRoot->u32Priority;
+				pTail->pLeft = nullptr;
+				pTail->pRight = pRoot->pRight;
+				X_Update(pTail);
+				pRoot->uSize = uOffset;
+				pRoot->pRight = nullptr;
+				X_Update(pRoot);
+				pLeft = pRoot;
+				pRight = pTail;
+				uDiscarded = 0;
+				break; }
+			case kSplitDiscardTail: {
+				pRoot->uSize = uOffset;
+				pRight = pRoot->pRight;
+				pRoot->pRight = nullptr;
+				X_Update(pRoot);
+				pLeft = pRoot;
+				uDiscarded = uTailSize;
+				break; }
+			default: {
+				std::memmove(pRoot->achData, pRoot->achData + uOffset, uTailSize * sizeof(Char));
+				pRoot->uSize = uTailSize;
+				pLeft = pRoot->pLeft;
+				pRoot->pLeft = nullptr;
+				X_Update(pRoot);
+				pRight = pRoot;
+				uDiscarded = uOffset;
+				break; }
+			}
+		}
+		return uDiscarded;
+	}
+
+	// 找到第 uPosition 个字符所在的块。如果 uPosition 落在两个块之间，返回前一个块。
+	static X_Node *X_Locate(X_Node *pRoot, std::size_t &uPosition) noexcept {
+		auto pNode = pRoot;
+		for(;;){
+			MCF_DEBUG_CHECK(pNode);
+			const auto uLeftSize = X_GetTotalSize(pNode->pLeft);
+			if((uPosition <= uLeftSize) && pNode->pLeft){
+				pNode = pNode->pLeft;
+			} else if(uPosition <= uLeftSize + pNode->uSize){
+				uPosition -= uLeftSize;
+				return pNode;
+			} else {
+				uPosition -= uLeftSize + pNode->uSize;
+				pNode = pNode->pRight;
+			}
+		}
+	}
+	static void X_AdjustSizes(X_Node *pRoot, const X_Node *pTarget, std::size_t uPosition, std::size_t uDelta, bool bGrow) noexcept {
+		auto pNode = pRoot;
+		for(;;){
+			if(bGrow){
+				pNode->uTotalSize += uDelta;
+			} else {
+				pNode->uTotalSize -= uDelta;
+			}
+			if(pNode == pTarget){
+				break;
+			}
+			const auto uLeftSize = X_GetTotalSize(pNode->pLeft);
+			if((uPosition <= uLeftSize) && pNode->pLeft){
+				pNode = pNode->pLeft;
+			} else {
+				uPosition -= uLeftSize + pNode->uSize;
+				pNode = pNode->pRight;
+			}
+		}
+	}
+
+	template<typename FunctionT>
+	static void X_EnumerateTree(const X_Node *pRoot, FunctionT &fnCallback){
+		while(pRoot){
+			X_EnumerateTree(pRoot->pLeft, fnCallback);
+			if(pRoot->uSize != 0){
+				fnCallback(View(pRoot->achData, pRoot->uSize));
+			}
+			pRoot = pRoot->pRight;
+		}
+	}
+
+private:
+	X_Node *x_pRoot;
+	X_Node *x_pTail;
+	std::uint32_t x_u32Seed;
+
+public:
+	constexpr Rope() noexcept
+		: x_pRoot(nullptr), x_pTail(nullptr), x_u32Seed(0x9E3779B9)
+	{ }
+	explicit Rope(const View &svOther)
+		: Rope()
+	{
+		Append(svOther);
+	}
+	Rope(const Rope &vOther)
+		: Rope()
+	{
+		Append(vOther);
+	}
+	Rope(Rope &&vOther) noexcept
+		: Rope()
+	{
+		vOther.Swap(*this);
+	}
+	Rope &operator=(const Rope &vOther){
+		Rope(vOther).Swap(*this);
+		return *this;
+	}
+	Rope &operator=(Rope &&vOther) noexcept {
+		vOther.Swap(*this);
+		return *this;
+	}
+	~Rope(){
+		X_DestroyTree(x_pRoot);
+		::operator delete(x_pTail);
+	}
+
+private:
+	std::uint32_t X_GeneratePriority() noexcept {
+		auto u32Seed = x_u32Seed;
+		u32Seed ^= u32Seed << 13;
+		u32Seed ^= u32Seed >> 17;
+		u32Seed ^= u32Seed << 5;
+		x_u32Seed = u32Seed;
+		return u32Seed;
+	}
+	void X_FlushTail() noexcept {
+		const auto pTail = x_pTail;
+		if(!pTail){
+			return;
+		}
+		x_pTail = nullptr;
+		if(pTail->uSize == 0){
+			::operator delete(pTail);
+			return;
+		}
+		X_Update(pTail);
+		x_pRoot = X_Merge(x_pRoot, pTail);
+	}
+	// 把字符复制到一系列新的块中，返回它们组成的树。
+	X_Node *X_BuildTree(const Char *pchBegin, std::size_t uCount){
+		X_Node *pRoot = nullptr;
+		try {
+			while(uCount != 0){
+				const auto uChunkSize = Min(uCount, kMaxChunkCapacity);
+				const auto pNode = X_CreateNode(Max(uChunkSize, kMinChunkCapacity), X_GeneratePriority());
+				std::memcpy(pNode->achData, pchBegin, uChunkSize * sizeof(Char));
+				pNode->uSize = uChunkSize;
+				X_Update(pNode);
+				pRoot = X_Merge(pRoot, pNode);
+				pchBegin += uChunkSize;
+				uCount -= uChunkSize;
+			}
+		} catch(...){
+			X_DestroyTree(pRoot);
+			throw;
+		}
+		return pRoot;
+	}
+
+public:
+	bool IsEmpty() const noexcept {
+		return GetSize() == 0;
+	}
+	std::size_t GetSize() const noexcept {
+		return X_GetTotalSize(x_pRoot) + (x_pTail ? x_pTail->uSize : 0);
+	}
+	std::size_t GetLength() const noexcept {
+		return GetSize();
+	}
+	void Clear() noexcept {
+		X_DestroyTree(x_pRoot);
+		x_pRoot = nullptr;
+		::operator delete(x_pTail);
+		x_pTail = nullptr;
+	}
+
+	Char Get(std::size_t uIndex) const noexcept {
+		MCF_DEBUG_CHECK(uIndex < GetSize());
+
+		const auto uTreeSize = X_GetTotalSize(x_pRoot);
+		if(uIndex >= uTreeSize){
+			return x_pTail->achData[uIndex - uTreeSize];
+		}
+		auto uOffset = uIndex + 1;
+		const auto pNode = X_Locate(x_pRoot, uOffset);
+		return pNode->achData[uOffset - 1];
+	}
+
+	void Append(Char chFill, std::size_t uCount = 1){
+		while(uCount != 0){
+			if(!x_pTail || (x_pTail->uSize == x_pTail->uCapacity)){
+				X_FlushTail();
+				// 块的大小随着字符串的长度增长，使得短字符串不会浪费太多内存。
+				const auto uCapacity = Min(Max(Max(uCount, GetSize() / 8), kMinChunkCapacity), kMaxChunkCapacity);
+				x_pTail = X_CreateNode(uCapacity, X_GeneratePriority());
+			}
+			const auto uChunkSize = Min(uCount, x_pTail->uCapacity - x_pTail->uSize);
+			FillN(x_pTail->achData + x_pTail->uSize, uChunkSize, chFill);
+			x_pTail->uSize += uChunkSize;
+			uCount -= uChunkSize;
+		}
+	}
+	void Append(const Char *pchBegin, std::size_t uCount){
+		while(uCount != 0){
+			if(!x_pTail || (x_pTail->uSize == x_pTail->uCapacity)){
+				X_FlushTail();
+				const auto uCapacity = Min(Max(Max(uCount, GetSize() / 8), kMinChunkCapacity), kMaxChunkCapacity);
+				x_pTail = X_CreateNode(uCapacity, X_GeneratePriority());
+			}
+			const auto uChunkSize = Min(uCount, x_pTail->uCapacity - x_pTail->uSize);
+			std::memcpy(x_pTail->achData + x_pTail->uSize, pchBegin, uChunkSize * sizeof(Char));
+			x_pTail->uSize += uChunkSize;
+			pchBegin += uChunkSize;
+			uCount -= uChunkSize;
+		}
+	}
+	void Append(const View &svOther){
+		Append(svOther.GetBegin(), svOther.GetSize());
+	}
+	void Append(const String<kTypeT> &strOther){
+		Append(strOther.GetBegin(), strOther.GetSize());
+	}
+	void Append(const Rope &vOther){
+		MCF_DEBUG_CHECK(&vOther != this);
+
+		vOther.EnumerateChunks([&](const View &svChunk){ Append(svChunk); });
+	}
+
+	void Insert(std::size_t uPosition, const View &svInsert){
+		MCF_DEBUG_CHECK(uPosition <= GetSize());
+
+		const auto uCount = svInsert.GetSize();
+		if(uCount == 0){
+			return;
+		}
+		if(uPosition == GetSize()){
+			Append(svInsert);
+			return;
+		}
+		X_FlushTail();
+
+		// 如果所在的块还有空间，就地插入。
+		auto uOffset = uPosition;
+		const auto pTarget = X_Locate(x_pRoot, uOffset);
+		if(pTarget->uCapacity - pTarget->uSize >= uCount){
+			std::memmove(pTarget->achData + uOffset + uCount, pTarget->achData + uOffset, (pTarget->uSize - uOffset) * sizeof(Char));
+			std::memcpy(pTarget->achData + uOffset, svInsert.GetBegin(), uCount * sizeof(Char));
+			pTarget->uSize += uCount;
+			X_AdjustSizes(x_pRoot, pTarget, uPosition, uCount, true);
+			return;
+		}
+
+		const auto pInserted = X_BuildTree(svInsert.GetBegin(), uCount);
+		X_Node *pSpare = nullptr;
+		if((uOffset != 0) && (uOffset != pTarget->uSize)){
+			try {
+				pSpare = X_CreateNode(Max(pTarget->uSize - uOffset, kMinChunkCapacity), 0);
+			} catch(...){
+				X_DestroyTree(pInserted);
+				throw;
+			}
+		}
+		X_Node *pLeft, *pRight;
+		X_Split(x_pRoot, uPosition, pLeft, pRight, kSplitCopyTail, pSpare);
+		MCF_DEBUG_CHECK(!pSpare);
+		x_pRoot = X_Merge(X_Merge(pLeft, pInserted), pRight);
+	}
+	void Erase(std::size_t uPosition, std::size_t uCount) noexcept {
+		MCF_DEBUG_CHECK(uPosition <= GetSize());
+		MCF_DEBUG_CHECK(uCount <= GetSize() - uPosition);
+
+		if(uCount == 0){
+			return;
+		}
+		X_FlushTail();
+
+		// 如果要删除的字符都在同一个块中，就地删除。
+		auto uOffset = uPosition + 1;
+		const auto pTarget = X_Locate(x_pRoot, uOffset);
+		--uOffset;
+		if(pTarget->uSize - uOffset >= uCount){
+			std::memmove(pTarget->achData + uOffset, pTarget->achData + uOffset + uCount, (pTarget->uSize - uOffset - uCount) * sizeof(Char));
+			pTarget->uSize -= uCount;
+			X_AdjustSizes(x_pRoot, pTarget, uPosition + 1, uCount, false);
+			return;
+		}
+
+		X_Node *pSpare = nullptr;
+		X_Node *pLeft, *pMiddle, *pRight;
+		const auto uDiscarded = X_Split(x_pRoot, uPosition, pLeft, pMiddle, kSplitDiscardTail, pSpare);
+		X_Node *pRemoved;
+		X_Split(pMiddle, uCount - uDiscarded, pRemoved, pRight, kSplitDiscardHead, pSpare);
+		X_DestroyTree(pRemoved);
+		x_pRoot = X_Merge(pLeft, pRight);
+	}
+	void Replace(std::size_t uPosition, std::size_t uCount, const View &svReplacement){
+		Insert(uPosition + uCount, svReplacement);
+		Erase(uPosition, uCount);
+	}
+
+	// 按顺序把每个非空的块以 View 的形式传给 fnCallback，不需要把整个字符串复制到一起。
+	template<typename FunctionT>
+	void EnumerateChunks(FunctionT &&fnCallback) const {
+		X_EnumerateTree(x_pRoot, fnCallback);
+		if(x_pTail && (x_pTail->uSize != 0)){
+			fnCallback(View(x_pTail->achData, x_pTail->uSize));
+		}
+	}
+	String<kTypeT> Flatten() const {
+		String<kTypeT> strRet;
+		auto pchWrite = strRet.ResizeMore(GetSize());
+		EnumerateChunks([&](const View &svChunk){ pchWrite = CopyN(pchWrite, svChunk.GetBegin(), svChunk.GetSize()).first; });
+		return strRet;
+	}
+
+	void Swap(Rope &vOther) noexcept {
+		using std::swap;
+		swap(x_pRoot,   vOther.x_pRoot);
+		swap(x_pTail,   vOther.x_pTail);
+		swap(x_u32Seed, vOther.x_u32Seed);
+	}
+
+public:
+	Rope &operator+=(const View &svOther){
+		Append(svOther);
+		return *this;
+	}
+	Rope &operator+=(Char chOther){
+		Append(chOther, 1);
+		return *this;
+	}
+
+	friend void swap(Rope &vSelf, Rope &vOther) noexcept {
+		vSelf.Swap(vOther);
+	}
+};
+
+extern template class Rope<Impl_StringTraits::Type::kUtf8>;
+extern template class Rope<Impl_StringTraits::Type::kUtf16>;
+extern template class Rope<Impl_StringTraits::Type::kUtf32>;
+extern template class Rope<Impl_StringTraits::Type::kCesu8>;
+extern template class Rope<Impl_StringTraits::Type::kAnsi>;
+extern template class Rope<Impl_StringTraits::Type::kModifiedUtf8>;
+extern template class Rope<Impl_StringTraits::Type::kNarrow>;
+extern template class Rope<Impl_StringTraits::Type::kWide>;
+
+using Utf8Rope         = Rope<Impl_StringTraits::Type::kUtf8>;
+using Utf16Rope        = Rope<Impl_StringTraits::Type::kUtf16>;
+using Utf32Rope        = Rope<Impl_StringTraits::Type::kUtf32>;
+using Cesu8Rope        = Rope<Impl_StringTraits::Type::kCesu8>;
+using AnsiRope         = Rope<Impl_StringTraits::Type::kAnsi>;
+using ModifiedUtf8Rope = Rope<Impl_StringTraits::Type::kModifiedUtf8>;
+using NarrowRope       = Rope<Impl_StringTraits::Type::kNarrow>;
+using WideRope         = Rope<Impl_StringTraits::Type::kWide>;
+
+}
+
+#endif
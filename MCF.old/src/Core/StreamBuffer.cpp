@@ -5,50 +5,307 @@
 #include "StreamBuffer.hpp"
 #include "_CheckedSizeArithmetic.hpp"
 #include "Assert.hpp"
+#include "Atomic.hpp"
+#include "MinMax.hpp"
+#include "ConstructDestruct.hpp"
+#include "Exception.hpp"
+#include "../Thread/ThreadLocal.hpp"
 
 namespace MCF {
 
-struct StreamBuffer::X_ChunkHeader {
-	static X_ChunkHeader *Create(std::size_t uMinCapacity, X_ChunkHeader *pPrev, X_ChunkHeader *pNext, bool bBackward){
-		const auto uCapacity = uMinCapacity | 1024;
-		const auto uOrigin = bBackward ? uCapacity : 0;
-		const auto pChunk = static_cast<X_ChunkHeader *>(::operator new(Impl_CheckedSizeArithmetic::Add(sizeof(X_ChunkHeader), uCapacity)));
-		pChunk->uCapacity = uCapacity;
-		pChunk->pPrev     = pPrev;
-		pChunk->pNext     = pNext;
-		pChunk->uBegin    = uOrigin;
-		pChunk->uEnd      = uOrigin;
-		return pChunk;
-	}
-	static void Destroy(X_ChunkHeader *pChunk) noexcept {
-		::operator delete(pChunk);
-	}
+// 块的数据部分，可以被多个缓冲区共享。共享的块是只读的。
+struct StreamBuffer::X_Block {
+	static X_Block *Create(std::size_t uMinCapacity);
+	static void Release(X_Block *pBlock) noexcept;
 
+	Atomic<std::size_t> uRef;
 	std::size_t uCapacity;
+	X_Block *pNextFree;
+	__extension__ unsigned char abyData[];
+};
+
+struct StreamBuffer::X_ChunkHeader {
+	static X_ChunkHeader *Create(std::size_t uMinCapacity, std::size_t uBufferedSize, X_ChunkHeader *pPrev, X_ChunkHeader *pNext, bool bBackward);
+	static X_ChunkHeader *CreateShared(X_Block *pBlock, std::size_t uBegin, std::size_t uEnd, X_ChunkHeader *pPrev, X_ChunkHeader *pNext);
+	static void Destroy(X_ChunkHeader *pChunk) noexcept;
+	static void Unshare(X_ChunkHeader *pChunk);
+
+	X_Block *pBlock;
 
 	X_ChunkHeader *pPrev;
 	X_ChunkHeader *pNext;
 
 	std::size_t uBegin;
 	std::size_t uEnd;
-	__extension__ unsigned char abyData[];
+
+	unsigned char *GetData() const noexcept {
+		return pBlock->abyData;
+	}
+	std::size_t GetCapacity() const noexcept {
+		return pBlock->uCapacity;
+	}
+	// 只有不被共享的块才能写入。
+	bool IsWritable() const noexcept {
+		return pBlock->uRef.Load(kAtomicAcquire) == 1;
+	}
 };
 
-StreamBuffer::StreamBuffer(const StreamBuffer &vOther){
-	auto pChunk = vOther.x_pFirst;
-	if(!pChunk){
+// 每个线程缓存一定数目的空闲块和链表节点，避免频繁地分配和释放内存。
+// 块的大小分为几个等级，只有这些等级的块会被缓存，更大的块直接分配和释放。参见 SetThreadChunkCache()。
+struct StreamBuffer::X_ChunkCache {
+	enum : std::size_t {
+		kMaxCachedNodes = 256,
+	};
+
+	static constexpr std::size_t kDefaultAllocationSizes[kChunkClassCount] = { 0x1000, 0x10000, 0x100000 };
+	static constexpr std::size_t kDefaultMaxCachedBlocks[kChunkClassCount] = { 64, 8, 2 };
+
+	static const ThreadLocal<X_ChunkCache> &GetThreadLocal(){
+		// 这个对象不会被销毁，这样在静态对象的析构函数中释放的块仍然可以被处理。
+		static const auto s_ptlsInstance = new ThreadLocal<X_ChunkCache>();
+		return *s_ptlsInstance;
+	}
+	// 分配内存的时候创建当前线程的缓存。
+	static X_ChunkCache &Require(){
+		const auto &tlsInstance = GetThreadLocal();
+		auto pCache = tlsInstance.Get();
+		if(!pCache){
+			pCache = tlsInstance.Require();
+		}
+		return *pCache;
+	}
+	// 释放内存的时候只使用已经存在的缓存，线程退出之后释放的内存直接还给系统。
+	// 块总是先被分配再被释放，所以 GetThreadLocal() 中的初始化已经完成了，不会抛出异常。
+	static X_ChunkCache *Get() noexcept {
+		return GetThreadLocal().Get();
+	}
+
+	static X_ChunkHeader *AllocateNode(){
+		auto &vCache = Require();
+		const auto pNode = vCache.pNodes;
+		if(!pNode){
+			return static_cast<X_ChunkHeader *>(::operator new(sizeof(X_ChunkHeader)));
+		}
+		vCache.pNodes = pNode->pNext;
+		vCache.uNodeCount -= 1;
+		return pNode;
+	}
+	static void FreeNode(X_ChunkHeader *pNode) noexcept {
+		const auto pCache = Get();
+		if(pCache && (pCache->uNodeCount < kMaxCachedNodes)){
+			pNode->pNext = pCache->pNodes;
+			pCache->pNodes = pNode;
+			pCache->uNodeCount += 1;
+			return;
+		}
+		::operator delete(pNode);
+	}
+
+	std::size_t auAllocationSizes[kChunkClassCount];
+	std::size_t auMaxCachedBlocks[kChunkClassCount];
+	X_Block *apBlocks[kChunkClassCount] = { };
+	std::size_t auBlockCounts[kChunkClassCount] = { };
+	X_ChunkHeader *pNodes = nullptr;
+	std::size_t uNodeCount = 0;
+
+	X_ChunkCache() noexcept {
+		for(std::size_t uClass = 0; uClass < kChunkClassCount; ++uClass){
+			auAllocationSizes[uClass] = kDefaultAllocationSizes[uClass];
+			auMaxCachedBlocks[uClass] = kDefaultMaxCachedBlocks[uClass];
+		}
+	}
+	~X_ChunkCache(){
+		FlushBlocks();
+		auto pNode = std::exchange(pNodes, nullptr);
+		while(pNode){
+			const auto pNext = pNode->pNext;
+			::operator delete(pNode);
+			pNode = pNext;
+		}
+		uNodeCount = 0;
+	}
+
+	std::size_t GetClassCapacity(std::size_t uClass) const noexcept {
+		return auAllocationSizes[uClass] - sizeof(X_Block);
+	}
+	void FlushBlocks() noexcept {
+		for(std::size_t uClass = 0; uClass < kChunkClassCount; ++uClass){
+			auto pBlock = std::exchange(apBlocks[uClass], nullptr);
+			while(pBlock){
+				const auto pNextFree = pBlock->pNextFree;
+				::operator delete(pBlock);
+				pBlock = pNextFree;
+			}
+			auBlockCounts[uClass] = 0;
+		}
+	}
+};
+
+void StreamBuffer::SetThreadChunkCache(const std::size_t (&auAllocationSizes)[kChunkClassCount], const std::size_t (&auMaxCachedBlocks)[kChunkClassCount]){
+	for(std::size_t uClass = 0; uClass < kChunkClassCount; ++uClass){
+		const auto uLowerBound = (uClass == 0) ? sizeof(X_Block) : auAllocationSizes[uClass - 1];
+		if(auAllocationSizes[uClass] <= uLowerBound){
+			MCF_THROW(Exception, ERROR_INVALID_PARAMETER, Rcntws::View(L"StreamBuffer: 块的大小等级必须递增，并且大于块头部的大小。"));
+		}
+	}
+	auto &vCache = X_ChunkCache::Require();
+	// 缓存中的块属于原来的等级，全部释放。
+	vCache.FlushBlocks();
+	for(std::size_t uClass = 0; uClass < kChunkClassCount; ++uClass){
+		vCache.auAllocationSizes[uClass] = auAllocationSizes[uClass];
+		vCache.auMaxCachedBlocks[uClass] = auMaxCachedBlocks[uClass];
+	}
+}
+
+StreamBuffer::X_Block *StreamBuffer::X_Block::Create(std::size_t uMinCapacity){
+	auto &vCache = X_ChunkCache::Require();
+	X_Block *pBlock = nullptr;
+	std::size_t uCapacity = uMinCapacity;
+	for(std::size_t uClass = 0; uClass < kChunkClassCount; ++uClass){
+		const auto uClassCapacity = vCache.GetClassCapacity(uClass);
+		if(uMinCapacity <= uClassCapacity){
+			pBlock = vCache.apBlocks[uClass];
+			if(pBlock){
+				vCache.apBlocks[uClass] = pBlock->pNextFree;
+				vCache.auBlockCounts[uClass] -= 1;
+			}
+			uCapacity = uClassCapacity;
+			break;
+		}
+	}
+	if(!pBlock){
+		pBlock = static_cast<X_Block *>(::operator new(Impl_CheckedSizeArithmetic::Add(sizeof(X_Block), uCapacity)));
+	}
+	Construct(&(pBlock->uRef), 1u);
+	pBlock->uCapacity = uCapacity;
+	pBlock->pNextFree = nullptr;
+	return pBlock;
+}
+void StreamBuffer::X_Block::Release(X_Block *pBlock) noexcept {
+	if(pBlock->uRef.Decrement(kAtomicAcqRel) != 0){
 		return;
 	}
-	const auto pIntegral = X_ChunkHeader::Create(vOther.x_uSize, nullptr, nullptr, false);
-	while(pChunk){
+	Destruct(&(pBlock->uRef));
+	const auto pCache = X_ChunkCache::Get();
+	if(pCache){
+		// 其他线程分配的块的大小可能不属于这个线程的任何等级，这样的块不会被缓存。
+		for(std::size_t uClass = 0; uClass < kChunkClassCount; ++uClass){
+			if(pBlock->uCapacity == pCache->GetClassCapacity(uClass)){
+				if(pCache->auBlockCounts[uClass] < pCache->auMaxCachedBlocks[uClass]){
+					pBlock->pNextFree = pCache->apBlocks[uClass];
+					pCache->apBlocks[uClass] = pBlock;
+					pCache->auBlockCounts[uClass] += 1;
+					return;
+				}
+				break;
+			}
+		}
+	}
+	::operator delete(pBlock);
+}
+
+StreamBuffer::X_ChunkHeader *StreamBuffer::X_ChunkHeader::Create(std::size_t uMinCapacity, std::size_t uBufferedSize, X_ChunkHeader *pPrev, X_ChunkHeader *pNext, bool bBackward){
+	// 缓冲区中的数据越多，新分配的块就越大，这样块的数目大致按对数增长。
+	const auto uLargestClassCapacity = X_ChunkCache::Require().GetClassCapacity(kChunkClassCount - 1);
+	const auto uPreferredCapacity = Max(uMinCapacity, Min(uBufferedSize / 4, uLargestClassCapacity));
+	const auto pChunk = X_ChunkCache::AllocateNode();
+	try {
+		pChunk->pBlock = X_Block::Create(uPreferredCapacity);
+	} catch(...){
+		X_ChunkCache::FreeNode(pChunk);
+		throw;
+	}
+	const auto uOrigin = bBackward ? pChunk->pBlock->uCapacity : 0;
+	pChunk->pPrev     = pPrev;
+	pChunk->pNext     = pNext;
+	pChunk->uBegin    = uOrigin;
+	pChunk->uEnd      = uOrigin;
+	return pChunk;
+}
+StreamBuffer::X_ChunkHeader *StreamBuffer::X_ChunkHeader::CreateShared(X_Block *pBlock, std::size_t uBegin, std::size_t uEnd, X_ChunkHeader *pPrev, X_ChunkHeader *pNext){
+	const auto pChunk = X_ChunkCache::AllocateNode();
+	pBlock->uRef.Increment(kAtomicRelaxed);
+	pChunk->pBlock    = pBlock;
+	pChunk->pPrev     = pPrev;
+	pChunk->pNext     = pNext;
+	pChunk->uBegin    = uBegin;
+	pChunk->uEnd      = uEnd;
+	return pChunk;
+}
+void StreamBuffer::X_ChunkHeader::Destroy(X_ChunkHeader *pChunk) noexcept {
+	X_Block::Release(pChunk->pBlock);
+	X_ChunkCache::FreeNode(pChunk);
+}
+void StreamBuffer::X_ChunkHeader::Unshare(X_ChunkHeader *pChunk){
+	if(pChunk->IsWritable()){
+		return;
+	}
+	const auto uAvail = pChunk->uEnd - pChunk->uBegin;
+	const auto pNewBlock = X_Block::Create(uAvail);
+	std::memcpy(pNewBlock->abyData, pChunk->GetData() + pChunk->uBegin, uAvail);
+	X_Block::Release(std::exchange(pChunk->pBlock, pNewBlock));
+	pChunk->uBegin = 0;
+	pChunk->uEnd   = uAvail;
+}
+
+StreamBuffer::X_ChunkHeader *StreamBuffer::X_PrepareBack(std::size_t uSize){
+	auto pChunk = x_pLast;
+	const auto pPrev = pChunk;
+	if(pChunk && (!pChunk->IsWritable() || (pChunk->GetCapacity() - pChunk->uEnd < uSize))){
 		const auto uAvail = pChunk->uEnd - pChunk->uBegin;
-		std::memcpy(pIntegral->abyData + pIntegral->uEnd, pChunk->abyData + pChunk->uBegin, uAvail);
-		pIntegral->uEnd += uAvail;
+		if(pChunk->IsWritable() && (pChunk->GetCapacity() - uAvail >= uSize)){
+			std::memmove(pChunk->GetData(), pChunk->GetData() + pChunk->uBegin, uAvail);
+			pChunk->uBegin = 0;
+			pChunk->uEnd = uAvail;
+		} else {
+			pChunk = nullptr;
+		}
+	}
+	if(!pChunk){
+		const auto pNext = X_ChunkHeader::Create(uSize, x_uSize, pPrev, nullptr, false);
+		(pPrev ? pPrev->pNext : x_pFirst) = pNext;
+		x_pLast = pNext;
+		pChunk = pNext;
+	}
+	return pChunk;
+}
+StreamBuffer::X_ChunkHeader *StreamBuffer::X_PrepareFront(std::size_t uSize){
+	auto pChunk = x_pFirst;
+	const auto pNext = pChunk;
+	if(pChunk && (!pChunk->IsWritable() || (pChunk->uBegin < uSize))){
+		const auto uAvail = pChunk->uEnd - pChunk->uBegin;
+		if(pChunk->IsWritable() && (pChunk->GetCapacity() - uAvail >= uSize)){
+			std::memmove(pChunk->GetData() + (pChunk->GetCapacity() - uAvail), pChunk->GetData() + pChunk->uBegin, uAvail);
+			pChunk->uBegin = pChunk->GetCapacity() - uAvail;
+			pChunk->uEnd = pChunk->GetCapacity();
+		} else {
+			pChunk = nullptr;
+		}
+	}
+	if(!pChunk){
+		const auto pPrev = X_ChunkHeader::Create(uSize, x_uSize, nullptr, pNext, true);
+		(pNext ? pNext->pPrev : x_pLast) = pPrev;
+		x_pFirst = pPrev;
+		pChunk = pPrev;
+	}
+	return pChunk;
+}
+
+StreamBuffer::StreamBuffer(const StreamBuffer &vOther){
+	// 块是共享的，只复制链表节点。
+	StreamBuffer vTemp;
+	auto pChunk = vOther.x_pFirst;
+	while(pChunk){
+		if(pChunk->uEnd != pChunk->uBegin){
+			const auto pPrev = vTemp.x_pLast;
+			const auto pShared = X_ChunkHeader::CreateShared(pChunk->pBlock, pChunk->uBegin, pChunk->uEnd, pPrev, nullptr);
+			(pPrev ? pPrev->pNext : vTemp.x_pFirst) = pShared;
+			vTemp.x_pLast = pShared;
+			vTemp.x_uSize += pChunk->uEnd - pChunk->uBegin;
+		}
 		pChunk = pChunk->pNext;
 	}
-	x_pLast  = pIntegral;
-	x_pFirst = pIntegral;
-	x_uSize  = vOther.x_uSize;
+	Swap(vTemp);
 }
 StreamBuffer::~StreamBuffer(){
 	auto pChunk = x_pFirst;
@@ -79,7 +336,7 @@ int StreamBuffer::PeekFront() const noexcept {
 	auto pChunk = x_pFirst;
 	while(pChunk){
 		if(pChunk->uEnd != pChunk->uBegin){
-			nRead = pChunk->abyData[pChunk->uBegin];
+			nRead = pChunk->GetData()[pChunk->uBegin];
 			break;
 		}
 		const auto pNext = pChunk->pNext;
@@ -92,7 +349,7 @@ int StreamBuffer::Get() noexcept {
 	auto pChunk = x_pFirst;
 	while(pChunk){
 		if(pChunk->uEnd != pChunk->uBegin){
-			nRead = pChunk->abyData[pChunk->uBegin];
+			nRead = pChunk->GetData()[pChunk->uBegin];
 			pChunk->uBegin += 1;
 			x_uSize -= 1;
 			break;
@@ -124,25 +381,8 @@ bool StreamBuffer::Discard() noexcept {
 	return bDiscarded;
 }
 void StreamBuffer::Put(unsigned char byData){
-	auto pChunk = x_pLast;
-	auto pPrev = pChunk;
-	if(pChunk && (pChunk->uCapacity == pChunk->uEnd)){
-		const auto uAvail = pChunk->uEnd - pChunk->uBegin;
-		if(pChunk->uCapacity > uAvail){
-			std::memmove(pChunk->abyData, pChunk->abyData + pChunk->uBegin, uAvail);
-			pChunk->uBegin = 0;
-			pChunk->uEnd = uAvail;
-		} else {
-			pChunk = nullptr;
-		}
-	}
-	if(!pChunk){
-		const auto pNext = X_ChunkHeader::Create(1, pPrev, nullptr, false);
-		(pPrev ? pPrev->pNext : x_pFirst) = pNext;
-		x_pLast = pNext;
-		pChunk = pNext;
-	}
-	pChunk->abyData[pChunk->uEnd] = byData;
+	const auto pChunk = X_PrepareBack(1);
+	pChunk->GetData()[pChunk->uEnd] = byData;
 	pChunk->uEnd += 1;
 	x_uSize += 1;
 }
@@ -151,7 +391,7 @@ int StreamBuffer::PeekBack() const noexcept {
 	auto pChunk = x_pLast;
 	while(pChunk){
 		if(pChunk->uEnd != pChunk->uBegin){
-			nRead = pChunk->abyData[pChunk->uEnd - 1];
+			nRead = pChunk->GetData()[pChunk->uEnd - 1];
 			break;
 		}
 		const auto pPrev = pChunk->pPrev;
@@ -164,7 +404,7 @@ int StreamBuffer::Unput() noexcept {
 	auto pChunk = x_pLast;
 	while(pChunk){
 		if(pChunk->uEnd != pChunk->uBegin){
-			nRead = pChunk->abyData[pChunk->uEnd - 1];
+			nRead = pChunk->GetData()[pChunk->uEnd - 1];
 			pChunk->uEnd -= 1;
 			x_uSize -= 1;
 			break;
@@ -178,25 +418,8 @@ int StreamBuffer::Unput() noexcept {
 	return nRead;
 }
 void StreamBuffer::Unget(unsigned char byData){
-	auto pChunk = x_pFirst;
-	auto pNext = pChunk;
-	if(pChunk && (pChunk->uBegin == 0)){
-		const auto uAvail = pChunk->uEnd - pChunk->uBegin;
-		if(pChunk->uCapacity > uAvail){
-			std::memmove(pChunk->abyData + pChunk->uBegin + (pChunk->uCapacity - pChunk->uEnd), pChunk->abyData + pChunk->uBegin, uAvail);
-			pChunk->uBegin = pChunk->uCapacity - uAvail;
-			pChunk->uEnd = pChunk->uCapacity;
-		} else {
-			pChunk = nullptr;
-		}
-	}
-	if(!pChunk){
-		const auto pPrev = X_ChunkHeader::Create(1, nullptr, pNext, true);
-		(pNext ? pNext->pPrev : x_pLast) = pPrev;
-		x_pFirst = pPrev;
-		pChunk = pPrev;
-	}
-	pChunk->abyData[pChunk->uBegin - 1] = byData;
+	const auto pChunk = X_PrepareFront(1);
+	pChunk->GetData()[pChunk->uBegin - 1] = byData;
 	pChunk->uBegin -= 1;
 	x_uSize += 1;
 }
@@ -211,11 +434,11 @@ std::size_t StreamBuffer::Peek(void *pData, std::size_t uSize) const noexcept {
 		}
 		const auto uAvail = pChunk->uEnd - pChunk->uBegin;
 		if(uAvail >= uRemaining){
-			std::memcpy(static_cast<unsigned char *>(pData) + uTotal, pChunk->abyData + pChunk->uBegin, uRemaining);
+			std::memcpy(static_cast<unsigned char *>(pData) + uTotal, pChunk->GetData() + pChunk->uBegin, uRemaining);
 			uTotal += uRemaining;
 			break;
 		}
-		std::memcpy(static_cast<unsigned char *>(pData) + uTotal, pChunk->abyData + pChunk->uBegin, uAvail);
+		std::memcpy(static_cast<unsigned char *>(pData) + uTotal, pChunk->GetData() + pChunk->uBegin, uAvail);
 		uTotal += uAvail;
 		const auto pNext = pChunk->pNext;
 		pChunk = pNext;
@@ -232,13 +455,13 @@ std::size_t StreamBuffer::Get(void *pData, std::size_t uSize) noexcept {
 		}
 		const auto uAvail = pChunk->uEnd - pChunk->uBegin;
 		if(uAvail >= uRemaining){
-			std::memcpy(static_cast<unsigned char *>(pData) + uTotal, pChunk->abyData + pChunk->uBegin, uRemaining);
+			std::memcpy(static_cast<unsigned char *>(pData) + uTotal, pChunk->GetData() + pChunk->uBegin, uRemaining);
 			pChunk->uBegin += uRemaining;
 			x_uSize -= uRemaining;
 			uTotal += uRemaining;
 			break;
 		}
-		std::memcpy(static_cast<unsigned char *>(pData) + uTotal, pChunk->abyData + pChunk->uBegin, uAvail);
+		std::memcpy(static_cast<unsigned char *>(pData) + uTotal, pChunk->GetData() + pChunk->uBegin, uAvail);
 		pChunk->uBegin += uAvail;
 		x_uSize -= uAvail;
 		uTotal += uAvail;
@@ -277,48 +500,43 @@ std::size_t StreamBuffer::Discard(std::size_t uSize) noexcept {
 	return uTotal;
 }
 void StreamBuffer::Put(unsigned char byData, std::size_t uSize){
-	auto pChunk = x_pLast;
-	auto pPrev = pChunk;
-	if(pChunk && (pChunk->uCapacity - pChunk->uEnd < uSize)){
-		const auto uAvail = pChunk->uEnd - pChunk->uBegin;
-		if(pChunk->uCapacity - uAvail >= uSize){
-			std::memmove(pChunk->abyData, pChunk->abyData + pChunk->uBegin, uAvail);
-			pChunk->uBegin = 0;
-			pChunk->uEnd = uAvail;
-		} else {
-			pChunk = nullptr;
-		}
-	}
-	if(!pChunk){
-		const auto pNext = X_ChunkHeader::Create(uSize, pPrev, nullptr, false);
-		(pPrev ? pPrev->pNext : x_pFirst) = pNext;
-		pChunk = pNext;
-		x_pLast = pNext;
-	}
-	std::memset(pChunk->abyData + pChunk->uEnd, byData, uSize);
+	const auto pChunk = X_PrepareBack(uSize);
+	std::memset(pChunk->GetData() + pChunk->uEnd, byData, uSize);
 	pChunk->uEnd += uSize;
 	x_uSize += uSize;
 }
 void StreamBuffer::Put(const void *pData, std::size_t uSize){
-	auto pChunk = x_pLast;
-	auto pPrev = pChunk;
-	if(pChunk && (pChunk->uCapacity - pChunk->uEnd < uSize)){
-		const auto uAvail = pChunk->uEnd - pChunk->uBegin;
-		if(pChunk->uCapacity - uAvail >= uSize){
-			std::memmove(pChunk->abyData, pChunk->abyData + pChunk->uBegin, uAvail);
-			pChunk->uBegin = 0;
-			pChunk->uEnd = uAvail;
-		} else {
-			pChunk = nullptr;
+	const auto pChunk = X_PrepareBack(uSize);
+	std::memcpy(pChunk->GetData() + pChunk->uEnd, pData, uSize);
+	pChunk->uEnd += uSize;
+	x_uSize += uSize;
+}
+
+bool StreamBuffer::Borrow(const void **ppData, std::size_t *puSize) const noexcept {
+	auto pChunk = x_pFirst;
+	while(pChunk){
+		if(pChunk->uEnd != pChunk->uBegin){
+			*ppData = pChunk->GetData() + pChunk->uBegin;
+			*puSize = pChunk->uEnd - pChunk->uBegin;
+			return true;
 		}
-	}
-	if(!pChunk){
-		const auto pNext = X_ChunkHeader::Create(uSize, pPrev, nullptr, false);
-		(pPrev ? pPrev->pNext : x_pFirst) = pNext;
-		x_pLast = pNext;
+		const auto pNext = pChunk->pNext;
 		pChunk = pNext;
 	}
-	std::memcpy(pChunk->abyData + pChunk->uEnd, pData, uSize);
+	return false;
+}
+std::size_t StreamBuffer::Reserve(void **ppData, std::size_t uMinSize){
+	const auto pChunk = X_PrepareBack((uMinSize != 0) ? uMinSize : 1);
+	*ppData = pChunk->GetData() + pChunk->uEnd;
+	return pChunk->GetCapacity() - pChunk->uEnd;
+}
+void StreamBuffer::Commit(std::size_t uSize) noexcept {
+	const auto pChunk = x_pLast;
+	MCF_DEBUG_CHECK((uSize == 0) || (pChunk && pChunk->IsWritable() && (pChunk->GetCapacity() - pChunk->uEnd >= uSize)));
+
+	if(uSize == 0){
+		return;
+	}
 	pChunk->uEnd += uSize;
 	x_uSize += uSize;
 }
@@ -329,10 +547,22 @@ void *StreamBuffer::Squash(){
 		return nullptr;
 	}
 	if(pChunk != x_pLast){
-		StreamBuffer(*this).Swap(*this);
+		const auto pIntegral = X_ChunkHeader::Create(x_uSize, 0, nullptr, nullptr, false);
+		while(pChunk){
+			const auto uAvail = pChunk->uEnd - pChunk->uBegin;
+			std::memcpy(pIntegral->GetData() + pIntegral->uEnd, pChunk->GetData() + pChunk->uBegin, uAvail);
+			pIntegral->uEnd += uAvail;
+			pChunk = pChunk->pNext;
+		}
+		StreamBuffer vTemp;
+		vTemp.x_pLast  = pIntegral;
+		vTemp.x_pFirst = pIntegral;
+		vTemp.x_uSize  = x_uSize;
+		vTemp.Swap(*this);
 		pChunk = x_pFirst;
 	}
-	return pChunk->abyData + pChunk->uBegin;
+	X_ChunkHeader::Unshare(pChunk);
+	return pChunk->GetData() + pChunk->uBegin;
 }
 
 StreamBuffer StreamBuffer::CutOff(std::size_t uSize){
@@ -348,9 +578,8 @@ StreamBuffer StreamBuffer::CutOff(std::size_t uSize){
 			if(uAvail > uRemaining){
 				const auto pPrev = pChunk->pPrev;
 				const auto pNext = pChunk;
-				pChunk = X_ChunkHeader::Create(uRemaining, pPrev, pNext, false);
-				std::memcpy(pChunk->abyData, pNext->abyData + pNext->uBegin, uRemaining);
-				pChunk->uEnd = uRemaining;
+				// 被切开的块由两个缓冲区共享，不需要复制数据。
+				pChunk = X_ChunkHeader::CreateShared(pNext->pBlock, pNext->uBegin, pNext->uBegin + uRemaining, pPrev, pNext);
 				pNext->uBegin += uRemaining;
 				(pPrev ? pPrev->pNext : x_pFirst) = pChunk;
 				pNext->pPrev = pChunk;
@@ -395,21 +624,24 @@ bool StreamBuffer::EnumerateChunk(const void **ppData, std::size_t *puSize, Stre
 		return false;
 	}
 	if(ppData){
-		*ppData = pChunk->abyData + pChunk->uBegin;
+		*ppData = pChunk->GetData() + pChunk->uBegin;
 	}
 	if(puSize){
 		*puSize = pChunk->uEnd - pChunk->uBegin;
 	}
 	return true;
 }
-bool StreamBuffer::EnumerateChunk(void **ppData, std::size_t *puSize, StreamBuffer::EnumerationCookie &vCookie) noexcept {
+bool StreamBuffer::EnumerateChunk(void **ppData, std::size_t *puSize, StreamBuffer::EnumerationCookie &vCookie){
 	const auto pChunk = vCookie.x_pPrev ? vCookie.x_pPrev->pNext : x_pFirst;
 	vCookie.x_pPrev = pChunk;
 	if(!pChunk){
 		return false;
 	}
 	if(ppData){
-		*ppData = pChunk->abyData + pChunk->uBegin;
+		X_ChunkHeader::Unshare(pChunk);
+	}
+	if(ppData){
+		*ppData = pChunk->GetData() + pChunk->uBegin;
 	}
 	if(puSize){
 		*puSize = pChunk->uEnd - pChunk->uBegin;
@@ -12,7 +12,9 @@ namespace MCF {
 
 class StreamBuffer {
 private:
+	struct X_Block;
 	struct X_ChunkHeader;
+	struct X_ChunkCache;
 
 public:
 	class EnumerationCookie {
@@ -36,6 +38,21 @@ private:
 	X_ChunkHeader *x_pFirst = nullptr;
 	std::size_t x_uSize = 0;
 
+private:
+	// 返回一个可以写入的块，其末尾（或开头）至少有 uSize 字节的空闲空间。
+	X_ChunkHeader *X_PrepareBack(std::size_t uSize);
+	X_ChunkHeader *X_PrepareFront(std::size_t uSize);
+
+public:
+	enum : std::size_t {
+		kChunkClassCount = 3,
+	};
+
+	// 每个线程缓存一定数目的空闲块，块的大小分为 kChunkClassCount 个等级，只有这些大小的块会被缓存。
+	// 默认的大小是 4 KiB、64 KiB 和 1 MiB（包括块的头部），分别最多缓存 64、8 和 2 个。
+	// 这个函数设置当前线程的各等级的大小和缓存的数目上限，大小必须递增。当前线程已经缓存的块被释放。
+	static void SetThreadChunkCache(const std::size_t (&auAllocationSizes)[kChunkClassCount], const std::size_t (&auMaxCachedBlocks)[kChunkClassCount]);
+
 public:
 	constexpr StreamBuffer() noexcept = default;
 	StreamBuffer(unsigned char byData, std::size_t uSize){
@@ -84,6 +101,12 @@ public:
 	void Put(unsigned char byData, std::size_t uSize);
 	void Put(const void *pData, std::size_t uSize);
 
+	// 返回第一个非空的块，不会复制。被读取的部分应当用 Discard() 丢弃。
+	bool Borrow(const void **ppData, std::size_t *puSize) const noexcept;
+	// 在末尾准备一块至少有 uMinSize 字节并且不为空的连续空间，然后用 Commit() 提交写入的数据。
+	std::size_t Reserve(void **ppData, std::size_t uMinSize);
+	void Commit(std::size_t uSize) noexcept;
+
 	void *Squash();
 
 	StreamBuffer CutOff(std::size_t uSize);
@@ -93,7 +116,8 @@ public:
 	}
 
 	bool EnumerateChunk(const void **ppData, std::size_t *puSize, EnumerationCookie &vCookie) const noexcept;
-	bool EnumerateChunk(void **ppData, std::size_t *puSize, EnumerationCookie &vCookie) noexcept;
+	// 可写的枚举会把被共享的块复制一份。
+	bool EnumerateChunk(void **ppData, std::size_t *puSize, EnumerationCookie &vCookie);
 
 	void Swap(StreamBuffer &vOther) noexcept {
 		using std::swap;
@@ -39,14 +39,9 @@ void Utf8String::UnifyAppend(Utf16String &u16sDst, const Utf8StringView &u8svSrc
 	try {
 		auto pc16Write = pc16WriteBegin;
 		auto pchRead = u8svSrc.GetBegin();
-		const auto pchReadEnd = u8svSrc.GetEnd();
-		while(pchRead < pchReadEnd){
-			auto c32CodePoint = ::_MCFCRT_DecodeUtf8(&pchRead, pchReadEnd, false);
-			if(!_MCFCRT_UTF_SUCCESS(c32CodePoint)){
-				MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Utf8String: _MCFCRT_DecodeUtf8() 失败。"));
-			}
-			c32CodePoint = ::_MCFCRT_UncheckedEncodeUtf16(&pc16Write, c32CodePoint, true);
-			MCF_ASSERT(_MCFCRT_UTF_SUCCESS(c32CodePoint));
+		const auto c32Status = ::_MCFCRT_TranscodeUtf8ToUtf16(&pc16Write, u16sDst.GetEnd(), &pchRead, u8svSrc.GetEnd(), 0);
+		if(c32Status != _MCFCRT_UTF_NO_DATA){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Utf8String: _MCFCRT_TranscodeUtf8ToUtf16() 失败。"));
 		}
 		u16sDst.Pop(static_cast<std::size_t>(u16sDst.GetEnd() - pc16Write));
 	} catch(...){
@@ -61,14 +56,9 @@ void Utf8String::DeunifyAppend(Utf8String &u8sDst, const Utf16StringView &u16svS
 	try {
 		auto pchWrite = pchWriteBegin;
 		auto pc16Read = u16svSrc.GetBegin();
-		const auto pc16ReadEnd = u16svSrc.GetEnd();
-		while(pc16Read < pc16ReadEnd){
-			auto c32CodePoint = ::_MCFCRT_DecodeUtf16(&pc16Read, pc16ReadEnd, false);
-			if(!_MCFCRT_UTF_SUCCESS(c32CodePoint)){
-				MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Utf8String: _MCFCRT_DecodeUtf16() 失败。"));
-			}
-			c32CodePoint = ::_MCFCRT_UncheckedEncodeUtf8(&pchWrite, c32CodePoint, true);
-			MCF_ASSERT(_MCFCRT_UTF_SUCCESS(c32CodePoint));
+		const auto c32Status = ::_MCFCRT_TranscodeUtf16ToUtf8(&pchWrite, u8sDst.GetEnd(), &pc16Read, u16svSrc.GetEnd(), 0);
+		if(c32Status != _MCFCRT_UTF_NO_DATA){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Utf8String: _MCFCRT_TranscodeUtf16ToUtf8() 失败。"));
 		}
 		u8sDst.Pop(static_cast<std::size_t>(u8sDst.GetEnd() - pchWrite));
 	} catch(...){
@@ -84,14 +74,9 @@ void Utf8String::UnifyAppend(Utf32String &u32sDst, const Utf8StringView &u8svSrc
 	try {
 		auto pc32Write = pc32WriteBegin;
 		auto pchRead = u8svSrc.GetBegin();
-		const auto pchReadEnd = u8svSrc.GetEnd();
-		while(pchRead < pchReadEnd){
-			auto c32CodePoint = ::_MCFCRT_DecodeUtf8(&pchRead, pchReadEnd, false);
-			if(!_MCFCRT_UTF_SUCCESS(c32CodePoint)){
-				MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Utf8String: _MCFCRT_DecodeUtf8() 失败。"));
-			}
-			c32CodePoint = ::_MCFCRT_UncheckedEncodeUtf32(&pc32Write, c32CodePoint, true);
-			MCF_ASSERT(_MCFCRT_UTF_SUCCESS(c32CodePoint));
+		const auto c32Status = ::_MCFCRT_TranscodeUtf8ToUtf32(&pc32Write, u32sDst.GetEnd(), &pchRead, u8svSrc.GetEnd(), 0);
+		if(c32Status != _MCFCRT_UTF_NO_DATA){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Utf8String: _MCFCRT_TranscodeUtf8ToUtf32() 失败。"));
 		}
 		u32sDst.Pop(static_cast<std::size_t>(u32sDst.GetEnd() - pc32Write));
 	} catch(...){
@@ -106,14 +91,9 @@ void Utf8String::DeunifyAppend(Utf8String &u8sDst, const Utf32StringView &u32svS
 	try {
 		auto pchWrite = pchWriteBegin;
 		auto pc32Read = u32svSrc.GetBegin();
-		const auto pc32ReadEnd = u32svSrc.GetEnd();
-		while(pc32Read < pc32ReadEnd){
-			auto c32CodePoint = ::_MCFCRT_DecodeUtf32(&pc32Read, pc32ReadEnd, false);
-			if(!_MCFCRT_UTF_SUCCESS(c32CodePoint)){
-				MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Utf8String: _MCFCRT_DecodeUtf32() 失败。"));
-			}
-			c32CodePoint = ::_MCFCRT_UncheckedEncodeUtf8(&pchWrite, c32CodePoint, true);
-			MCF_ASSERT(_MCFCRT_UTF_SUCCESS(c32CodePoint));
+		const auto c32Status = ::_MCFCRT_TranscodeUtf32ToUtf8(&pchWrite, u8sDst.GetEnd(), &pc32Read, u32svSrc.GetEnd(), 0);
+		if(c32Status != _MCFCRT_UTF_NO_DATA){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Utf8String: _MCFCRT_TranscodeUtf32ToUtf8() 失败。"));
 		}
 		u8sDst.Pop(static_cast<std::size_t>(u8sDst.GetEnd() - pchWrite));
 	} catch(...){
@@ -130,14 +110,9 @@ void Utf16String::UnifyAppend(Utf16String &u16sDst, const Utf16StringView &u16sv
 	try {
 		auto pc16Write = pc16WriteBegin;
 		auto pc16Read = u16svSrc.GetBegin();
-		const auto pc16ReadEnd = u16svSrc.GetEnd();
-		while(pc16Read < pc16ReadEnd){
-			auto c32CodePoint = ::_MCFCRT_DecodeUtf16(&pc16Read, pc16ReadEnd, false);
-			if(!_MCFCRT_UTF_SUCCESS(c32CodePoint)){
-				MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Utf16String: _MCFCRT_DecodeUtf16() 失败。"));
-			}
-			c32CodePoint = ::_MCFCRT_UncheckedEncodeUtf16(&pc16Write, c32CodePoint, true);
-			MCF_ASSERT(_MCFCRT_UTF_SUCCESS(c32CodePoint));
+		const auto c32Status = ::_MCFCRT_TranscodeUtf16ToUtf16(&pc16Write, u16sDst.GetEnd(), &pc16Read, u16svSrc.GetEnd(), 0);
+		if(c32Status != _MCFCRT_UTF_NO_DATA){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Utf16String: _MCFCRT_TranscodeUtf16ToUtf16() 失败。"));
 		}
 		u16sDst.Pop(static_cast<std::size_t>(u16sDst.GetEnd() - pc16Write));
 	} catch(...){
@@ -152,14 +127,9 @@ void Utf16String::DeunifyAppend(Utf16String &u16sDst, const Utf16StringView &u16
 	try {
 		auto pc16Write = pc16WriteBegin;
 		auto pc16Read = u16svSrc.GetBegin();
-		const auto pc16ReadEnd = u16svSrc.GetEnd();
-		while(pc16Read < pc16ReadEnd){
-			auto c32CodePoint = ::_MCFCRT_DecodeUtf16(&pc16Read, pc16ReadEnd, false);
-			if(!_MCFCRT_UTF_SUCCESS(c32CodePoint)){
-				MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Utf16String: _MCFCRT_DecodeUtf16() 失败。"));
-			}
-			c32CodePoint = ::_MCFCRT_UncheckedEncodeUtf16(&pc16Write, c32CodePoint, true);
-			MCF_ASSERT(_MCFCRT_UTF_SUCCESS(c32CodePoint));
+		const auto c32Status = ::_MCFCRT_TranscodeUtf16ToUtf16(&pc16Write, u16sDst.GetEnd(), &pc16Read, u16svSrc.GetEnd(), 0);
+		if(c32Status != _MCFCRT_UTF_NO_DATA){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Utf16String: _MCFCRT_TranscodeUtf16ToUtf16() 失败。"));
 		}
 		u16sDst.Pop(static_cast<std::size_t>(u16sDst.GetEnd() - pc16Write));
 	} catch(...){
@@ -175,14 +145,9 @@ void Utf16String::UnifyAppend(Utf32String &u32sDst, const Utf16StringView &u16sv
 	try {
 		auto pc32Write = pc32WriteBegin;
 		auto pc16Read = u16svSrc.GetBegin();
-		const auto pc16ReadEnd = u16svSrc.GetEnd();
-		while(pc16Read < pc16ReadEnd){
-			auto c32CodePoint = ::_MCFCRT_DecodeUtf16(&pc16Read, pc16ReadEnd, false);
-			if(!_MCFCRT_UTF_SUCCESS(c32CodePoint)){
-				MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Utf16String: _MCFCRT_DecodeUtf16() 失败。"));
-			}
-			c32CodePoint = ::_MCFCRT_UncheckedEncodeUtf32(&pc32Write, c32CodePoint, true);
-			MCF_ASSERT(_MCFCRT_UTF_SUCCESS(c32CodePoint));
+		const auto c32Status = ::_MCFCRT_TranscodeUtf16ToUtf32(&pc32Write, u32sDst.GetEnd(), &pc16Read, u16svSrc.GetEnd(), 0);
+		if(c32Status != _MCFCRT_UTF_NO_DATA){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Utf16String: _MCFCRT_TranscodeUtf16ToUtf32() 失败。"));
 		}
 		u32sDst.Pop(static_cast<std::size_t>(u32sDst.GetEnd() - pc32Write));
 	} catch(...){
@@ -197,14 +162,9 @@ void Utf16String::DeunifyAppend(Utf16String &u16sDst, const Utf32StringView &u32
 	try {
 		auto pc16Write = pc16WriteBegin;
 		auto pc32Read = u32svSrc.GetBegin();
-		const auto pc32ReadEnd = u32svSrc.GetEnd();
-		while(pc32Read < pc32ReadEnd){
-			auto c32CodePoint = ::_MCFCRT_DecodeUtf32(&pc32Read, pc32ReadEnd, false);
-			if(!_MCFCRT_UTF_SUCCESS(c32CodePoint)){
-				MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Utf16String: _MCFCRT_DecodeUtf32() 失败。"));
-			}
-			c32CodePoint = ::_MCFCRT_UncheckedEncodeUtf16(&pc16Write, c32CodePoint, true);
-			MCF_ASSERT(_MCFCRT_UTF_SUCCESS(c32CodePoint));
+		const auto c32Status = ::_MCFCRT_TranscodeUtf32ToUtf16(&pc16Write, u16sDst.GetEnd(), &pc32Read, u32svSrc.GetEnd(), 0);
+		if(c32Status != _MCFCRT_UTF_NO_DATA){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Utf16String: _MCFCRT_TranscodeUtf32ToUtf16() 失败。"));
 		}
 		u16sDst.Pop(static_cast<std::size_t>(u16sDst.GetEnd() - pc16Write));
 	} catch(...){
@@ -221,14 +181,9 @@ void Utf32String::UnifyAppend(Utf16String &u16sDst, const Utf32StringView &u32sv
 	try {
 		auto pc16Write = pc16WriteBegin;
 		auto pc32Read = u32svSrc.GetBegin();
-		const auto pc32ReadEnd = u32svSrc.GetEnd();
-		while(pc32Read < pc32ReadEnd){
-			auto c32CodePoint = ::_MCFCRT_DecodeUtf32(&pc32Read, pc32ReadEnd, false);
-			if(!_MCFCRT_UTF_SUCCESS(c32CodePoint)){
-				MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Utf32String: _MCFCRT_DecodeUtf32() 失败。"));
-			}
-			c32CodePoint = ::_MCFCRT_UncheckedEncodeUtf16(&pc16Write, c32CodePoint, true);
-			MCF_ASSERT(_MCFCRT_UTF_SUCCESS(c32CodePoint));
+		const auto c32Status = ::_MCFCRT_TranscodeUtf32ToUtf16(&pc16Write, u16sDst.GetEnd(), &pc32Read, u32svSrc.GetEnd(), 0);
+		if(c32Status != _MCFCRT_UTF_NO_DATA){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Utf32String: _MCFCRT_TranscodeUtf32ToUtf16() 失败。"));
 		}
 		u16sDst.Pop(static_cast<std::size_t>(u16sDst.GetEnd() - pc16Write));
 	} catch(...){
@@ -243,14 +198,9 @@ void Utf32String::DeunifyAppend(Utf32String &u32sDst, const Utf16StringView &u16
 	try {
 		auto pc32Write = pc32WriteBegin;
 		auto pc16Read = u16svSrc.GetBegin();
-		const auto pc16ReadEnd = u16svSrc.GetEnd();
-		while(pc16Read < pc16ReadEnd){
-			auto c32CodePoint = ::_MCFCRT_DecodeUtf16(&pc16Read, pc16ReadEnd, false);
-			if(!_MCFCRT_UTF_SUCCESS(c32CodePoint)){
-				MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Utf32String: _MCFCRT_DecodeUtf16() 失败。"));
-			}
-			c32CodePoint = ::_MCFCRT_UncheckedEncodeUtf32(&pc32Write, c32CodePoint, true);
-			MCF_ASSERT(_MCFCRT_UTF_SUCCESS(c32CodePoint));
+		const auto c32Status = ::_MCFCRT_TranscodeUtf16ToUtf32(&pc32Write, u32sDst.GetEnd(), &pc16Read, u16svSrc.GetEnd(), 0);
+		if(c32Status != _MCFCRT_UTF_NO_DATA){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Utf32String: _MCFCRT_TranscodeUtf16ToUtf32() 失败。"));
 		}
 		u32sDst.Pop(static_cast<std::size_t>(u32sDst.GetEnd() - pc32Write));
 	} catch(...){
@@ -266,14 +216,9 @@ void Utf32String::UnifyAppend(Utf32String &u32sDst, const Utf32StringView &u32sv
 	try {
 		auto pc32Write = pc32WriteBegin;
 		auto pc32Read = u32svSrc.GetBegin();
-		const auto pc32ReadEnd = u32svSrc.GetEnd();
-		while(pc32Read < pc32ReadEnd){
-			auto c32CodePoint = ::_MCFCRT_DecodeUtf32(&pc32Read, pc32ReadEnd, false);
-			if(!_MCFCRT_UTF_SUCCESS(c32CodePoint)){
-				MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Utf32String: _MCFCRT_DecodeUtf32() 失败。"));
-			}
-			c32CodePoint = ::_MCFCRT_UncheckedEncodeUtf32(&pc32Write, c32CodePoint, true);
-			MCF_ASSERT(_MCFCRT_UTF_SUCCESS(c32CodePoint));
+		const auto c32Status = ::_MCFCRT_TranscodeUtf32ToUtf32(&pc32Write, u32sDst.GetEnd(), &pc32Read, u32svSrc.GetEnd(), 0);
+		if(c32Status != _MCFCRT_UTF_NO_DATA){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Utf32String: _MCFCRT_TranscodeUtf32ToUtf32() 失败。"));
 		}
 		u32sDst.Pop(static_cast<std::size_t>(u32sDst.GetEnd() - pc32Write));
 	} catch(...){
@@ -288,14 +233,9 @@ void Utf32String::DeunifyAppend(Utf32String &u32sDst, const Utf32StringView &u32
 	try {
 		auto pc32Write = pc32WriteBegin;
 		auto pc32Read = u32svSrc.GetBegin();
-		const auto pc32ReadEnd = u32svSrc.GetEnd();
-		while(pc32Read < pc32ReadEnd){
-			auto c32CodePoint = ::_MCFCRT_DecodeUtf32(&pc32Read, pc32ReadEnd, false);
-			if(!_MCFCRT_UTF_SUCCESS(c32CodePoint)){
-				MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Utf32String: _MCFCRT_DecodeUtf32() 失败。"));
-			}
-			c32CodePoint = ::_MCFCRT_UncheckedEncodeUtf32(&pc32Write, c32CodePoint, true);
-			MCF_ASSERT(_MCFCRT_UTF_SUCCESS(c32CodePoint));
+		const auto c32Status = ::_MCFCRT_TranscodeUtf32ToUtf32(&pc32Write, u32sDst.GetEnd(), &pc32Read, u32svSrc.GetEnd(), 0);
+		if(c32Status != _MCFCRT_UTF_NO_DATA){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Utf32String: _MCFCRT_TranscodeUtf32ToUtf32() 失败。"));
 		}
 		u32sDst.Pop(static_cast<std::size_t>(u32sDst.GetEnd() - pc32Write));
 	} catch(...){
@@ -312,14 +252,9 @@ void Cesu8String::UnifyAppend(Utf16String &u16sDst, const Cesu8StringView &u8svS
 	try {
 		auto pc16Write = pc16WriteBegin;
 		auto pchRead = u8svSrc.GetBegin();
-		const auto pchReadEnd = u8svSrc.GetEnd();
-		while(pchRead < pchReadEnd){
-			auto c32CodePoint = ::_MCFCRT_DecodeCesu8(&pchRead, pchReadEnd, false);
-			if(!_MCFCRT_UTF_SUCCESS(c32CodePoint)){
-				MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Cesu8String: _MCFCRT_DecodeCesu8() 失败。"));
-			}
-			c32CodePoint = ::_MCFCRT_UncheckedEncodeUtf16(&pc16Write, c32CodePoint, true);
-			MCF_ASSERT(_MCFCRT_UTF_SUCCESS(c32CodePoint));
+		const auto c32Status = ::_MCFCRT_TranscodeCesu8ToUtf16(&pc16Write, u16sDst.GetEnd(), &pchRead, u8svSrc.GetEnd(), 0);
+		if(c32Status != _MCFCRT_UTF_NO_DATA){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Cesu8String: _MCFCRT_TranscodeCesu8ToUtf16() 失败。"));
 		}
 		u16sDst.Pop(static_cast<std::size_t>(u16sDst.GetEnd() - pc16Write));
 	} catch(...){
@@ -334,14 +269,9 @@ void Cesu8String::DeunifyAppend(Cesu8String &u8sDst, const Utf16StringView &u16s
 	try {
 		auto pchWrite = pchWriteBegin;
 		auto pc16Read = u16svSrc.GetBegin();
-		const auto pc16ReadEnd = u16svSrc.GetEnd();
-		while(pc16Read < pc16ReadEnd){
-			auto c32CodePoint = ::_MCFCRT_DecodeUtf16(&pc16Read, pc16ReadEnd, false);
-			if(!_MCFCRT_UTF_SUCCESS(c32CodePoint)){
-				MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Cesu8String: _MCFCRT_DecodeUtf16() 失败。"));
-			}
-			c32CodePoint = ::_MCFCRT_UncheckedEncodeCesu8(&pchWrite, c32CodePoint, true);
-			MCF_ASSERT(_MCFCRT_UTF_SUCCESS(c32CodePoint));
+		const auto c32Status = ::_MCFCRT_TranscodeUtf16ToCesu8(&pchWrite, u8sDst.GetEnd(), &pc16Read, u16svSrc.GetEnd(), 0);
+		if(c32Status != _MCFCRT_UTF_NO_DATA){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Cesu8String: _MCFCRT_TranscodeUtf16ToCesu8() 失败。"));
 		}
 		u8sDst.Pop(static_cast<std::size_t>(u8sDst.GetEnd() - pchWrite));
 	} catch(...){
@@ -357,14 +287,9 @@ void Cesu8String::UnifyAppend(Utf32String &u32sDst, const Cesu8StringView &u8svS
 	try {
 		auto pc32Write = pc32WriteBegin;
 		auto pchRead = u8svSrc.GetBegin();
-		const auto pchReadEnd = u8svSrc.GetEnd();
-		while(pchRead < pchReadEnd){
-			auto c32CodePoint = ::_MCFCRT_DecodeCesu8(&pchRead, pchReadEnd, false);
-			if(!_MCFCRT_UTF_SUCCESS(c32CodePoint)){
-				MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Cesu8String: _MCFCRT_DecodeCesu8() 失败。"));
-			}
-			c32CodePoint = ::_MCFCRT_UncheckedEncodeUtf32(&pc32Write, c32CodePoint, true);
-			MCF_ASSERT(_MCFCRT_UTF_SUCCESS(c32CodePoint));
+		const auto c32Status = ::_MCFCRT_TranscodeCesu8ToUtf32(&pc32Write, u32sDst.GetEnd(), &pchRead, u8svSrc.GetEnd(), 0);
+		if(c32Status != _MCFCRT_UTF_NO_DATA){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Cesu8String: _MCFCRT_TranscodeCesu8ToUtf32() 失败。"));
 		}
 		u32sDst.Pop(static_cast<std::size_t>(u32sDst.GetEnd() - pc32Write));
 	} catch(...){
@@ -379,14 +304,9 @@ void Cesu8String::DeunifyAppend(Cesu8String &u8sDst, const Utf32StringView &u32s
 	try {
 		auto pchWrite = pchWriteBegin;
 		auto pc32Read = u32svSrc.GetBegin();
-		const auto pc32ReadEnd = u32svSrc.GetEnd();
-		while(pc32Read < pc32ReadEnd){
-			auto c32CodePoint = ::_MCFCRT_DecodeUtf32(&pc32Read, pc32ReadEnd, false);
-			if(!_MCFCRT_UTF_SUCCESS(c32CodePoint)){
-				MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Cesu8String: _MCFCRT_DecodeUtf32() 失败。"));
-			}
-			c32CodePoint = ::_MCFCRT_UncheckedEncodeCesu8(&pchWrite, c32CodePoint, true);
-			MCF_ASSERT(_MCFCRT_UTF_SUCCESS(c32CodePoint));
+		const auto c32Status = ::_MCFCRT_TranscodeUtf32ToCesu8(&pchWrite, u8sDst.GetEnd(), &pc32Read, u32svSrc.GetEnd(), 0);
+		if(c32Status != _MCFCRT_UTF_NO_DATA){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Cesu8String: _MCFCRT_TranscodeUtf32ToCesu8() 失败。"));
 		}
 		u8sDst.Pop(static_cast<std::size_t>(u8sDst.GetEnd() - pchWrite));
 	} catch(...){
@@ -470,24 +390,9 @@ void ModifiedUtf8String::UnifyAppend(Utf16String &u16sDst, const ModifiedUtf8Str
 	try {
 		auto pc16Write = pc16WriteBegin;
 		auto pchRead = u8svSrc.GetBegin();
-		const auto pchReadEnd = u8svSrc.GetEnd();
-		while(pchRead < pchReadEnd){
-			const unsigned uFirst = static_cast<unsigned char>(*pchRead);
-			if(uFirst == 0x00){
-				MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"ModifiedUtf8String: 输入的字符串不合法。"));
-			}
-			char32_t c32CodePoint;
-			if((uFirst == 0xC0) && (pchReadEnd - pchRead >= 1) && (static_cast<unsigned char>(pchRead[1]) == 0x80)){
-				pchRead += 2;
-				c32CodePoint = 0;
-			} else {
-				c32CodePoint = ::_MCFCRT_DecodeCesu8(&pchRead, pchReadEnd, false);
-				if(!_MCFCRT_UTF_SUCCESS(c32CodePoint)){
-					MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"ModifiedUtf8String: _MCFCRT_DecodeCesu8() 失败。"));
-				}
-			}
-			c32CodePoint = ::_MCFCRT_UncheckedEncodeUtf16(&pc16Write, c32CodePoint, true);
-			MCF_ASSERT(_MCFCRT_UTF_SUCCESS(c32CodePoint));
+		const auto c32Status = ::_MCFCRT_TranscodeModifiedUtf8ToUtf16(&pc16Write, u16sDst.GetEnd(), &pchRead, u8svSrc.GetEnd(), 0);
+		if(c32Status != _MCFCRT_UTF_NO_DATA){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"ModifiedUtf8String: _MCFCRT_TranscodeModifiedUtf8ToUtf16() 失败。"));
 		}
 		u16sDst.Pop(static_cast<std::size_t>(u16sDst.GetEnd() - pc16Write));
 	} catch(...){
@@ -502,19 +407,9 @@ void ModifiedUtf8String::DeunifyAppend(ModifiedUtf8String &u8sDst, const Utf16St
 	try {
 		auto pchWrite = pchWriteBegin;
 		auto pc16Read = u16svSrc.GetBegin();
-		const auto pc16ReadEnd = u16svSrc.GetEnd();
-		while(pc16Read < pc16ReadEnd){
-			auto c32CodePoint = ::_MCFCRT_DecodeUtf16(&pc16Read, pc16ReadEnd, false);
-			if(!_MCFCRT_UTF_SUCCESS(c32CodePoint)){
-				MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"ModifiedUtf8String: _MCFCRT_DecodeUtf16() 失败。"));
-			}
-			if(c32CodePoint == 0){
-				*(pchWrite++) = (char)0xC0;
-				*(pchWrite++) = (char)0x80;
-			} else {
-				c32CodePoint = ::_MCFCRT_UncheckedEncodeCesu8(&pchWrite, c32CodePoint, true);
-				MCF_ASSERT(_MCFCRT_UTF_SUCCESS(c32CodePoint));
-			}
+		const auto c32Status = ::_MCFCRT_TranscodeUtf16ToModifiedUtf8(&pchWrite, u8sDst.GetEnd(), &pc16Read, u16svSrc.GetEnd(), 0);
+		if(c32Status != _MCFCRT_UTF_NO_DATA){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"ModifiedUtf8String: _MCFCRT_TranscodeUtf16ToModifiedUtf8() 失败。"));
 		}
 		u8sDst.Pop(static_cast<std::size_t>(u8sDst.GetEnd() - pchWrite));
 	} catch(...){
@@ -530,24 +425,9 @@ void ModifiedUtf8String::UnifyAppend(Utf32String &u32sDst, const ModifiedUtf8Str
 	try {
 		auto pc32Write = pc32WriteBegin;
 		auto pchRead = u8svSrc.GetBegin();
-		const auto pchReadEnd = u8svSrc.GetEnd();
-		while(pchRead < pchReadEnd){
-			const unsigned uFirst = static_cast<unsigned char>(*pchRead);
-			if(uFirst == 0x00){
-				MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"ModifiedUtf8String: 输入的字符串不合法。"));
-			}
-			char32_t c32CodePoint;
-			if((uFirst == 0xC0) && (pchReadEnd - pchRead >= 1) && (static_cast<unsigned char>(pchRead[1]) == 0x80)){
-				pchRead += 2;
-				c32CodePoint = 0;
-			} else {
-				c32CodePoint = ::_MCFCRT_DecodeCesu8(&pchRead, pchReadEnd, false);
-				if(!_MCFCRT_UTF_SUCCESS(c32CodePoint)){
-					MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"ModifiedUtf8String: _MCFCRT_DecodeCesu8() 失败。"));
-				}
-			}
-			c32CodePoint = ::_MCFCRT_UncheckedEncodeUtf32(&pc32Write, c32CodePoint, true);
-			MCF_ASSERT(_MCFCRT_UTF_SUCCESS(c32CodePoint));
+		const auto c32Status = ::_MCFCRT_TranscodeModifiedUtf8ToUtf32(&pc32Write, u32sDst.GetEnd(), &pchRead, u8svSrc.GetEnd(), 0);
+		if(c32Status != _MCFCRT_UTF_NO_DATA){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"ModifiedUtf8String: _MCFCRT_TranscodeModifiedUtf8ToUtf32() 失败。"));
 		}
 		u32sDst.Pop(static_cast<std::size_t>(u32sDst.GetEnd() - pc32Write));
 	} catch(...){
@@ -562,19 +442,9 @@ void ModifiedUtf8String::DeunifyAppend(ModifiedUtf8String &u8sDst, const Utf32St
 	try {
 		auto pchWrite = pchWriteBegin;
 		auto pc32Read = u32svSrc.GetBegin();
-		const auto pc32ReadEnd = u32svSrc.GetEnd();
-		while(pc32Read < pc32ReadEnd){
-			auto c32CodePoint = ::_MCFCRT_DecodeUtf32(&pc32Read, pc32ReadEnd, false);
-			if(!_MCFCRT_UTF_SUCCESS(c32CodePoint)){
-				MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"ModifiedUtf8String: _MCFCRT_DecodeUtf32() 失败。"));
-			}
-			if(c32CodePoint == 0){
-				*(pchWrite++) = (char)0xC0;
-				*(pchWrite++) = (char)0x80;
-			} else {
-				c32CodePoint = ::_MCFCRT_UncheckedEncodeCesu8(&pchWrite, c32CodePoint, true);
-				MCF_ASSERT(_MCFCRT_UTF_SUCCESS(c32CodePoint));
-			}
+		const auto c32Status = ::_MCFCRT_TranscodeUtf32ToModifiedUtf8(&pchWrite, u8sDst.GetEnd(), &pc32Read, u32svSrc.GetEnd(), 0);
+		if(c32Status != _MCFCRT_UTF_NO_DATA){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"ModifiedUtf8String: _MCFCRT_TranscodeUtf32ToModifiedUtf8() 失败。"));
 		}
 		u8sDst.Pop(static_cast<std::size_t>(u8sDst.GetEnd() - pchWrite));
 	} catch(...){
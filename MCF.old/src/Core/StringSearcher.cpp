@@ -0,0 +1,18 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "StringSearcher.hpp"
+
+namespace MCF {
+
+template class StringSearcher<Impl_StringTraits::Type::kUtf8>;
+template class StringSearcher<Impl_StringTraits::Type::kUtf16>;
+template class StringSearcher<Impl_StringTraits::Type::kUtf32>;
+template class StringSearcher<Impl_StringTraits::Type::kCesu8>;
+template class StringSearcher<Impl_StringTraits::Type::kAnsi>;
+template class StringSearcher<Impl_StringTraits::Type::kModifiedUtf8>;
+template class StringSearcher<Impl_StringTraits::Type::kNarrow>;
+template class StringSearcher<Impl_StringTraits::Type::kWide>;
+
+}
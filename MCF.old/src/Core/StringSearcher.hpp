@@ -0,0 +1,94 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_CORE_STRING_SEARCHER_HPP_
+#define MCF_CORE_STRING_SEARCHER_HPP_
+
+#include "_StringTraits.hpp"
+#include "StringView.hpp"
+#include "Assert.hpp"
+#include <cstddef>
+
+namespace MCF {
+
+// 预处理一个模式串，然后在多个文本中查找它。
+// 短模式串使用 SIMD 比较首尾字符，长模式串使用预先建好的 Boyer-Moore 表。
+// 模式串的存储不归搜索器所有，其生存期必须长于搜索器。
+template<Impl_StringTraits::Type kTypeT>
+class StringSearcher {
+public:
+	enum : std::size_t { kNpos = StringView<kTypeT>::kNpos };
+
+	using Char = typename StringView<kTypeT>::Char;
+
+private:
+	StringView<kTypeT> x_svPattern;
+	Impl_StringTraits::BoyerMooreTables x_vTables;
+
+public:
+	explicit StringSearcher(const StringView<kTypeT> &svPattern) noexcept
+		: x_svPattern(svPattern)
+	{
+		const auto nPatternLength = static_cast<std::ptrdiff_t>(x_svPattern.GetSize());
+		if(nPatternLength > Impl_StringTraits::kShortPatternLengthMax){
+			Impl_StringTraits::BuildBoyerMooreTables(x_vTables, x_svPattern.GetBegin(), nPatternLength);
+		}
+	}
+
+public:
+	const StringView<kTypeT> &GetPattern() const noexcept {
+		return x_svPattern;
+	}
+
+	const Char *Search(const Char *pchTextBegin, const Char *pchTextEnd) const noexcept {
+		const auto nPatternLength = static_cast<std::ptrdiff_t>(x_svPattern.GetSize());
+		if(nPatternLength == 0){
+			return pchTextBegin;
+		}
+		if(nPatternLength <= Impl_StringTraits::kShortPatternLengthMax){
+			return Impl_StringTraits::FindSpanShort(pchTextBegin, pchTextEnd, x_svPattern.GetBegin(), nPatternLength);
+		}
+		if(pchTextEnd - pchTextBegin < nPatternLength){
+			return pchTextEnd;
+		}
+		return Impl_StringTraits::SearchBoyerMoore(x_vTables, pchTextBegin, pchTextEnd, x_svPattern.GetBegin(), nPatternLength);
+	}
+	// 语义同 StringView::Find()。
+	std::size_t Find(const StringView<kTypeT> &svText, std::ptrdiff_t nBegin = 0) const noexcept {
+		auto uRealBegin = static_cast<std::size_t>(nBegin);
+		if(nBegin < 0){
+			uRealBegin += svText.GetSize() + 1;
+		}
+		MCF_DEBUG_CHECK(uRealBegin <= svText.GetSize());
+		const auto pchRealBegin = svText.GetBegin() + uRealBegin;
+		const auto pchRealEnd = svText.GetEnd();
+		const auto pchPosition = Search(pchRealBegin, pchRealEnd);
+		if((pchPosition == pchRealEnd) && !x_svPattern.IsEmpty()){
+			return kNpos;
+		}
+		return static_cast<std::size_t>(pchPosition - pchRealBegin);
+	}
+};
+
+extern template class StringSearcher<Impl_StringTraits::Type::kUtf8>;
+extern template class StringSearcher<Impl_StringTraits::Type::kUtf16>;
+extern template class StringSearcher<Impl_StringTraits::Type::kUtf32>;
+extern template class StringSearcher<Impl_StringTraits::Type::kCesu8>;
+extern template class StringSearcher<Impl_StringTraits::Type::kAnsi>;
+extern template class StringSearcher<Impl_StringTraits::Type::kModifiedUtf8>;
+extern template class StringSearcher<Impl_StringTraits::Type::kNarrow>;
+extern template class StringSearcher<Impl_StringTraits::Type::kWide>;
+
+using Utf8StringSearcher         = StringSearcher<Impl_StringTraits::Type::kUtf8>;
+using Utf16StringSearcher        = StringSearcher<Impl_StringTraits::Type::kUtf16>;
+using Utf32StringSearcher        = StringSearcher<Impl_StringTraits::Type::kUtf32>;
+using Cesu8StringSearcher        = StringSearcher<Impl_StringTraits::Type::kCesu8>;
+using AnsiStringSearcher         = StringSearcher<Impl_StringTraits::Type::kAnsi>;
+using ModifiedUtf8StringSearcher = StringSearcher<Impl_StringTraits::Type::kModifiedUtf8>;
+using NarrowStringSearcher       = StringSearcher<Impl_StringTraits::Type::kNarrow>;
+using WideStringSearcher         = StringSearcher<Impl_StringTraits::Type::kWide>;
+
+}
+
+#endif
@@ -254,7 +254,13 @@ public:
 		const auto uRealBegin = X_TranslateOffset(nBegin, GetLength());
 		const auto itRealBegin = GetBegin() + uRealBegin;
 		const auto itRealEnd = GetEnd();
-		const auto itPosition = Impl_StringTraits::FindSpan(itRealBegin, itRealEnd, svToFind.GetBegin(), svToFind.GetEnd());
+		const auto nPatternLength = svToFind.GetEnd() - svToFind.GetBegin();
+		const Char *itPosition;
+		if((nPatternLength > 0) && (nPatternLength <= Impl_StringTraits::kShortPatternLengthMax)){
+			itPosition = Impl_StringTraits::FindSpanShort(itRealBegin, itRealEnd, svToFind.GetBegin(), nPatternLength);
+		} else {
+			itPosition = Impl_StringTraits::FindSpan(itRealBegin, itRealEnd, svToFind.GetBegin(), svToFind.GetEnd());
+		}
 		if(itPosition == itRealEnd){
 			return kNpos;
 		}
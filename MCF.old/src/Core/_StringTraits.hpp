@@ -8,6 +8,9 @@
 #include <MCFCRT/env/expect.h>
 #include <type_traits>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <emmintrin.h>
 
 namespace MCF {
 
@@ -112,36 +115,34 @@ namespace Impl_StringTraits {
 		}
 	}
 
-	template<typename TextBeginT, typename TextEndT, typename PatternBeginT, typename PatternEndT>
-	TextBeginT FindSpan(TextBeginT itTextBegin, TextEndT itTextEnd, PatternBeginT itPatternBegin, PatternEndT itPatternEnd){
-		const auto nPatternLength = static_cast<std::ptrdiff_t>(itPatternEnd - itPatternBegin);
-		if(nPatternLength < 0){
-			return itTextEnd;
-		}
-		if(nPatternLength == 0){
-			return itTextBegin;
-		}
-		const auto nTextCount = static_cast<std::ptrdiff_t>(itTextEnd - itTextBegin);
-		if(nTextCount < nPatternLength){
-			return itTextEnd;
-		}
+	// https://en.wikipedia.org/wiki/Boyer-Moore-Horspool_algorithm
+	// https://en.wikipedia.org/wiki/Boyer-Moore_string_search_algorithm
+	// We store the offsets as small integers using saturation arithmetic for space efficiency. Bits that do not fit into a byte are truncated.
+	struct BoyerMooreTables {
+		enum : unsigned short {
+			kBcrTableSize = 256,
+			kGsrTableSize = 512,
+		};
 
-		// https://en.wikipedia.org/wiki/Boyer-Moore-Horspool_algorithm
-		// We store the offsets as small integers using saturation arithmetic for space efficiency. Bits that do not fit into a byte are truncated.
-		constexpr unsigned short kBcrTableSize = 256;
 		__attribute__((__aligned__(64))) short ashBcrTable[kBcrTableSize];
+		__attribute__((__aligned__(64))) short ashGsrTable[kGsrTableSize];
+		std::ptrdiff_t nGsrTableSize;
+	};
+
+	template<typename PatternBeginT>
+	void BuildBoyerMooreTables(BoyerMooreTables &vTables, PatternBeginT itPatternBegin, std::ptrdiff_t nPatternLength){
+		constexpr auto kBcrTableSize = BoyerMooreTables::kBcrTableSize;
 		const std::ptrdiff_t nMaxBcrShift = (nPatternLength <= 0x7FFF) ? nPatternLength : 0x7FFF;
 		for(unsigned uIndex = 0; uIndex < kBcrTableSize; ++uIndex){
-			ashBcrTable[uIndex] = static_cast<short>(nMaxBcrShift);
+			vTables.ashBcrTable[uIndex] = static_cast<short>(nMaxBcrShift);
 		}
 		for(std::ptrdiff_t nBcrShift = nMaxBcrShift - 1; nBcrShift > 0; --nBcrShift){
 			const auto chGoodChar = itPatternBegin[nPatternLength - nBcrShift - 1];
-			ashBcrTable[static_cast<std::make_unsigned_t<decltype(chGoodChar)>>(chGoodChar) % kBcrTableSize] = static_cast<short>(nBcrShift);
+			vTables.ashBcrTable[static_cast<std::make_unsigned_t<decltype(chGoodChar)>>(chGoodChar) % kBcrTableSize] = static_cast<short>(nBcrShift);
 		}
 
-		// https://en.wikipedia.org/wiki/Boyer-Moore_string_search_algorithm
 		// We create the GSR table from an intermediate table of suffix offsets.
-		constexpr unsigned short kGsrTableSize = 512;
+		constexpr auto kGsrTableSize = BoyerMooreTables::kGsrTableSize;
 		__attribute__((__aligned__(64))) short ashGsrOffsetTable[kGsrTableSize];
 		const auto nGsrTableSize = (nPatternLength <= kGsrTableSize) ? nPatternLength : static_cast<std::ptrdiff_t>(kGsrTableSize);
 		std::ptrdiff_t nGsrCandidateLength = 0;
@@ -161,9 +162,8 @@ namespace Impl_StringTraits {
 			}
 			ashGsrOffsetTable[nTestIndex] = static_cast<short>(nTestIndex - nGsrCandidateLength + 1);
 		}
-		__attribute__((__aligned__(64))) short ashGsrTable[kGsrTableSize];
 		const auto nMaxGsrShift = nGsrTableSize - nGsrCandidateLength;
-		ashGsrTable[0] = 0;
+		vTables.ashGsrTable[0] = 0;
 		for(std::ptrdiff_t nTestIndex = 1; nTestIndex < nGsrTableSize; ++nTestIndex){
 			std::ptrdiff_t nGsrShift = ashGsrOffsetTable[nTestIndex - 1];
 			if(nGsrShift != ashGsrOffsetTable[nTestIndex]){
@@ -172,14 +172,23 @@ namespace Impl_StringTraits {
 					if(nAdjustIndex <= 0){
 						break;
 					}
-					if(ashGsrTable[nAdjustIndex] > nGsrShift){
-						ashGsrTable[nAdjustIndex] = static_cast<short>(nGsrShift);
+					if(vTables.ashGsrTable[nAdjustIndex] > nGsrShift){
+						vTables.ashGsrTable[nAdjustIndex] = static_cast<short>(nGsrShift);
 					}
 					nGsrShift += ashGsrOffsetTable[nAdjustIndex - 1];
 				}
 			}
-			ashGsrTable[nTestIndex] = static_cast<short>(nMaxGsrShift);
+			vTables.ashGsrTable[nTestIndex] = static_cast<short>(nMaxGsrShift);
 		}
+		vTables.nGsrTableSize = nGsrTableSize;
+	}
+
+	// 模式串的长度必须为正数，并且不大于文本的长度。
+	template<typename TextBeginT, typename TextEndT, typename PatternBeginT>
+	TextBeginT SearchBoyerMoore(const BoyerMooreTables &vTables, TextBeginT itTextBegin, TextEndT itTextEnd, PatternBeginT itPatternBegin, std::ptrdiff_t nPatternLength){
+		constexpr auto kBcrTableSize = BoyerMooreTables::kBcrTableSize;
+		const auto nTextCount = static_cast<std::ptrdiff_t>(itTextEnd - itTextBegin);
+		const auto nGsrTableSize = vTables.nGsrTableSize;
 
 		std::ptrdiff_t nOffset = 0;
 		std::ptrdiff_t nKnownMatchEnd = 0;
@@ -205,8 +214,8 @@ namespace Impl_StringTraits {
 				--nTestIndex;
 			}
 			const auto nSuffixLength = nPatternLength - nTestIndex - 1;
-			const std::ptrdiff_t nBcrShift = ashBcrTable[static_cast<std::make_unsigned_t<decltype(chLast)>>(chLast) % kBcrTableSize];
-			const std::ptrdiff_t nGsrShift = (nSuffixLength < nGsrTableSize) ? ashGsrTable[nSuffixLength] : 0;
+			const std::ptrdiff_t nBcrShift = vTables.ashBcrTable[static_cast<std::make_unsigned_t<decltype(chLast)>>(chLast) % kBcrTableSize];
+			const std::ptrdiff_t nGsrShift = (nSuffixLength < nGsrTableSize) ? vTables.ashGsrTable[nSuffixLength] : 0;
 			if(_MCFCRT_EXPECT(nBcrShift > nGsrShift)){
 				nOffset += nBcrShift;
 				nKnownMatchEnd = 0;
@@ -219,6 +228,104 @@ namespace Impl_StringTraits {
 		}
 	}
 
+	template<typename TextBeginT, typename TextEndT, typename PatternBeginT, typename PatternEndT>
+	TextBeginT FindSpan(TextBeginT itTextBegin, TextEndT itTextEnd, PatternBeginT itPatternBegin, PatternEndT itPatternEnd){
+		const auto nPatternLength = static_cast<std::ptrdiff_t>(itPatternEnd - itPatternBegin);
+		if(nPatternLength < 0){
+			return itTextEnd;
+		}
+		if(nPatternLength == 0){
+			return itTextBegin;
+		}
+		const auto nTextCount = static_cast<std::ptrdiff_t>(itTextEnd - itTextBegin);
+		if(nTextCount < nPatternLength){
+			return itTextEnd;
+		}
+
+		BoyerMooreTables vTables;
+		BuildBoyerMooreTables(vTables, itPatternBegin, nPatternLength);
+		return SearchBoyerMoore(vTables, itTextBegin, itTextEnd, itPatternBegin, nPatternLength);
+	}
+
+	//-----------------------------------------------------------------------------
+	// Short patterns
+	//-----------------------------------------------------------------------------
+
+	// 短模式串不需要建表。
+	// 我们用 SSE2 同时比较文本中每个位置上的第一个和最后一个字符，只有二者都匹配的位置才需要比较中间的字符。
+	// Wojciech Muła, SIMD-friendly algorithms for substring searching, <http://0x80.pl/articles/simd-strfind.html>.
+	enum : std::ptrdiff_t {
+		kShortPatternLengthMax = 32,
+	};
+
+	template<typename CharT>
+	__m128i BroadcastChar(CharT chValue) noexcept {
+		static_assert((sizeof(CharT) == 1) || (sizeof(CharT) == 2) || (sizeof(CharT) == 4), "Unsupported character size.");
+		if constexpr(sizeof(CharT) == 1){
+			return _mm_set1_epi8(static_cast<char>(chValue));
+		} else if constexpr(sizeof(CharT) == 2){
+			return _mm_set1_epi16(static_cast<short>(chValue));
+		} else {
+			return _mm_set1_epi32(static_cast<int>(chValue));
+		}
+	}
+	template<typename CharT>
+	__m128i CompareChars(__m128i xmmLhs, __m128i xmmRhs) noexcept {
+		if constexpr(sizeof(CharT) == 1){
+			return _mm_cmpeq_epi8(xmmLhs, xmmRhs);
+		} else if constexpr(sizeof(CharT) == 2){
+			return _mm_cmpeq_epi16(xmmLhs, xmmRhs);
+		} else {
+			return _mm_cmpeq_epi32(xmmLhs, xmmRhs);
+		}
+	}
+
+	// 模式串的长度必须为正数，并且不大于 kShortPatternLengthMax。
+	template<typename CharT>
+	const CharT *FindSpanShort(const CharT *pchTextBegin, const CharT *pchTextEnd, const CharT *pchPatternBegin, std::ptrdiff_t nPatternLength) noexcept {
+		constexpr std::ptrdiff_t kCharsPerWord = 16 / sizeof(CharT);
+		// 每个字符在 PMOVMSKB 的结果中占 sizeof(CharT) 位，我们只保留其中最低的一位。
+		constexpr std::uint32_t kMaskPerChar = (sizeof(CharT) == 1) ? 0xFFFF : ((sizeof(CharT) == 2) ? 0x5555 : 0x1111);
+
+		const auto nTextCount = pchTextEnd - pchTextBegin;
+		if(nTextCount < nPatternLength){
+			return pchTextEnd;
+		}
+		const auto chFirst = pchPatternBegin[0];
+		const auto chLast = pchPatternBegin[nPatternLength - 1];
+		const auto uMiddleBytes = static_cast<std::size_t>(nPatternLength - 1) * sizeof(CharT);
+
+		std::ptrdiff_t nOffset = 0;
+		const auto nLastOffset = nTextCount - nPatternLength;
+		if(nLastOffset + 1 >= kCharsPerWord){
+			const auto xmmFirst = BroadcastChar(chFirst);
+			const auto xmmLast = BroadcastChar(chLast);
+			do {
+				const auto xmmTextFirst = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pchTextBegin + nOffset));
+				const auto xmmTextLast = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pchTextBegin + nOffset + nPatternLength - 1));
+				const auto xmmMatch = _mm_and_si128(CompareChars<CharT>(xmmTextFirst, xmmFirst), CompareChars<CharT>(xmmTextLast, xmmLast));
+				auto u32Mask = static_cast<std::uint32_t>(_mm_movemask_epi8(xmmMatch)) & kMaskPerChar;
+				while(u32Mask != 0){
+					const auto nIndex = static_cast<std::ptrdiff_t>(static_cast<unsigned>(__builtin_ctz(u32Mask)) / sizeof(CharT));
+					const auto pchCandidate = pchTextBegin + nOffset + nIndex;
+					// 最后一个字符会被再比较一次，这样模式串只有一个字符时也不需要特殊处理。
+					if(std::memcmp(pchCandidate + 1, pchPatternBegin + 1, uMiddleBytes) == 0){
+						return pchCandidate;
+					}
+					u32Mask &= u32Mask - 1;
+				}
+				nOffset += kCharsPerWord;
+			} while(nLastOffset + 1 - nOffset >= kCharsPerWord);
+		}
+		for(; nOffset <= nLastOffset; ++nOffset){
+			const auto pchCandidate = pchTextBegin + nOffset;
+			if((pchCandidate[0] == chFirst) && (pchCandidate[nPatternLength - 1] == chLast) && (std::memcmp(pchCandidate + 1, pchPatternBegin + 1, uMiddleBytes) == 0)){
+				return pchCandidate;
+			}
+		}
+		return pchTextEnd;
+	}
+
 	template<typename TextBeginT, typename TextEndT, typename PatternT>
 	TextBeginT FindRepeat(TextBeginT itTextBegin, TextEndT itTextEnd, const PatternT &chPattern, std::size_t uPatternLength){
 		const auto nPatternLength = static_cast<std::ptrdiff_t>(uPatternLength);
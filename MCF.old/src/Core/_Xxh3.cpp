@@ -0,0 +1,490 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "_Xxh3.hpp"
+#include "Endian.hpp"
+#include <MCFCRT/env/cpu.h>
+#include <emmintrin.h>
+#include <immintrin.h>
+#include <cstring>
+
+// https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+// 1. 长度不超过 240 字节的数据使用几个固定的分支处理，不进入累加器。
+// 2. 更长的数据按照 64 字节分条（stripe），每条使用 8 个 64 位的累加器；每 16 条（一块）之后打乱一次累加器。
+//    累加器的计算只需要 32 位乘 32 位的乘法，使用 SSE2 时每次处理两个，使用 AVX2 时每次处理四个。
+
+namespace MCF {
+
+namespace Impl_Xxh3 {
+	namespace {
+		constexpr std::uint32_t kPrime32_1 = 0x9E3779B1;
+		constexpr std::uint32_t kPrime32_2 = 0x85EBCA77;
+		constexpr std::uint32_t kPrime32_3 = 0xC2B2AE3D;
+		constexpr std::uint64_t kPrime64_1 = 0x9E3779B185EBCA87;
+		constexpr std::uint64_t kPrime64_2 = 0xC2B2AE3D27D4EB4F;
+		constexpr std::uint64_t kPrime64_3 = 0x165667B19E3779F9;
+		constexpr std::uint64_t kPrime64_4 = 0x85EBCA77C2B2AE63;
+		constexpr std::uint64_t kPrime64_5 = 0x27D4EB2F165667C5;
+		constexpr std::uint64_t kPrimeMx1  = 0x165667919E3779F9;
+		constexpr std::uint64_t kPrimeMx2  = 0x9FB21C651E98DF25;
+
+		enum : std::size_t {
+			kStripeSize         = 64,
+			kSecretConsumeRate  = 8,
+			kStripesInBlock     = (Xxh3::kSecretSize - kStripeSize) / kSecretConsumeRate,
+			kStripesInBuffer    = Xxh3::kBufferSize / kStripeSize,
+			kMidSizeMax         = 240,
+			kSecretSizeMin      = 136,
+			kMidSizeStartOffset = 3,
+			kMidSizeLastOffset  = 17,
+			kLastStripeStart    = 7,
+			kMergeAccsStart     = 11,
+		};
+
+		alignas(16) constexpr unsigned char kDefaultSecret[Xxh3::kSecretSize] = {
+			0xB8, 0xFE, 0x6C, 0x39, 0x23, 0xA4, 0x4B, 0xBE, 0x7C, 0x01, 0x81, 0x2C, 0xF7, 0x21, 0xAD, 0x1C,
+			0xDE, 0xD4, 0x6D, 0xE9, 0x83, 0x90, 0x97, 0xDB, 0x72, 0x40, 0xA4, 0xA4, 0xB7, 0xB3, 0x67, 0x1F,
+			0xCB, 0x79, 0xE6, 0x4E, 0xCC, 0xC0, 0xE5, 0x78, 0x82, 0x5A, 0xD0, 0x7D, 0xCC, 0xFF, 0x72, 0x21,
+			0xB8, 0x08, 0x46, 0x74, 0xF7, 0x43, 0x24, 0x8E, 0xE0, 0x35, 0x90, 0xE6, 0x81, 0x3A, 0x26, 0x4C,
+			0x3C, 0x28, 0x52, 0xBB, 0x91, 0xC3, 0x00, 0xCB, 0x88, 0xD0, 0x65, 0x8B, 0x1B, 0x53, 0x2E, 0xA3,
+			0x71, 0x64, 0x48, 0x97, 0xA2, 0x0D, 0xF9, 0x4E, 0x38, 0x19, 0xEF, 0x46, 0xA9, 0xDE, 0xAC, 0xD8,
+			0xA8, 0xFA, 0x76, 0x3F, 0xE3, 0x9C, 0x34, 0x3F, 0xF9, 0xDC, 0xBB, 0xC7, 0xC7, 0x0B, 0x4F, 0x1D,
+			0x8A, 0x51, 0xE0, 0x4B, 0xCD, 0xB4, 0x59, 0x31, 0xC8, 0x9F, 0x7E, 0xC9, 0xD9, 0x78, 0x73, 0x64,
+			0xEA, 0xC5, 0xAC, 0x83, 0x34, 0xD3, 0xEB, 0xC3, 0xC5, 0x81, 0xA0, 0xFF, 0xFA, 0x13, 0x63, 0xEB,
+			0x17, 0x0D, 0xDD, 0x51, 0xB7, 0xF0, 0xDA, 0x49, 0xD3, 0x16, 0x55, 0x26, 0x29, 0xD4, 0x68, 0x9E,
+			0x2B, 0x16, 0xBE, 0x58, 0x7D, 0x47, 0xA1, 0xFC, 0x8F, 0xF8, 0xB8, 0xD1, 0x7A, 0xD0, 0x31, 0xCE,
+			0x45, 0xCB, 0x3A, 0x8F, 0x95, 0x16, 0x04, 0x28, 0xAF, 0xD7, 0xFB, 0xCA, 0xBB, 0x4B, 0x40, 0x7E,
+		};
+
+		constexpr std::uint64_t kInitialAcc[8] = {
+			kPrime32_3, kPrime64_1, kPrime64_2, kPrime64_3, kPrime64_4, kPrime32_2, kPrime64_5, kPrime32_1,
+		};
+
+		inline std::uint32_t Load32(const unsigned char *pbyData) noexcept {
+			std::uint32_t u32Word;
+			std::memcpy(&u32Word, pbyData, sizeof(u32Word));
+			return LoadLe(u32Word);
+		}
+		inline std::uint64_t Load64(const unsigned char *pbyData) noexcept {
+			std::uint64_t u64Word;
+			std::memcpy(&u64Word, pbyData, sizeof(u64Word));
+			return LoadLe(u64Word);
+		}
+		inline void Store64(unsigned char *pbyData, std::uint64_t u64Value) noexcept {
+			std::uint64_t u64Word;
+			StoreLe(u64Word, u64Value);
+			std::memcpy(pbyData, &u64Word, sizeof(u64Word));
+		}
+
+		inline std::uint32_t RotateLeft32(std::uint32_t u32Value, unsigned uBits) noexcept {
+			return (u32Value << uBits) | (u32Value >> (32 - uBits));
+		}
+		inline std::uint64_t RotateLeft64(std::uint64_t u64Value, unsigned uBits) noexcept {
+			return (u64Value << uBits) | (u64Value >> (64 - uBits));
+		}
+
+		inline Result128 Multiply(std::uint64_t u64Lhs, std::uint64_t u64Rhs) noexcept {
+#ifdef __SIZEOF_INT128__
+			__extension__ const unsigned __int128 u128Product = static_cast<unsigned __int128>(u64Lhs) * u64Rhs;
+			return { static_cast<std::uint64_t>(u128Product), static_cast<std::uint64_t>(u128Product >> 64) };
+#else
+			const std::uint64_t u64LoLo = static_cast<std::uint64_t>(static_cast<std::uint32_t>(u64Lhs)) * static_cast<std::uint32_t>(u64Rhs);
+			const std::uint64_t u64LoHi = static_cast<std::uint64_t>(static_cast<std::uint32_t>(u64Lhs)) * static_cast<std::uint32_t>(u64Rhs >> 32);
+			const std::uint64_t u64HiLo = static_cast<std::uint64_t>(static_cast<std::uint32_t>(u64Lhs >> 32)) * static_cast<std::uint32_t>(u64Rhs);
+			const std::uint64_t u64HiHi = static_cast<std::uint64_t>(static_cast<std::uint32_t>(u64Lhs >> 32)) * static_cast<std::uint32_t>(u64Rhs >> 32);
+			const std::uint64_t u64Middle = (u64LoLo >> 32) + static_cast<std::uint32_t>(u64LoHi) + static_cast<std::uint32_t>(u64HiLo);
+			return { (u64Middle << 32) | static_cast<std::uint32_t>(u64LoLo), u64HiHi + (u64LoHi >> 32) + (u64HiLo >> 32) + (u64Middle >> 32) };
+#endif
+		}
+		inline std::uint64_t MultiplyFold(std::uint64_t u64Lhs, std::uint64_t u64Rhs) noexcept {
+			const auto vProduct = Multiply(u64Lhs, u64Rhs);
+			return vProduct.u64Low ^ vProduct.u64High;
+		}
+
+		inline std::uint64_t AvalancheXxh64(std::uint64_t u64Hash) noexcept {
+			u64Hash ^= u64Hash >> 33;
+			u64Hash *= kPrime64_2;
+			u64Hash ^= u64Hash >> 29;
+			u64Hash *= kPrime64_3;
+			u64Hash ^= u64Hash >> 32;
+			return u64Hash;
+		}
+		inline std::uint64_t Avalanche(std::uint64_t u64Hash) noexcept {
+			u64Hash ^= u64Hash >> 37;
+			u64Hash *= kPrimeMx1;
+			u64Hash ^= u64Hash >> 32;
+			return u64Hash;
+		}
+		inline std::uint64_t AvalancheRrmxmx(std::uint64_t u64Hash, std::uint64_t u64Size) noexcept {
+			u64Hash ^= RotateLeft64(u64Hash, 49) ^ RotateLeft64(u64Hash, 24);
+			u64Hash *= kPrimeMx2;
+			u64Hash ^= (u64Hash >> 35) + u64Size;
+			u64Hash *= kPrimeMx2;
+			u64Hash ^= u64Hash >> 28;
+			return u64Hash;
+		}
+
+		// 短数据。这里的 pbySecret 总是默认密钥，种子直接参与计算。
+		inline std::uint64_t Mix16(const unsigned char *pbyData, const unsigned char *pbySecret, std::uint64_t u64Seed) noexcept {
+			return MultiplyFold(Load64(pbyData) ^ (Load64(pbySecret) + u64Seed), Load64(pbyData + 8) ^ (Load64(pbySecret + 8) - u64Seed));
+		}
+		inline Result128 Mix32(Result128 vAcc, const unsigned char *pbyData1, const unsigned char *pbyData2, const unsigned char *pbySecret, std::uint64_t u64Seed) noexcept {
+			vAcc.u64Low  += Mix16(pbyData1, pbySecret, u64Seed);
+			vAcc.u64Low  ^= Load64(pbyData2) + Load64(pbyData2 + 8);
+			vAcc.u64High += Mix16(pbyData2, pbySecret + 16, u64Seed);
+			vAcc.u64High ^= Load64(pbyData1) + Load64(pbyData1 + 8);
+			return vAcc;
+		}
+
+		std::uint64_t HashShort64(const unsigned char *pbyData, std::size_t uSize, std::uint64_t u64Seed) noexcept {
+			const auto pbySecret = kDefaultSecret;
+			if(uSize == 0){
+				return AvalancheXxh64(u64Seed ^ Load64(pbySecret + 56) ^ Load64(pbySecret + 64));
+			}
+			if(uSize <= 3){
+				const std::uint32_t u32Combined = (static_cast<std::uint32_t>(pbyData[0]) << 16) | (static_cast<std::uint32_t>(pbyData[uSize / 2]) << 24) |
+				                                  static_cast<std::uint32_t>(pbyData[uSize - 1]) | (static_cast<std::uint32_t>(uSize) << 8);
+				const auto u64BitFlip = (Load32(pbySecret) ^ Load32(pbySecret + 4)) + u64Seed;
+				return AvalancheXxh64(u32Combined ^ u64BitFlip);
+			}
+			if(uSize <= 8){
+				const auto u64SeedMixed = u64Seed ^ (static_cast<std::uint64_t>(__builtin_bswap32(static_cast<std::uint32_t>(u64Seed))) << 32);
+				const auto u64Input = Load32(pbyData + uSize - 4) + (static_cast<std::uint64_t>(Load32(pbyData)) << 32);
+				const auto u64BitFlip = (Load64(pbySecret + 8) ^ Load64(pbySecret + 16)) - u64SeedMixed;
+				return AvalancheRrmxmx(u64Input ^ u64BitFlip, uSize);
+			}
+			if(uSize <= 16){
+				const auto u64BitFlip1 = (Load64(pbySecret + 24) ^ Load64(pbySecret + 32)) + u64Seed;
+				const auto u64BitFlip2 = (Load64(pbySecret + 40) ^ Load64(pbySecret + 48)) - u64Seed;
+				const auto u64Low = Load64(pbyData) ^ u64BitFlip1;
+				const auto u64High = Load64(pbyData + uSize - 8) ^ u64BitFlip2;
+				return Avalanche(uSize + __builtin_bswap64(u64Low) + u64High + MultiplyFold(u64Low, u64High));
+			}
+			std::uint64_t u64Acc = uSize * kPrime64_1;
+			if(uSize <= 128){
+				if(uSize > 32){
+					if(uSize > 64){
+						if(uSize > 96){
+							u64Acc += Mix16(pbyData + 48, pbySecret + 96, u64Seed);
+							u64Acc += Mix16(pbyData + uSize - 64, pbySecret + 112, u64Seed);
+						}
+						u64Acc += Mix16(pbyData + 32, pbySecret + 64, u64Seed);
+						u64Acc += Mix16(pbyData + uSize - 48, pbySecret + 80, u64Seed);
+					}
+					u64Acc += Mix16(pbyData + 16, pbySecret + 32, u64Seed);
+					u64Acc += Mix16(pbyData + uSize - 32, pbySecret + 48, u64Seed);
+				}
+				u64Acc += Mix16(pbyData, pbySecret, u64Seed);
+				u64Acc += Mix16(pbyData + uSize - 16, pbySecret + 16, u64Seed);
+				return Avalanche(u64Acc);
+			}
+			for(unsigned uRound = 0; uRound < 8; ++uRound){
+				u64Acc += Mix16(pbyData + uRound * 16, pbySecret + uRound * 16, u64Seed);
+			}
+			u64Acc = Avalanche(u64Acc);
+			auto u64AccEnd = Mix16(pbyData + uSize - 16, pbySecret + kSecretSizeMin - kMidSizeLastOffset, u64Seed);
+			for(unsigned uRound = 8; uRound < uSize / 16; ++uRound){
+				u64AccEnd += Mix16(pbyData + uRound * 16, pbySecret + (uRound - 8) * 16 + kMidSizeStartOffset, u64Seed);
+			}
+			return Avalanche(u64Acc + u64AccEnd);
+		}
+		Result128 HashShort128(const unsigned char *pbyData, std::size_t uSize, std::uint64_t u64Seed) noexcept {
+			const auto pbySecret = kDefaultSecret;
+			if(uSize == 0){
+				return { AvalancheXxh64(u64Seed ^ Load64(pbySecret + 64) ^ Load64(pbySecret + 72)),
+				         AvalancheXxh64(u64Seed ^ Load64(pbySecret + 80) ^ Load64(pbySecret + 88)) };
+			}
+			if(uSize <= 3){
+				const std::uint32_t u32CombinedLow = (static_cast<std::uint32_t>(pbyData[0]) << 16) | (static_cast<std::uint32_t>(pbyData[uSize / 2]) << 24) |
+				                                     static_cast<std::uint32_t>(pbyData[uSize - 1]) | (static_cast<std::uint32_t>(uSize) << 8);
+				const auto u32CombinedHigh = RotateLeft32(__builtin_bswap32(u32CombinedLow), 13);
+				const auto u64BitFlipLow = (Load32(pbySecret) ^ Load32(pbySecret + 4)) + u64Seed;
+				const auto u64BitFlipHigh = (Load32(pbySecret + 8) ^ Load32(pbySecret + 12)) - u64Seed;
+				return { AvalancheXxh64(u32CombinedLow ^ u64BitFlipLow), AvalancheXxh64(u32CombinedHigh ^ u64BitFlipHigh) };
+			}
+			if(uSize <= 8){
+				const auto u64SeedMixed = u64Seed ^ (static_cast<std::uint64_t>(__builtin_bswap32(static_cast<std::uint32_t>(u64Seed))) << 32);
+				const auto u64Input = Load32(pbyData) + (static_cast<std::uint64_t>(Load32(pbyData + uSize - 4)) << 32);
+				const auto u64BitFlip = (Load64(pbySecret + 16) ^ Load64(pbySecret + 24)) + u64SeedMixed;
+				auto vProduct = Multiply(u64Input ^ u64BitFlip, kPrime64_1 + (uSize << 2));
+				vProduct.u64High += vProduct.u64Low << 1;
+				vProduct.u64Low ^= vProduct.u64High >> 3;
+				vProduct.u64Low ^= vProduct.u64Low >> 35;
+				vProduct.u64Low *= kPrimeMx2;
+				vProduct.u64Low ^= vProduct.u64Low >> 28;
+				vProduct.u64High = Avalanche(vProduct.u64High);
+				return vProduct;
+			}
+			if(uSize <= 16){
+				const auto u64BitFlipLow = (Load64(pbySecret + 32) ^ Load64(pbySecret + 40)) - u64Seed;
+				const auto u64BitFlipHigh = (Load64(pbySecret + 48) ^ Load64(pbySecret + 56)) + u64Seed;
+				const auto u64InputLow = Load64(pbyData);
+				auto u64InputHigh = Load64(pbyData + uSize - 8);
+				auto vProduct = Multiply(u64InputLow ^ u64InputHigh ^ u64BitFlipLow, kPrime64_1);
+				vProduct.u64Low += static_cast<std::uint64_t>(uSize - 1) << 54;
+				u64InputHigh ^= u64BitFlipHigh;
+				vProduct.u64High += u64InputHigh + static_cast<std::uint64_t>(static_cast<std::uint32_t>(u64InputHigh)) * (kPrime32_2 - 1);
+				vProduct.u64Low ^= __builtin_bswap64(vProduct.u64High);
+				auto vResult = Multiply(vProduct.u64Low, kPrime64_2);
+				vResult.u64High += vProduct.u64High * kPrime64_2;
+				return { Avalanche(vResult.u64Low), Avalanche(vResult.u64High) };
+			}
+			Result128 vAcc = { uSize * kPrime64_1, 0 };
+			if(uSize <= 128){
+				if(uSize > 32){
+					if(uSize > 64){
+						if(uSize > 96){
+							vAcc = Mix32(vAcc, pbyData + 48, pbyData + uSize - 64, pbySecret + 96, u64Seed);
+						}
+						vAcc = Mix32(vAcc, pbyData + 32, pbyData + uSize - 48, pbySecret + 64, u64Seed);
+					}
+					vAcc = Mix32(vAcc, pbyData + 16, pbyData + uSize - 32, pbySecret + 32, u64Seed);
+				}
+				vAcc = Mix32(vAcc, pbyData, pbyData + uSize - 16, pbySecret, u64Seed);
+			} else {
+				for(unsigned uOffset = 32; uOffset < 160; uOffset += 32){
+					vAcc = Mix32(vAcc, pbyData + uOffset - 32, pbyData + uOffset - 16, pbySecret + uOffset - 32, u64Seed);
+				}
+				vAcc.u64Low = Avalanche(vAcc.u64Low);
+				vAcc.u64High = Avalanche(vAcc.u64High);
+				for(unsigned uOffset = 160; uOffset <= uSize; uOffset += 32){
+					vAcc = Mix32(vAcc, pbyData + uOffset - 32, pbyData + uOffset - 16, pbySecret + kMidSizeStartOffset + uOffset - 160, u64Seed);
+				}
+				vAcc = Mix32(vAcc, pbyData + uSize - 16, pbyData + uSize - 32, pbySecret + kSecretSizeMin - kMidSizeLastOffset - 16, 0 - u64Seed);
+			}
+			const auto u64Low = vAcc.u64Low + vAcc.u64High;
+			const auto u64High = vAcc.u64Low * kPrime64_1 + vAcc.u64High * kPrime64_4 + (uSize - u64Seed) * kPrime64_2;
+			return { Avalanche(u64Low), 0 - Avalanche(u64High) };
+		}
+
+		// 长数据。累加器按照条处理，pbySecret 每处理一条向后移动 8 个字节。
+		void AccumulateSse2(std::uint64_t *pu64Acc, const unsigned char *pbyData, const unsigned char *pbySecret, std::size_t uStripes) noexcept {
+			__m128i axmmAcc[4];
+			for(unsigned uIndex = 0; uIndex < 4; ++uIndex){
+				axmmAcc[uIndex] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pu64Acc) + uIndex);
+			}
+			for(std::size_t uStripe = 0; uStripe < uStripes; ++uStripe){
+				const auto pbyStripe = pbyData + uStripe * kStripeSize;
+				const auto pbyKey = pbySecret + uStripe * kSecretConsumeRate;
+				for(unsigned uIndex = 0; uIndex < 4; ++uIndex){
+					const auto xmmData = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pbyStripe) + uIndex);
+					const auto xmmDataKey = _mm_xor_si128(xmmData, _mm_loadu_si128(reinterpret_cast<const __m128i *>(pbyKey) + uIndex));
+					const auto xmmProduct = _mm_mul_epu32(xmmDataKey, _mm_shuffle_epi32(xmmDataKey, 0x31));
+					axmmAcc[uIndex] = _mm_add_epi64(axmmAcc[uIndex], _mm_add_epi64(xmmProduct, _mm_shuffle_epi32(xmmData, 0x4E)));
+				}
+			}
+			for(unsigned uIndex = 0; uIndex < 4; ++uIndex){
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(pu64Acc) + uIndex, axmmAcc[uIndex]);
+			}
+		}
+		void ScrambleSse2(std::uint64_t *pu64Acc, const unsigned char *pbySecret) noexcept {
+			const auto xmmPrime = _mm_set1_epi32(static_cast<int>(kPrime32_1));
+			for(unsigned uIndex = 0; uIndex < 4; ++uIndex){
+				auto xmmAcc = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pu64Acc) + uIndex);
+				xmmAcc = _mm_xor_si128(xmmAcc, _mm_srli_epi64(xmmAcc, 47));
+				xmmAcc = _mm_xor_si128(xmmAcc, _mm_loadu_si128(reinterpret_cast<const __m128i *>(pbySecret) + uIndex));
+				const auto xmmLow = _mm_mul_epu32(xmmAcc, xmmPrime);
+				const auto xmmHigh = _mm_mul_epu32(_mm_shuffle_epi32(xmmAcc, 0x31), xmmPrime);
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(pu64Acc) + uIndex, _mm_add_epi64(xmmLow, _mm_slli_epi64(xmmHigh, 32)));
+			}
+		}
+
+		__attribute__((__target__("avx2")))
+		void AccumulateAvx2(std::uint64_t *pu64Acc, const unsigned char *pbyData, const unsigned char *pbySecret, std::size_t uStripes) noexcept {
+			__m256i aymmAcc[2];
+			for(unsigned uIndex = 0; uIndex < 2; ++uIndex){
+				aymmAcc[uIndex] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pu64Acc) + uIndex);
+			}
+			for(std::size_t uStripe = 0; uStripe < uStripes; ++uStripe){
+				const auto pbyStripe = pbyData + uStripe * kStripeSize;
+				const auto pbyKey = pbySecret + uStripe * kSecretConsumeRate;
+				for(unsigned uIndex = 0; uIndex < 2; ++uIndex){
+					const auto ymmData = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pbyStripe) + uIndex);
+					const auto ymmDataKey = _mm256_xor_si256(ymmData, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pbyKey) + uIndex));
+					const auto ymmProduct = _mm256_mul_epu32(ymmDataKey, _mm256_srli_epi64(ymmDataKey, 32));
+					aymmAcc[uIndex] = _mm256_add_epi64(aymmAcc[uIndex], _mm256_add_epi64(ymmProduct, _mm256_shuffle_epi32(ymmData, 0x4E)));
+				}
+			}
+			for(unsigned uIndex = 0; uIndex < 2; ++uIndex){
+				_mm256_storeu_si256(reinterpret_cast<__m256i *>(pu64Acc) + uIndex, aymmAcc[uIndex]);
+			}
+		}
+		__attribute__((__target__("avx2")))
+		void ScrambleAvx2(std::uint64_t *pu64Acc, const unsigned char *pbySecret) noexcept {
+			const auto ymmPrime = _mm256_set1_epi32(static_cast<int>(kPrime32_1));
+			for(unsigned uIndex = 0; uIndex < 2; ++uIndex){
+				auto ymmAcc = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pu64Acc) + uIndex);
+				ymmAcc = _mm256_xor_si256(ymmAcc, _mm256_srli_epi64(ymmAcc, 47));
+				ymmAcc = _mm256_xor_si256(ymmAcc, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pbySecret) + uIndex));
+				const auto ymmLow = _mm256_mul_epu32(ymmAcc, ymmPrime);
+				const auto ymmHigh = _mm256_mul_epu32(_mm256_srli_epi64(ymmAcc, 32), ymmPrime);
+				_mm256_storeu_si256(reinterpret_cast<__m256i *>(pu64Acc) + uIndex, _mm256_add_epi64(ymmLow, _mm256_slli_epi64(ymmHigh, 32)));
+			}
+		}
+
+		struct Kernel {
+			void (*pfnAccumulate)(std::uint64_t *, const unsigned char *, const unsigned char *, std::size_t) noexcept;
+			void (*pfnScramble)(std::uint64_t *, const unsigned char *) noexcept;
+		};
+
+		inline Kernel GetKernel() noexcept {
+			if(_MCFCRT_CpuHasFeature(_MCFCRT_kCpuFeatureAvx2)){
+				return { &AccumulateAvx2, &ScrambleAvx2 };
+			}
+			return { &AccumulateSse2, &ScrambleSse2 };
+		}
+
+		void InitializeSecret(unsigned char (&abySecret)[Xxh3::kSecretSize], std::uint64_t u64Seed) noexcept {
+			for(unsigned uOffset = 0; uOffset < Xxh3::kSecretSize; uOffset += 16){
+				Store64(abySecret + uOffset, Load64(kDefaultSecret + uOffset) + u64Seed);
+				Store64(abySecret + uOffset + 8, Load64(kDefaultSecret + uOffset + 8) - u64Seed);
+			}
+		}
+
+		// 处理 uStripes 条数据，uStripesInBlock 是当前块中已经处理的条数。
+		const unsigned char *ConsumeStripes(const Kernel &vKernel, std::uint64_t *pu64Acc, std::size_t &uStripesInBlock, const unsigned char *pbyData, std::size_t uStripes, const unsigned char *pbySecret) noexcept {
+			auto pbyRead = pbyData;
+			auto uStripesRemaining = uStripes;
+			auto uStripesToBlockEnd = kStripesInBlock - uStripesInBlock;
+			while(uStripesRemaining >= uStripesToBlockEnd){
+				(*vKernel.pfnAccumulate)(pu64Acc, pbyRead, pbySecret + uStripesInBlock * kSecretConsumeRate, uStripesToBlockEnd);
+				(*vKernel.pfnScramble)(pu64Acc, pbySecret + Xxh3::kSecretSize - kStripeSize);
+				pbyRead += uStripesToBlockEnd * kStripeSize;
+				uStripesRemaining -= uStripesToBlockEnd;
+				uStripesInBlock = 0;
+				uStripesToBlockEnd = kStripesInBlock;
+			}
+			if(uStripesRemaining != 0){
+				(*vKernel.pfnAccumulate)(pu64Acc, pbyRead, pbySecret + uStripesInBlock * kSecretConsumeRate, uStripesRemaining);
+				pbyRead += uStripesRemaining * kStripeSize;
+				uStripesInBlock += uStripesRemaining;
+			}
+			return pbyRead;
+		}
+
+		std::uint64_t MergeAccs(const std::uint64_t (&au64Acc)[8], const unsigned char *pbySecret, std::uint64_t u64Start) noexcept {
+			auto u64Result = u64Start;
+			for(unsigned uIndex = 0; uIndex < 4; ++uIndex){
+				u64Result += MultiplyFold(au64Acc[uIndex * 2] ^ Load64(pbySecret + uIndex * 16), au64Acc[uIndex * 2 + 1] ^ Load64(pbySecret + uIndex * 16 + 8));
+			}
+			return Avalanche(u64Result);
+		}
+
+		// uSize 必须大于 240。
+		void HashLong(std::uint64_t (&au64Acc)[8], const unsigned char *pbyData, std::size_t uSize, const unsigned char *pbySecret) noexcept {
+			const auto vKernel = GetKernel();
+			std::memcpy(au64Acc, kInitialAcc, sizeof(au64Acc));
+			std::size_t uStripesInBlock = 0;
+			ConsumeStripes(vKernel, au64Acc, uStripesInBlock, pbyData, (uSize - 1) / kStripeSize, pbySecret);
+			// 最后一条总是由末尾的 64 个字节组成，可能与前面的条重叠。
+			(*vKernel.pfnAccumulate)(au64Acc, pbyData + uSize - kStripeSize, pbySecret + Xxh3::kSecretSize - kStripeSize - kLastStripeStart, 1);
+		}
+	}
+
+	void Xxh3::X_DigestLong(std::uint64_t (&au64Acc)[8]) const noexcept {
+		const auto vKernel = GetKernel();
+		std::memcpy(au64Acc, x_au64Acc, sizeof(au64Acc));
+		const unsigned char *pbyLastStripe;
+		unsigned char abyLastStripe[kStripeSize];
+		if(x_uBytesInBuffer >= kStripeSize){
+			auto uStripesInBlock = x_uStripesInBlock;
+			ConsumeStripes(vKernel, au64Acc, uStripesInBlock, x_abyBuffer, (x_uBytesInBuffer - 1) / kStripeSize, x_abySecret);
+			pbyLastStripe = x_abyBuffer + x_uBytesInBuffer - kStripeSize;
+		} else {
+			// 缓冲区的末尾保存着上一次处理的最后一条。
+			const auto uBytesToCatchUp = kStripeSize - x_uBytesInBuffer;
+			std::memcpy(abyLastStripe, x_abyBuffer + kBufferSize - uBytesToCatchUp, uBytesToCatchUp);
+			std::memcpy(abyLastStripe + uBytesToCatchUp, x_abyBuffer, x_uBytesInBuffer);
+			pbyLastStripe = abyLastStripe;
+		}
+		(*vKernel.pfnAccumulate)(au64Acc, pbyLastStripe, x_abySecret + kSecretSize - kStripeSize - kLastStripeStart, 1);
+	}
+
+	void Xxh3::Reset(std::uint64_t u64Seed) noexcept {
+		std::memcpy(x_au64Acc, kInitialAcc, sizeof(x_au64Acc));
+		InitializeSecret(x_abySecret, u64Seed);
+		x_uBytesInBuffer = 0;
+		x_uStripesInBlock = 0;
+		x_u64BytesTotal = 0;
+		x_u64Seed = u64Seed;
+	}
+	void Xxh3::Update(const void *pData, std::size_t uSize) noexcept {
+		auto pbyRead = static_cast<const unsigned char *>(pData);
+		const auto pbyEnd = pbyRead + uSize;
+		x_u64BytesTotal += uSize;
+		// 缓冲区被填满之后还有更多数据才会处理，这样最后一条总是留在缓冲区里。
+		if(uSize <= kBufferSize - x_uBytesInBuffer){
+			if(uSize != 0){
+				std::memcpy(x_abyBuffer + x_uBytesInBuffer, pbyRead, uSize);
+				x_uBytesInBuffer += uSize;
+			}
+			return;
+		}
+		const auto vKernel = GetKernel();
+		if(x_uBytesInBuffer != 0){
+			const auto uBytesToCopy = kBufferSize - x_uBytesInBuffer;
+			std::memcpy(x_abyBuffer + x_uBytesInBuffer, pbyRead, uBytesToCopy);
+			pbyRead += uBytesToCopy;
+			ConsumeStripes(vKernel, x_au64Acc, x_uStripesInBlock, x_abyBuffer, kStripesInBuffer, x_abySecret);
+			x_uBytesInBuffer = 0;
+		}
+		if(static_cast<std::size_t>(pbyEnd - pbyRead) > kBufferSize){
+			pbyRead = ConsumeStripes(vKernel, x_au64Acc, x_uStripesInBlock, pbyRead, static_cast<std::size_t>(pbyEnd - 1 - pbyRead) / kStripeSize, x_abySecret);
+			std::memcpy(x_abyBuffer + kBufferSize - kStripeSize, pbyRead - kStripeSize, kStripeSize);
+		}
+		x_uBytesInBuffer = static_cast<std::size_t>(pbyEnd - pbyRead);
+		std::memcpy(x_abyBuffer, pbyRead, x_uBytesInBuffer);
+	}
+	std::uint64_t Xxh3::Finalize64() const noexcept {
+		if(x_u64BytesTotal <= kMidSizeMax){
+			return HashShort64(x_abyBuffer, static_cast<std::size_t>(x_u64BytesTotal), x_u64Seed);
+		}
+		std::uint64_t au64Acc[8];
+		X_DigestLong(au64Acc);
+		return MergeAccs(au64Acc, x_abySecret + kMergeAccsStart, x_u64BytesTotal * kPrime64_1);
+	}
+	Result128 Xxh3::Finalize128() const noexcept {
+		if(x_u64BytesTotal <= kMidSizeMax){
+			return HashShort128(x_abyBuffer, static_cast<std::size_t>(x_u64BytesTotal), x_u64Seed);
+		}
+		std::uint64_t au64Acc[8];
+		X_DigestLong(au64Acc);
+		return { MergeAccs(au64Acc, x_abySecret + kMergeAccsStart, x_u64BytesTotal * kPrime64_1),
+		         MergeAccs(au64Acc, x_abySecret + kSecretSize - sizeof(au64Acc) - kMergeAccsStart, ~(x_u64BytesTotal * kPrime64_2)) };
+	}
+
+	std::uint64_t Xxh3::Hash64(const void *pData, std::size_t uSize, std::uint64_t u64Seed) noexcept {
+		const auto pbyData = static_cast<const unsigned char *>(pData);
+		if(uSize <= kMidSizeMax){
+			return HashShort64(pbyData, uSize, u64Seed);
+		}
+		unsigned char abySecret[kSecretSize];
+		const unsigned char *pbySecret = kDefaultSecret;
+		if(u64Seed != 0){
+			InitializeSecret(abySecret, u64Seed);
+			pbySecret = abySecret;
+		}
+		std::uint64_t au64Acc[8];
+		HashLong(au64Acc, pbyData, uSize, pbySecret);
+		return MergeAccs(au64Acc, pbySecret + kMergeAccsStart, uSize * kPrime64_1);
+	}
+	Result128 Xxh3::Hash128(const void *pData, std::size_t uSize, std::uint64_t u64Seed) noexcept {
+		const auto pbyData = static_cast<const unsigned char *>(pData);
+		if(uSize <= kMidSizeMax){
+			return HashShort128(pbyData, uSize, u64Seed);
+		}
+		unsigned char abySecret[kSecretSize];
+		const unsigned char *pbySecret = kDefaultSecret;
+		if(u64Seed != 0){
+			InitializeSecret(abySecret, u64Seed);
+			pbySecret = abySecret;
+		}
+		std::uint64_t au64Acc[8];
+		HashLong(au64Acc, pbyData, uSize, pbySecret);
+		return { MergeAccs(au64Acc, pbySecret + kMergeAccsStart, uSize * kPrime64_1),
+		         MergeAccs(au64Acc, pbySecret + kSecretSize - sizeof(au64Acc) - kMergeAccsStart, ~(uSize * kPrime64_2)) };
+	}
+}
+
+}
@@ -0,0 +1,60 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_CORE_XXH3_HPP_
+#define MCF_CORE_XXH3_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace MCF {
+
+namespace Impl_Xxh3 {
+	// https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+	// 结果与 xxHash 0.8 的 XXH3_64bits_withSeed() 和 XXH3_128bits_withSeed() 相同。
+
+	struct Result128 {
+		std::uint64_t u64Low;
+		std::uint64_t u64High;
+	};
+
+	class Xxh3 {
+	public:
+		enum : std::size_t {
+			kSecretSize = 192,
+			kBufferSize = 256,
+		};
+
+	private:
+		std::uint64_t x_au64Acc[8];
+		unsigned char x_abySecret[kSecretSize];
+		unsigned char x_abyBuffer[kBufferSize];
+		std::size_t x_uBytesInBuffer;
+		std::size_t x_uStripesInBlock;
+		std::uint64_t x_u64BytesTotal;
+		std::uint64_t x_u64Seed;
+
+	private:
+		void X_DigestLong(std::uint64_t (&au64Acc)[8]) const noexcept;
+
+	public:
+		explicit Xxh3(std::uint64_t u64Seed = 0) noexcept {
+			Reset(u64Seed);
+		}
+
+	public:
+		void Reset(std::uint64_t u64Seed = 0) noexcept;
+		void Update(const void *pData, std::size_t uSize) noexcept;
+		std::uint64_t Finalize64() const noexcept;
+		Result128 Finalize128() const noexcept;
+
+		// 一次性计算的版本不需要缓冲区，短数据也不需要生成密钥。
+		static std::uint64_t Hash64(const void *pData, std::size_t uSize, std::uint64_t u64Seed = 0) noexcept;
+		static Result128 Hash128(const void *pData, std::size_t uSize, std::uint64_t u64Seed = 0) noexcept;
+	};
+}
+
+}
+
+#endif
@@ -0,0 +1,185 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "ChaChaGenerator.hpp"
+#include "../Core/MinMax.hpp"
+#include <cstring>
+#include <tmmintrin.h>
+
+namespace MCF {
+
+// https://cr.yp.to/chacha/chacha-20080128.pdf
+// https://tools.ietf.org/html/rfc7539
+
+namespace {
+	constexpr std::uint32_t kConstants[4] = { 0x61707865, 0x3320646E, 0x79622D32, 0x6B206574 };
+
+	inline std::uint32_t RotateLeft(std::uint32_t u32Word, unsigned uBits) noexcept {
+		return (u32Word << uBits) | (u32Word >> (32 - uBits));
+	}
+
+	void GenerateOneBlock(std::uint32_t (&au32Result)[16], const std::uint32_t (&au32Key)[8], std::uint64_t u64Counter, std::uint64_t u64Stream) noexcept {
+		std::uint32_t au32Input[16];
+		std::memcpy(au32Input + 0, kConstants, 16);
+		std::memcpy(au32Input + 4, au32Key, 32);
+		au32Input[12] = (std::uint32_t)u64Counter;
+		au32Input[13] = (std::uint32_t)(u64Counter >> 32);
+		au32Input[14] = (std::uint32_t)u64Stream;
+		au32Input[15] = (std::uint32_t)(u64Stream >> 32);
+
+		auto &x = au32Result;
+		std::memcpy(x, au32Input, 64);
+		const auto QuarterRound = [&](unsigned a, unsigned b, unsigned c, unsigned d){
+			x[a] += x[b]; x[d] = RotateLeft(x[d] ^ x[a], 16);
+			x[c] += x[d]; x[b] = RotateLeft(x[b] ^ x[c], 12);
+			x[a] += x[b]; x[d] = RotateLeft(x[d] ^ x[a],  8);
+			x[c] += x[d]; x[b] = RotateLeft(x[b] ^ x[c],  7);
+		};
+		for(unsigned uRound = 0; uRound < 10; ++uRound){
+			QuarterRound(0, 4,  8, 12);
+			QuarterRound(1, 5,  9, 13);
+			QuarterRound(2, 6, 10, 14);
+			QuarterRound(3, 7, 11, 15);
+			QuarterRound(0, 5, 10, 15);
+			QuarterRound(1, 6, 11, 12);
+			QuarterRound(2, 7,  8, 13);
+			QuarterRound(3, 4,  9, 14);
+		}
+		for(unsigned uIndex = 0; uIndex < 16; ++uIndex){
+			x[uIndex] += au32Input[uIndex];
+		}
+	}
+
+	// 四个块并行计算，每个 XMM 寄存器存放四个块中的同一个字。
+	// 循环移位 16 位和 8 位使用 PSHUFB 实现。
+	void GenerateFourBlocks(void *pOutput, const std::uint32_t (&au32Key)[8], std::uint64_t u64Counter, std::uint64_t u64Stream) noexcept {
+		__m128i axmmInput[16];
+		for(unsigned uIndex = 0; uIndex < 4; ++uIndex){
+			axmmInput[uIndex] = _mm_set1_epi32((int)kConstants[uIndex]);
+		}
+		for(unsigned uIndex = 0; uIndex < 8; ++uIndex){
+			axmmInput[4 + uIndex] = _mm_set1_epi32((int)au32Key[uIndex]);
+		}
+		std::uint32_t au32CounterLo[4], au32CounterHi[4];
+		for(unsigned uIndex = 0; uIndex < 4; ++uIndex){
+			const auto u64BlockCounter = u64Counter + uIndex;
+			au32CounterLo[uIndex] = (std::uint32_t)u64BlockCounter;
+			au32CounterHi[uIndex] = (std::uint32_t)(u64BlockCounter >> 32);
+		}
+		axmmInput[12] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(au32CounterLo));
+		axmmInput[13] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(au32CounterHi));
+		axmmInput[14] = _mm_set1_epi32((int)(std::uint32_t)u64Stream);
+		axmmInput[15] = _mm_set1_epi32((int)(std::uint32_t)(u64Stream >> 32));
+
+		const auto xmmRot16 = _mm_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+		const auto xmmRot8  = _mm_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14);
+
+		__m128i x[16];
+		for(unsigned uIndex = 0; uIndex < 16; ++uIndex){
+			x[uIndex] = axmmInput[uIndex];
+		}
+		const auto QuarterRound = [&](unsigned a, unsigned b, unsigned c, unsigned d){
+			x[a] = _mm_add_epi32(x[a], x[b]); x[d] = _mm_shuffle_epi8(_mm_xor_si128(x[d], x[a]), xmmRot16);
+			x[c] = _mm_add_epi32(x[c], x[d]); x[b] = _mm_xor_si128(x[b], x[c]); x[b] = _mm_or_si128(_mm_slli_epi32(x[b], 12), _mm_srli_epi32(x[b], 20));
+			x[a] = _mm_add_epi32(x[a], x[b]); x[d] = _mm_shuffle_epi8(_mm_xor_si128(x[d], x[a]), xmmRot8);
+			x[c] = _mm_add_epi32(x[c], x[d]); x[b] = _mm_xor_si128(x[b], x[c]); x[b] = _mm_or_si128(_mm_slli_epi32(x[b],  7), _mm_srli_epi32(x[b], 25));
+		};
+		for(unsigned uRound = 0; uRound < 10; ++uRound){
+			QuarterRound(0, 4,  8, 12);
+			QuarterRound(1, 5,  9, 13);
+			QuarterRound(2, 6, 10, 14);
+			QuarterRound(3, 7, 11, 15);
+			QuarterRound(0, 5, 10, 15);
+			QuarterRound(1, 6, 11, 12);
+			QuarterRound(2, 7,  8, 13);
+			QuarterRound(3, 4,  9, 14);
+		}
+		// 转置之后，每个块的 64 字节是连续的。
+		const auto pbyOutput = static_cast<unsigned char *>(pOutput);
+		for(unsigned uGroup = 0; uGroup < 4; ++uGroup){
+			const auto xmm0 = _mm_add_epi32(x[uGroup * 4 + 0], axmmInput[uGroup * 4 + 0]);
+			const auto xmm1 = _mm_add_epi32(x[uGroup * 4 + 1], axmmInput[uGroup * 4 + 1]);
+			const auto xmm2 = _mm_add_epi32(x[uGroup * 4 + 2], axmmInput[uGroup * 4 + 2]);
+			const auto xmm3 = _mm_add_epi32(x[uGroup * 4 + 3], axmmInput[uGroup * 4 + 3]);
+			const auto xmm01Lo = _mm_unpacklo_epi32(xmm0, xmm1);
+			const auto xmm01Hi = _mm_unpackhi_epi32(xmm0, xmm1);
+			const auto xmm23Lo = _mm_unpacklo_epi32(xmm2, xmm3);
+			const auto xmm23Hi = _mm_unpackhi_epi32(xmm2, xmm3);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pbyOutput +   0 + uGroup * 16), _mm_unpacklo_epi64(xmm01Lo, xmm23Lo));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pbyOutput +  64 + uGroup * 16), _mm_unpackhi_epi64(xmm01Lo, xmm23Lo));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pbyOutput + 128 + uGroup * 16), _mm_unpacklo_epi64(xmm01Hi, xmm23Hi));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pbyOutput + 192 + uGroup * 16), _mm_unpackhi_epi64(xmm01Hi, xmm23Hi));
+		}
+	}
+}
+
+void ChaChaGenerator::X_RefreshInternal() noexcept {
+	GenerateOneBlock(x_au32Result, x_au32Key, x_u64Counter, x_u64Stream);
+	++x_u64Counter;
+	x_uRead = 0;
+}
+
+void ChaChaGenerator::Init(std::uint32_t u32Seed, std::uint64_t u64Stream) noexcept {
+	Array<std::uint32_t, 8> au32Key;
+	for(unsigned uIndex = 0; uIndex < 8; ++uIndex){
+		au32Key[uIndex] = u32Seed ^ (0x9E3779B9u * (uIndex + 1));
+	}
+	Init(au32Key, u64Stream);
+}
+void ChaChaGenerator::Init(const Array<std::uint32_t, 8> &au32Key, std::uint64_t u64Stream) noexcept {
+	for(unsigned uIndex = 0; uIndex < 8; ++uIndex){
+		x_au32Key[uIndex] = au32Key[uIndex];
+	}
+	x_u64Stream = u64Stream;
+	x_u64Counter = 0;
+	x_uRead = 16;
+}
+
+void ChaChaGenerator::Seek(std::uint64_t u64Position) noexcept {
+	x_u64Counter = u64Position / 16;
+	x_uRead = 16;
+	const auto uOffset = static_cast<unsigned>(u64Position % 16);
+	if(uOffset != 0){
+		X_RefreshInternal();
+		x_uRead = uOffset;
+	}
+}
+
+std::uint32_t ChaChaGenerator::Get() noexcept {
+	if(x_uRead == 16){
+		X_RefreshInternal();
+	}
+	return x_au32Result[x_uRead++];
+}
+void ChaChaGenerator::Fill(void *pBuffer, std::size_t uSize) noexcept {
+	auto pbyWrite = static_cast<unsigned char *>(pBuffer);
+	const auto pbyEnd = pbyWrite + uSize;
+	// 先用完当前块中剩余的值。
+	while((x_uRead != 16) && (static_cast<std::size_t>(pbyEnd - pbyWrite) >= 4)){
+		const auto u32Word = Get();
+		std::memcpy(pbyWrite, &u32Word, 4);
+		pbyWrite += 4;
+	}
+	if(x_uRead == 16){
+		while(static_cast<std::size_t>(pbyEnd - pbyWrite) >= 256){
+			GenerateFourBlocks(pbyWrite, x_au32Key, x_u64Counter, x_u64Stream);
+			x_u64Counter += 4;
+			pbyWrite += 256;
+		}
+		while(static_cast<std::size_t>(pbyEnd - pbyWrite) >= 64){
+			X_RefreshInternal();
+			std::memcpy(pbyWrite, x_au32Result, 64);
+			x_uRead = 16;
+			pbyWrite += 64;
+		}
+	}
+	while(pbyWrite != pbyEnd){
+		const auto u32Word = Get();
+		const auto uBytes = Min(static_cast<std::size_t>(pbyEnd - pbyWrite), 4u);
+		std::memcpy(pbyWrite, &u32Word, uBytes);
+		pbyWrite += uBytes;
+	}
+}
+
+}
@@ -0,0 +1,74 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_RANDOM_CHACHA_GENERATOR_HPP_
+#define MCF_RANDOM_CHACHA_GENERATOR_HPP_
+
+#include "../Core/Clocks.hpp"
+#include "../Core/Array.hpp"
+#include <cstddef>
+
+namespace MCF {
+
+// 基于计数器的生成器，使用 ChaCha20 分组函数（64 位块计数器，64 位流编号）。
+// 相同的密钥和流编号总是产生相同的序列，不同流编号的序列相互独立。
+// 可以在常数时间内跳转到序列中的任意位置，适合并行计算中每个线程使用一个流。
+class ChaChaGenerator {
+private:
+	std::uint32_t x_au32Key[8];
+	std::uint64_t x_u64Stream;
+	std::uint64_t x_u64Counter;
+
+	std::uint32_t x_au32Result[16];
+	unsigned x_uRead;
+
+public:
+	explicit ChaChaGenerator(std::uint32_t u32Seed = ReadTimeStampCounter32(), std::uint64_t u64Stream = 0) noexcept {
+		Init(u32Seed, u64Stream);
+	}
+	explicit ChaChaGenerator(const Array<std::uint32_t, 8> &au32Key, std::uint64_t u64Stream = 0) noexcept {
+		Init(au32Key, u64Stream);
+	}
+
+private:
+	void X_RefreshInternal() noexcept;
+
+public:
+	void Init(std::uint32_t u32Seed = ReadTimeStampCounter32(), std::uint64_t u64Stream = 0) noexcept;
+	void Init(const Array<std::uint32_t, 8> &au32Key, std::uint64_t u64Stream = 0) noexcept;
+
+	std::uint64_t GetStream() const noexcept {
+		return x_u64Stream;
+	}
+	// 位置以 32 位的值为单位。
+	std::uint64_t GetPosition() const noexcept {
+		return x_u64Counter * 16 - 16 + x_uRead;
+	}
+	void Seek(std::uint64_t u64Position) noexcept;
+	void Discard(std::uint64_t u64Count) noexcept {
+		Seek(GetPosition() + u64Count);
+	}
+
+	std::uint32_t Get() noexcept;
+	// 输出的字节序列与连续调用 Get() 得到的小端序字节序列相同。
+	// 如果 uSize 不是 4 的倍数，最后一个值只使用前面的部分字节。
+	void Fill(void *pBuffer, std::size_t uSize) noexcept;
+	template<typename OutputIteratorT>
+	OutputIteratorT Generate(OutputIteratorT itOutput, std::size_t uCount){
+		for(std::size_t uIndex = 0; uIndex < uCount; ++uIndex){
+			*itOutput = Get();
+			++itOutput;
+		}
+		return itOutput;
+	}
+
+public:
+	std::uint32_t operator()() noexcept {
+		return Get();
+	}
+};
+
+}
+
+#endif
@@ -3,6 +3,8 @@
 // Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
 
 #include "FastGenerator.hpp"
+#include "../Core/MinMax.hpp"
+#include <cstring>
 
 namespace MCF {
 
@@ -27,5 +29,27 @@ std::uint32_t FastGenerator::Get() noexcept {
 	x_u64Seed = u64NewSeed;
 	return (std::uint32_t)(u64NewSeed >> 32);
 }
+void FastGenerator::Fill(void *pBuffer, std::size_t uSize) noexcept {
+	// 把种子放在寄存器中，每次迭代写入两个值。
+	auto pbyWrite = static_cast<unsigned char *>(pBuffer);
+	const auto pbyEnd = pbyWrite + uSize;
+	auto u64Seed = x_u64Seed;
+	while(static_cast<std::size_t>(pbyEnd - pbyWrite) >= 8){
+		const auto u64Seed1 = u64Seed * kMultiplier + kIncrement;
+		const auto u64Seed2 = u64Seed1 * kMultiplier + kIncrement;
+		const std::uint64_t u64Word = (u64Seed1 >> 32) | (u64Seed2 >> 32 << 32);
+		std::memcpy(pbyWrite, &u64Word, 8);
+		pbyWrite += 8;
+		u64Seed = u64Seed2;
+	}
+	while(pbyWrite != pbyEnd){
+		u64Seed = u64Seed * kMultiplier + kIncrement;
+		const auto u32Word = (std::uint32_t)(u64Seed >> 32);
+		const auto uBytes = Min(static_cast<std::size_t>(pbyEnd - pbyWrite), 4u);
+		std::memcpy(pbyWrite, &u32Word, uBytes);
+		pbyWrite += uBytes;
+	}
+	x_u64Seed = u64Seed;
+}
 
 }
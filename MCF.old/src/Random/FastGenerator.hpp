@@ -6,6 +6,7 @@
 #define MCF_RANDOM_FAST_GENERATOR_HPP_
 
 #include "../Core/Clocks.hpp"
+#include <cstddef>
 
 namespace MCF {
 
@@ -22,6 +23,17 @@ public:
 	void Init(std::uint32_t u32Seed = ReadTimeStampCounter32()) noexcept;
 
 	std::uint32_t Get() noexcept;
+	// 输出的字节序列与连续调用 Get() 得到的小端序字节序列相同。
+	// 如果 uSize 不是 4 的倍数，最后一个值只使用前面的部分字节。
+	void Fill(void *pBuffer, std::size_t uSize) noexcept;
+	template<typename OutputIteratorT>
+	OutputIteratorT Generate(OutputIteratorT itOutput, std::size_t uCount){
+		for(std::size_t uIndex = 0; uIndex < uCount; ++uIndex){
+			*itOutput = Get();
+			++itOutput;
+		}
+		return itOutput;
+	}
 
 public:
 	std::uint32_t operator()() noexcept {
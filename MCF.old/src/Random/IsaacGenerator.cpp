@@ -4,6 +4,8 @@
 
 #include "IsaacGenerator.hpp"
 #include "../Core/CopyMoveFill.hpp"
+#include "../Core/MinMax.hpp"
+#include <cstring>
 
 namespace MCF {
 
@@ -34,7 +36,7 @@ void IsaacGenerator::X_RefreshInternal() noexcept {
 
 void IsaacGenerator::Init(std::uint32_t u32Seed) noexcept {
 	Array<std::uint32_t, 8> au32Seed;
-	Fill(au32Seed.GetBegin(), au32Seed.GetEnd(), u32Seed);
+	MCF::Fill(au32Seed.GetBegin(), au32Seed.GetEnd(), u32Seed);
 	Init(au32Seed);
 }
 void IsaacGenerator::Init(const Array<std::uint32_t, 8> &au32Seed) noexcept {
@@ -85,5 +87,29 @@ std::uint32_t IsaacGenerator::Get() noexcept {
 	x_uRead = (x_uRead + 1) % 256;
 	return u32Ret;
 }
+void IsaacGenerator::Fill(void *pBuffer, std::size_t uSize) noexcept {
+	auto pbyWrite = static_cast<unsigned char *>(pBuffer);
+	const auto pbyEnd = pbyWrite + uSize;
+	// 先用完当前块中剩余的值。
+	while((x_uRead != 0) && (static_cast<std::size_t>(pbyEnd - pbyWrite) >= 4)){
+		const auto u32Word = Get();
+		std::memcpy(pbyWrite, &u32Word, 4);
+		pbyWrite += 4;
+	}
+	// 整块输出时直接复制结果数组。x_uRead 保持为零，这与连续调用 256 次 Get() 的效果相同。
+	if(x_uRead == 0){
+		while(static_cast<std::size_t>(pbyEnd - pbyWrite) >= sizeof(x_au32Result)){
+			X_RefreshInternal();
+			std::memcpy(pbyWrite, x_au32Result, sizeof(x_au32Result));
+			pbyWrite += sizeof(x_au32Result);
+		}
+	}
+	while(pbyWrite != pbyEnd){
+		const auto u32Word = Get();
+		const auto uBytes = Min(static_cast<std::size_t>(pbyEnd - pbyWrite), 4u);
+		std::memcpy(pbyWrite, &u32Word, uBytes);
+		pbyWrite += uBytes;
+	}
+}
 
 }
@@ -7,6 +7,7 @@
 
 #include "../Core/Clocks.hpp"
 #include "../Core/Array.hpp"
+#include <cstddef>
 
 namespace MCF {
 
@@ -36,6 +37,17 @@ public:
 	void Init(const Array<std::uint32_t, 8> &au32Seed) noexcept;
 
 	std::uint32_t Get() noexcept;
+	// 输出的字节序列与连续调用 Get() 得到的小端序字节序列相同。
+	// 如果 uSize 不是 4 的倍数，最后一个值只使用前面的部分字节。
+	void Fill(void *pBuffer, std::size_t uSize) noexcept;
+	template<typename OutputIteratorT>
+	OutputIteratorT Generate(OutputIteratorT itOutput, std::size_t uCount){
+		for(std::size_t uIndex = 0; uIndex < uCount; ++uIndex){
+			*itOutput = Get();
+			++itOutput;
+		}
+		return itOutput;
+	}
 
 public:
 	std::uint32_t operator()() noexcept {
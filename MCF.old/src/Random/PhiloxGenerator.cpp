@@ -0,0 +1,157 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "PhiloxGenerator.hpp"
+#include "../Core/MinMax.hpp"
+#include <cstring>
+#include <emmintrin.h>
+
+namespace MCF {
+
+// John K. Salmon, Mark A. Moraes, Ron O. Dror, David E. Shaw,
+//   Parallel Random Numbers: As Easy as 1, 2, 3, SC '11, 2011.
+// https://github.com/DEShawResearch/random123
+
+namespace {
+	enum : std::uint32_t {
+		kMultiplier0 = 0xD2511F53,
+		kMultiplier1 = 0xCD9E8D57,
+		kWeyl0       = 0x9E3779B9,
+		kWeyl1       = 0xBB67AE85,
+	};
+
+	void GenerateOneBlock(std::uint32_t (&au32Result)[4], const std::uint32_t (&au32Key)[2], std::uint64_t u64Counter, std::uint64_t u64Stream) noexcept {
+		auto u32C0 = (std::uint32_t)u64Counter;
+		auto u32C1 = (std::uint32_t)(u64Counter >> 32);
+		auto u32C2 = (std::uint32_t)u64Stream;
+		auto u32C3 = (std::uint32_t)(u64Stream >> 32);
+		auto u32K0 = au32Key[0];
+		auto u32K1 = au32Key[1];
+		for(unsigned uRound = 0; uRound < 10; ++uRound){
+			const auto u64Product0 = (std::uint64_t)kMultiplier0 * u32C0;
+			const auto u64Product1 = (std::uint64_t)kMultiplier1 * u32C2;
+			u32C0 = (std::uint32_t)(u64Product1 >> 32) ^ u32C1 ^ u32K0;
+			u32C1 = (std::uint32_t)u64Product1;
+			u32C2 = (std::uint32_t)(u64Product0 >> 32) ^ u32C3 ^ u32K1;
+			u32C3 = (std::uint32_t)u64Product0;
+			u32K0 += kWeyl0;
+			u32K1 += kWeyl1;
+		}
+		au32Result[0] = u32C0;
+		au32Result[1] = u32C1;
+		au32Result[2] = u32C2;
+		au32Result[3] = u32C3;
+	}
+
+	// 四个块并行计算，每个 XMM 寄存器存放四个块中的同一个字。
+	// PMULUDQ 一次只能计算两个 32 位乘法，因此奇数和偶数通道分开计算。
+	inline void MultiplyFull(__m128i &xmmHi, __m128i &xmmLo, __m128i xmmLhs, __m128i xmmRhs) noexcept {
+		const auto xmmEven = _mm_mul_epu32(xmmLhs, xmmRhs);
+		const auto xmmOdd = _mm_mul_epu32(_mm_srli_epi64(xmmLhs, 32), xmmRhs);
+		const auto xmmMaskLo = _mm_set_epi32(0, -1, 0, -1);
+		xmmLo = _mm_or_si128(_mm_and_si128(xmmEven, xmmMaskLo), _mm_slli_epi64(xmmOdd, 32));
+		xmmHi = _mm_or_si128(_mm_srli_epi64(xmmEven, 32), _mm_andnot_si128(xmmMaskLo, xmmOdd));
+	}
+	void GenerateFourBlocks(void *pOutput, const std::uint32_t (&au32Key)[2], std::uint64_t u64Counter, std::uint64_t u64Stream) noexcept {
+		std::uint32_t au32CounterLo[4], au32CounterHi[4];
+		for(unsigned uIndex = 0; uIndex < 4; ++uIndex){
+			const auto u64BlockCounter = u64Counter + uIndex;
+			au32CounterLo[uIndex] = (std::uint32_t)u64BlockCounter;
+			au32CounterHi[uIndex] = (std::uint32_t)(u64BlockCounter >> 32);
+		}
+		auto xmmC0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(au32CounterLo));
+		auto xmmC1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(au32CounterHi));
+		auto xmmC2 = _mm_set1_epi32((int)(std::uint32_t)u64Stream);
+		auto xmmC3 = _mm_set1_epi32((int)(std::uint32_t)(u64Stream >> 32));
+		auto xmmK0 = _mm_set1_epi32((int)au32Key[0]);
+		auto xmmK1 = _mm_set1_epi32((int)au32Key[1]);
+		const auto xmmMultiplier0 = _mm_set1_epi32((int)kMultiplier0);
+		const auto xmmMultiplier1 = _mm_set1_epi32((int)kMultiplier1);
+		const auto xmmWeyl0 = _mm_set1_epi32((int)kWeyl0);
+		const auto xmmWeyl1 = _mm_set1_epi32((int)kWeyl1);
+		for(unsigned uRound = 0; uRound < 10; ++uRound){
+			__m128i xmmHi0, xmmLo0, xmmHi1, xmmLo1;
+			MultiplyFull(xmmHi0, xmmLo0, xmmC0, xmmMultiplier0);
+			MultiplyFull(xmmHi1, xmmLo1, xmmC2, xmmMultiplier1);
+			xmmC0 = _mm_xor_si128(_mm_xor_si128(xmmHi1, xmmC1), xmmK0);
+			xmmC1 = xmmLo1;
+			xmmC2 = _mm_xor_si128(_mm_xor_si128(xmmHi0, xmmC3), xmmK1);
+			xmmC3 = xmmLo0;
+			xmmK0 = _mm_add_epi32(xmmK0, xmmWeyl0);
+			xmmK1 = _mm_add_epi32(xmmK1, xmmWeyl1);
+		}
+		// 转置之后，每个块的 16 字节是连续的。
+		const auto pbyOutput = static_cast<unsigned char *>(pOutput);
+		const auto xmm01Lo = _mm_unpacklo_epi32(xmmC0, xmmC1);
+		const auto xmm01Hi = _mm_unpackhi_epi32(xmmC0, xmmC1);
+		const auto xmm23Lo = _mm_unpacklo_epi32(xmmC2, xmmC3);
+		const auto xmm23Hi = _mm_unpackhi_epi32(xmmC2, xmmC3);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(pbyOutput +  0), _mm_unpacklo_epi64(xmm01Lo, xmm23Lo));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(pbyOutput + 16), _mm_unpackhi_epi64(xmm01Lo, xmm23Lo));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(pbyOutput + 32), _mm_unpacklo_epi64(xmm01Hi, xmm23Hi));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(pbyOutput + 48), _mm_unpackhi_epi64(xmm01Hi, xmm23Hi));
+	}
+}
+
+void PhiloxGenerator::X_RefreshInternal() noexcept {
+	GenerateOneBlock(x_au32Result, x_au32Key, x_u64Counter, x_u64Stream);
+	++x_u64Counter;
+	x_uRead = 0;
+}
+
+void PhiloxGenerator::Init(std::uint32_t u32Seed, std::uint64_t u64Stream) noexcept {
+	Array<std::uint32_t, 2> au32Key;
+	au32Key[0] = u32Seed;
+	au32Key[1] = u32Seed ^ kWeyl0;
+	Init(au32Key, u64Stream);
+}
+void PhiloxGenerator::Init(const Array<std::uint32_t, 2> &au32Key, std::uint64_t u64Stream) noexcept {
+	x_au32Key[0] = au32Key[0];
+	x_au32Key[1] = au32Key[1];
+	x_u64Stream = u64Stream;
+	x_u64Counter = 0;
+	x_uRead = 4;
+}
+
+void PhiloxGenerator::Seek(std::uint64_t u64Position) noexcept {
+	x_u64Counter = u64Position / 4;
+	x_uRead = 4;
+	const auto uOffset = static_cast<unsigned>(u64Position % 4);
+	if(uOffset != 0){
+		X_RefreshInternal();
+		x_uRead = uOffset;
+	}
+}
+
+std::uint32_t PhiloxGenerator::Get() noexcept {
+	if(x_uRead == 4){
+		X_RefreshInternal();
+	}
+	return x_au32Result[x_uRead++];
+}
+void PhiloxGenerator::Fill(void *pBuffer, std::size_t uSize) noexcept {
+	auto pbyWrite = static_cast<unsigned char *>(pBuffer);
+	const auto pbyEnd = pbyWrite + uSize;
+	// 先用完当前块中剩余的值。
+	while((x_uRead != 4) && (static_cast<std::size_t>(pbyEnd - pbyWrite) >= 4)){
+		const auto u32Word = Get();
+		std::memcpy(pbyWrite, &u32Word, 4);
+		pbyWrite += 4;
+	}
+	if(x_uRead == 4){
+		while(static_cast<std::size_t>(pbyEnd - pbyWrite) >= 64){
+			GenerateFourBlocks(pbyWrite, x_au32Key, x_u64Counter, x_u64Stream);
+			x_u64Counter += 4;
+			pbyWrite += 64;
+		}
+	}
+	while(pbyWrite != pbyEnd){
+		const auto u32Word = Get();
+		const auto uBytes = Min(static_cast<std::size_t>(pbyEnd - pbyWrite), 4u);
+		std::memcpy(pbyWrite, &u32Word, uBytes);
+		pbyWrite += uBytes;
+	}
+}
+
+}
@@ -0,0 +1,53 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "Base64OutputStreamFilter.hpp"
+#include "../Core/MinMax.hpp"
+
+namespace MCF {
+
+namespace {
+	// 每次编码的最大字节数，是 3 的倍数。
+	constexpr std::size_t kChunkSize = 0xC000;
+}
+
+Base64OutputStreamFilter::~Base64OutputStreamFilter(){
+	try {
+		if(x_vEncoder.GetPendingSize() != 0){
+			Finalize();
+		}
+	} catch(...){ }
+}
+
+void Base64OutputStreamFilter::Put(unsigned char byData){
+	Base64OutputStreamFilter::Put(&byData, 1);
+}
+void Base64OutputStreamFilter::Put(const void *pData, std::size_t uSize){
+	const auto uCapacity = Base64Encoder::GetMaxEncodedSize(kChunkSize + 2);
+	if(x_vecOutput.GetSize() < uCapacity){
+		x_vecOutput.Resize(uCapacity);
+	}
+	std::size_t uBytesTotal = 0;
+	while(uBytesTotal < uSize){
+		const auto uBytesToEncode = Min(uSize - uBytesTotal, kChunkSize);
+		const auto uCharsWritten = x_vEncoder.Update(x_vecOutput.GetData(), static_cast<const unsigned char *>(pData) + uBytesTotal, uBytesToEncode);
+		if(uCharsWritten != 0){
+			GetUnderlyingStream()->Put(x_vecOutput.GetData(), uCharsWritten);
+		}
+		uBytesTotal += uBytesToEncode;
+	}
+}
+void Base64OutputStreamFilter::Flush(bool bHard){
+	GetUnderlyingStream()->Flush(bHard);
+}
+
+void Base64OutputStreamFilter::Finalize(){
+	char achTail[4];
+	const auto uCharsWritten = x_vEncoder.Finalize(achTail);
+	if(uCharsWritten != 0){
+		GetUnderlyingStream()->Put(achTail, uCharsWritten);
+	}
+}
+
+}
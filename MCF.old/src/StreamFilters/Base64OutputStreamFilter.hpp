@@ -0,0 +1,45 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_STREAM_FILTERS_BASE64_OUTPUT_STREAM_FILTER_HPP_
+#define MCF_STREAM_FILTERS_BASE64_OUTPUT_STREAM_FILTER_HPP_
+
+#include "AbstractOutputStreamFilter.hpp"
+#include "../Core/Base64.hpp"
+#include "../Containers/Vector.hpp"
+
+namespace MCF {
+
+// 把写入的数据编码为 Base64 文本，不插入换行符。
+// Flush() 不会编码不足三个字节的部分。Finalize() 编码剩下的字节并输出填充，之后的数据作为新的编码开始。
+class Base64OutputStreamFilter : public AbstractOutputStreamFilter {
+private:
+	Base64Encoder x_vEncoder;
+	Vector<char> x_vecOutput;
+
+public:
+	explicit Base64OutputStreamFilter(PolyIntrusivePtr<AbstractOutputStream> pUnderlyingStream, bool bUrlSafe = false, bool bPadding = true) noexcept
+		: AbstractOutputStreamFilter(std::move(pUnderlyingStream))
+		, x_vEncoder(bUrlSafe, bPadding)
+	{ }
+	~Base64OutputStreamFilter() override;
+
+public:
+	void Put(unsigned char byData) override;
+	void Put(const void *pData, std::size_t uSize) override;
+	void Flush(bool bHard) override;
+
+	bool IsUrlSafe() const noexcept {
+		return x_vEncoder.IsUrlSafe();
+	}
+	bool IsPaddingEnabled() const noexcept {
+		return x_vEncoder.IsPaddingEnabled();
+	}
+
+	void Finalize();
+};
+
+}
+
+#endif
@@ -15,6 +15,26 @@ BufferingInputStreamFilter::~BufferingInputStreamFilter(){
 	} catch(...){ }
 }
 
+void BufferingInputStreamFilter::X_Populate(std::size_t uSize){
+	if(x_uOffset != 0){
+		GetUnderlyingStream()->Discard(x_uOffset);
+		x_uOffset = 0;
+	}
+	x_vecBuffer.Clear();
+
+	x_vecBuffer.Reserve(Max(uSize, kPopulationThreshold * 2));
+	{
+		x_vecBuffer.UncheckedAppend(x_vecBuffer.GetCapacityRemaining());
+		try {
+			const auto uBytesRead = GetUnderlyingStream()->Peek(x_vecBuffer.GetData(), x_vecBuffer.GetSize());
+			x_vecBuffer.Pop(x_vecBuffer.GetSize() - uBytesRead);
+		} catch(...){
+			x_vecBuffer.Clear();
+			throw;
+		}
+	}
+}
+
 int BufferingInputStreamFilter::Peek(){
 	int nRet = -1;
 	unsigned char byData;
@@ -41,23 +61,7 @@ bool BufferingInputStreamFilter::Discard(){
 std::size_t BufferingInputStreamFilter::Peek(void *pData, std::size_t uSize){
 	std::size_t uBytesTotal = 0;
 	if(x_vecBuffer.GetSize() - x_uOffset < uSize){
-		if(x_uOffset != 0){
-			GetUnderlyingStream()->Discard(x_uOffset);
-			x_uOffset = 0;
-		}
-		x_vecBuffer.Clear();
-
-		x_vecBuffer.Reserve(Max(uSize, kPopulationThreshold * 2));
-		{
-			x_vecBuffer.UncheckedAppend(x_vecBuffer.GetCapacityRemaining());
-			try {
-				const auto uBytesRead = GetUnderlyingStream()->Peek(x_vecBuffer.GetData(), x_vecBuffer.GetSize());
-				x_vecBuffer.Pop(x_vecBuffer.GetSize() - uBytesRead);
-			} catch(...){
-				x_vecBuffer.Clear();
-				throw;
-			}
-		}
+		X_Populate(uSize);
 		const auto uBytesCopied = Min(uSize, x_vecBuffer.GetSize());
 		if(uBytesCopied > 0){
 			std::memcpy(pData, x_vecBuffer.GetData(), uBytesCopied);
@@ -104,5 +108,19 @@ void BufferingInputStreamFilter::Invalidate(){
 
 	GetUnderlyingStream()->Invalidate();
 }
+bool BufferingInputStreamFilter::Borrow(const void **ppData, std::size_t *puSize){
+	if(x_vecBuffer.GetSize() == x_uOffset){
+		X_Populate(0);
+		if(x_vecBuffer.IsEmpty()){
+			return false;
+		}
+	}
+	*ppData = x_vecBuffer.GetData() + x_uOffset;
+	*puSize = x_vecBuffer.GetSize() - x_uOffset;
+	return true;
+}
+void BufferingInputStreamFilter::Consume(std::size_t uSize){
+	BufferingInputStreamFilter::Discard(uSize);
+}
 
 }
@@ -15,6 +15,9 @@ private:
 	Vector<unsigned char> x_vecBuffer;
 	std::size_t x_uOffset = 0;
 
+private:
+	void X_Populate(std::size_t uSize);
+
 public:
 	explicit BufferingInputStreamFilter(PolyIntrusivePtr<AbstractInputStream> pUnderlyingStream) noexcept
 		: AbstractInputStreamFilter(std::move(pUnderlyingStream))
@@ -29,6 +32,8 @@ public:
 	std::size_t Get(void *pData, std::size_t uSize) override;
 	std::size_t Discard(std::size_t uSize) override;
 	void Invalidate() override;
+	bool Borrow(const void **ppData, std::size_t *puSize) override;
+	void Consume(std::size_t uSize) override;
 };
 
 }
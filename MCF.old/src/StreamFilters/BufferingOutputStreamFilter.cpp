@@ -30,6 +30,18 @@ void BufferingOutputStreamFilter::Put(const void *pData, std::size_t uSize){
 		x_vecBuffer.Clear();
 	}
 }
+void BufferingOutputStreamFilter::PutChunks(const StreamBuffer &sbufData){
+	if(x_vecBuffer.GetSize() + sbufData.GetSize() <= kFlushThreshold){
+		AbstractOutputStream::PutChunks(sbufData);
+		return;
+	}
+	// 数据足够多时不再经过缓冲区，直接交给下层的流。
+	if(x_vecBuffer.GetSize() > 0){
+		GetUnderlyingStream()->Put(x_vecBuffer.GetData(), x_vecBuffer.GetSize());
+		x_vecBuffer.Clear();
+	}
+	GetUnderlyingStream()->PutChunks(sbufData);
+}
 void BufferingOutputStreamFilter::Flush(bool bHard){
 	if(x_vecBuffer.GetSize() > 0){
 		GetUnderlyingStream()->Put(x_vecBuffer.GetData(), x_vecBuffer.GetSize());
@@ -0,0 +1,718 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "DeflateOutputStreamFilter.hpp"
+#include "../Core/Exception.hpp"
+#include "../Core/Endian.hpp"
+#include "../Core/MinMax.hpp"
+#include "../Core/CountLeadingTrailingZeroes.hpp"
+#include <algorithm>
+
+namespace MCF {
+
+using namespace Impl_Deflate;
+
+namespace {
+	enum : std::size_t {
+		kHashBits             = 15,
+		kHashSize             = 1u << kHashBits,
+		// 窗口缓冲区达到这个大小时，丢弃不再需要的数据。
+		kMaxWindowBufferSize  = 0x40000,
+		kMaxTokenCount        = 0x8000,
+	};
+
+	enum : std::uint32_t {
+		kTokenMatch = 0x80000000,  // 位 16 ~ 24 是长度，位 0 ~ 15 是距离。否则是一个字面量。
+	};
+
+	struct LevelConfig {
+		unsigned uMaxChain;    // 每个位置最多尝试的候选数。
+		unsigned uNiceLength;  // 找到这个长度的匹配之后不再尝试其他候选。
+		bool bLazy;            // 是否检查下一个位置有没有更长的匹配。
+	};
+
+	constexpr LevelConfig kLevelConfigs[] = {
+		{    0,   0, false },
+		{    4,   8, false },
+		{    8,  16, false },
+		{   16,  32, false },
+		{   16,  32, true  },
+		{   32,  64, true  },
+		{  128, 128, true  },
+		{  256, 128, true  },
+		{ 1024, 258, true  },
+		{ 4096, 258, true  },
+	};
+
+	struct CodeTables {
+		std::uint8_t au8LengthCodes[kMaxMatch + 1];
+		// 距离不超过 256 时使用 [距离 - 1]，否则使用 [256 + (距离 - 1) / 128]。
+		std::uint8_t au8DistanceCodes[512];
+	};
+
+	constexpr CodeTables GenerateCodeTables() noexcept {
+		CodeTables vRet = { };
+		for(unsigned uCode = 0; uCode < 29; ++uCode){
+			for(unsigned uLength = kLengthBase[uCode]; (uLength < kLengthBase[uCode] + (1u << kLengthExtraBits[uCode])) && (uLength <= kMaxMatch); ++uLength){
+				vRet.au8LengthCodes[uLength] = static_cast<std::uint8_t>(uCode);
+			}
+		}
+		for(unsigned uCode = 0; uCode < 30; ++uCode){
+			for(unsigned uDistance = kDistanceBase[uCode]; uDistance < kDistanceBase[uCode] + (1u << kDistanceExtraBits[uCode]); ++uDistance){
+				if(uDistance <= 256){
+					vRet.au8DistanceCodes[uDistance - 1] = static_cast<std::uint8_t>(uCode);
+				} else {
+					vRet.au8DistanceCodes[256 + (uDistance - 1) / 128] = static_cast<std::uint8_t>(uCode);
+				}
+			}
+		}
+		return vRet;
+	}
+
+	constexpr auto kCodeTables = GenerateCodeTables();
+
+	inline unsigned GetLengthCode(unsigned uLength) noexcept {
+		return kCodeTables.au8LengthCodes[uLength];
+	}
+	inline unsigned GetDistanceCode(unsigned uDistance) noexcept {
+		return (uDistance <= 256) ? kCodeTables.au8DistanceCodes[uDistance - 1] : kCodeTables.au8DistanceCodes[256 + (uDistance - 1) / 128];
+	}
+
+	inline std::uint32_t GetHash(const unsigned char *pbyData) noexcept {
+		const std::uint32_t u32Word = pbyData[0] | (static_cast<std::uint32_t>(pbyData[1]) << 8) | (static_cast<std::uint32_t>(pbyData[2]) << 16);
+		return (u32Word * 2654435761u) >> (32 - kHashBits);
+	}
+
+	// 根据频率计算长度受限的霍夫曼编码的码长。
+	// 先构造最优的霍夫曼树，如果有码长超过 uMaxLength，把它们截断之后再调整其他码长使得编码是完整的。
+	void BuildCodeLengths(unsigned char *pbyLengths, const std::uint32_t *pu32Frequencies, unsigned uCount, unsigned uMaxLength){
+		std::uint32_t au32Weights[2 * kLitLenSymbolCount];
+		std::uint16_t au16Symbols[kLitLenSymbolCount];
+		std::uint16_t au16Parents[2 * kLitLenSymbolCount];
+		unsigned auDepths[2 * kLitLenSymbolCount];
+
+		std::memset(pbyLengths, 0, uCount);
+		unsigned uLeafCount = 0;
+		for(unsigned uSymbol = 0; uSymbol < uCount; ++uSymbol){
+			if(pu32Frequencies[uSymbol] != 0){
+				au16Symbols[uLeafCount++] = static_cast<std::uint16_t>(uSymbol);
+			}
+		}
+		// 某些解码器不接受只有一个符号的编码，这里至少使用两个。
+		for(unsigned uSymbol = 0; uLeafCount < 2; ++uSymbol){
+			if(pu32Frequencies[uSymbol] == 0){
+				au16Symbols[uLeafCount++] = static_cast<std::uint16_t>(uSymbol);
+			}
+		}
+		std::sort(au16Symbols, au16Symbols + uLeafCount,
+			[&](unsigned uLeft, unsigned uRight){
+				return (pu32Frequencies[uLeft] != pu32Frequencies[uRight]) ? (pu32Frequencies[uLeft] < pu32Frequencies[uRight]) : (uLeft < uRight);
+			});
+		for(unsigned uIndex = 0; uIndex < uLeafCount; ++uIndex){
+			au32Weights[uIndex] = Max(pu32Frequencies[au16Symbols[uIndex]], static_cast<std::uint32_t>(1));
+		}
+
+		// 叶子按照权重升序排列，内部节点按照创建的顺序也是升序的，因此每次只需要比较两个队列的队首。
+		unsigned uNextLeaf = 0;
+		unsigned uNextNode = uLeafCount;
+		unsigned uNodeEnd = uLeafCount;
+		const auto fnPopSmallest = [&]{
+			if((uNextLeaf < uLeafCount) && ((uNextNode == uNodeEnd) || (au32Weights[uNextLeaf] <= au32Weights[uNextNode]))){
+				return uNextLeaf++;
+			}
+			return uNextNode++;
+		};
+		while(uNodeEnd < 2 * uLeafCount - 1){
+			const auto uFirst = fnPopSmallest();
+			const auto uSecond = fnPopSmallest();
+			au32Weights[uNodeEnd] = au32Weights[uFirst] + au32Weights[uSecond];
+			au16Parents[uFirst] = static_cast<std::uint16_t>(uNodeEnd);
+			au16Parents[uSecond] = static_cast<std::uint16_t>(uNodeEnd);
+			++uNodeEnd;
+		}
+		auDepths[uNodeEnd - 1] = 0;
+		for(unsigned uIndex = uNodeEnd - 1; uIndex != 0; --uIndex){
+			auDepths[uIndex - 1] = auDepths[au16Parents[uIndex - 1]] + 1;
+		}
+
+		unsigned auCounts[kMaxCodeLength + 1] = { };
+		for(unsigned uIndex = 0; uIndex < uLeafCount; ++uIndex){
+			++auCounts[Min(auDepths[uIndex], uMaxLength)];
+		}
+		std::uint32_t u32Total = 0;
+		for(unsigned uLength = 1; uLength <= uMaxLength; ++uLength){
+			u32Total += auCounts[uLength] << (uMaxLength - uLength);
+		}
+		while(u32Total != (1u << uMaxLength)){
+			// 把一个最长的编码去掉，再把一个较短的编码延长一位，使它变成两个编码。
+			--auCounts[uMaxLength];
+			for(unsigned uLength = uMaxLength - 1; uLength != 0; --uLength){
+				if(auCounts[uLength] != 0){
+					--auCounts[uLength];
+					auCounts[uLength + 1] += 2;
+					break;
+				}
+			}
+			--u32Total;
+		}
+
+		// 频率最低的符号使用最长的编码。
+		unsigned uIndex = 0;
+		for(unsigned uLength = uMaxLength; uLength != 0; --uLength){
+			for(unsigned uCounter = 0; uCounter < auCounts[uLength]; ++uCounter){
+				pbyLengths[au16Symbols[uIndex++]] = static_cast<unsigned char>(uLength);
+			}
+		}
+	}
+	// 根据码长计算范式霍夫曼编码。DEFLATE 的编码是从低位开始输出的，因此这里保存按位反序的编码。
+	void BuildCodes(std::uint16_t *pu16Codes, const unsigned char *pbyLengths, unsigned uCount) noexcept {
+		unsigned auCounts[kMaxCodeLength + 1] = { };
+		for(unsigned uSymbol = 0; uSymbol < uCount; ++uSymbol){
+			++auCounts[pbyLengths[uSymbol]];
+		}
+		auCounts[0] = 0;
+		unsigned auNextCodes[kMaxCodeLength + 1];
+		unsigned uCode = 0;
+		for(unsigned uLength = 1; uLength <= kMaxCodeLength; ++uLength){
+			uCode = (uCode + auCounts[uLength - 1]) << 1;
+			auNextCodes[uLength] = uCode;
+		}
+		for(unsigned uSymbol = 0; uSymbol < uCount; ++uSymbol){
+			const unsigned uLength = pbyLengths[uSymbol];
+			if(uLength == 0){
+				pu16Codes[uSymbol] = 0;
+				continue;
+			}
+			auto uNext = auNextCodes[uLength]++;
+			unsigned uReversed = 0;
+			for(unsigned uBit = 0; uBit < uLength; ++uBit){
+				uReversed = (uReversed << 1) | (uNext & 1);
+				uNext >>= 1;
+			}
+			pu16Codes[uSymbol] = static_cast<std::uint16_t>(uReversed);
+		}
+	}
+}
+
+DeflateOutputStreamFilter::DeflateOutputStreamFilter(PolyIntrusivePtr<AbstractOutputStream> pUnderlyingStream, Format eFormat, unsigned uLevel)
+	: AbstractOutputStreamFilter(std::move(pUnderlyingStream))
+	, x_eFormat(eFormat), x_uLevel(uLevel)
+{
+	if(eFormat > kFormatGzip){
+		MCF_THROW(Exception, ERROR_INVALID_PARAMETER, Rcntws::View(L"DeflateOutputStreamFilter: 数据格式无效。"));
+	}
+	if(uLevel > kLevelMax){
+		MCF_THROW(Exception, ERROR_INVALID_PARAMETER, Rcntws::View(L"DeflateOutputStreamFilter: 压缩级别无效。"));
+	}
+}
+DeflateOutputStreamFilter::~DeflateOutputStreamFilter(){
+	try {
+		if(x_bStreamStarted){
+			Finalize();
+		}
+	} catch(...){ }
+}
+
+void DeflateOutputStreamFilter::X_PutBits(std::uint32_t u32Bits, unsigned uCount){
+	x_u64Bits |= static_cast<std::uint64_t>(u32Bits) << x_uBitCount;
+	x_uBitCount += uCount;
+	if(x_uBitCount >= 32){
+		const auto pbyWrite = x_vecOutput.ResizeMore(4);
+		StoreLe(reinterpret_cast<std::uint32_t *>(pbyWrite)[0], static_cast<std::uint32_t>(x_u64Bits));
+		x_u64Bits >>= 32;
+		x_uBitCount -= 32;
+	}
+}
+void DeflateOutputStreamFilter::X_AlignToByte(){
+	while(x_uBitCount != 0){
+		x_vecOutput.Push(static_cast<unsigned char>(x_u64Bits));
+		x_u64Bits >>= 8;
+		x_uBitCount -= Min(x_uBitCount, 8u);
+	}
+	x_u64Bits = 0;
+}
+void DeflateOutputStreamFilter::X_PutOutput(){
+	if(x_vecOutput.IsEmpty()){
+		return;
+	}
+	GetUnderlyingStream()->Put(x_vecOutput.GetData(), x_vecOutput.GetSize());
+	x_vecOutput.Clear();
+}
+
+void DeflateOutputStreamFilter::X_StartStream(){
+	switch(x_eFormat){
+	case kFormatRaw:
+		break;
+
+	case kFormatZlib: {
+		// CM = 8，CINFO = 7（32 KiB 窗口）。
+		const unsigned uMethod = 0x78;
+		const unsigned uLevelFlags = (x_uLevel < 2) ? 0 : (x_uLevel < 6) ? 1 : (x_uLevel == 6) ? 2 : 3;
+		unsigned uFlags = uLevelFlags << 6;
+		uFlags += 31 - ((uMethod << 8) | uFlags) % 31;
+		const auto pbyWrite = x_vecOutput.ResizeMore(2);
+		pbyWrite[0] = static_cast<unsigned char>(uMethod);
+		pbyWrite[1] = static_cast<unsigned char>(uFlags);
+		break; }
+
+	case kFormatGzip: {
+		// ID1 ID2 CM FLG MTIME(4) XFL OS，OS = 11 表示 NTFS。
+		const auto pbyWrite = x_vecOutput.ResizeMore(10);
+		std::memcpy(pbyWrite, "\x1F\x8B\x08\x00\x00\x00\x00\x00\x00\x0B", 10);
+		pbyWrite[8] = static_cast<unsigned char>((x_uLevel == kLevelMax) ? 2 : (x_uLevel == kLevelFast) ? 4 : 0);
+		break; }
+	}
+
+	if((x_uLevel != kLevelStore) && x_vecHashHeads.IsEmpty()){
+		x_vecHashHeads.Resize(kHashSize);
+		x_vecHashChain.Resize(kWindowSize);
+	}
+	x_vCrc32.Reset();
+	x_vAdler32.Reset();
+	x_u32Size = 0;
+	x_bStreamStarted = true;
+}
+unsigned DeflateOutputStreamFilter::X_FindMatch(std::size_t uPos, std::size_t uLimit, unsigned uMinLength, unsigned *puDistance) const noexcept {
+	const auto &vConfig = kLevelConfigs[x_uLevel];
+	const auto pbyWindow = x_vecWindow.GetData();
+	const auto pbyCurrent = pbyWindow + uPos;
+
+	// 只返回比 uMinLength 更长的匹配。
+	std::size_t uBestLength = Max(uMinLength, static_cast<unsigned>(kMinMatch - 1));
+	if(uBestLength >= uLimit){
+		return 0;
+	}
+	unsigned uBestDistance = 0;
+	auto uChainRemaining = vConfig.uMaxChain;
+	auto u32Candidate = x_vecHashHeads.GetData()[GetHash(pbyCurrent)];
+	while((u32Candidate != 0) && (uChainRemaining != 0)){
+		--uChainRemaining;
+		const std::size_t uCandidatePos = u32Candidate - 1;
+		const auto uDistance = uPos - uCandidatePos;
+		if(uDistance >= kWindowSize){
+			break;
+		}
+		const auto pbyCandidate = pbyWindow + uCandidatePos;
+		if((pbyCandidate[uBestLength] == pbyCurrent[uBestLength]) && (pbyCandidate[0] == pbyCurrent[0])){
+			std::size_t uLength = 0;
+			for(;;){
+				if(uLimit - uLength < 8){
+					while((uLength < uLimit) && (pbyCandidate[uLength] == pbyCurrent[uLength])){
+						++uLength;
+					}
+					break;
+				}
+				const auto u64Diff = LoadLe(reinterpret_cast<const std::uint64_t *>(pbyCandidate + uLength)[0]) ^ LoadLe(reinterpret_cast<const std::uint64_t *>(pbyCurrent + uLength)[0]);
+				if(u64Diff != 0){
+					uLength += CountTrailingZeroes(u64Diff) / 8;
+					break;
+				}
+				uLength += 8;
+			}
+			if(uLength > uBestLength){
+				uBestLength = uLength;
+				uBestDistance = static_cast<unsigned>(uDistance);
+				if((uLength >= vConfig.uNiceLength) || (uLength == uLimit)){
+					break;
+				}
+			}
+		}
+		// 散列链中的位置是递减的，否则说明链中的这个元素已经被覆盖了。
+		const auto u32Next = x_vecHashChain.GetData()[uCandidatePos % kWindowSize];
+		if(u32Next >= u32Candidate){
+			break;
+		}
+		u32Candidate = u32Next;
+	}
+	if(uBestDistance == 0){
+		return 0;
+	}
+	*puDistance = uBestDistance;
+	return static_cast<unsigned>(uBestLength);
+}
+void DeflateOutputStreamFilter::X_InsertHash(std::size_t uPos) noexcept {
+	auto &u32Head = x_vecHashHeads.GetData()[GetHash(x_vecWindow.GetData() + uPos)];
+	x_vecHashChain.GetData()[uPos % kWindowSize] = u32Head;
+	u32Head = static_cast<std::uint32_t>(uPos + 1);
+}
+void DeflateOutputStreamFilter::X_Deflate(bool bFlush){
+	const auto uEnd = x_vecWindow.GetSize();
+	// 不刷新时保留足够的数据，使得每个位置都可以找到最长的匹配。
+	const auto uStop = bFlush ? uEnd : ((uEnd > kMaxMatch) ? (uEnd - kMaxMatch) : 0);
+	if(x_uLevel == kLevelStore){
+		x_uProcessed = Max(x_uProcessed, uStop);
+		return;
+	}
+
+	const auto &vConfig = kLevelConfigs[x_uLevel];
+	const auto pbyWindow = x_vecWindow.GetData();
+	const auto fnPushMatch = [&](unsigned uLength, unsigned uDistance){
+		x_vecTokens.Push(kTokenMatch | (uLength << 16) | uDistance);
+	};
+	const auto fnInsertRange = [&](std::size_t uBegin, std::size_t uRangeEnd){
+		for(auto uPos = uBegin; (uPos < uRangeEnd) && (uPos + kMinMatch <= uEnd); ++uPos){
+			X_InsertHash(uPos);
+		}
+	};
+
+	auto uPos = x_uProcessed;
+	while(uPos < uStop){
+		if(x_vecTokens.GetSize() >= kMaxTokenCount){
+			x_uProcessed = uPos;
+			X_WriteBlock(false);
+		}
+
+		unsigned uLength = 0;
+		unsigned uDistance = 0;
+		const auto uLimit = Min(static_cast<std::size_t>(kMaxMatch), uEnd - uPos);
+		if(uLimit >= kMinMatch){
+			if(!(x_bPrevPending && (x_uPrevLength >= vConfig.uNiceLength))){
+				uLength = X_FindMatch(uPos, uLimit, x_bPrevPending ? x_uPrevLength : 0, &uDistance);
+			}
+			X_InsertHash(uPos);
+		}
+
+		if(!vConfig.bLazy){
+			if(uLength != 0){
+				fnPushMatch(uLength, uDistance);
+				fnInsertRange(uPos + 1, uPos + uLength);
+				uPos += uLength;
+			} else {
+				x_vecTokens.Push(pbyWindow[uPos]);
+				++uPos;
+			}
+			continue;
+		}
+
+		// 惰性匹配：如果下一个位置的匹配不比当前位置的长，就使用当前位置的匹配。
+		if(x_bPrevPending){
+			if((x_uPrevLength >= kMinMatch) && (uLength == 0)){
+				fnPushMatch(x_uPrevLength, x_uPrevDistance);
+				const auto uMatchEnd = uPos - 1 + x_uPrevLength;
+				fnInsertRange(uPos + 1, uMatchEnd);
+				uPos = uMatchEnd;
+				x_bPrevPending = false;
+				continue;
+			}
+			x_vecTokens.Push(pbyWindow[uPos - 1]);
+		}
+		x_bPrevPending = true;
+		x_uPrevLength = uLength;
+		x_uPrevDistance = uDistance;
+		++uPos;
+	}
+	if(bFlush && x_bPrevPending){
+		// 最后一个位置之后没有数据，因此不可能有匹配。
+		x_vecTokens.Push(pbyWindow[uPos - 1]);
+		x_bPrevPending = false;
+	}
+	x_uProcessed = uPos;
+}
+void DeflateOutputStreamFilter::X_Slide(){
+	// 散列链是按照位置对窗口大小取模索引的，因此每次丢弃窗口大小的整数倍。
+	if(x_uProcessed <= kWindowSize){
+		return;
+	}
+	const auto uDelta = (x_uProcessed - kWindowSize) / kWindowSize * kWindowSize;
+	if(uDelta == 0){
+		return;
+	}
+	if(x_uBlockBegin < uDelta){
+		X_WriteBlock(false);
+	}
+
+	std::memmove(x_vecWindow.GetData(), x_vecWindow.GetData() + uDelta, x_vecWindow.GetSize() - uDelta);
+	x_vecWindow.Pop(uDelta);
+	x_uProcessed -= uDelta;
+	x_uBlockBegin -= uDelta;
+	const auto fnRebase = [&](Vector<std::uint32_t> &vecTable){
+		for(auto &u32Pos : vecTable){
+			u32Pos = (u32Pos > uDelta) ? static_cast<std::uint32_t>(u32Pos - uDelta) : 0;
+		}
+	};
+	fnRebase(x_vecHashHeads);
+	fnRebase(x_vecHashChain);
+}
+void DeflateOutputStreamFilter::X_WriteBlock(bool bFinal){
+	const auto uBlockEnd = x_uProcessed - (x_bPrevPending ? 1 : 0);
+	const auto pbyBlock = x_vecWindow.GetData() + x_uBlockBegin;
+	const auto uBlockSize = uBlockEnd - x_uBlockBegin;
+	if(!bFinal && (uBlockSize == 0)){
+		return;
+	}
+	const auto vUpdateBlockBegin = [&]{
+		x_vecTokens.Clear();
+		x_uBlockBegin = uBlockEnd;
+	};
+
+	const auto uStoredBlockCount = Max(static_cast<std::size_t>(1), (uBlockSize + kMaxStoredBlockSize - 1) / kMaxStoredBlockSize);
+	const auto u64StoredBits = (uBlockSize + uStoredBlockCount * 5) * 8 + 7;
+	if(x_uLevel == kLevelStore){
+		X_WriteStoredBlocks(pbyBlock, uBlockSize, bFinal);
+		vUpdateBlockBegin();
+		X_PutOutput();
+		return;
+	}
+
+	// 统计符号的频率。
+	std::uint32_t au32LitLenFrequencies[kLitLenSymbolCount] = { };
+	std::uint32_t au32DistanceFrequencies[kDistanceSymbolCount] = { };
+	std::uint64_t u64ExtraBits = 0;
+	for(const auto &u32Token : x_vecTokens){
+		if((u32Token & kTokenMatch) == 0){
+			++au32LitLenFrequencies[u32Token];
+			continue;
+		}
+		const unsigned uLengthCode = GetLengthCode((u32Token >> 16) & 0x1FF);
+		const unsigned uDistanceCode = GetDistanceCode(u32Token & 0xFFFF);
+		++au32LitLenFrequencies[kEndOfBlock + 1 + uLengthCode];
+		++au32DistanceFrequencies[uDistanceCode];
+		u64ExtraBits += kLengthExtraBits[uLengthCode] + kDistanceExtraBits[uDistanceCode];
+	}
+	++au32LitLenFrequencies[kEndOfBlock];
+
+	// 动态霍夫曼编码。
+	unsigned char abyLengths[286 + 30];
+	BuildCodeLengths(abyLengths, au32LitLenFrequencies, 286, kMaxCodeLength);
+	BuildCodeLengths(abyLengths + 286, au32DistanceFrequencies, 30, kMaxCodeLength);
+	unsigned uLitLenCount = 286;
+	while(abyLengths[uLitLenCount - 1] == 0){
+		--uLitLenCount;
+	}
+	unsigned uDistanceCount = 30;
+	while(abyLengths[286 + uDistanceCount - 1] == 0){
+		--uDistanceCount;
+	}
+	// 码长使用游程编码，每个元素的低 5 位是符号，其余的位是额外位的值。
+	unsigned char abyAllLengths[286 + 30];
+	std::memcpy(abyAllLengths, abyLengths, uLitLenCount);
+	std::memcpy(abyAllLengths + uLitLenCount, abyLengths + 286, uDistanceCount);
+	const unsigned uAllCount = uLitLenCount + uDistanceCount;
+	std::uint16_t au16CodeLengthTokens[286 + 30];
+	unsigned uCodeLengthTokenCount = 0;
+	std::uint32_t au32CodeLengthFrequencies[kCodeLengthCount] = { };
+	const auto fnPushCodeLength = [&](unsigned uSymbol, unsigned uExtra){
+		au16CodeLengthTokens[uCodeLengthTokenCount++] = static_cast<std::uint16_t>(uSymbol | (uExtra << 5));
+		++au32CodeLengthFrequencies[uSymbol];
+	};
+	for(unsigned uIndex = 0; uIndex < uAllCount; ){
+		const unsigned uValue = abyAllLengths[uIndex];
+		unsigned uRunLength = 1;
+		while((uIndex + uRunLength < uAllCount) && (abyAllLengths[uIndex + uRunLength] == uValue)){
+			++uRunLength;
+		}
+		uIndex += uRunLength;
+		if(uValue == 0){
+			while(uRunLength >= 11){
+				const auto uRepeatCount = Min(uRunLength, 138u);
+				fnPushCodeLength(18, uRepeatCount - 11);
+				uRunLength -= uRepeatCount;
+			}
+			if(uRunLength >= 3){
+				fnPushCodeLength(17, uRunLength - 3);
+				uRunLength = 0;
+			}
+		} else {
+			fnPushCodeLength(uValue, 0);
+			--uRunLength;
+			while(uRunLength >= 3){
+				const auto uRepeatCount = Min(uRunLength, 6u);
+				fnPushCodeLength(16, uRepeatCount - 3);
+				uRunLength -= uRepeatCount;
+			}
+		}
+		while(uRunLength != 0){
+			fnPushCodeLength(uValue, 0);
+			--uRunLength;
+		}
+	}
+	unsigned char abyCodeLengthLengths[kCodeLengthCount];
+	BuildCodeLengths(abyCodeLengthLengths, au32CodeLengthFrequencies, kCodeLengthCount, kMaxCodeLengthLength);
+	unsigned uCodeLengthCount = kCodeLengthCount;
+	while((uCodeLengthCount > 4) && (abyCodeLengthLengths[kCodeLengthOrder[uCodeLengthCount - 1]] == 0)){
+		--uCodeLengthCount;
+	}
+
+	// 比较三种方式的输出大小。
+	std::uint64_t u64DynamicBits = 3 + 5 + 5 + 4 + 3 * uCodeLengthCount + u64ExtraBits;
+	std::uint64_t u64FixedBits = 3 + u64ExtraBits;
+	for(unsigned uSymbol = 0; uSymbol < kCodeLengthCount; ++uSymbol){
+		u64DynamicBits += static_cast<std::uint64_t>(au32CodeLengthFrequencies[uSymbol]) * abyCodeLengthLengths[uSymbol];
+	}
+	u64DynamicBits += au32CodeLengthFrequencies[16] * 2 + au32CodeLengthFrequencies[17] * 3 + au32CodeLengthFrequencies[18] * 7;
+	for(unsigned uSymbol = 0; uSymbol < 286; ++uSymbol){
+		u64DynamicBits += static_cast<std::uint64_t>(au32LitLenFrequencies[uSymbol]) * abyLengths[uSymbol];
+		u64FixedBits += static_cast<std::uint64_t>(au32LitLenFrequencies[uSymbol]) * GetFixedLitLenLength(uSymbol);
+	}
+	for(unsigned uSymbol = 0; uSymbol < 30; ++uSymbol){
+		u64DynamicBits += static_cast<std::uint64_t>(au32DistanceFrequencies[uSymbol]) * abyLengths[286 + uSymbol];
+		u64FixedBits += static_cast<std::uint64_t>(au32DistanceFrequencies[uSymbol]) * kFixedDistanceLength;
+	}
+	if((u64StoredBits <= u64DynamicBits) && (u64StoredBits <= u64FixedBits)){
+		X_WriteStoredBlocks(pbyBlock, uBlockSize, bFinal);
+		vUpdateBlockBegin();
+		X_PutOutput();
+		return;
+	}
+
+	std::uint16_t au16LitLenCodes[kLitLenSymbolCount];
+	std::uint16_t au16DistanceCodes[30];
+	const unsigned char *pbyLitLenLengths;
+	const unsigned char *pbyDistanceLengths;
+	unsigned uLitLenSymbolCount;
+	// 固定霍夫曼编码包含不会出现的符号 286 和 287，计算编码时不能省略它们。
+	unsigned char abyFixedLengths[kLitLenSymbolCount + 30];
+	if(u64DynamicBits < u64FixedBits){
+		pbyLitLenLengths = abyLengths;
+		pbyDistanceLengths = abyLengths + 286;
+		uLitLenSymbolCount = 286;
+
+		std::uint16_t au16CodeLengthCodes[kCodeLengthCount];
+		BuildCodes(au16CodeLengthCodes, abyCodeLengthLengths, kCodeLengthCount);
+		X_PutBits((bFinal ? 1u : 0u) | (2u << 1), 3);
+		X_PutBits(uLitLenCount - 257, 5);
+		X_PutBits(uDistanceCount - 1, 5);
+		X_PutBits(uCodeLengthCount - 4, 4);
+		for(unsigned uIndex = 0; uIndex < uCodeLengthCount; ++uIndex){
+			X_PutBits(abyCodeLengthLengths[kCodeLengthOrder[uIndex]], 3);
+		}
+		for(unsigned uIndex = 0; uIndex < uCodeLengthTokenCount; ++uIndex){
+			const unsigned uSymbol = au16CodeLengthTokens[uIndex] & 0x1F;
+			X_PutBits(au16CodeLengthCodes[uSymbol], abyCodeLengthLengths[uSymbol]);
+			if(uSymbol >= 16){
+				static constexpr unsigned char kRepeatExtraBits[3] = { 2, 3, 7 };
+				X_PutBits(au16CodeLengthTokens[uIndex] >> 5u, kRepeatExtraBits[uSymbol - 16]);
+			}
+		}
+	} else {
+		for(unsigned uSymbol = 0; uSymbol < kLitLenSymbolCount; ++uSymbol){
+			abyFixedLengths[uSymbol] = static_cast<unsigned char>(GetFixedLitLenLength(uSymbol));
+		}
+		std::memset(abyFixedLengths + kLitLenSymbolCount, kFixedDistanceLength, 30);
+		pbyLitLenLengths = abyFixedLengths;
+		pbyDistanceLengths = abyFixedLengths + kLitLenSymbolCount;
+		uLitLenSymbolCount = kLitLenSymbolCount;
+
+		X_PutBits((bFinal ? 1u : 0u) | (1u << 1), 3);
+	}
+	BuildCodes(au16LitLenCodes, pbyLitLenLengths, uLitLenSymbolCount);
+	BuildCodes(au16DistanceCodes, pbyDistanceLengths, 30);
+
+	x_vecOutput.Reserve(x_vecOutput.GetSize() + static_cast<std::size_t>(Min(u64DynamicBits, u64FixedBits) / 8) + 16);
+	for(const auto &u32Token : x_vecTokens){
+		if((u32Token & kTokenMatch) == 0){
+			X_PutBits(au16LitLenCodes[u32Token], pbyLitLenLengths[u32Token]);
+			continue;
+		}
+		const unsigned uLength = (u32Token >> 16) & 0x1FF;
+		const unsigned uDistance = u32Token & 0xFFFF;
+		const unsigned uLengthCode = GetLengthCode(uLength);
+		const unsigned uLengthSymbol = kEndOfBlock + 1 + uLengthCode;
+		X_PutBits(au16LitLenCodes[uLengthSymbol], pbyLitLenLengths[uLengthSymbol]);
+		X_PutBits(uLength - kLengthBase[uLengthCode], kLengthExtraBits[uLengthCode]);
+		const unsigned uDistanceCode = GetDistanceCode(uDistance);
+		X_PutBits(au16DistanceCodes[uDistanceCode], pbyDistanceLengths[uDistanceCode]);
+		X_PutBits(uDistance - kDistanceBase[uDistanceCode], kDistanceExtraBits[uDistanceCode]);
+	}
+	X_PutBits(au16LitLenCodes[kEndOfBlock], pbyLitLenLengths[kEndOfBlock]);
+
+	vUpdateBlockBegin();
+	X_PutOutput();
+}
+void DeflateOutputStreamFilter::X_WriteStoredBlocks(const unsigned char *pbyData, std::size_t uSize, bool bFinal){
+	auto pbyRead = pbyData;
+	auto uBytesRemaining = uSize;
+	do {
+		const auto uChunkSize = Min(uBytesRemaining, static_cast<std::size_t>(kMaxStoredBlockSize));
+		const bool bLast = bFinal && (uChunkSize == uBytesRemaining);
+		X_PutBits(bLast ? 1u : 0u, 3);
+		X_AlignToByte();
+		const auto pbyWrite = x_vecOutput.ResizeMore(4 + uChunkSize);
+		StoreLe(reinterpret_cast<std::uint16_t *>(pbyWrite)[0], static_cast<std::uint16_t>(uChunkSize));
+		StoreLe(reinterpret_cast<std::uint16_t *>(pbyWrite)[1], static_cast<std::uint16_t>(~uChunkSize));
+		if(uChunkSize != 0){
+			std::memcpy(pbyWrite + 4, pbyRead, uChunkSize);
+		}
+		pbyRead += uChunkSize;
+		uBytesRemaining -= uChunkSize;
+	} while(uBytesRemaining != 0);
+}
+
+void DeflateOutputStreamFilter::Put(unsigned char byData){
+	DeflateOutputStreamFilter::Put(&byData, 1);
+}
+void DeflateOutputStreamFilter::Put(const void *pData, std::size_t uSize){
+	if(!x_bStreamStarted){
+		X_StartStream();
+	}
+	if(x_eFormat == kFormatGzip){
+		x_vCrc32.Put(pData, uSize);
+		x_u32Size += static_cast<std::uint32_t>(uSize);
+	} else if(x_eFormat == kFormatZlib){
+		x_vAdler32.Update(pData, uSize);
+	}
+
+	std::size_t uBytesTotal = 0;
+	while(uBytesTotal < uSize){
+		const auto uBytesToCopy = Min(uSize - uBytesTotal, kMaxWindowBufferSize - x_vecWindow.GetSize());
+		const auto pbyWrite = x_vecWindow.ResizeMore(uBytesToCopy);
+		std::memcpy(pbyWrite, static_cast<const unsigned char *>(pData) + uBytesTotal, uBytesToCopy);
+		uBytesTotal += uBytesToCopy;
+		x_bDataPending = true;
+		if(x_vecWindow.GetSize() == kMaxWindowBufferSize){
+			X_Deflate(false);
+			X_Slide();
+		}
+	}
+}
+void DeflateOutputStreamFilter::Flush(bool bHard){
+	if(x_bDataPending){
+		X_Deflate(true);
+		X_WriteBlock(false);
+		// 输出一个空的不压缩的块，使得之前的数据都对齐到字节。
+		X_WriteStoredBlocks(nullptr, 0, false);
+		x_bDataPending = false;
+	}
+	X_PutOutput();
+
+	GetUnderlyingStream()->Flush(bHard);
+}
+
+void DeflateOutputStreamFilter::Finalize(){
+	if(!x_bStreamStarted){
+		X_StartStream();
+	}
+	X_Deflate(true);
+	X_WriteBlock(true);
+	X_AlignToByte();
+
+	switch(x_eFormat){
+	case kFormatRaw:
+		break;
+
+	case kFormatZlib: {
+		const auto pbyWrite = x_vecOutput.ResizeMore(4);
+		StoreBe(reinterpret_cast<std::uint32_t *>(pbyWrite)[0], x_vAdler32.Finalize());
+		break; }
+
+	case kFormatGzip: {
+		const auto pbyWrite = x_vecOutput.ResizeMore(8);
+		StoreLe(reinterpret_cast<std::uint32_t *>(pbyWrite)[0], x_vCrc32.Finalize());
+		StoreLe(reinterpret_cast<std::uint32_t *>(pbyWrite)[1], x_u32Size);
+		break; }
+	}
+	X_PutOutput();
+
+	x_vecWindow.Clear();
+	x_uProcessed = 0;
+	x_uBlockBegin = 0;
+	for(auto &u32Pos : x_vecHashHeads){
+		u32Pos = 0;
+	}
+	x_bPrevPending = false;
+	x_bStreamStarted = false;
+	x_bDataPending = false;
+}
+
+}
@@ -0,0 +1,94 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_STREAM_FILTERS_DEFLATE_OUTPUT_STREAM_FILTER_HPP_
+#define MCF_STREAM_FILTERS_DEFLATE_OUTPUT_STREAM_FILTER_HPP_
+
+#include "AbstractOutputStreamFilter.hpp"
+#include "_Deflate.hpp"
+#include "../Streams/Crc32OutputStream.hpp"
+#include "../Containers/Vector.hpp"
+
+namespace MCF {
+
+// 输出 DEFLATE 格式的数据，可以带有 zlib 或 gzip 的头部与尾部。每个块选择动态霍夫曼编码、固定霍夫曼编码和不压缩中输出最短的一种。
+// Flush() 输出所有已经写入的数据并且在末尾对齐到字节（相当于 zlib 的 Z_SYNC_FLUSH），但是不结束当前的数据流。
+// Finalize() 结束当前的数据流，之后的数据写入一个新的数据流。
+class DeflateOutputStreamFilter : public AbstractOutputStreamFilter {
+public:
+	enum Format : unsigned {
+		kFormatRaw  = 0,
+		kFormatZlib = 1,
+		kFormatGzip = 2,
+	};
+
+	enum Level : unsigned {
+		kLevelStore   = 0,  // 只输出不压缩的块。
+		kLevelFast    = 1,
+		kLevelDefault = 6,
+		kLevelMax     = 9,
+	};
+
+private:
+	Format x_eFormat;
+	unsigned x_uLevel;
+
+	// [0, x_uProcessed) 是已经匹配过的数据，它之后是等待匹配的数据。
+	Vector<unsigned char> x_vecWindow;
+	std::size_t x_uProcessed = 0;
+	std::size_t x_uBlockBegin = 0;
+	Vector<std::uint32_t> x_vecHashHeads;
+	Vector<std::uint32_t> x_vecHashChain;
+	// 惰性匹配时，上一个位置的匹配结果。
+	bool x_bPrevPending = false;
+	unsigned x_uPrevLength = 0;
+	unsigned x_uPrevDistance = 0;
+
+	Vector<std::uint32_t> x_vecTokens;
+	Vector<unsigned char> x_vecOutput;
+	std::uint64_t x_u64Bits = 0;
+	unsigned x_uBitCount = 0;
+
+	bool x_bStreamStarted = false;
+	bool x_bDataPending = false;
+	Crc32OutputStream x_vCrc32;
+	Impl_Deflate::Adler32 x_vAdler32;
+	std::uint32_t x_u32Size = 0;
+
+private:
+	void X_PutBits(std::uint32_t u32Bits, unsigned uCount);
+	void X_AlignToByte();
+	void X_PutOutput();
+
+	void X_StartStream();
+	unsigned X_FindMatch(std::size_t uPos, std::size_t uLimit, unsigned uMinLength, unsigned *puDistance) const noexcept;
+	void X_InsertHash(std::size_t uPos) noexcept;
+	void X_Deflate(bool bFlush);
+	void X_Slide();
+	void X_WriteBlock(bool bFinal);
+	void X_WriteStoredBlocks(const unsigned char *pbyData, std::size_t uSize, bool bFinal);
+
+public:
+	explicit DeflateOutputStreamFilter(PolyIntrusivePtr<AbstractOutputStream> pUnderlyingStream, Format eFormat = kFormatGzip, unsigned uLevel = kLevelDefault);
+	~DeflateOutputStreamFilter() override;
+
+public:
+	void Put(unsigned char byData) override;
+	void Put(const void *pData, std::size_t uSize) override;
+	void Flush(bool bHard) override;
+
+	Format GetFormat() const noexcept {
+		return x_eFormat;
+	}
+	unsigned GetLevel() const noexcept {
+		return x_uLevel;
+	}
+
+	// 结束当前的数据流。即使没有写入任何数据，也会输出一个空的数据流。
+	void Finalize();
+};
+
+}
+
+#endif
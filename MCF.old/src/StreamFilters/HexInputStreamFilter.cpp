@@ -0,0 +1,137 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "HexInputStreamFilter.hpp"
+#include "../Core/Exception.hpp"
+#include "../Core/MinMax.hpp"
+
+namespace MCF {
+
+namespace {
+	// 每次从下层流读取的最大字符数。
+	constexpr std::size_t kChunkSize = 0x10000;
+}
+
+HexInputStreamFilter::~HexInputStreamFilter(){ }
+
+bool HexInputStreamFilter::X_Decode(){
+	if(x_bEnded){
+		return false;
+	}
+	// 丢弃已经读取的数据。
+	if(x_uOffset != 0){
+		std::memmove(x_vecBuffer.GetData(), x_vecBuffer.GetData() + x_uOffset, x_uEnd - x_uOffset);
+		x_uEnd -= x_uOffset;
+		x_uOffset = 0;
+	}
+	if(x_vecInput.GetSize() < kChunkSize){
+		x_vecInput.Resize(kChunkSize);
+	}
+	const auto uCapacity = x_uEnd + HexDecoder::GetMaxDecodedSize(kChunkSize);
+	if(x_vecBuffer.GetSize() < uCapacity){
+		x_vecBuffer.Resize(uCapacity);
+	}
+
+	const auto uCharsRead = GetUnderlyingStream()->Get(x_vecInput.GetData(), kChunkSize);
+	std::size_t uBytesWritten;
+	if(uCharsRead == 0){
+		// 下层流结束，检查数据是否完整。
+		uBytesWritten = x_vDecoder.Finalize() ? 0 : SIZE_MAX;
+		x_bEnded = true;
+	} else {
+		uBytesWritten = x_vDecoder.Update(x_vecBuffer.GetData() + x_uEnd, x_vecInput.GetData(), uCharsRead);
+	}
+	if(uBytesWritten == SIZE_MAX){
+		x_vDecoder.Reset();
+		MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"HexInputStreamFilter: 十六进制数据无效。"));
+	}
+	x_uEnd += uBytesWritten;
+	return true;
+}
+bool HexInputStreamFilter::X_Populate(std::size_t uMinSize){
+	while(x_uEnd - x_uOffset < uMinSize){
+		if(!X_Decode()){
+			return false;
+		}
+	}
+	return true;
+}
+
+int HexInputStreamFilter::Peek(){
+	int nRet = -1;
+	unsigned char byData;
+	if(HexInputStreamFilter::Peek(&byData, 1) >= 1){
+		nRet = byData;
+	}
+	return nRet;
+}
+int HexInputStreamFilter::Get(){
+	int nRet = -1;
+	unsigned char byData;
+	if(HexInputStreamFilter::Get(&byData, 1) >= 1){
+		nRet = byData;
+	}
+	return nRet;
+}
+bool HexInputStreamFilter::Discard(){
+	bool bRet = false;
+	if(HexInputStreamFilter::Discard(1) >= 1){
+		bRet = true;
+	}
+	return bRet;
+}
+std::size_t HexInputStreamFilter::Peek(void *pData, std::size_t uSize){
+	X_Populate(uSize);
+	const auto uBytesCopied = Min(uSize, x_uEnd - x_uOffset);
+	if(uBytesCopied > 0){
+		std::memcpy(pData, x_vecBuffer.GetData() + x_uOffset, uBytesCopied);
+	}
+	return uBytesCopied;
+}
+std::size_t HexInputStreamFilter::Get(void *pData, std::size_t uSize){
+	std::size_t uBytesTotal = 0;
+	while(uBytesTotal < uSize){
+		if(!X_Populate(1)){
+			break;
+		}
+		const auto uBytesCopied = Min(uSize - uBytesTotal, x_uEnd - x_uOffset);
+		std::memcpy(static_cast<unsigned char *>(pData) + uBytesTotal, x_vecBuffer.GetData() + x_uOffset, uBytesCopied);
+		x_uOffset += uBytesCopied;
+		uBytesTotal += uBytesCopied;
+	}
+	return uBytesTotal;
+}
+std::size_t HexInputStreamFilter::Discard(std::size_t uSize){
+	std::size_t uBytesTotal = 0;
+	while(uBytesTotal < uSize){
+		if(!X_Populate(1)){
+			break;
+		}
+		const auto uBytesDiscarded = Min(uSize - uBytesTotal, x_uEnd - x_uOffset);
+		x_uOffset += uBytesDiscarded;
+		uBytesTotal += uBytesDiscarded;
+	}
+	return uBytesTotal;
+}
+void HexInputStreamFilter::Invalidate(){
+	x_vDecoder.Reset();
+	x_uOffset = 0;
+	x_uEnd = 0;
+	x_bEnded = false;
+
+	GetUnderlyingStream()->Invalidate();
+}
+bool HexInputStreamFilter::Borrow(const void **ppData, std::size_t *puSize){
+	if(!X_Populate(1)){
+		return false;
+	}
+	*ppData = x_vecBuffer.GetData() + x_uOffset;
+	*puSize = x_uEnd - x_uOffset;
+	return true;
+}
+void HexInputStreamFilter::Consume(std::size_t uSize){
+	HexInputStreamFilter::Discard(uSize);
+}
+
+}
@@ -0,0 +1,54 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_STREAM_FILTERS_HEX_INPUT_STREAM_FILTER_HPP_
+#define MCF_STREAM_FILTERS_HEX_INPUT_STREAM_FILTER_HPP_
+
+#include "AbstractInputStreamFilter.hpp"
+#include "../Core/Hex.hpp"
+#include "../Containers/Vector.hpp"
+
+namespace MCF {
+
+// 解码十六进制文本。数据无效时抛出 ERROR_INVALID_DATA。
+// Invalidate() 丢弃已经解码但是还没有被读取的数据，下一次读取从一个新的编码开始。
+class HexInputStreamFilter : public AbstractInputStreamFilter {
+private:
+	HexDecoder x_vDecoder;
+	Vector<char> x_vecInput;
+	Vector<unsigned char> x_vecBuffer;
+	std::size_t x_uOffset = 0;
+	std::size_t x_uEnd = 0;
+	bool x_bEnded = false;
+
+private:
+	bool X_Decode();
+	bool X_Populate(std::size_t uMinSize);
+
+public:
+	explicit HexInputStreamFilter(PolyIntrusivePtr<AbstractInputStream> pUnderlyingStream, HexDecoder::Mode eMode = HexDecoder::kModeStrict) noexcept
+		: AbstractInputStreamFilter(std::move(pUnderlyingStream))
+		, x_vDecoder(eMode)
+	{ }
+	~HexInputStreamFilter() override;
+
+public:
+	int Peek() override;
+	int Get() override;
+	bool Discard() override;
+	std::size_t Peek(void *pData, std::size_t uSize) override;
+	std::size_t Get(void *pData, std::size_t uSize) override;
+	std::size_t Discard(std::size_t uSize) override;
+	void Invalidate() override;
+	bool Borrow(const void **ppData, std::size_t *puSize) override;
+	void Consume(std::size_t uSize) override;
+
+	HexDecoder::Mode GetMode() const noexcept {
+		return x_vDecoder.GetMode();
+	}
+};
+
+}
+
+#endif
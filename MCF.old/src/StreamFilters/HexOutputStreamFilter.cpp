@@ -0,0 +1,37 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "HexOutputStreamFilter.hpp"
+#include "../Core/MinMax.hpp"
+
+namespace MCF {
+
+namespace {
+	// 每次编码的最大字节数。
+	constexpr std::size_t kChunkSize = 0x8000;
+}
+
+HexOutputStreamFilter::~HexOutputStreamFilter(){ }
+
+void HexOutputStreamFilter::Put(unsigned char byData){
+	HexOutputStreamFilter::Put(&byData, 1);
+}
+void HexOutputStreamFilter::Put(const void *pData, std::size_t uSize){
+	const auto uCapacity = HexEncoder::GetEncodedSize(kChunkSize);
+	if(x_vecOutput.GetSize() < uCapacity){
+		x_vecOutput.Resize(uCapacity);
+	}
+	std::size_t uBytesTotal = 0;
+	while(uBytesTotal < uSize){
+		const auto uBytesToEncode = Min(uSize - uBytesTotal, kChunkSize);
+		const auto uCharsWritten = x_vEncoder.Update(x_vecOutput.GetData(), static_cast<const unsigned char *>(pData) + uBytesTotal, uBytesToEncode);
+		GetUnderlyingStream()->Put(x_vecOutput.GetData(), uCharsWritten);
+		uBytesTotal += uBytesToEncode;
+	}
+}
+void HexOutputStreamFilter::Flush(bool bHard){
+	GetUnderlyingStream()->Flush(bHard);
+}
+
+}
@@ -0,0 +1,39 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_STREAM_FILTERS_HEX_OUTPUT_STREAM_FILTER_HPP_
+#define MCF_STREAM_FILTERS_HEX_OUTPUT_STREAM_FILTER_HPP_
+
+#include "AbstractOutputStreamFilter.hpp"
+#include "../Core/Hex.hpp"
+#include "../Containers/Vector.hpp"
+
+namespace MCF {
+
+// 把写入的数据编码为十六进制文本，不插入分隔符或换行符。
+class HexOutputStreamFilter : public AbstractOutputStreamFilter {
+private:
+	HexEncoder x_vEncoder;
+	Vector<char> x_vecOutput;
+
+public:
+	explicit HexOutputStreamFilter(PolyIntrusivePtr<AbstractOutputStream> pUnderlyingStream, bool bUpperCase = false) noexcept
+		: AbstractOutputStreamFilter(std::move(pUnderlyingStream))
+		, x_vEncoder(bUpperCase)
+	{ }
+	~HexOutputStreamFilter() override;
+
+public:
+	void Put(unsigned char byData) override;
+	void Put(const void *pData, std::size_t uSize) override;
+	void Flush(bool bHard) override;
+
+	bool IsUpperCase() const noexcept {
+		return x_vEncoder.IsUpperCase();
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,849 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "InflateInputStreamFilter.hpp"
+#include "../Core/Exception.hpp"
+#include "../Core/Endian.hpp"
+#include "../Core/MinMax.hpp"
+#include "../Core/Defer.hpp"
+#include "../Core/Assert.hpp"
+
+namespace MCF {
+
+using namespace Impl_Deflate;
+
+namespace {
+	enum : std::size_t {
+		// 每次解压的输出的大小。
+		kChunkSize = 0x10000,
+	};
+
+	// 查找表的每个元素是一个 32 位整数。位 0 ~ 4 是需要丢弃的位数，位 5 ~ 7 是元素的类型。
+	enum : std::uint32_t {
+		kEntryLiteral    = 0x00,  // 一个字面量，位 8 ~ 15 是它的值。
+		kEntryLiteral2   = 0x20,  // 两个字面量，位 8 ~ 15 和位 16 ~ 23 依次是它们的值。
+		kEntryLength     = 0x40,  // 长度或距离，位 8 ~ 15 是额外位数，位 16 ~ 31 是基数。
+		kEntryEndOfBlock = 0x60,
+		kEntrySubtable   = 0x80,  // 二级表，位 8 ~ 15 是它的索引位数，位 16 ~ 31 是它的起始位置。
+		kEntryInvalid    = 0xA0,
+
+		kEntryBitsMask   = 0x1F,
+		kEntryKindMask   = 0xE0,
+	};
+
+	enum : unsigned {
+		kLitLenTableBits     = 11,
+		kDistanceTableBits   = 8,
+		kCodeLengthTableBits = 7,
+	};
+
+	std::uint32_t MakeLitLenEntry(unsigned uSymbol) noexcept {
+		if(uSymbol < kEndOfBlock){
+			return kEntryLiteral | (uSymbol << 8);
+		}
+		if(uSymbol == kEndOfBlock){
+			return kEntryEndOfBlock;
+		}
+		const auto uIndex = uSymbol - kEndOfBlock - 1;
+		if(uIndex < sizeof(kLengthBase) / sizeof(kLengthBase[0])){
+			return kEntryLength | (static_cast<std::uint32_t>(kLengthExtraBits[uIndex]) << 8) | (static_cast<std::uint32_t>(kLengthBase[uIndex]) << 16);
+		}
+		return kEntryInvalid;
+	}
+	std::uint32_t MakeDistanceEntry(unsigned uSymbol) noexcept {
+		if(uSymbol < sizeof(kDistanceBase) / sizeof(kDistanceBase[0])){
+			return kEntryLength | (static_cast<std::uint32_t>(kDistanceExtraBits[uSymbol]) << 8) | (static_cast<std::uint32_t>(kDistanceBase[uSymbol]) << 16);
+		}
+		return kEntryInvalid;
+	}
+	std::uint32_t MakeCodeLengthEntry(unsigned uSymbol) noexcept {
+		return kEntryLiteral | (uSymbol << 8);
+	}
+
+	// 构造范式霍夫曼编码的查找表。码长大于 uTableBits 的编码放在二级表中。
+	// 如果编码是过载的则返回 false；不完整的编码是允许的，未使用的元素被标记为无效。
+	template<typename EntryMakerT>
+	bool BuildDecodingTable(Vector<std::uint32_t> &vecTable, const unsigned char *pbyLengths, unsigned uCount, unsigned uTableBits, EntryMakerT &&fnMakeEntry){
+		unsigned auCounts[kMaxCodeLength + 1] = { };
+		for(unsigned uSymbol = 0; uSymbol < uCount; ++uSymbol){
+			++auCounts[pbyLengths[uSymbol]];
+		}
+		auCounts[0] = 0;
+
+		int nCodesLeft = 1;
+		unsigned auNextCodes[kMaxCodeLength + 1];
+		unsigned uCode = 0;
+		for(unsigned uLength = 1; uLength <= kMaxCodeLength; ++uLength){
+			nCodesLeft = nCodesLeft * 2 - static_cast<int>(auCounts[uLength]);
+			if(nCodesLeft < 0){
+				return false;
+			}
+			uCode = (uCode + auCounts[uLength - 1]) << 1;
+			auNextCodes[uLength] = uCode;
+		}
+
+		// DEFLATE 的编码是从低位开始读取的，因此这里保存按位反序的编码。
+		const unsigned uPrimarySize = 1u << uTableBits;
+		std::uint16_t au16Codes[kLitLenSymbolCount];
+		unsigned char abySubtableBits[1u << kLitLenTableBits] = { };
+		for(unsigned uSymbol = 0; uSymbol < uCount; ++uSymbol){
+			const unsigned uLength = pbyLengths[uSymbol];
+			if(uLength == 0){
+				continue;
+			}
+			auto uNext = auNextCodes[uLength]++;
+			unsigned uReversed = 0;
+			for(unsigned uBit = 0; uBit < uLength; ++uBit){
+				uReversed = (uReversed << 1) | (uNext & 1);
+				uNext >>= 1;
+			}
+			au16Codes[uSymbol] = static_cast<std::uint16_t>(uReversed);
+			if(uLength > uTableBits){
+				auto &byBits = abySubtableBits[uReversed & (uPrimarySize - 1)];
+				byBits = Max(byBits, static_cast<unsigned char>(uLength - uTableBits));
+			}
+		}
+
+		vecTable.Clear();
+		vecTable.ResizeMore(uPrimarySize, static_cast<std::uint32_t>(kEntryInvalid));
+		for(unsigned uPrefix = 0; uPrefix < uPrimarySize; ++uPrefix){
+			const unsigned uSubtableBits = abySubtableBits[uPrefix];
+			if(uSubtableBits == 0){
+				continue;
+			}
+			const auto uStart = static_cast<std::uint32_t>(vecTable.GetSize());
+			vecTable.ResizeMore(1u << uSubtableBits, static_cast<std::uint32_t>(kEntryInvalid));
+			vecTable.GetData()[uPrefix] = kEntrySubtable | uTableBits | (uSubtableBits << 8) | (uStart << 16);
+		}
+
+		const auto pu32Table = vecTable.GetData();
+		for(unsigned uSymbol = 0; uSymbol < uCount; ++uSymbol){
+			const unsigned uLength = pbyLengths[uSymbol];
+			if(uLength == 0){
+				continue;
+			}
+			const unsigned uReversed = au16Codes[uSymbol];
+			const auto u32Entry = fnMakeEntry(uSymbol);
+			if(uLength <= uTableBits){
+				for(unsigned uIndex = uReversed; uIndex < uPrimarySize; uIndex += 1u << uLength){
+					pu32Table[uIndex] = u32Entry | uLength;
+				}
+			} else {
+				const auto u32Subtable = pu32Table[uReversed & (uPrimarySize - 1)];
+				const unsigned uSubtableBits = (u32Subtable >> 8) & 0xFF;
+				const unsigned uSubLength = uLength - uTableBits;
+				const auto pu32Subtable = pu32Table + (u32Subtable >> 16);
+				for(unsigned uIndex = uReversed >> uTableBits; uIndex < (1u << uSubtableBits); uIndex += 1u << uSubLength){
+					pu32Subtable[uIndex] = u32Entry | uSubLength;
+				}
+			}
+		}
+		return true;
+	}
+
+	// 如果两个字面量的码长之和不超过一级表的索引位数，就把它们合并到一个元素中，这样一次查表可以解码两个字面量。
+	void PairLiterals(Vector<std::uint32_t> &vecTable) noexcept {
+		constexpr unsigned kPrimarySize = 1u << kLitLenTableBits;
+
+		std::uint32_t au32Primary[kPrimarySize];
+		std::memcpy(au32Primary, vecTable.GetData(), sizeof(au32Primary));
+		const auto pu32Table = vecTable.GetData();
+		for(unsigned uIndex = 0; uIndex < kPrimarySize; ++uIndex){
+			const auto u32First = au32Primary[uIndex];
+			if((u32First & kEntryKindMask) != kEntryLiteral){
+				continue;
+			}
+			const unsigned uFirstLength = u32First & kEntryBitsMask;
+			const auto u32Second = au32Primary[uIndex >> uFirstLength];
+			if((u32Second & kEntryKindMask) != kEntryLiteral){
+				continue;
+			}
+			const unsigned uSecondLength = u32Second & kEntryBitsMask;
+			if(uFirstLength + uSecondLength > kLitLenTableBits){
+				continue;
+			}
+			pu32Table[uIndex] = kEntryLiteral2 | (uFirstLength + uSecondLength) | (u32First & 0xFF00) | ((u32Second & 0xFF00) << 8);
+		}
+	}
+}
+
+InflateInputStreamFilter::~InflateInputStreamFilter(){ }
+
+void InflateInputStreamFilter::X_ConsumeInput(std::size_t uSize){
+	if(x_bInputPeeked){
+		GetUnderlyingStream()->Discard(uSize);
+	} else {
+		GetUnderlyingStream()->Consume(uSize);
+	}
+}
+bool InflateInputStreamFilter::X_NextInputWindow(){
+	// 位缓冲区中的字节（包括不完整的字节）还留在底层流中，它们总是当前窗口中已经读取的最后几个字节。
+	// 只丢弃它们之前的部分，然后在新的窗口中跳过它们，这样之后还可以把没有用到的字节还给底层流。
+	const auto uBytesBuffered = static_cast<std::size_t>((x_uBitCount + 7) / 8);
+	if(x_pbyInBegin){
+		X_ConsumeInput(static_cast<std::size_t>(x_pbyIn - x_pbyInBegin) - uBytesBuffered);
+	} else {
+		MCF_ASSERT(x_uHeldBytes >= uBytesBuffered);
+		GetUnderlyingStream()->Discard(x_uHeldBytes - uBytesBuffered);
+	}
+	x_uHeldBytes = 0;
+	x_pbyInBegin = nullptr;
+	x_pbyIn = nullptr;
+	x_pbyInEnd = nullptr;
+	x_bInputPeeked = false;
+
+	const void *pData;
+	std::size_t uSize;
+	if(GetUnderlyingStream()->Borrow(&pData, &uSize) && (uSize > uBytesBuffered)){
+		x_pbyInBegin = static_cast<const unsigned char *>(pData);
+	} else {
+		// 借来的数据只包含位缓冲区中的字节时，不能保证下一次能借到更多的数据，这里窥视一小段数据。
+		uSize = GetUnderlyingStream()->Peek(x_abyPeeked, sizeof(x_abyPeeked));
+		x_pbyInBegin = x_abyPeeked;
+		x_bInputPeeked = true;
+	}
+	MCF_ASSERT(uSize >= uBytesBuffered);
+	x_pbyIn = x_pbyInBegin + uBytesBuffered;
+	x_pbyInEnd = x_pbyInBegin + uSize;
+	return x_pbyIn != x_pbyInEnd;
+}
+void InflateInputStreamFilter::X_ReleaseInput(){
+	// 在输入的末尾补上的零不是输入的一部分。
+	x_uBitCount -= Min(x_uBitCount, x_uOverrunBytes * 8);
+	x_u64Bits &= (static_cast<std::uint64_t>(1) << x_uBitCount) - 1;
+	x_uOverrunBytes = 0;
+	// 把位缓冲区中的字节（包括不完整的字节）留在底层流中，下次从这些字节开始读取。
+	const auto uBytesBuffered = static_cast<std::size_t>((x_uBitCount + 7) / 8);
+	if(x_pbyInBegin){
+		X_ConsumeInput(static_cast<std::size_t>(x_pbyIn - x_pbyInBegin) - uBytesBuffered);
+	} else {
+		MCF_ASSERT(x_uHeldBytes >= uBytesBuffered);
+		GetUnderlyingStream()->Discard(x_uHeldBytes - uBytesBuffered);
+	}
+	x_uHeldBytes = uBytesBuffered;
+	x_pbyInBegin = nullptr;
+	x_pbyIn = nullptr;
+	x_pbyInEnd = nullptr;
+	x_bInputPeeked = false;
+}
+void InflateInputStreamFilter::X_Refill(){
+	// 位缓冲区中超出 x_uBitCount 的位要么是零，要么是之后的输入，因此这里可以直接按位或。
+	if(x_pbyInEnd - x_pbyIn >= 8){
+		x_u64Bits |= LoadLe(reinterpret_cast<const std::uint64_t *>(x_pbyIn)[0]) << x_uBitCount;
+		x_pbyIn += (63 - x_uBitCount) / 8;
+		x_uBitCount |= 56;
+		return;
+	}
+	while(x_uBitCount < 56){
+		if(x_pbyIn == x_pbyInEnd){
+			if((x_uOverrunBytes != 0) || !X_NextInputWindow()){
+				// 在输入的末尾补零，在 X_CheckOverrun() 中检查它们有没有被用到。
+				++x_uOverrunBytes;
+				x_uBitCount += 8;
+				continue;
+			}
+			if(x_pbyInEnd - x_pbyIn >= 8){
+				X_Refill();
+				return;
+			}
+		}
+		x_u64Bits |= static_cast<std::uint64_t>(*x_pbyIn) << x_uBitCount;
+		++x_pbyIn;
+		x_uBitCount += 8;
+	}
+}
+std::uint32_t InflateInputStreamFilter::X_ReadBits(unsigned uCount){
+	if(x_uBitCount < uCount){
+		X_Refill();
+	}
+	const auto u32Value = static_cast<std::uint32_t>(x_u64Bits & ((static_cast<std::uint64_t>(1) << uCount) - 1));
+	x_u64Bits >>= uCount;
+	x_uBitCount -= uCount;
+	return u32Value;
+}
+std::size_t InflateInputStreamFilter::X_ReadBytesUpTo(void *pData, std::size_t uSize){
+	// 丢弃不满一个字节的位，然后先读取位缓冲区中的字节。
+	const auto uPartialBits = x_uBitCount % 8;
+	x_u64Bits >>= uPartialBits;
+	x_uBitCount -= uPartialBits;
+
+	const auto pbyWrite = static_cast<unsigned char *>(pData);
+	std::size_t uBytesTotal = 0;
+	while((uBytesTotal < uSize) && (x_uBitCount > x_uOverrunBytes * 8)){
+		pbyWrite[uBytesTotal] = static_cast<unsigned char>(x_u64Bits);
+		++uBytesTotal;
+		x_u64Bits >>= 8;
+		x_uBitCount -= 8;
+	}
+	if((uBytesTotal == uSize) || (x_uOverrunBytes != 0)){
+		return uBytesTotal;
+	}
+	x_u64Bits = 0;
+	while(uBytesTotal < uSize){
+		if((x_pbyIn == x_pbyInEnd) && !X_NextInputWindow()){
+			break;
+		}
+		const auto uBytesToCopy = Min(uSize - uBytesTotal, static_cast<std::size_t>(x_pbyInEnd - x_pbyIn));
+		std::memcpy(pbyWrite + uBytesTotal, x_pbyIn, uBytesToCopy);
+		x_pbyIn += uBytesToCopy;
+		uBytesTotal += uBytesToCopy;
+	}
+	return uBytesTotal;
+}
+void InflateInputStreamFilter::X_ReadBytes(void *pData, std::size_t uSize){
+	if(X_ReadBytesUpTo(pData, uSize) < uSize){
+		MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"InflateInputStreamFilter: 压缩数据不完整。"));
+	}
+}
+void InflateInputStreamFilter::X_CheckOverrun() const {
+	if(x_uOverrunBytes * 8 > x_uBitCount){
+		MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"InflateInputStreamFilter: 压缩数据不完整。"));
+	}
+}
+void InflateInputStreamFilter::X_UpdateChecksum() noexcept {
+	const auto pbyBegin = x_vecBuffer.GetData() + x_uChecksumEnd;
+	const auto uSize = x_uEnd - x_uChecksumEnd;
+	if(uSize == 0){
+		return;
+	}
+	if(x_eStreamFormat == kFormatGzip){
+		x_vCrc32.Put(pbyBegin, uSize);
+		x_u32Size += static_cast<std::uint32_t>(uSize);
+	} else if(x_eStreamFormat == kFormatZlib){
+		x_vAdler32.Update(pbyBegin, uSize);
+	}
+	x_uChecksumEnd = x_uEnd;
+}
+
+bool InflateInputStreamFilter::X_ReadHeader(){
+	x_uHistoryBegin = x_uEnd;
+	x_uChecksumEnd = x_uEnd;
+	x_bFinalBlock = false;
+	x_vCrc32.Reset();
+	x_vAdler32.Reset();
+	x_u32Size = 0;
+
+	if(!x_bFirstMember && (x_eStreamFormat != kFormatGzip)){
+		return false;
+	}
+	if(x_eFormat == kFormatRaw){
+		x_eStreamFormat = kFormatRaw;
+		x_bFirstMember = false;
+		return true;
+	}
+
+	// 魔数先留在位缓冲区中，如果它不是头部的一部分，它还可以被当作压缩数据，或者被还给底层流。
+	const auto uPartialBits = x_uBitCount % 8;
+	x_u64Bits >>= uPartialBits;
+	x_uBitCount -= uPartialBits;
+	if(x_uBitCount < 16){
+		X_Refill();
+	}
+	unsigned char abyMagic[2];
+	abyMagic[0] = static_cast<unsigned char>(x_u64Bits);
+	abyMagic[1] = static_cast<unsigned char>(x_u64Bits >> 8);
+	const auto uMagicSize = Min(static_cast<std::size_t>((x_uBitCount - Min(x_uBitCount, x_uOverrunBytes * 8)) / 8), sizeof(abyMagic));
+	const bool bGzipMagic = (uMagicSize == sizeof(abyMagic)) && (abyMagic[0] == 0x1F) && (abyMagic[1] == 0x8B);
+	const auto fnDiscardMagic = [&]{
+		x_u64Bits >>= 16;
+		x_uBitCount -= 16;
+	};
+	if(!x_bFirstMember){
+		// 之后的不是 gzip 成员的数据被忽略。
+		if(!bGzipMagic){
+			return false;
+		}
+	} else {
+		if(uMagicSize < sizeof(abyMagic)){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"InflateInputStreamFilter: 压缩数据不完整。"));
+		}
+		auto eFormat = x_eFormat;
+		if(eFormat == kFormatAuto){
+			if(bGzipMagic){
+				eFormat = kFormatGzip;
+			} else if(((abyMagic[0] & 0x0F) == 8) && ((abyMagic[0] >> 4) <= 7) && (((abyMagic[0] << 8) | abyMagic[1]) % 31 == 0)){
+				eFormat = kFormatZlib;
+			} else {
+				eFormat = kFormatRaw;
+			}
+		}
+		x_eStreamFormat = eFormat;
+		x_bFirstMember = false;
+	}
+
+	switch(x_eStreamFormat){
+	case kFormatRaw:
+		break;
+
+	case kFormatZlib: {
+		if(((abyMagic[0] & 0x0F) != 8) || ((abyMagic[0] >> 4) > 7) || (((abyMagic[0] << 8) | abyMagic[1]) % 31 != 0)){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"InflateInputStreamFilter: zlib 头部无效。"));
+		}
+		if((abyMagic[1] & 0x20) != 0){
+			MCF_THROW(Exception, ERROR_NOT_SUPPORTED, Rcntws::View(L"InflateInputStreamFilter: 不支持使用预设字典的 zlib 数据。"));
+		}
+		fnDiscardMagic();
+		break; }
+
+	case kFormatGzip: {
+		if(!bGzipMagic){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"InflateInputStreamFilter: gzip 头部无效。"));
+		}
+		fnDiscardMagic();
+		Crc32OutputStream vHeaderCrc32;
+		vHeaderCrc32.Put(abyMagic, sizeof(abyMagic));
+		const auto fnReadHeaderBytes = [&](void *pData, std::size_t uSize){
+			X_ReadBytes(pData, uSize);
+			vHeaderCrc32.Put(pData, uSize);
+		};
+
+		// CM FLG MTIME(4) XFL OS
+		unsigned char abyFixed[8];
+		fnReadHeaderBytes(abyFixed, sizeof(abyFixed));
+		const unsigned uFlags = abyFixed[1];
+		if((abyFixed[0] != 8) || ((uFlags & 0xE0) != 0)){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"InflateInputStreamFilter: gzip 头部无效。"));
+		}
+		unsigned char abyTemp[256];
+		if((uFlags & 0x04) != 0){
+			// FEXTRA
+			fnReadHeaderBytes(abyTemp, 2);
+			std::size_t uExtraSize = static_cast<std::size_t>(abyTemp[0] | (abyTemp[1] << 8));
+			while(uExtraSize != 0){
+				const auto uBytesToRead = Min(uExtraSize, sizeof(abyTemp));
+				fnReadHeaderBytes(abyTemp, uBytesToRead);
+				uExtraSize -= uBytesToRead;
+			}
+		}
+		for(unsigned uFlag = 0x08; uFlag <= 0x10; uFlag <<= 1){
+			// FNAME 和 FCOMMENT，以零结尾。
+			if((uFlags & uFlag) == 0){
+				continue;
+			}
+			do {
+				fnReadHeaderBytes(abyTemp, 1);
+			} while(abyTemp[0] != 0);
+		}
+		if((uFlags & 0x02) != 0){
+			// FHCRC
+			const auto u32HeaderCrc32 = vHeaderCrc32.Finalize();
+			X_ReadBytes(abyTemp, 2);
+			if(static_cast<std::uint32_t>(abyTemp[0] | (abyTemp[1] << 8)) != (u32HeaderCrc32 & 0xFFFF)){
+				MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"InflateInputStreamFilter: gzip 头部校验和错误。"));
+			}
+		}
+		break; }
+
+	default:
+		MCF_ASSERT(false);
+	}
+	return true;
+}
+void InflateInputStreamFilter::X_ReadBlockHeader(){
+	if(x_bFinalBlock){
+		x_eState = kStateTrailer;
+		return;
+	}
+
+	const auto u32Header = X_ReadBits(3);
+	x_bFinalBlock = (u32Header & 1) != 0;
+	switch(u32Header >> 1){
+	case 0: {
+		// 不压缩的块。
+		unsigned char abyLength[4];
+		X_ReadBytes(abyLength, sizeof(abyLength));
+		const unsigned uLength = static_cast<unsigned>(abyLength[0] | (abyLength[1] << 8));
+		const unsigned uLengthComplement = static_cast<unsigned>(abyLength[2] | (abyLength[3] << 8));
+		if((uLength ^ uLengthComplement) != 0xFFFF){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"InflateInputStreamFilter: 压缩数据已损坏。"));
+		}
+		x_uStoredRemaining = uLength;
+		x_eState = kStateStored;
+		break; }
+
+	case 1: {
+		// 固定霍夫曼编码。
+		unsigned char abyLitLenLengths[kLitLenSymbolCount];
+		for(unsigned uSymbol = 0; uSymbol < kLitLenSymbolCount; ++uSymbol){
+			abyLitLenLengths[uSymbol] = static_cast<unsigned char>(GetFixedLitLenLength(uSymbol));
+		}
+		unsigned char abyDistanceLengths[kDistanceSymbolCount];
+		std::memset(abyDistanceLengths, kFixedDistanceLength, sizeof(abyDistanceLengths));
+		BuildDecodingTable(x_vecLitLenTable, abyLitLenLengths, kLitLenSymbolCount, kLitLenTableBits, MakeLitLenEntry);
+		PairLiterals(x_vecLitLenTable);
+		BuildDecodingTable(x_vecDistanceTable, abyDistanceLengths, kDistanceSymbolCount, kDistanceTableBits, MakeDistanceEntry);
+		x_eState = kStateHuffman;
+		break; }
+
+	case 2:
+		// 动态霍夫曼编码。
+		X_ReadDynamicTables();
+		x_eState = kStateHuffman;
+		break;
+
+	default:
+		MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"InflateInputStreamFilter: 压缩数据已损坏。"));
+	}
+	X_CheckOverrun();
+}
+void InflateInputStreamFilter::X_ReadDynamicTables(){
+	const unsigned uLitLenCount = X_ReadBits(5) + 257;
+	const unsigned uDistanceCount = X_ReadBits(5) + 1;
+	const unsigned uCodeLengthCount = X_ReadBits(4) + 4;
+	if((uLitLenCount > 286) || (uDistanceCount > 30)){
+		MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"InflateInputStreamFilter: 压缩数据已损坏。"));
+	}
+
+	unsigned char abyCodeLengthLengths[kCodeLengthCount] = { };
+	for(unsigned uIndex = 0; uIndex < uCodeLengthCount; ++uIndex){
+		abyCodeLengthLengths[kCodeLengthOrder[uIndex]] = static_cast<unsigned char>(X_ReadBits(3));
+	}
+	// 码长的查找表暂时放在距离的查找表中。
+	if(!BuildDecodingTable(x_vecDistanceTable, abyCodeLengthLengths, kCodeLengthCount, kCodeLengthTableBits, MakeCodeLengthEntry)){
+		MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"InflateInputStreamFilter: 压缩数据已损坏。"));
+	}
+	const auto pu32CodeLengthTable = x_vecDistanceTable.GetData();
+
+	unsigned char abyLengths[286 + 30];
+	const unsigned uTotalCount = uLitLenCount + uDistanceCount;
+	unsigned uIndex = 0;
+	while(uIndex < uTotalCount){
+		if(x_uBitCount < kMaxCodeLengthLength + 7){
+			X_Refill();
+		}
+		const auto u32Entry = pu32CodeLengthTable[x_u64Bits & ((1u << kCodeLengthTableBits) - 1)];
+		if((u32Entry & kEntryKindMask) != kEntryLiteral){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"InflateInputStreamFilter: 压缩数据已损坏。"));
+		}
+		const unsigned uEntryBits = u32Entry & kEntryBitsMask;
+		x_u64Bits >>= uEntryBits;
+		x_uBitCount -= uEntryBits;
+
+		const unsigned uSymbol = (u32Entry >> 8) & 0xFF;
+		if(uSymbol < 16){
+			abyLengths[uIndex++] = static_cast<unsigned char>(uSymbol);
+			continue;
+		}
+		unsigned char byValue = 0;
+		unsigned uRepeatCount;
+		if(uSymbol == 16){
+			if(uIndex == 0){
+				MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"InflateInputStreamFilter: 压缩数据已损坏。"));
+			}
+			byValue = abyLengths[uIndex - 1];
+			uRepeatCount = 3 + X_ReadBits(2);
+		} else if(uSymbol == 17){
+			uRepeatCount = 3 + X_ReadBits(3);
+		} else {
+			uRepeatCount = 11 + X_ReadBits(7);
+		}
+		if(uRepeatCount > uTotalCount - uIndex){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"InflateInputStreamFilter: 压缩数据已损坏。"));
+		}
+		std::memset(abyLengths + uIndex, byValue, uRepeatCount);
+		uIndex += uRepeatCount;
+	}
+	if(abyLengths[kEndOfBlock] == 0){
+		MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"InflateInputStreamFilter: 压缩数据已损坏。"));
+	}
+
+	if(!BuildDecodingTable(x_vecLitLenTable, abyLengths, uLitLenCount, kLitLenTableBits, MakeLitLenEntry)){
+		MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"InflateInputStreamFilter: 压缩数据已损坏。"));
+	}
+	PairLiterals(x_vecLitLenTable);
+	if(!BuildDecodingTable(x_vecDistanceTable, abyLengths + uLitLenCount, uDistanceCount, kDistanceTableBits, MakeDistanceEntry)){
+		MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"InflateInputStreamFilter: 压缩数据已损坏。"));
+	}
+}
+bool InflateInputStreamFilter::X_DecodeHuffman(std::size_t uOutLimit){
+	const auto pu32LitLenTable = x_vecLitLenTable.GetData();
+	const auto pu32DistanceTable = x_vecDistanceTable.GetData();
+	const auto pbyBuffer = x_vecBuffer.GetData();
+
+	// 每次补充之后位缓冲区中至少有 56 位，足够解码一个字面量或者一对长度和距离（最多 15 + 5 + 15 + 13 位）。
+	bool bEndOfBlock = false;
+	auto uOut = x_uEnd;
+	while(uOut < uOutLimit){
+		X_Refill();
+
+		auto u32Entry = pu32LitLenTable[x_u64Bits & ((1u << kLitLenTableBits) - 1)];
+		if((u32Entry & kEntryKindMask) == kEntrySubtable){
+			x_u64Bits >>= kLitLenTableBits;
+			x_uBitCount -= kLitLenTableBits;
+			u32Entry = pu32LitLenTable[(u32Entry >> 16) + (x_u64Bits & ((1u << ((u32Entry >> 8) & 0xFF)) - 1))];
+		}
+		unsigned uEntryBits = u32Entry & kEntryBitsMask;
+		x_u64Bits >>= uEntryBits;
+		x_uBitCount -= uEntryBits;
+
+		const auto u32Kind = u32Entry & kEntryKindMask;
+		if(u32Kind == kEntryLiteral){
+			pbyBuffer[uOut] = static_cast<unsigned char>(u32Entry >> 8);
+			uOut += 1;
+			continue;
+		}
+		if(u32Kind == kEntryLiteral2){
+			pbyBuffer[uOut] = static_cast<unsigned char>(u32Entry >> 8);
+			pbyBuffer[uOut + 1] = static_cast<unsigned char>(u32Entry >> 16);
+			uOut += 2;
+			continue;
+		}
+		if(u32Kind == kEntryEndOfBlock){
+			bEndOfBlock = true;
+			break;
+		}
+		if(u32Kind != kEntryLength){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"InflateInputStreamFilter: 压缩数据已损坏。"));
+		}
+		unsigned uExtraBits = (u32Entry >> 8) & 0xFF;
+		const std::size_t uLength = (u32Entry >> 16) + (x_u64Bits & ((1u << uExtraBits) - 1));
+		x_u64Bits >>= uExtraBits;
+		x_uBitCount -= uExtraBits;
+
+		u32Entry = pu32DistanceTable[x_u64Bits & ((1u << kDistanceTableBits) - 1)];
+		if((u32Entry & kEntryKindMask) == kEntrySubtable){
+			x_u64Bits >>= kDistanceTableBits;
+			x_uBitCount -= kDistanceTableBits;
+			u32Entry = pu32DistanceTable[(u32Entry >> 16) + (x_u64Bits & ((1u << ((u32Entry >> 8) & 0xFF)) - 1))];
+		}
+		if((u32Entry & kEntryKindMask) != kEntryLength){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"InflateInputStreamFilter: 压缩数据已损坏。"));
+		}
+		uEntryBits = u32Entry & kEntryBitsMask;
+		x_u64Bits >>= uEntryBits;
+		x_uBitCount -= uEntryBits;
+		uExtraBits = (u32Entry >> 8) & 0xFF;
+		const std::size_t uDistance = (u32Entry >> 16) + (x_u64Bits & ((1u << uExtraBits) - 1));
+		x_u64Bits >>= uExtraBits;
+		x_uBitCount -= uExtraBits;
+		if(uDistance > uOut - x_uHistoryBegin){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"InflateInputStreamFilter: 压缩数据已损坏。"));
+		}
+
+		// 缓冲区末尾留有余量，这里可以多复制至多 7 个字节。
+		auto pbyWrite = pbyBuffer + uOut;
+		auto pbyRead = pbyWrite - uDistance;
+		const auto pbyWriteEnd = pbyWrite + uLength;
+		if(uDistance >= 8){
+			do {
+				std::memcpy(pbyWrite, pbyRead, 8);
+				pbyWrite += 8;
+				pbyRead += 8;
+			} while(pbyWrite < pbyWriteEnd);
+		} else if(uDistance == 1){
+			std::memset(pbyWrite, *pbyRead, uLength);
+		} else {
+			do {
+				*pbyWrite = *pbyRead;
+				++pbyWrite;
+				++pbyRead;
+			} while(pbyWrite != pbyWriteEnd);
+		}
+		uOut += uLength;
+	}
+	x_uEnd = uOut;
+	X_CheckOverrun();
+	return bEndOfBlock;
+}
+void InflateInputStreamFilter::X_ReadTrailer(){
+	unsigned char abyTrailer[8];
+	switch(x_eStreamFormat){
+	case kFormatRaw:
+		break;
+
+	case kFormatZlib: {
+		X_ReadBytes(abyTrailer, 4);
+		if(LoadBe(reinterpret_cast<const std::uint32_t *>(abyTrailer)[0]) != x_vAdler32.Finalize()){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"InflateInputStreamFilter: zlib 校验和错误。"));
+		}
+		break; }
+
+	case kFormatGzip: {
+		X_ReadBytes(abyTrailer, 8);
+		if(LoadLe(reinterpret_cast<const std::uint32_t *>(abyTrailer)[0]) != x_vCrc32.Finalize()){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"InflateInputStreamFilter: gzip 校验和错误。"));
+		}
+		if(LoadLe(reinterpret_cast<const std::uint32_t *>(abyTrailer)[1]) != x_u32Size){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"InflateInputStreamFilter: gzip 数据长度错误。"));
+		}
+		break; }
+
+	default:
+		MCF_ASSERT(false);
+	}
+}
+
+bool InflateInputStreamFilter::X_DecodeSome(){
+	// 丢弃已经读取并且不再用于解析距离的数据。
+	const auto uKeepBegin = Min(x_uOffset, Max(x_uHistoryBegin, (x_uEnd > kWindowSize) ? (x_uEnd - kWindowSize) : static_cast<std::size_t>(0)));
+	if(uKeepBegin != 0){
+		std::memmove(x_vecBuffer.GetData(), x_vecBuffer.GetData() + uKeepBegin, x_uEnd - uKeepBegin);
+		x_uHistoryBegin = (x_uHistoryBegin > uKeepBegin) ? (x_uHistoryBegin - uKeepBegin) : 0;
+		x_uOffset -= uKeepBegin;
+		x_uEnd -= uKeepBegin;
+		x_uChecksumEnd -= uKeepBegin;
+	}
+	const auto uOutLimit = x_uEnd + kChunkSize;
+	if(x_vecBuffer.GetSize() < uOutLimit + kMaxMatch + 8){
+		x_vecBuffer.Resize(uOutLimit + kMaxMatch + 8);
+	}
+
+	// 出现异常时借来的数据不再有效。
+	const auto vInputGuard = DeferOnException([&]{
+		x_pbyInBegin = nullptr;
+		x_pbyIn = nullptr;
+		x_pbyInEnd = nullptr;
+		x_bInputPeeked = false;
+		x_uHeldBytes = 0;
+	});
+
+	const auto uOldEnd = x_uEnd;
+	while((x_uEnd == uOldEnd) && (x_eState != kStateEnd)){
+		switch(x_eState){
+		case kStateHeader:
+			if(!X_ReadHeader()){
+				// 丢弃不满一个字节的位，完整的字节在 X_ReleaseInput() 中还给底层流。
+				const auto uPartialBits = x_uBitCount % 8;
+				x_u64Bits >>= uPartialBits;
+				x_uBitCount -= uPartialBits;
+				x_eState = kStateEnd;
+				break;
+			}
+			x_eState = kStateBlockHeader;
+			break;
+
+		case kStateBlockHeader:
+			X_ReadBlockHeader();
+			break;
+
+		case kStateStored: {
+			const auto uBytesToRead = Min(x_uStoredRemaining, uOutLimit - x_uEnd);
+			X_ReadBytes(x_vecBuffer.GetData() + x_uEnd, uBytesToRead);
+			x_uEnd += uBytesToRead;
+			x_uStoredRemaining -= uBytesToRead;
+			if(x_uStoredRemaining == 0){
+				x_eState = kStateBlockHeader;
+			}
+			break; }
+
+		case kStateHuffman:
+			if(X_DecodeHuffman(uOutLimit)){
+				x_eState = kStateBlockHeader;
+			}
+			break;
+
+		case kStateTrailer:
+			X_UpdateChecksum();
+			X_ReadTrailer();
+			x_eState = kStateHeader;
+			break;
+
+		default:
+			MCF_ASSERT(false);
+		}
+	}
+	X_UpdateChecksum();
+	X_ReleaseInput();
+	return x_uEnd != uOldEnd;
+}
+bool InflateInputStreamFilter::X_Populate(std::size_t uMinSize){
+	while(x_uEnd - x_uOffset < uMinSize){
+		if(!X_DecodeSome()){
+			return false;
+		}
+	}
+	return true;
+}
+
+int InflateInputStreamFilter::Peek(){
+	int nRet = -1;
+	unsigned char byData;
+	if(InflateInputStreamFilter::Peek(&byData, 1) >= 1){
+		nRet = byData;
+	}
+	return nRet;
+}
+int InflateInputStreamFilter::Get(){
+	int nRet = -1;
+	unsigned char byData;
+	if(InflateInputStreamFilter::Get(&byData, 1) >= 1){
+		nRet = byData;
+	}
+	return nRet;
+}
+bool InflateInputStreamFilter::Discard(){
+	bool bRet = false;
+	if(InflateInputStreamFilter::Discard(1) >= 1){
+		bRet = true;
+	}
+	return bRet;
+}
+std::size_t InflateInputStreamFilter::Peek(void *pData, std::size_t uSize){
+	X_Populate(uSize);
+	const auto uBytesCopied = Min(uSize, x_uEnd - x_uOffset);
+	if(uBytesCopied > 0){
+		std::memcpy(pData, x_vecBuffer.GetData() + x_uOffset, uBytesCopied);
+	}
+	return uBytesCopied;
+}
+std::size_t InflateInputStreamFilter::Get(void *pData, std::size_t uSize){
+	std::size_t uBytesTotal = 0;
+	while(uBytesTotal < uSize){
+		if(!X_Populate(1)){
+			break;
+		}
+		const auto uBytesCopied = Min(uSize - uBytesTotal, x_uEnd - x_uOffset);
+		std::memcpy(static_cast<unsigned char *>(pData) + uBytesTotal, x_vecBuffer.GetData() + x_uOffset, uBytesCopied);
+		x_uOffset += uBytesCopied;
+		uBytesTotal += uBytesCopied;
+	}
+	return uBytesTotal;
+}
+std::size_t InflateInputStreamFilter::Discard(std::size_t uSize){
+	std::size_t uBytesTotal = 0;
+	while(uBytesTotal < uSize){
+		if(!X_Populate(1)){
+			break;
+		}
+		const auto uBytesDiscarded = Min(uSize - uBytesTotal, x_uEnd - x_uOffset);
+		x_uOffset += uBytesDiscarded;
+		uBytesTotal += uBytesDiscarded;
+	}
+	return uBytesTotal;
+}
+void InflateInputStreamFilter::Invalidate(){
+	x_uHistoryBegin = 0;
+	x_uOffset = 0;
+	x_uEnd = 0;
+	x_uChecksumEnd = 0;
+
+	x_pbyInBegin = nullptr;
+	x_pbyIn = nullptr;
+	x_pbyInEnd = nullptr;
+	x_bInputPeeked = false;
+	x_uHeldBytes = 0;
+	x_u64Bits = 0;
+	x_uBitCount = 0;
+	x_uOverrunBytes = 0;
+
+	x_eState = kStateHeader;
+	x_bFirstMember = true;
+	x_bFinalBlock = false;
+	x_uStoredRemaining = 0;
+
+	GetUnderlyingStream()->Invalidate();
+}
+bool InflateInputStreamFilter::Borrow(const void **ppData, std::size_t *puSize){
+	if(!X_Populate(1)){
+		return false;
+	}
+	*ppData = x_vecBuffer.GetData() + x_uOffset;
+	*puSize = x_uEnd - x_uOffset;
+	return true;
+}
+void InflateInputStreamFilter::Consume(std::size_t uSize){
+	InflateInputStreamFilter::Discard(uSize);
+}
+
+}
@@ -0,0 +1,115 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_STREAM_FILTERS_INFLATE_INPUT_STREAM_FILTER_HPP_
+#define MCF_STREAM_FILTERS_INFLATE_INPUT_STREAM_FILTER_HPP_
+
+#include "AbstractInputStreamFilter.hpp"
+#include "_Deflate.hpp"
+#include "../Streams/Crc32OutputStream.hpp"
+#include "../Containers/Vector.hpp"
+
+namespace MCF {
+
+// 解压 DEFLATE 格式的数据，可以带有 zlib 或 gzip 的头部与尾部。gzip 格式支持多个连续的成员，之后的不是 gzip 成员的数据被忽略。
+// 底层流通过 Borrow() 和 Consume() 读取。数据流结束之后，没有用到的完整的字节被留在底层流中。
+// 数据损坏时抛出 ERROR_INVALID_DATA。Invalidate() 丢弃已经解压但是还没有被读取的数据，下一次读取从一个新的数据流开始。
+class InflateInputStreamFilter : public AbstractInputStreamFilter {
+public:
+	enum Format : unsigned {
+		kFormatRaw  = 0,
+		kFormatZlib = 1,
+		kFormatGzip = 2,
+		kFormatAuto = 3,  // 根据头部识别 gzip 和 zlib，都不是则认为是没有头部的 DEFLATE 数据。
+	};
+
+private:
+	enum State : unsigned {
+		kStateHeader,
+		kStateBlockHeader,
+		kStateStored,
+		kStateHuffman,
+		kStateTrailer,
+		kStateEnd,
+	};
+
+private:
+	Format x_eFormat;
+
+	// 解压出的数据。[x_uOffset, x_uEnd) 是还没有被读取的部分，它之前最多 32 KiB 的数据用于解析距离。
+	Vector<unsigned char> x_vecBuffer;
+	std::size_t x_uHistoryBegin = 0;
+	std::size_t x_uOffset = 0;
+	std::size_t x_uEnd = 0;
+	std::size_t x_uChecksumEnd = 0;
+
+	// 从底层流借来的数据，或者借不到更多的数据时从底层流窥视到的数据。
+	const unsigned char *x_pbyInBegin = nullptr;
+	const unsigned char *x_pbyIn = nullptr;
+	const unsigned char *x_pbyInEnd = nullptr;
+	bool x_bInputPeeked = false;
+	unsigned char x_abyPeeked[64];
+	std::size_t x_uHeldBytes = 0; // 没有借来的数据时，底层流开头已经被读入位缓冲区的字节数。
+	std::uint64_t x_u64Bits = 0;
+	unsigned x_uBitCount = 0;
+	unsigned x_uOverrunBytes = 0;
+
+	State x_eState = kStateHeader;
+	Format x_eStreamFormat = kFormatRaw;
+	bool x_bFirstMember = true;
+	bool x_bFinalBlock = false;
+	std::size_t x_uStoredRemaining = 0;
+	Vector<std::uint32_t> x_vecLitLenTable;
+	Vector<std::uint32_t> x_vecDistanceTable;
+
+	Crc32OutputStream x_vCrc32;
+	Impl_Deflate::Adler32 x_vAdler32;
+	std::uint32_t x_u32Size = 0;
+
+private:
+	void X_ConsumeInput(std::size_t uSize);
+	bool X_NextInputWindow();
+	void X_ReleaseInput();
+	void X_Refill();
+	std::uint32_t X_ReadBits(unsigned uCount);
+	std::size_t X_ReadBytesUpTo(void *pData, std::size_t uSize);
+	void X_ReadBytes(void *pData, std::size_t uSize);
+	void X_CheckOverrun() const;
+	void X_UpdateChecksum() noexcept;
+
+	bool X_ReadHeader();
+	void X_ReadBlockHeader();
+	void X_ReadDynamicTables();
+	bool X_DecodeHuffman(std::size_t uOutLimit);
+	void X_ReadTrailer();
+
+	bool X_DecodeSome();
+	bool X_Populate(std::size_t uMinSize);
+
+public:
+	explicit InflateInputStreamFilter(PolyIntrusivePtr<AbstractInputStream> pUnderlyingStream, Format eFormat = kFormatAuto) noexcept
+		: AbstractInputStreamFilter(std::move(pUnderlyingStream))
+		, x_eFormat(eFormat)
+	{ }
+	~InflateInputStreamFilter() override;
+
+public:
+	int Peek() override;
+	int Get() override;
+	bool Discard() override;
+	std::size_t Peek(void *pData, std::size_t uSize) override;
+	std::size_t Get(void *pData, std::size_t uSize) override;
+	std::size_t Discard(std::size_t uSize) override;
+	void Invalidate() override;
+	bool Borrow(const void **ppData, std::size_t *puSize) override;
+	void Consume(std::size_t uSize) override;
+
+	Format GetFormat() const noexcept {
+		return x_eFormat;
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,250 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "Lz4InputStreamFilter.hpp"
+#include "../Core/Exception.hpp"
+#include "../Core/Endian.hpp"
+#include "../Core/MinMax.hpp"
+
+namespace MCF {
+
+Lz4InputStreamFilter::~Lz4InputStreamFilter(){ }
+
+std::size_t Lz4InputStreamFilter::X_ReadUnderlying(void *pData, std::size_t uSize){
+	std::size_t uBytesTotal = 0;
+	while(uBytesTotal < uSize){
+		const auto uBytesRead = GetUnderlyingStream()->Get(static_cast<unsigned char *>(pData) + uBytesTotal, uSize - uBytesTotal);
+		if(uBytesRead == 0){
+			break;
+		}
+		uBytesTotal += uBytesRead;
+	}
+	return uBytesTotal;
+}
+void Lz4InputStreamFilter::X_ReadUnderlyingExact(void *pData, std::size_t uSize){
+	if(X_ReadUnderlying(pData, uSize) < uSize){
+		MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Lz4InputStreamFilter: LZ4 数据不完整。"));
+	}
+}
+void Lz4InputStreamFilter::X_StartFrame(std::uint32_t u32Magic){
+	if(u32Magic != Impl_Lz4::kFrameMagic){
+		MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Lz4InputStreamFilter: 不是 LZ4 帧。"));
+	}
+
+	// FLG、BD 和可选的 8 字节内容大小。
+	unsigned char abyDescriptor[10];
+	std::size_t uDescriptorSize = 2;
+	X_ReadUnderlyingExact(abyDescriptor, 2);
+	const unsigned uFlags = abyDescriptor[0];
+	const unsigned uBlockDescriptor = abyDescriptor[1];
+	if(((uFlags >> 6) != 1) || ((uFlags & 0x02) != 0) || ((uBlockDescriptor & 0x8F) != 0)){
+		MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Lz4InputStreamFilter: LZ4 帧描述符无效。"));
+	}
+	if((uFlags & 0x01) != 0){
+		MCF_THROW(Exception, ERROR_NOT_SUPPORTED, Rcntws::View(L"Lz4InputStreamFilter: 不支持使用外部字典的 LZ4 帧。"));
+	}
+	const unsigned uBlockSizeId = uBlockDescriptor >> 4;
+	if(uBlockSizeId < 4){
+		MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Lz4InputStreamFilter: LZ4 块大小无效。"));
+	}
+	if((uFlags & 0x08) != 0){
+		// 内容大小仅供参考，这里不使用它。
+		X_ReadUnderlyingExact(abyDescriptor + 2, 8);
+		uDescriptorSize += 8;
+	}
+	unsigned char byHeaderChecksum;
+	X_ReadUnderlyingExact(&byHeaderChecksum, 1);
+	if(byHeaderChecksum != static_cast<unsigned char>(Impl_Lz4::Xxh32::Hash(abyDescriptor, uDescriptorSize) >> 8)){
+		MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Lz4InputStreamFilter: LZ4 帧头校验和错误。"));
+	}
+
+	x_bInFrame = true;
+	x_bBlocksIndependent = (uFlags & 0x20) != 0;
+	x_bBlockChecksums = (uFlags & 0x10) != 0;
+	x_bContentChecksum = (uFlags & 0x04) != 0;
+	x_uMaxBlockSize = static_cast<std::size_t>(1) << (uBlockSizeId * 2 + 8);
+	x_vChecksum.Reset();
+	// 不同的帧之间不共享字典。
+	x_uDictBegin = x_uEnd;
+}
+bool Lz4InputStreamFilter::X_DecodeBlock(){
+	for(;;){
+		if(!x_bInFrame){
+			std::uint32_t u32Magic;
+			const auto uBytesRead = X_ReadUnderlying(&u32Magic, sizeof(u32Magic));
+			if(uBytesRead == 0){
+				return false;
+			}
+			if(uBytesRead < sizeof(u32Magic)){
+				MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Lz4InputStreamFilter: LZ4 数据不完整。"));
+			}
+			u32Magic = LoadLe(u32Magic);
+			if((u32Magic & Impl_Lz4::kSkippableMagicMask) == Impl_Lz4::kSkippableMagic){
+				std::uint32_t u32SkipSize;
+				X_ReadUnderlyingExact(&u32SkipSize, sizeof(u32SkipSize));
+				u32SkipSize = LoadLe(u32SkipSize);
+				if(GetUnderlyingStream()->Discard(u32SkipSize) < u32SkipSize){
+					MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Lz4InputStreamFilter: LZ4 数据不完整。"));
+				}
+				continue;
+			}
+			X_StartFrame(u32Magic);
+			continue;
+		}
+
+		std::uint32_t u32BlockHeader;
+		X_ReadUnderlyingExact(&u32BlockHeader, sizeof(u32BlockHeader));
+		u32BlockHeader = LoadLe(u32BlockHeader);
+		if(u32BlockHeader == 0){
+			// 帧结束。
+			if(x_bContentChecksum){
+				std::uint32_t u32Checksum;
+				X_ReadUnderlyingExact(&u32Checksum, sizeof(u32Checksum));
+				if(LoadLe(u32Checksum) != x_vChecksum.Finalize()){
+					MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Lz4InputStreamFilter: LZ4 内容校验和错误。"));
+				}
+			}
+			x_bInFrame = false;
+			continue;
+		}
+		const bool bUncompressed = (u32BlockHeader & Impl_Lz4::kUncompressedFlag) != 0;
+		const std::size_t uBlockSize = u32BlockHeader & ~Impl_Lz4::kUncompressedFlag;
+		if(uBlockSize > x_uMaxBlockSize){
+			MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Lz4InputStreamFilter: LZ4 块太大。"));
+		}
+
+		// 丢弃已经读取并且不再用作字典的数据。
+		auto uKeepBegin = x_uOffset;
+		if(!x_bBlocksIndependent){
+			uKeepBegin = Min(uKeepBegin, Max(x_uDictBegin, (x_uEnd > Impl_Lz4::kWindowSize) ? (x_uEnd - Impl_Lz4::kWindowSize) : static_cast<std::size_t>(0)));
+		}
+		if(uKeepBegin != 0){
+			std::memmove(x_vecBuffer.GetData(), x_vecBuffer.GetData() + uKeepBegin, x_uEnd - uKeepBegin);
+			x_uDictBegin = (x_uDictBegin > uKeepBegin) ? (x_uDictBegin - uKeepBegin) : 0;
+			x_uOffset -= uKeepBegin;
+			x_uEnd -= uKeepBegin;
+		}
+		if(x_vecBuffer.GetSize() < x_uEnd + x_uMaxBlockSize){
+			x_vecBuffer.Resize(x_uEnd + x_uMaxBlockSize);
+		}
+		const auto pbyOut = x_vecBuffer.GetData() + x_uEnd;
+
+		const unsigned char *pbyStored;
+		std::size_t uDecodedSize;
+		if(bUncompressed){
+			X_ReadUnderlyingExact(pbyOut, uBlockSize);
+			pbyStored = pbyOut;
+			uDecodedSize = uBlockSize;
+		} else {
+			if(x_vecBlock.GetSize() < uBlockSize){
+				x_vecBlock.Resize(uBlockSize);
+			}
+			X_ReadUnderlyingExact(x_vecBlock.GetData(), uBlockSize);
+			pbyStored = x_vecBlock.GetData();
+			const auto pbyDictBegin = x_bBlocksIndependent ? pbyOut : (x_vecBuffer.GetData() + x_uDictBegin);
+			uDecodedSize = Impl_Lz4::Decompress(pbyOut, x_uMaxBlockSize, pbyDictBegin, pbyStored, uBlockSize);
+			if(uDecodedSize == SIZE_MAX){
+				MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Lz4InputStreamFilter: LZ4 块已损坏。"));
+			}
+		}
+		if(x_bBlockChecksums){
+			std::uint32_t u32Checksum;
+			X_ReadUnderlyingExact(&u32Checksum, sizeof(u32Checksum));
+			if(LoadLe(u32Checksum) != Impl_Lz4::Xxh32::Hash(pbyStored, uBlockSize)){
+				MCF_THROW(Exception, ERROR_INVALID_DATA, Rcntws::View(L"Lz4InputStreamFilter: LZ4 块校验和错误。"));
+			}
+		}
+		if(x_bContentChecksum){
+			x_vChecksum.Update(pbyOut, uDecodedSize);
+		}
+		x_uEnd += uDecodedSize;
+		return true;
+	}
+}
+bool Lz4InputStreamFilter::X_Populate(std::size_t uMinSize){
+	while(x_uEnd - x_uOffset < uMinSize){
+		if(!X_DecodeBlock()){
+			return false;
+		}
+	}
+	return true;
+}
+
+int Lz4InputStreamFilter::Peek(){
+	int nRet = -1;
+	unsigned char byData;
+	if(Lz4InputStreamFilter::Peek(&byData, 1) >= 1){
+		nRet = byData;
+	}
+	return nRet;
+}
+int Lz4InputStreamFilter::Get(){
+	int nRet = -1;
+	unsigned char byData;
+	if(Lz4InputStreamFilter::Get(&byData, 1) >= 1){
+		nRet = byData;
+	}
+	return nRet;
+}
+bool Lz4InputStreamFilter::Discard(){
+	bool bRet = false;
+	if(Lz4InputStreamFilter::Discard(1) >= 1){
+		bRet = true;
+	}
+	return bRet;
+}
+std::size_t Lz4InputStreamFilter::Peek(void *pData, std::size_t uSize){
+	X_Populate(uSize);
+	const auto uBytesCopied = Min(uSize, x_uEnd - x_uOffset);
+	if(uBytesCopied > 0){
+		std::memcpy(pData, x_vecBuffer.GetData() + x_uOffset, uBytesCopied);
+	}
+	return uBytesCopied;
+}
+std::size_t Lz4InputStreamFilter::Get(void *pData, std::size_t uSize){
+	std::size_t uBytesTotal = 0;
+	while(uBytesTotal < uSize){
+		if(!X_Populate(1)){
+			break;
+		}
+		const auto uBytesCopied = Min(uSize - uBytesTotal, x_uEnd - x_uOffset);
+		std::memcpy(static_cast<unsigned char *>(pData) + uBytesTotal, x_vecBuffer.GetData() + x_uOffset, uBytesCopied);
+		x_uOffset += uBytesCopied;
+		uBytesTotal += uBytesCopied;
+	}
+	return uBytesTotal;
+}
+std::size_t Lz4InputStreamFilter::Discard(std::size_t uSize){
+	std::size_t uBytesTotal = 0;
+	while(uBytesTotal < uSize){
+		if(!X_Populate(1)){
+			break;
+		}
+		const auto uBytesDiscarded = Min(uSize - uBytesTotal, x_uEnd - x_uOffset);
+		x_uOffset += uBytesDiscarded;
+		uBytesTotal += uBytesDiscarded;
+	}
+	return uBytesTotal;
+}
+void Lz4InputStreamFilter::Invalidate(){
+	x_uDictBegin = 0;
+	x_uOffset = 0;
+	x_uEnd = 0;
+	x_bInFrame = false;
+
+	GetUnderlyingStream()->Invalidate();
+}
+bool Lz4InputStreamFilter::Borrow(const void **ppData, std::size_t *puSize){
+	if(!X_Populate(1)){
+		return false;
+	}
+	*ppData = x_vecBuffer.GetData() + x_uOffset;
+	*puSize = x_uEnd - x_uOffset;
+	return true;
+}
+void Lz4InputStreamFilter::Consume(std::size_t uSize){
+	Lz4InputStreamFilter::Discard(uSize);
+}
+
+}
@@ -0,0 +1,59 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_STREAM_FILTERS_LZ4_INPUT_STREAM_FILTER_HPP_
+#define MCF_STREAM_FILTERS_LZ4_INPUT_STREAM_FILTER_HPP_
+
+#include "AbstractInputStreamFilter.hpp"
+#include "_Lz4.hpp"
+#include "../Containers/Vector.hpp"
+
+namespace MCF {
+
+// 解压 LZ4 帧格式的数据。支持多个连续的帧、可跳过的帧、互相依赖的块、块校验和与内容校验和，不支持外部字典。
+// 数据损坏时抛出 ERROR_INVALID_DATA。Invalidate() 丢弃已经解压但是还没有被读取的数据，下一次读取从一个新的帧开始。
+class Lz4InputStreamFilter : public AbstractInputStreamFilter {
+private:
+	// 解压出的数据。[x_uOffset, x_uEnd) 是还没有被读取的部分，它之前最多 64 KiB 的数据用作后续块的字典。
+	Vector<unsigned char> x_vecBuffer;
+	std::size_t x_uDictBegin = 0;
+	std::size_t x_uOffset = 0;
+	std::size_t x_uEnd = 0;
+	Vector<unsigned char> x_vecBlock;
+
+	bool x_bInFrame = false;
+	bool x_bBlocksIndependent = false;
+	bool x_bBlockChecksums = false;
+	bool x_bContentChecksum = false;
+	std::size_t x_uMaxBlockSize = 0;
+	Impl_Lz4::Xxh32 x_vChecksum;
+
+private:
+	std::size_t X_ReadUnderlying(void *pData, std::size_t uSize);
+	void X_ReadUnderlyingExact(void *pData, std::size_t uSize);
+	void X_StartFrame(std::uint32_t u32Magic);
+	bool X_DecodeBlock();
+	bool X_Populate(std::size_t uMinSize);
+
+public:
+	explicit Lz4InputStreamFilter(PolyIntrusivePtr<AbstractInputStream> pUnderlyingStream) noexcept
+		: AbstractInputStreamFilter(std::move(pUnderlyingStream))
+	{ }
+	~Lz4InputStreamFilter() override;
+
+public:
+	int Peek() override;
+	int Get() override;
+	bool Discard() override;
+	std::size_t Peek(void *pData, std::size_t uSize) override;
+	std::size_t Get(void *pData, std::size_t uSize) override;
+	std::size_t Discard(std::size_t uSize) override;
+	void Invalidate() override;
+	bool Borrow(const void **ppData, std::size_t *puSize) override;
+	void Consume(std::size_t uSize) override;
+};
+
+}
+
+#endif
@@ -0,0 +1,103 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "Lz4OutputStreamFilter.hpp"
+#include "../Core/Exception.hpp"
+#include "../Core/Endian.hpp"
+#include "../Core/MinMax.hpp"
+
+namespace MCF {
+
+Lz4OutputStreamFilter::Lz4OutputStreamFilter(PolyIntrusivePtr<AbstractOutputStream> pUnderlyingStream, unsigned uLevel, BlockSize eBlockSize)
+	: AbstractOutputStreamFilter(std::move(pUnderlyingStream))
+	, x_vCompressor(uLevel), x_eBlockSize(eBlockSize)
+{
+	if((eBlockSize < kBlockSize64KiB) || (eBlockSize > kBlockSize4MiB)){
+		MCF_THROW(Exception, ERROR_INVALID_PARAMETER, Rcntws::View(L"Lz4OutputStreamFilter: 块大小无效。"));
+	}
+}
+Lz4OutputStreamFilter::~Lz4OutputStreamFilter(){
+	try {
+		if(x_bFrameStarted || !x_vecInput.IsEmpty()){
+			Finalize();
+		}
+	} catch(...){ }
+}
+
+void Lz4OutputStreamFilter::X_StartFrame(){
+	unsigned char abyHeader[7];
+	StoreLe(reinterpret_cast<std::uint32_t *>(abyHeader)[0], Impl_Lz4::kFrameMagic);
+	// 版本 01，块独立，带有内容校验和。
+	abyHeader[4] = 0x64;
+	abyHeader[5] = static_cast<unsigned char>(x_eBlockSize << 4);
+	abyHeader[6] = static_cast<unsigned char>(Impl_Lz4::Xxh32::Hash(abyHeader + 4, 2) >> 8);
+	GetUnderlyingStream()->Put(abyHeader, sizeof(abyHeader));
+
+	x_vChecksum.Reset();
+	x_bFrameStarted = true;
+}
+void Lz4OutputStreamFilter::X_FlushBlock(){
+	if(!x_bFrameStarted){
+		X_StartFrame();
+	}
+	const auto uInputSize = x_vecInput.GetSize();
+	if(uInputSize == 0){
+		return;
+	}
+	x_vChecksum.Update(x_vecInput.GetData(), uInputSize);
+
+	const auto uOutputCapacity = Impl_Lz4::GetCompressBound(X_GetBlockSize()) + 4;
+	if(x_vecOutput.GetSize() < uOutputCapacity){
+		x_vecOutput.Resize(uOutputCapacity);
+	}
+	// 如果压缩之后没有变小，就保存原始数据。
+	const auto uCompressedSize = x_vCompressor.Compress(x_vecOutput.GetData() + 4, uInputSize - 1, x_vecInput.GetData(), uInputSize);
+	if(uCompressedSize != 0){
+		StoreLe(reinterpret_cast<std::uint32_t *>(x_vecOutput.GetData())[0], static_cast<std::uint32_t>(uCompressedSize));
+		GetUnderlyingStream()->Put(x_vecOutput.GetData(), uCompressedSize + 4);
+	} else {
+		StoreLe(reinterpret_cast<std::uint32_t *>(x_vecOutput.GetData())[0], static_cast<std::uint32_t>(uInputSize | Impl_Lz4::kUncompressedFlag));
+		GetUnderlyingStream()->Put(x_vecOutput.GetData(), 4);
+		GetUnderlyingStream()->Put(x_vecInput.GetData(), uInputSize);
+	}
+	x_vecInput.Clear();
+}
+
+void Lz4OutputStreamFilter::Put(unsigned char byData){
+	Lz4OutputStreamFilter::Put(&byData, 1);
+}
+void Lz4OutputStreamFilter::Put(const void *pData, std::size_t uSize){
+	const auto uBlockSize = X_GetBlockSize();
+	std::size_t uBytesTotal = 0;
+	while(uBytesTotal < uSize){
+		x_vecInput.Reserve(uBlockSize);
+		const auto uBytesToCopy = Min(uSize - uBytesTotal, uBlockSize - x_vecInput.GetSize());
+		const auto pbyBuffer = x_vecInput.ResizeMore(uBytesToCopy);
+		std::memcpy(pbyBuffer, static_cast<const unsigned char *>(pData) + uBytesTotal, uBytesToCopy);
+		uBytesTotal += uBytesToCopy;
+		if(x_vecInput.GetSize() == uBlockSize){
+			X_FlushBlock();
+		}
+	}
+}
+void Lz4OutputStreamFilter::Flush(bool bHard){
+	if(!x_vecInput.IsEmpty()){
+		X_FlushBlock();
+	}
+
+	GetUnderlyingStream()->Flush(bHard);
+}
+
+void Lz4OutputStreamFilter::Finalize(){
+	X_FlushBlock();
+
+	unsigned char abyTrailer[8];
+	StoreLe(reinterpret_cast<std::uint32_t *>(abyTrailer)[0], 0);
+	StoreLe(reinterpret_cast<std::uint32_t *>(abyTrailer)[1], x_vChecksum.Finalize());
+	GetUnderlyingStream()->Put(abyTrailer, sizeof(abyTrailer));
+
+	x_bFrameStarted = false;
+}
+
+}
@@ -0,0 +1,73 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_STREAM_FILTERS_LZ4_OUTPUT_STREAM_FILTER_HPP_
+#define MCF_STREAM_FILTERS_LZ4_OUTPUT_STREAM_FILTER_HPP_
+
+#include "AbstractOutputStreamFilter.hpp"
+#include "_Lz4.hpp"
+#include "../Containers/Vector.hpp"
+
+namespace MCF {
+
+// 输出 LZ4 帧格式的数据，可以由 lz4 命令行工具解压。块之间互相独立，帧的末尾带有内容校验和。
+// Flush() 把已经写入的数据压缩为一个块，但是不结束当前的帧。Finalize() 结束当前的帧，之后的数据写入一个新的帧。
+class Lz4OutputStreamFilter : public AbstractOutputStreamFilter {
+public:
+	enum Level : unsigned {
+		kLevelFast    = 0,  // 只使用散列表。
+		kLevelDefault = 9,  // 散列链，每个位置最多尝试 256 个候选。
+		kLevelMax     = 12,
+	};
+
+	enum BlockSize : unsigned {
+		kBlockSize64KiB  = 4,
+		kBlockSize256KiB = 5,
+		kBlockSize1MiB   = 6,
+		kBlockSize4MiB   = 7,
+	};
+
+private:
+	Impl_Lz4::Compressor x_vCompressor;
+	BlockSize x_eBlockSize;
+	Vector<unsigned char> x_vecInput;
+	Vector<unsigned char> x_vecOutput;
+
+	bool x_bFrameStarted = false;
+	Impl_Lz4::Xxh32 x_vChecksum;
+
+private:
+	std::size_t X_GetBlockSize() const noexcept {
+		return static_cast<std::size_t>(1) << (x_eBlockSize * 2 + 8);
+	}
+
+	void X_StartFrame();
+	void X_FlushBlock();
+
+public:
+	explicit Lz4OutputStreamFilter(PolyIntrusivePtr<AbstractOutputStream> pUnderlyingStream, unsigned uLevel = kLevelFast, BlockSize eBlockSize = kBlockSize256KiB);
+	~Lz4OutputStreamFilter() override;
+
+public:
+	void Put(unsigned char byData) override;
+	void Put(const void *pData, std::size_t uSize) override;
+	void Flush(bool bHard) override;
+
+	unsigned GetLevel() const noexcept {
+		return x_vCompressor.GetLevel();
+	}
+	void SetLevel(unsigned uLevel) noexcept {
+		x_vCompressor.SetLevel(uLevel);
+	}
+	BlockSize GetBlockSize() const noexcept {
+		return x_eBlockSize;
+	}
+
+	// 结束当前的帧。即使没有写入任何数据，也会输出一个空的帧。
+	void Finalize();
+};
+
+}
+
+#endif
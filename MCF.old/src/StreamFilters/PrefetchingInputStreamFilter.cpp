@@ -0,0 +1,202 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "PrefetchingInputStreamFilter.hpp"
+#include "../Core/Exception.hpp"
+#include "../Core/MinMax.hpp"
+
+namespace MCF {
+
+PrefetchingInputStreamFilter::PrefetchingInputStreamFilter(PolyIntrusivePtr<AbstractInputStream> pUnderlyingStream, std::size_t uBufferCount, std::size_t uBufferSize)
+	: AbstractInputStreamFilter(std::move(pUnderlyingStream))
+	, x_uBufferSize(uBufferSize)
+{
+	if(uBufferCount == 0){
+		MCF_THROW(Exception, ERROR_INVALID_PARAMETER, Rcntws::View(L"PrefetchingInputStreamFilter: 缓冲区的数目不能为零。"));
+	}
+	if(uBufferSize == 0){
+		MCF_THROW(Exception, ERROR_INVALID_PARAMETER, Rcntws::View(L"PrefetchingInputStreamFilter: 缓冲区的大小不能为零。"));
+	}
+	x_vecBuffers.Append(uBufferCount);
+}
+PrefetchingInputStreamFilter::~PrefetchingInputStreamFilter(){
+	X_StopWorker();
+}
+
+void PrefetchingInputStreamFilter::X_WorkerProc(){
+	const auto uBufferCount = x_vecBuffers.GetSize();
+	auto vLock = x_mtxGuard.GetLock();
+	for(;;){
+		while(!x_bStopping && (x_uFilled == uBufferCount)){
+			x_cvEmptied.Wait(vLock);
+		}
+		if(x_bStopping){
+			break;
+		}
+		// 这个缓冲区不在读取的一方可以访问的范围之内，填充它的时候不需要加锁。
+		auto &vecBuffer = x_vecBuffers[(x_uFront + x_uFilled) % uBufferCount];
+		vLock.Reset();
+		std::size_t uBytesRead = 0;
+		std::exception_ptr pException;
+		try {
+			vecBuffer.Resize(x_uBufferSize);
+			uBytesRead = GetUnderlyingStream()->Get(vecBuffer.GetData(), vecBuffer.GetSize());
+			vecBuffer.Pop(vecBuffer.GetSize() - uBytesRead);
+		} catch(...){
+			pException = std::current_exception();
+		}
+		vLock.Reset(x_mtxGuard);
+		if(pException){
+			x_pException = std::move(pException);
+			x_bEndOfStream = true;
+			x_cvFilled.Broadcast();
+			break;
+		}
+		if(uBytesRead == 0){
+			x_bEndOfStream = true;
+			x_cvFilled.Broadcast();
+			break;
+		}
+		++x_uFilled;
+		x_cvFilled.Broadcast();
+	}
+}
+void PrefetchingInputStreamFilter::X_StopWorker() noexcept {
+	if(!x_pWorker){
+		return;
+	}
+	{
+		const auto vLock = x_mtxGuard.GetLock();
+		x_bStopping = true;
+		x_cvEmptied.Broadcast();
+	}
+	// 如果后台线程正在读取底层流，这里会等待读取完成。
+	x_pWorker->Wait();
+	x_pWorker.Reset();
+	x_bStopping = false;
+}
+const Vector<unsigned char> *PrefetchingInputStreamFilter::X_WaitForBuffer(std::size_t uIndex){
+	const auto uBufferCount = x_vecBuffers.GetSize();
+	if(uIndex >= uBufferCount){
+		return nullptr;
+	}
+	if(!x_pWorker){
+		x_pWorker = MakeThread([this]{ X_WorkerProc(); });
+	}
+	auto vLock = x_mtxGuard.GetLock();
+	while((x_uFilled <= uIndex) && !x_bEndOfStream){
+		x_cvFilled.Wait(vLock);
+	}
+	if(x_uFilled > uIndex){
+		return &(x_vecBuffers[(x_uFront + uIndex) % uBufferCount]);
+	}
+	// 底层流抛出的异常只被重新抛出一次，之后就像流已经结束一样。调用 Invalidate() 可以重新开始。
+	if(x_pException){
+		std::rethrow_exception(std::exchange(x_pException, std::exception_ptr()));
+	}
+	return nullptr;
+}
+void PrefetchingInputStreamFilter::X_PopFront() noexcept {
+	const auto vLock = x_mtxGuard.GetLock();
+	x_uFront = (x_uFront + 1) % x_vecBuffers.GetSize();
+	--x_uFilled;
+	x_uOffset = 0;
+	x_cvEmptied.Signal();
+}
+
+int PrefetchingInputStreamFilter::Peek(){
+	int nRet = -1;
+	unsigned char byData;
+	if(PrefetchingInputStreamFilter::Peek(&byData, 1) >= 1){
+		nRet = byData;
+	}
+	return nRet;
+}
+int PrefetchingInputStreamFilter::Get(){
+	int nRet = -1;
+	unsigned char byData;
+	if(PrefetchingInputStreamFilter::Get(&byData, 1) >= 1){
+		nRet = byData;
+	}
+	return nRet;
+}
+bool PrefetchingInputStreamFilter::Discard(){
+	bool bRet = false;
+	if(PrefetchingInputStreamFilter::Discard(1) >= 1){
+		bRet = true;
+	}
+	return bRet;
+}
+std::size_t PrefetchingInputStreamFilter::Peek(void *pData, std::size_t uSize){
+	std::size_t uBytesTotal = 0;
+	std::size_t uOffset = x_uOffset;
+	for(std::size_t uIndex = 0; uBytesTotal < uSize; ++uIndex){
+		const auto pvecBuffer = X_WaitForBuffer(uIndex);
+		if(!pvecBuffer){
+			break;
+		}
+		const auto uBytesCopied = Min(uSize - uBytesTotal, pvecBuffer->GetSize() - uOffset);
+		std::memcpy(static_cast<unsigned char *>(pData) + uBytesTotal, pvecBuffer->GetData() + uOffset, uBytesCopied);
+		uBytesTotal += uBytesCopied;
+		uOffset = 0;
+	}
+	return uBytesTotal;
+}
+std::size_t PrefetchingInputStreamFilter::Get(void *pData, std::size_t uSize){
+	std::size_t uBytesTotal = 0;
+	while(uBytesTotal < uSize){
+		const auto pvecBuffer = X_WaitForBuffer(0);
+		if(!pvecBuffer){
+			break;
+		}
+		const auto uBytesCopied = Min(uSize - uBytesTotal, pvecBuffer->GetSize() - x_uOffset);
+		std::memcpy(static_cast<unsigned char *>(pData) + uBytesTotal, pvecBuffer->GetData() + x_uOffset, uBytesCopied);
+		uBytesTotal += uBytesCopied;
+		x_uOffset += uBytesCopied;
+		if(x_uOffset == pvecBuffer->GetSize()){
+			X_PopFront();
+		}
+	}
+	return uBytesTotal;
+}
+std::size_t PrefetchingInputStreamFilter::Discard(std::size_t uSize){
+	std::size_t uBytesTotal = 0;
+	while(uBytesTotal < uSize){
+		const auto pvecBuffer = X_WaitForBuffer(0);
+		if(!pvecBuffer){
+			break;
+		}
+		const auto uBytesDiscarded = Min(uSize - uBytesTotal, pvecBuffer->GetSize() - x_uOffset);
+		uBytesTotal += uBytesDiscarded;
+		x_uOffset += uBytesDiscarded;
+		if(x_uOffset == pvecBuffer->GetSize()){
+			X_PopFront();
+		}
+	}
+	return uBytesTotal;
+}
+void PrefetchingInputStreamFilter::Invalidate(){
+	X_StopWorker();
+	x_uFront = 0;
+	x_uFilled = 0;
+	x_bEndOfStream = false;
+	x_pException = std::exception_ptr();
+	x_uOffset = 0;
+
+	GetUnderlyingStream()->Invalidate();
+}
+bool PrefetchingInputStreamFilter::Borrow(const void **ppData, std::size_t *puSize){
+	const auto pvecBuffer = X_WaitForBuffer(0);
+	if(!pvecBuffer){
+		return false;
+	}
+	*ppData = pvecBuffer->GetData() + x_uOffset;
+	*puSize = pvecBuffer->GetSize() - x_uOffset;
+	return true;
+}
+void PrefetchingInputStreamFilter::Consume(std::size_t uSize){
+	PrefetchingInputStreamFilter::Discard(uSize);
+}
+
+}
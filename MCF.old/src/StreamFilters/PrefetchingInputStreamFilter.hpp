@@ -0,0 +1,78 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_STREAM_FILTERS_PREFETCHING_INPUT_STREAM_FILTER_HPP_
+#define MCF_STREAM_FILTERS_PREFETCHING_INPUT_STREAM_FILTER_HPP_
+
+#include "AbstractInputStreamFilter.hpp"
+#include "../Containers/Vector.hpp"
+#include "../Thread/Mutex.hpp"
+#include "../Thread/ConditionVariable.hpp"
+#include "../Thread/Thread.hpp"
+#include "../SmartPointers/IntrusivePtr.hpp"
+#include <exception>
+
+namespace MCF {
+
+// 由一个后台线程从底层流中预读数据，使读取和处理可以同时进行。
+// 后台线程在第一次读取时启动，它最多填满 uBufferCount 个大小为 uBufferSize 的缓冲区，Borrow() 直接返回这些缓冲区。
+// 预读的数据已经从底层流中取出，Invalidate() 会停止后台线程并丢弃它们。底层流只能由后台线程访问。
+class PrefetchingInputStreamFilter : public AbstractInputStreamFilter {
+public:
+	enum : std::size_t {
+		kDefaultBufferCount = 4,
+		kDefaultBufferSize  = 0x40000,
+	};
+
+private:
+	Vector<Vector<unsigned char>> x_vecBuffers;
+	std::size_t x_uBufferSize;
+
+	mutable Mutex x_mtxGuard;
+	mutable ConditionVariable x_cvFilled;
+	mutable ConditionVariable x_cvEmptied;
+	IntrusivePtr<Thread> x_pWorker;
+	// 下面这些由 x_mtxGuard 保护。
+	std::size_t x_uFront = 0;
+	std::size_t x_uFilled = 0;
+	bool x_bEndOfStream = false;
+	bool x_bStopping = false;
+	std::exception_ptr x_pException;
+
+	// 第一个缓冲区中已经被读取的字节数，只有读取的一方访问它。
+	std::size_t x_uOffset = 0;
+
+private:
+	void X_WorkerProc();
+	void X_StopWorker() noexcept;
+	const Vector<unsigned char> *X_WaitForBuffer(std::size_t uIndex);
+	void X_PopFront() noexcept;
+
+public:
+	explicit PrefetchingInputStreamFilter(PolyIntrusivePtr<AbstractInputStream> pUnderlyingStream, std::size_t uBufferCount = kDefaultBufferCount, std::size_t uBufferSize = kDefaultBufferSize);
+	~PrefetchingInputStreamFilter() override;
+
+public:
+	int Peek() override;
+	int Get() override;
+	bool Discard() override;
+	// 最多返回所有缓冲区中的数据，因此 uSize 超过 uBufferCount * uBufferSize 时返回的数目可能偏小。
+	std::size_t Peek(void *pData, std::size_t uSize) override;
+	std::size_t Get(void *pData, std::size_t uSize) override;
+	std::size_t Discard(std::size_t uSize) override;
+	void Invalidate() override;
+	bool Borrow(const void **ppData, std::size_t *puSize) override;
+	void Consume(std::size_t uSize) override;
+
+	std::size_t GetBufferCount() const noexcept {
+		return x_vecBuffers.GetSize();
+	}
+	std::size_t GetBufferSize() const noexcept {
+		return x_uBufferSize;
+	}
+};
+
+}
+
+#endif
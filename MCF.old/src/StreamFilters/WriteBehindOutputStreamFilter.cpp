@@ -0,0 +1,153 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "WriteBehindOutputStreamFilter.hpp"
+#include "../Core/Exception.hpp"
+#include "../Core/MinMax.hpp"
+
+namespace MCF {
+
+WriteBehindOutputStreamFilter::WriteBehindOutputStreamFilter(PolyIntrusivePtr<AbstractOutputStream> pUnderlyingStream, std::size_t uBufferCount, std::size_t uBufferSize)
+	: AbstractOutputStreamFilter(std::move(pUnderlyingStream))
+	, x_uBufferSize(uBufferSize)
+{
+	if(uBufferCount == 0){
+		MCF_THROW(Exception, ERROR_INVALID_PARAMETER, Rcntws::View(L"WriteBehindOutputStreamFilter: 缓冲区的数目不能为零。"));
+	}
+	if(uBufferSize == 0){
+		MCF_THROW(Exception, ERROR_INVALID_PARAMETER, Rcntws::View(L"WriteBehindOutputStreamFilter: 缓冲区的大小不能为零。"));
+	}
+	x_vecBuffers.Append(uBufferCount);
+}
+WriteBehindOutputStreamFilter::~WriteBehindOutputStreamFilter(){
+	try {
+		WriteBehindOutputStreamFilter::Flush(false);
+	} catch(...){ }
+	X_StopWorker();
+}
+
+void WriteBehindOutputStreamFilter::X_WorkerProc(){
+	const auto uBufferCount = x_vecBuffers.GetSize();
+	auto vLock = x_mtxGuard.GetLock();
+	for(;;){
+		while(!x_bStopping && (x_uQueued == 0)){
+			x_cvQueued.Wait(vLock);
+		}
+		if(x_uQueued == 0){
+			break;
+		}
+		// 这个缓冲区已经被写入的一方交出，写入底层流的时候不需要加锁。
+		auto &vecBuffer = x_vecBuffers[x_uFront];
+		const bool bDiscard = x_bFailed;
+		vLock.Reset();
+		std::exception_ptr pException;
+		if(!bDiscard){
+			try {
+				GetUnderlyingStream()->Put(vecBuffer.GetData(), vecBuffer.GetSize());
+			} catch(...){
+				pException = std::current_exception();
+			}
+		}
+		vecBuffer.Clear();
+		vLock.Reset(x_mtxGuard);
+		if(pException){
+			x_pException = std::move(pException);
+			x_bFailed = true;
+		}
+		x_uFront = (x_uFront + 1) % uBufferCount;
+		--x_uQueued;
+		x_cvWritten.Broadcast();
+	}
+}
+void WriteBehindOutputStreamFilter::X_StopWorker() noexcept {
+	if(!x_pWorker){
+		return;
+	}
+	{
+		const auto vLock = x_mtxGuard.GetLock();
+		x_bStopping = true;
+		x_cvQueued.Broadcast();
+	}
+	x_pWorker->Wait();
+	x_pWorker.Reset();
+	x_bStopping = false;
+}
+void WriteBehindOutputStreamFilter::X_CheckFailure(){
+	if(!x_bFailed){
+		return;
+	}
+	if(x_pException){
+		std::rethrow_exception(std::exchange(x_pException, std::exception_ptr()));
+	}
+	MCF_THROW(Exception, ERROR_WRITE_FAULT, Rcntws::View(L"WriteBehindOutputStreamFilter: 之前的写入已经失败，需要先调用 Reset()。"));
+}
+void WriteBehindOutputStreamFilter::X_WaitForBuffer(){
+	const auto uBufferCount = x_vecBuffers.GetSize();
+	auto vLock = x_mtxGuard.GetLock();
+	while(x_uQueued == uBufferCount){
+		x_cvWritten.Wait(vLock);
+	}
+	X_CheckFailure();
+	x_pvecCurrent = &(x_vecBuffers[(x_uFront + x_uQueued) % uBufferCount]);
+}
+void WriteBehindOutputStreamFilter::X_QueueBuffer(){
+	if(!x_pWorker){
+		x_pWorker = MakeThread([this]{ X_WorkerProc(); });
+	}
+	const auto vLock = x_mtxGuard.GetLock();
+	x_pvecCurrent = nullptr;
+	++x_uQueued;
+	x_cvQueued.Signal();
+}
+void WriteBehindOutputStreamFilter::X_WaitForAll(){
+	auto vLock = x_mtxGuard.GetLock();
+	while(x_uQueued != 0){
+		x_cvWritten.Wait(vLock);
+	}
+	X_CheckFailure();
+}
+
+void WriteBehindOutputStreamFilter::Put(unsigned char byData){
+	WriteBehindOutputStreamFilter::Put(&byData, 1);
+}
+void WriteBehindOutputStreamFilter::Put(const void *pData, std::size_t uSize){
+	std::size_t uBytesTotal = 0;
+	while(uBytesTotal < uSize){
+		if(!x_pvecCurrent){
+			X_WaitForBuffer();
+			x_pvecCurrent->Reserve(x_uBufferSize);
+		}
+		const auto uBytesToCopy = Min(uSize - uBytesTotal, x_uBufferSize - x_pvecCurrent->GetSize());
+		const auto pbyBuffer = x_pvecCurrent->ResizeMore(uBytesToCopy);
+		std::memcpy(pbyBuffer, static_cast<const unsigned char *>(pData) + uBytesTotal, uBytesToCopy);
+		uBytesTotal += uBytesToCopy;
+		if(x_pvecCurrent->GetSize() == x_uBufferSize){
+			X_QueueBuffer();
+		}
+	}
+}
+void WriteBehindOutputStreamFilter::Flush(bool bHard){
+	if(x_pvecCurrent && !x_pvecCurrent->IsEmpty()){
+		X_QueueBuffer();
+	}
+	X_WaitForAll();
+
+	// 后台线程现在是空闲的，可以直接访问底层流。
+	GetUnderlyingStream()->Flush(bHard);
+}
+
+void WriteBehindOutputStreamFilter::Reset(){
+	if(x_pvecCurrent){
+		x_pvecCurrent->Clear();
+	}
+	auto vLock = x_mtxGuard.GetLock();
+	// 排队的缓冲区会被丢弃，必须等到它们都被处理完，否则清除标志之后它们会被写入。
+	while(x_uQueued != 0){
+		x_cvWritten.Wait(vLock);
+	}
+	x_pException = nullptr;
+	x_bFailed = false;
+}
+
+}
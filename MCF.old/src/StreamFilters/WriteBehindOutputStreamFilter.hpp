@@ -0,0 +1,78 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_STREAM_FILTERS_WRITE_BEHIND_OUTPUT_STREAM_FILTER_HPP_
+#define MCF_STREAM_FILTERS_WRITE_BEHIND_OUTPUT_STREAM_FILTER_HPP_
+
+#include "AbstractOutputStreamFilter.hpp"
+#include "../Containers/Vector.hpp"
+#include "../Thread/Mutex.hpp"
+#include "../Thread/ConditionVariable.hpp"
+#include "../Thread/Thread.hpp"
+#include "../SmartPointers/IntrusivePtr.hpp"
+#include <exception>
+
+namespace MCF {
+
+// 写入的数据被放入 uBufferCount 个大小为 uBufferSize 的缓冲区中，由一个后台线程写入底层流，写入的一方不需要等待 I/O。
+// 只有当所有缓冲区都已写满并且还没有被写入底层流时，写入的一方才会等待。
+// Flush(false) 等待所有数据写入底层流；Flush(true) 在此之后还要求底层流把数据写入持久存储，可以用作持久化的屏障。
+// 后台线程写入失败时，异常在下一次调用 Put() 或 Flush() 时被重新抛出一次，此后排队的和新写入的数据都被丢弃，
+// Put() 和 Flush() 抛出 ERROR_WRITE_FAULT，直到调用 Reset() 为止。
+class WriteBehindOutputStreamFilter : public AbstractOutputStreamFilter {
+public:
+	enum : std::size_t {
+		kDefaultBufferCount = 4,
+		kDefaultBufferSize  = 0x100000,
+	};
+
+private:
+	Vector<Vector<unsigned char>> x_vecBuffers;
+	std::size_t x_uBufferSize;
+
+	mutable Mutex x_mtxGuard;
+	mutable ConditionVariable x_cvQueued;
+	mutable ConditionVariable x_cvWritten;
+	IntrusivePtr<Thread> x_pWorker;
+	// 下面这些由 x_mtxGuard 保护。
+	std::size_t x_uFront = 0;
+	std::size_t x_uQueued = 0;
+	bool x_bStopping = false;
+	bool x_bFailed = false; // 写入失败之后一直为 true，直到调用 Reset()。
+	std::exception_ptr x_pException;
+
+	// 正在被写入的缓冲区，只有写入的一方访问它。
+	Vector<unsigned char> *x_pvecCurrent = nullptr;
+
+private:
+	void X_WorkerProc();
+	void X_StopWorker() noexcept;
+	void X_CheckFailure();
+	void X_WaitForBuffer();
+	void X_QueueBuffer();
+	void X_WaitForAll();
+
+public:
+	explicit WriteBehindOutputStreamFilter(PolyIntrusivePtr<AbstractOutputStream> pUnderlyingStream, std::size_t uBufferCount = kDefaultBufferCount, std::size_t uBufferSize = kDefaultBufferSize);
+	~WriteBehindOutputStreamFilter() override;
+
+public:
+	void Put(unsigned char byData) override;
+	void Put(const void *pData, std::size_t uSize) override;
+	void Flush(bool bHard) override;
+
+	// 丢弃还没有写入底层流的数据并清除失败的状态。底层流中的数据可能在失败的位置之前就已经中断，这里不作处理。
+	void Reset();
+
+	std::size_t GetBufferCount() const noexcept {
+		return x_vecBuffers.GetSize();
+	}
+	std::size_t GetBufferSize() const noexcept {
+		return x_uBufferSize;
+	}
+};
+
+}
+
+#endif
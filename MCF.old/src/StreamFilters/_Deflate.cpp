@@ -0,0 +1,47 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "_Deflate.hpp"
+#include "../Core/MinMax.hpp"
+
+namespace MCF {
+
+namespace Impl_Deflate {
+	void Adler32::Update(const void *pData, std::size_t uSize) noexcept {
+		// 5552 是使 B 在 32 位无符号整数中不溢出的最大块长度。
+		constexpr std::size_t kMaxChunkSize = 5552;
+
+		auto pbyRead = static_cast<const unsigned char *>(pData);
+		auto uBytesRemaining = uSize;
+		auto u32A = x_u32A;
+		auto u32B = x_u32B;
+		while(uBytesRemaining != 0){
+			const auto uChunkSize = Min(uBytesRemaining, kMaxChunkSize);
+			const auto pbyChunkEnd = pbyRead + uChunkSize;
+			while(pbyChunkEnd - pbyRead >= 4){
+				u32A += pbyRead[0];
+				u32B += u32A;
+				u32A += pbyRead[1];
+				u32B += u32A;
+				u32A += pbyRead[2];
+				u32B += u32A;
+				u32A += pbyRead[3];
+				u32B += u32A;
+				pbyRead += 4;
+			}
+			while(pbyRead != pbyChunkEnd){
+				u32A += *pbyRead;
+				u32B += u32A;
+				++pbyRead;
+			}
+			u32A %= 65521;
+			u32B %= 65521;
+			uBytesRemaining -= uChunkSize;
+		}
+		x_u32A = u32A;
+		x_u32B = u32B;
+	}
+}
+
+}
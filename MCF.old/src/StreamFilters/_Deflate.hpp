@@ -0,0 +1,85 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_STREAM_FILTERS_DEFLATE_HPP_
+#define MCF_STREAM_FILTERS_DEFLATE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace MCF {
+
+namespace Impl_Deflate {
+	// https://tools.ietf.org/html/rfc1950
+	// https://tools.ietf.org/html/rfc1951
+	// https://tools.ietf.org/html/rfc1952
+	enum : std::size_t {
+		kWindowSize         = 0x8000,
+		kMinMatch           = 3,
+		kMaxMatch           = 258,
+		kMaxStoredBlockSize = 0xFFFF,
+	};
+
+	enum : unsigned {
+		kEndOfBlock          = 256,
+		kLitLenSymbolCount   = 288,
+		kDistanceSymbolCount = 32,
+		kCodeLengthCount     = 19,
+		kMaxCodeLength       = 15,
+		kMaxCodeLengthLength = 7,
+	};
+
+	// 长度符号 257 ~ 285 和距离符号 0 ~ 29 的基数与额外位数。
+	constexpr std::uint16_t kLengthBase[29] = {
+		3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+		35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258,
+	};
+	constexpr std::uint8_t kLengthExtraBits[29] = {
+		0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+		3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0,
+	};
+	constexpr std::uint16_t kDistanceBase[30] = {
+		1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+		257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577,
+	};
+	constexpr std::uint8_t kDistanceExtraBits[30] = {
+		0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+		7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13,
+	};
+	// 码长的码长在动态块头中的顺序。
+	constexpr std::uint8_t kCodeLengthOrder[kCodeLengthCount] = {
+		16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15,
+	};
+
+	// 固定霍夫曼块使用的码长。
+	constexpr unsigned GetFixedLitLenLength(unsigned uSymbol) noexcept {
+		return (uSymbol < 144) ? 8 : (uSymbol < 256) ? 9 : (uSymbol < 280) ? 7 : 8;
+	}
+	constexpr unsigned kFixedDistanceLength = 5;
+
+	class Adler32 {
+	private:
+		std::uint32_t x_u32A;
+		std::uint32_t x_u32B;
+
+	public:
+		Adler32() noexcept {
+			Reset();
+		}
+
+	public:
+		void Reset() noexcept {
+			x_u32A = 1;
+			x_u32B = 0;
+		}
+		void Update(const void *pData, std::size_t uSize) noexcept;
+		std::uint32_t Finalize() const noexcept {
+			return (x_u32B << 16) | x_u32A;
+		}
+	};
+}
+
+}
+
+#endif
@@ -0,0 +1,446 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "_Lz4.hpp"
+#include "../Core/Endian.hpp"
+#include "../Core/CountLeadingTrailingZeroes.hpp"
+#include "../Core/MinMax.hpp"
+#include "../Core/Assert.hpp"
+#include <cstring>
+
+namespace MCF {
+
+namespace Impl_Lz4 {
+	namespace {
+		enum : unsigned {
+			kMinMatch     = 4,
+			kLastLiterals = 5,  // 最后 5 字节必须是字面量。
+			kMatchLimit   = 12, // 最后一个匹配必须在末尾 12 字节之前开始。
+			kFastHashBits = 13,
+			kHighHashBits = 15,
+			kSkipTrigger  = 6,
+		};
+
+		std::uint16_t Load16(const unsigned char *pbyData) noexcept {
+			std::uint16_t u16Word;
+			std::memcpy(&u16Word, pbyData, sizeof(u16Word));
+			return LoadLe(u16Word);
+		}
+		std::uint32_t Load32(const unsigned char *pbyData) noexcept {
+			std::uint32_t u32Word;
+			std::memcpy(&u32Word, pbyData, sizeof(u32Word));
+			return LoadLe(u32Word);
+		}
+		std::uint64_t Load64(const unsigned char *pbyData) noexcept {
+			std::uint64_t u64Word;
+			std::memcpy(&u64Word, pbyData, sizeof(u64Word));
+			return LoadLe(u64Word);
+		}
+		void Store16(unsigned char *pbyData, std::uint16_t u16Value) noexcept {
+			std::uint16_t u16Word;
+			StoreLe(u16Word, u16Value);
+			std::memcpy(pbyData, &u16Word, sizeof(u16Word));
+		}
+
+		constexpr std::uint32_t RotateLeft(std::uint32_t u32Value, unsigned uBits) noexcept {
+			return (u32Value << uBits) | (u32Value >> (32 - uBits));
+		}
+
+		unsigned Hash(std::uint32_t u32Sequence, unsigned uBits) noexcept {
+			return (u32Sequence * 2654435761u) >> (32 - uBits);
+		}
+
+		// 返回 [pbyRead, pbyLimit) 和从 pbyRef 开始的数据相同的前缀的长度。
+		std::size_t CountCommonBytes(const unsigned char *pbyRead, const unsigned char *pbyRef, const unsigned char *pbyLimit) noexcept {
+			const auto pbyBegin = pbyRead;
+			while(pbyLimit - pbyRead >= 8){
+				const auto u64Diff = Load64(pbyRead) ^ Load64(pbyRef);
+				if(u64Diff != 0){
+					return static_cast<std::size_t>(pbyRead - pbyBegin) + CountTrailingZeroes(static_cast<unsigned long long>(u64Diff)) / 8;
+				}
+				pbyRead += 8;
+				pbyRef += 8;
+			}
+			while((pbyRead < pbyLimit) && (*pbyRead == *pbyRef)){
+				++pbyRead;
+				++pbyRef;
+			}
+			return static_cast<std::size_t>(pbyRead - pbyBegin);
+		}
+
+		unsigned char *EncodeLength(unsigned char *pbyWrite, std::size_t uLength) noexcept {
+			while(uLength >= 255){
+				*(pbyWrite++) = 255;
+				uLength -= 255;
+			}
+			*(pbyWrite++) = static_cast<unsigned char>(uLength);
+			return pbyWrite;
+		}
+
+		// 写入一个序列。空间不足时返回 false。
+		bool EncodeSequence(unsigned char *&pbyWrite, unsigned char *pbyEnd, const unsigned char *pbyLiterals, std::size_t uLiteralLength, std::size_t uOffset, std::size_t uMatchLength) noexcept {
+			const auto uMatchCode = uMatchLength - kMinMatch;
+			const auto uSizeNeeded = 1 + uLiteralLength / 255 + 1 + uLiteralLength + 2 + uMatchCode / 255 + 1;
+			if(static_cast<std::size_t>(pbyEnd - pbyWrite) < uSizeNeeded){
+				return false;
+			}
+			const auto pbyToken = pbyWrite++;
+			if(uLiteralLength >= 15){
+				*pbyToken = 0xF0;
+				pbyWrite = EncodeLength(pbyWrite, uLiteralLength - 15);
+			} else {
+				*pbyToken = static_cast<unsigned char>(uLiteralLength << 4);
+			}
+			std::memcpy(pbyWrite, pbyLiterals, uLiteralLength);
+			pbyWrite += uLiteralLength;
+			Store16(pbyWrite, static_cast<std::uint16_t>(uOffset));
+			pbyWrite += 2;
+			if(uMatchCode >= 15){
+				*pbyToken |= 0x0F;
+				pbyWrite = EncodeLength(pbyWrite, uMatchCode - 15);
+			} else {
+				*pbyToken |= static_cast<unsigned char>(uMatchCode);
+			}
+			return true;
+		}
+		// 写入最后一个只有字面量的序列。
+		bool EncodeLastLiterals(unsigned char *&pbyWrite, unsigned char *pbyEnd, const unsigned char *pbyLiterals, std::size_t uLiteralLength) noexcept {
+			const auto uSizeNeeded = 1 + uLiteralLength / 255 + 1 + uLiteralLength;
+			if(static_cast<std::size_t>(pbyEnd - pbyWrite) < uSizeNeeded){
+				return false;
+			}
+			const auto pbyToken = pbyWrite++;
+			if(uLiteralLength >= 15){
+				*pbyToken = 0xF0;
+				pbyWrite = EncodeLength(pbyWrite, uLiteralLength - 15);
+			} else {
+				*pbyToken = static_cast<unsigned char>(uLiteralLength << 4);
+			}
+			std::memcpy(pbyWrite, pbyLiterals, uLiteralLength);
+			pbyWrite += uLiteralLength;
+			return true;
+		}
+	}
+
+	void Xxh32::Reset(std::uint32_t u32Seed) noexcept {
+		x_au32Acc[0] = u32Seed + 2654435761u + 2246822519u;
+		x_au32Acc[1] = u32Seed + 2246822519u;
+		x_au32Acc[2] = u32Seed;
+		x_au32Acc[3] = u32Seed - 2654435761u;
+		x_uBytesInChunk = 0;
+		x_u64BytesTotal = 0;
+		x_u32Seed = u32Seed;
+	}
+	void Xxh32::Update(const void *pData, std::size_t uSize) noexcept {
+		const auto fnRound = [](std::uint32_t &u32Acc, const unsigned char *pbyLane){
+			u32Acc = RotateLeft(u32Acc + Load32(pbyLane) * 2246822519u, 13) * 2654435761u;
+		};
+		const auto fnUpdate = [&](const unsigned char *pbyStripe){
+			fnRound(x_au32Acc[0], pbyStripe);
+			fnRound(x_au32Acc[1], pbyStripe + 4);
+			fnRound(x_au32Acc[2], pbyStripe + 8);
+			fnRound(x_au32Acc[3], pbyStripe + 12);
+		};
+
+		auto pbyRead = static_cast<const unsigned char *>(pData);
+		auto uBytesRemaining = uSize;
+		x_u64BytesTotal += uSize;
+		if(x_uBytesInChunk != 0){
+			const auto uBytesToCopy = Min(uBytesRemaining, sizeof(x_abyChunk) - x_uBytesInChunk);
+			std::memcpy(x_abyChunk + x_uBytesInChunk, pbyRead, uBytesToCopy);
+			x_uBytesInChunk += static_cast<unsigned>(uBytesToCopy);
+			pbyRead += uBytesToCopy;
+			uBytesRemaining -= uBytesToCopy;
+			if(x_uBytesInChunk < sizeof(x_abyChunk)){
+				return;
+			}
+			fnUpdate(x_abyChunk);
+			x_uBytesInChunk = 0;
+		}
+		while(uBytesRemaining >= sizeof(x_abyChunk)){
+			fnUpdate(pbyRead);
+			pbyRead += sizeof(x_abyChunk);
+			uBytesRemaining -= sizeof(x_abyChunk);
+		}
+		if(uBytesRemaining != 0){
+			std::memcpy(x_abyChunk, pbyRead, uBytesRemaining);
+			x_uBytesInChunk = static_cast<unsigned>(uBytesRemaining);
+		}
+	}
+	std::uint32_t Xxh32::Finalize() const noexcept {
+		std::uint32_t u32Hash;
+		if(x_u64BytesTotal >= sizeof(x_abyChunk)){
+			u32Hash = RotateLeft(x_au32Acc[0], 1) + RotateLeft(x_au32Acc[1], 7) + RotateLeft(x_au32Acc[2], 12) + RotateLeft(x_au32Acc[3], 18);
+		} else {
+			u32Hash = x_u32Seed + 374761393u;
+		}
+		u32Hash += static_cast<std::uint32_t>(x_u64BytesTotal);
+
+		unsigned uIndex = 0;
+		for(; uIndex + 4 <= x_uBytesInChunk; uIndex += 4){
+			u32Hash = RotateLeft(u32Hash + Load32(x_abyChunk + uIndex) * 3266489917u, 17) * 668265263u;
+		}
+		for(; uIndex < x_uBytesInChunk; ++uIndex){
+			u32Hash = RotateLeft(u32Hash + x_abyChunk[uIndex] * 374761393u, 11) * 2654435761u;
+		}
+		u32Hash ^= u32Hash >> 15;
+		u32Hash *= 2246822519u;
+		u32Hash ^= u32Hash >> 13;
+		u32Hash *= 3266489917u;
+		u32Hash ^= u32Hash >> 16;
+		return u32Hash;
+	}
+
+	std::size_t Compressor::X_CompressFast(unsigned char *pbyOut, std::size_t uOutCapacity, const unsigned char *pbyIn, std::size_t uInSize) noexcept {
+		const auto pu32HashTable = x_vecHashTable.GetData();
+		std::memset(pu32HashTable, 0, (1u << kFastHashBits) * sizeof(std::uint32_t));
+
+		auto pbyWrite = pbyOut;
+		const auto pbyWriteEnd = pbyOut + uOutCapacity;
+		auto pbyRead = pbyIn;
+		auto pbyAnchor = pbyIn;
+		const auto pbyReadEnd = pbyIn + uInSize;
+
+		if(uInSize > kMatchLimit){
+			const auto pbyMatchStartLimit = pbyReadEnd - kMatchLimit;
+			const auto pbyMatchEndLimit = pbyReadEnd - kLastLiterals;
+
+			pu32HashTable[Hash(Load32(pbyRead), kFastHashBits)] = 0;
+			++pbyRead;
+			for(;;){
+				// 寻找下一个匹配。连续失败时步长逐渐增大，这样不可压缩的数据可以很快被跳过。
+				const unsigned char *pbyRef;
+				unsigned uAttempts = 1u << kSkipTrigger;
+				for(;;){
+					if(pbyRead > pbyMatchStartLimit){
+						goto jDone;
+					}
+					const auto u32Sequence = Load32(pbyRead);
+					auto &u32Slot = pu32HashTable[Hash(u32Sequence, kFastHashBits)];
+					pbyRef = pbyIn + u32Slot;
+					u32Slot = static_cast<std::uint32_t>(pbyRead - pbyIn);
+					if((pbyRef < pbyRead) && (static_cast<std::size_t>(pbyRead - pbyRef) < kWindowSize) && (Load32(pbyRef) == u32Sequence)){
+						break;
+					}
+					pbyRead += uAttempts++ >> kSkipTrigger;
+				}
+				// 向前扩展匹配。
+				while((pbyRead > pbyAnchor) && (pbyRef > pbyIn) && (pbyRead[-1] == pbyRef[-1])){
+					--pbyRead;
+					--pbyRef;
+				}
+				const auto uMatchLength = kMinMatch + CountCommonBytes(pbyRead + kMinMatch, pbyRef + kMinMatch, pbyMatchEndLimit);
+				if(!EncodeSequence(pbyWrite, pbyWriteEnd, pbyAnchor, static_cast<std::size_t>(pbyRead - pbyAnchor), static_cast<std::size_t>(pbyRead - pbyRef), uMatchLength)){
+					return 0;
+				}
+				pbyRead += uMatchLength;
+				pbyAnchor = pbyRead;
+				if(pbyRead > pbyMatchStartLimit){
+					break;
+				}
+				pu32HashTable[Hash(Load32(pbyRead - 2), kFastHashBits)] = static_cast<std::uint32_t>(pbyRead - 2 - pbyIn);
+			}
+		}
+	jDone:
+		if(!EncodeLastLiterals(pbyWrite, pbyWriteEnd, pbyAnchor, static_cast<std::size_t>(pbyReadEnd - pbyAnchor))){
+			return 0;
+		}
+		return static_cast<std::size_t>(pbyWrite - pbyOut);
+	}
+	std::size_t Compressor::X_CompressHigh(unsigned char *pbyOut, std::size_t uOutCapacity, const unsigned char *pbyIn, std::size_t uInSize) noexcept {
+		// 散列表中保存的是位置加一，零表示空。链表中保存的是到同一个散列值的前一个位置的距离，零表示没有。
+		const auto pu32HashTable = x_vecHashTable.GetData();
+		std::memset(pu32HashTable, 0, (1u << kHighHashBits) * sizeof(std::uint32_t));
+		const auto pu16ChainTable = x_vecChainTable.GetData();
+		const auto uMaxAttempts = 1u << Min(x_uLevel - 1, 15u);
+
+		auto pbyWrite = pbyOut;
+		const auto pbyWriteEnd = pbyOut + uOutCapacity;
+		auto pbyRead = pbyIn;
+		auto pbyAnchor = pbyIn;
+		const auto pbyReadEnd = pbyIn + uInSize;
+
+		if(uInSize > kMatchLimit){
+			const auto pbyMatchStartLimit = pbyReadEnd - kMatchLimit;
+			const auto pbyMatchEndLimit = pbyReadEnd - kLastLiterals;
+
+			std::size_t uNextToInsert = 0;
+			const auto fnFindLongestMatch = [&](const unsigned char *pbyCur, const unsigned char **ppbyRef) noexcept {
+				const auto uCur = static_cast<std::size_t>(pbyCur - pbyIn);
+				while(uNextToInsert <= uCur){
+					auto &u32Slot = pu32HashTable[Hash(Load32(pbyIn + uNextToInsert), kHighHashBits)];
+					const auto uDelta = (u32Slot == 0) ? 0 : (uNextToInsert - (u32Slot - 1));
+					pu16ChainTable[uNextToInsert & (kWindowSize - 1)] = static_cast<std::uint16_t>((uDelta < kWindowSize) ? uDelta : 0);
+					u32Slot = static_cast<std::uint32_t>(uNextToInsert + 1);
+					++uNextToInsert;
+				}
+
+				const auto u32Sequence = Load32(pbyCur);
+				std::size_t uBestLength = 0;
+				auto uCandidate = uCur;
+				for(unsigned uAttempt = 0; uAttempt < uMaxAttempts; ++uAttempt){
+					const unsigned uDelta = pu16ChainTable[uCandidate & (kWindowSize - 1)];
+					if(uDelta == 0){
+						break;
+					}
+					uCandidate -= uDelta;
+					if(uCur - uCandidate >= kWindowSize){
+						break;
+					}
+					const auto pbyCandidate = pbyIn + uCandidate;
+					// 先比较当前最长匹配之后的那个字节，不可能更长的候选可以很快被排除。
+					if((uBestLength != 0) && (pbyCandidate[uBestLength] != pbyCur[uBestLength])){
+						continue;
+					}
+					if(Load32(pbyCandidate) != u32Sequence){
+						continue;
+					}
+					const auto uLength = kMinMatch + CountCommonBytes(pbyCur + kMinMatch, pbyCandidate + kMinMatch, pbyMatchEndLimit);
+					if(uLength > uBestLength){
+						uBestLength = uLength;
+						*ppbyRef = pbyCandidate;
+						if(pbyCur + uLength == pbyMatchEndLimit){
+							break;
+						}
+					}
+				}
+				return uBestLength;
+			};
+
+			while(pbyRead <= pbyMatchStartLimit){
+				const unsigned char *pbyRef;
+				auto uMatchLength = fnFindLongestMatch(pbyRead, &pbyRef);
+				if(uMatchLength == 0){
+					++pbyRead;
+					continue;
+				}
+				// 如果下一个位置的匹配更长，就把当前位置作为字面量输出。
+				while(pbyRead + 1 <= pbyMatchStartLimit){
+					const unsigned char *pbyNextRef;
+					const auto uNextMatchLength = fnFindLongestMatch(pbyRead + 1, &pbyNextRef);
+					if(uNextMatchLength <= uMatchLength){
+						break;
+					}
+					++pbyRead;
+					pbyRef = pbyNextRef;
+					uMatchLength = uNextMatchLength;
+				}
+				if(!EncodeSequence(pbyWrite, pbyWriteEnd, pbyAnchor, static_cast<std::size_t>(pbyRead - pbyAnchor), static_cast<std::size_t>(pbyRead - pbyRef), uMatchLength)){
+					return 0;
+				}
+				pbyRead += uMatchLength;
+				pbyAnchor = pbyRead;
+			}
+		}
+		if(!EncodeLastLiterals(pbyWrite, pbyWriteEnd, pbyAnchor, static_cast<std::size_t>(pbyReadEnd - pbyAnchor))){
+			return 0;
+		}
+		return static_cast<std::size_t>(pbyWrite - pbyOut);
+	}
+
+	std::size_t Compressor::Compress(void *pOut, std::size_t uOutCapacity, const void *pIn, std::size_t uInSize){
+		// 位置用 32 位整数保存。
+		MCF_ASSERT(uInSize <= UINT32_MAX - 1);
+
+		if(x_uLevel == 0){
+			if(x_vecHashTable.GetSize() < (1u << kFastHashBits)){
+				x_vecHashTable.Resize(1u << kFastHashBits);
+			}
+			return X_CompressFast(static_cast<unsigned char *>(pOut), uOutCapacity, static_cast<const unsigned char *>(pIn), uInSize);
+		} else {
+			if(x_vecHashTable.GetSize() < (1u << kHighHashBits)){
+				x_vecHashTable.Resize(1u << kHighHashBits);
+			}
+			if(x_vecChainTable.GetSize() < kWindowSize){
+				x_vecChainTable.Resize(kWindowSize);
+			}
+			return X_CompressHigh(static_cast<unsigned char *>(pOut), uOutCapacity, static_cast<const unsigned char *>(pIn), uInSize);
+		}
+	}
+
+	std::size_t Decompress(unsigned char *pbyOut, std::size_t uOutCapacity, const unsigned char *pbyDictBegin, const void *pIn, std::size_t uInSize) noexcept {
+		auto pbyWrite = pbyOut;
+		const auto pbyWriteEnd = pbyOut + uOutCapacity;
+		auto pbyRead = static_cast<const unsigned char *>(pIn);
+		const auto pbyReadEnd = pbyRead + uInSize;
+
+		const auto fnDecodeLength = [&](std::size_t &uLength) noexcept {
+			for(;;){
+				if(pbyRead == pbyReadEnd){
+					return false;
+				}
+				const unsigned uByte = *(pbyRead++);
+				uLength += uByte;
+				if(uByte != 255){
+					return true;
+				}
+			}
+		};
+
+		for(;;){
+			if(pbyRead == pbyReadEnd){
+				return SIZE_MAX;
+			}
+			const unsigned uToken = *(pbyRead++);
+
+			std::size_t uLiteralLength = uToken >> 4;
+			if((uLiteralLength != 15) && (pbyReadEnd - pbyRead >= 32) && (pbyWriteEnd - pbyWrite >= 32)){
+				// 快速路径：短的字面量总是复制 16 字节。由于输入至少还有 32 字节，这不会是最后一个序列。
+				std::memcpy(pbyWrite, pbyRead, 16);
+				pbyWrite += uLiteralLength;
+				pbyRead += uLiteralLength;
+				goto jMatch;
+			}
+			if((uLiteralLength == 15) && !fnDecodeLength(uLiteralLength)){
+				return SIZE_MAX;
+			}
+			if((static_cast<std::size_t>(pbyReadEnd - pbyRead) < uLiteralLength) || (static_cast<std::size_t>(pbyWriteEnd - pbyWrite) < uLiteralLength)){
+				return SIZE_MAX;
+			}
+			std::memcpy(pbyWrite, pbyRead, uLiteralLength);
+			pbyWrite += uLiteralLength;
+			pbyRead += uLiteralLength;
+			if(pbyRead == pbyReadEnd){
+				// 最后一个序列没有匹配。
+				break;
+			}
+		jMatch:
+			if(pbyReadEnd - pbyRead < 2){
+				return SIZE_MAX;
+			}
+			const std::size_t uOffset = Load16(pbyRead);
+			pbyRead += 2;
+			if((uOffset == 0) || (uOffset > static_cast<std::size_t>(pbyWrite - pbyDictBegin))){
+				return SIZE_MAX;
+			}
+			std::size_t uMatchLength = uToken & 0x0F;
+			if((uMatchLength == 15) && !fnDecodeLength(uMatchLength)){
+				return SIZE_MAX;
+			}
+			uMatchLength += kMinMatch;
+			if(static_cast<std::size_t>(pbyWriteEnd - pbyWrite) < uMatchLength){
+				return SIZE_MAX;
+			}
+			const auto pbyRef = pbyWrite - uOffset;
+			if((uOffset >= 8) && (static_cast<std::size_t>(pbyWriteEnd - pbyWrite) >= uMatchLength + 8)){
+				// 快速路径：每次复制 8 字节，允许越过匹配的末尾。
+				for(std::size_t uIndex = 0; uIndex < uMatchLength; uIndex += 8){
+					std::memcpy(pbyWrite + uIndex, pbyRef + uIndex, 8);
+				}
+				pbyWrite += uMatchLength;
+				continue;
+			}
+			// 匹配可以和输出重叠。每次复制的长度不超过已经写入的部分，这样复制的长度每次翻倍。
+			while(uMatchLength != 0){
+				const auto uBytesToCopy = Min(uMatchLength, static_cast<std::size_t>(pbyWrite - pbyRef));
+				std::memcpy(pbyWrite, pbyRef, uBytesToCopy);
+				pbyWrite += uBytesToCopy;
+				uMatchLength -= uBytesToCopy;
+			}
+		}
+		return static_cast<std::size_t>(pbyWrite - pbyOut);
+	}
+}
+
+}
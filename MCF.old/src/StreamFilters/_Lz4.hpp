@@ -0,0 +1,95 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_STREAM_FILTERS_LZ4_HPP_
+#define MCF_STREAM_FILTERS_LZ4_HPP_
+
+#include "../Containers/Vector.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace MCF {
+
+namespace Impl_Lz4 {
+	// https://github.com/lz4/lz4/blob/dev/doc/lz4_Frame_format.md
+	// https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+	enum : std::uint32_t {
+		kFrameMagic         = 0x184D2204,
+		kSkippableMagic     = 0x184D2A50,
+		kSkippableMagicMask = 0xFFFFFFF0,
+		kUncompressedFlag   = 0x80000000,
+	};
+
+	enum : std::size_t {
+		kWindowSize   = 0x10000,
+		kMaxBlockSize = 0x400000,
+	};
+
+	// 压缩 uSize 字节的数据在最坏情况下需要的输出缓冲区大小。
+	constexpr std::size_t GetCompressBound(std::size_t uSize) noexcept {
+		return uSize + uSize / 255 + 16;
+	}
+
+	class Xxh32 {
+	private:
+		std::uint32_t x_au32Acc[4];
+		unsigned char x_abyChunk[16];
+		unsigned x_uBytesInChunk;
+		std::uint64_t x_u64BytesTotal;
+		std::uint32_t x_u32Seed;
+
+	public:
+		explicit Xxh32(std::uint32_t u32Seed = 0) noexcept {
+			Reset(u32Seed);
+		}
+
+	public:
+		void Reset(std::uint32_t u32Seed = 0) noexcept;
+		void Update(const void *pData, std::size_t uSize) noexcept;
+		std::uint32_t Finalize() const noexcept;
+
+		static std::uint32_t Hash(const void *pData, std::size_t uSize, std::uint32_t u32Seed = 0) noexcept {
+			Xxh32 vHasher(u32Seed);
+			vHasher.Update(pData, uSize);
+			return vHasher.Finalize();
+		}
+	};
+
+	// 每次压缩一个独立的块，不引用之前的块。
+	// uLevel 为 0 时使用单一的散列表，速度最快；否则使用散列链，每个位置最多尝试 2^(uLevel-1) 个候选。
+	class Compressor {
+	private:
+		unsigned x_uLevel;
+		Vector<std::uint32_t> x_vecHashTable;
+		Vector<std::uint16_t> x_vecChainTable;
+
+	private:
+		std::size_t X_CompressFast(unsigned char *pbyOut, std::size_t uOutCapacity, const unsigned char *pbyIn, std::size_t uInSize) noexcept;
+		std::size_t X_CompressHigh(unsigned char *pbyOut, std::size_t uOutCapacity, const unsigned char *pbyIn, std::size_t uInSize) noexcept;
+
+	public:
+		explicit Compressor(unsigned uLevel = 0) noexcept
+			: x_uLevel(uLevel)
+		{ }
+
+	public:
+		unsigned GetLevel() const noexcept {
+			return x_uLevel;
+		}
+		void SetLevel(unsigned uLevel) noexcept {
+			x_uLevel = uLevel;
+		}
+
+		// 返回压缩后的大小。如果 uOutCapacity 不够大则返回 0。
+		std::size_t Compress(void *pOut, std::size_t uOutCapacity, const void *pIn, std::size_t uInSize);
+	};
+
+	// 解压一个块，返回解压后的大小。[pbyDictBegin, pbyOut) 中的数据可以被引用，它们应当是之前解压出的数据。
+	// 如果数据无效或者 uOutCapacity 不够大则返回 SIZE_MAX。
+	std::size_t Decompress(unsigned char *pbyOut, std::size_t uOutCapacity, const unsigned char *pbyDictBegin, const void *pIn, std::size_t uInSize) noexcept;
+}
+
+}
+
+#endif
@@ -6,6 +6,22 @@
 
 namespace MCF {
 
+enum : std::size_t { kBorrowBufferSize = 4096 };
+
 AbstractInputStream::~AbstractInputStream(){ }
 
+bool AbstractInputStream::Borrow(const void **ppData, std::size_t *puSize){
+	x_vecBorrowBuffer.Resize(kBorrowBufferSize);
+	const auto uBytesRead = Peek(x_vecBorrowBuffer.GetData(), x_vecBorrowBuffer.GetSize());
+	if(uBytesRead == 0){
+		return false;
+	}
+	*ppData = x_vecBorrowBuffer.GetData();
+	*puSize = uBytesRead;
+	return true;
+}
+void AbstractInputStream::Consume(std::size_t uSize){
+	Discard(uSize);
+}
+
 }
@@ -6,11 +6,15 @@
 #define MCF_STREAMS_ABSTRACT_INPUT_STREAM_HPP_
 
 #include "../SmartPointers/PolyIntrusivePtr.hpp"
+#include "../Containers/Vector.hpp"
 #include <cstddef>
 
 namespace MCF {
 
 class AbstractInputStream : public PolyIntrusiveBase<AbstractInputStream> {
+private:
+	Vector<unsigned char> x_vecBorrowBuffer;
+
 public:
 	AbstractInputStream() noexcept = default;
 	~AbstractInputStream() override;
@@ -26,6 +30,12 @@ public:
 	virtual std::size_t Get(void *pData, std::size_t uSize) = 0;
 	virtual std::size_t Discard(std::size_t uSize) = 0;
 	virtual void Invalidate() = 0;
+
+	// 返回流中接下来的一段数据，调用者可以直接读取而不需要复制。如果流已经结束则返回 false。
+	// 返回的数据在下一次调用此流的其他成员函数之前有效，被读取的部分应当用 Consume() 丢弃。
+	// 默认实现把数据 Peek() 到内部的缓冲区中，派生类应当尽可能直接返回自己的缓冲区。
+	virtual bool Borrow(const void **ppData, std::size_t *puSize);
+	virtual void Consume(std::size_t uSize);
 };
 
 }
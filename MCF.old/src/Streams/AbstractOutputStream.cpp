@@ -3,9 +3,36 @@
 // Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
 
 #include "AbstractOutputStream.hpp"
+#include "../Core/MinMax.hpp"
+#include "../Core/Assert.hpp"
 
 namespace MCF {
 
+enum : std::size_t { kReserveBufferSize = 4096 };
+
 AbstractOutputStream::~AbstractOutputStream(){ }
 
+std::size_t AbstractOutputStream::Reserve(void **ppData, std::size_t uMinSize){
+	x_vecReserveBuffer.Resize(Max(uMinSize, static_cast<std::size_t>(kReserveBufferSize)));
+	*ppData = x_vecReserveBuffer.GetData();
+	return x_vecReserveBuffer.GetSize();
+}
+void AbstractOutputStream::Commit(std::size_t uSize){
+	MCF_DEBUG_CHECK(uSize <= x_vecReserveBuffer.GetSize());
+
+	if(uSize > 0){
+		Put(x_vecReserveBuffer.GetData(), uSize);
+	}
+}
+void AbstractOutputStream::PutChunks(const StreamBuffer &sbufData){
+	StreamBuffer::EnumerationCookie vCookie;
+	const void *pChunk;
+	std::size_t uChunkSize;
+	while(sbufData.EnumerateChunk(&pChunk, &uChunkSize, vCookie)){
+		if(uChunkSize > 0){
+			Put(pChunk, uChunkSize);
+		}
+	}
+}
+
 }
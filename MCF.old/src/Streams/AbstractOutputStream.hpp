@@ -6,11 +6,16 @@
 #define MCF_STREAMS_ABSTRACT_OUTPUT_STREAM_HPP_
 
 #include "../SmartPointers/PolyIntrusivePtr.hpp"
+#include "../Containers/Vector.hpp"
+#include "../Core/StreamBuffer.hpp"
 #include <cstddef>
 
 namespace MCF {
 
 class AbstractOutputStream : public PolyIntrusiveBase<AbstractOutputStream> {
+private:
+	Vector<unsigned char> x_vecReserveBuffer;
+
 public:
 	AbstractOutputStream() noexcept = default;
 	~AbstractOutputStream() override;
@@ -22,6 +27,15 @@ public:
 	virtual void Put(unsigned char byData) = 0;
 	virtual void Put(const void *pData, std::size_t uSize) = 0;
 	virtual void Flush(bool bHard) = 0;
+
+	// 返回一块可以直接写入的缓冲区及其大小，大小不小于 uMinSize 并且不为零。
+	// 写入之后调用 Commit() 提交其中的前 uSize 字节，在此之前不能调用此流的其他成员函数。
+	// 默认实现使用内部的缓冲区，在 Commit() 时调用 Put()，派生类应当尽可能直接返回自己的缓冲区。
+	virtual std::size_t Reserve(void **ppData, std::size_t uMinSize);
+	virtual void Commit(std::size_t uSize);
+
+	// 写入 sbufData 中的所有数据，不会修改它。默认实现对每个块调用 Put()。
+	virtual void PutChunks(const StreamBuffer &sbufData);
 };
 
 }
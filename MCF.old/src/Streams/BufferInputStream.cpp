@@ -27,5 +27,11 @@ std::size_t BufferInputStream::Discard(std::size_t uSize){
 	return x_vBuffer.Discard(uSize);
 }
 void BufferInputStream::Invalidate(){ }
+bool BufferInputStream::Borrow(const void **ppData, std::size_t *puSize){
+	return x_vBuffer.Borrow(ppData, puSize);
+}
+void BufferInputStream::Consume(std::size_t uSize){
+	x_vBuffer.Discard(uSize);
+}
 
 }
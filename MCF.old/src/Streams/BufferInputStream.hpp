@@ -28,6 +28,8 @@ public:
 	std::size_t Get(void *pData, std::size_t uSize) override;
 	std::size_t Discard(std::size_t uSize) override;
 	void Invalidate() override;
+	bool Borrow(const void **ppData, std::size_t *puSize) override;
+	void Consume(std::size_t uSize) override;
 
 	const StreamBuffer &GetBuffer() const noexcept {
 		return x_vBuffer;
@@ -17,5 +17,15 @@ void BufferOutputStream::Put(const void *pData, std::size_t uSize){
 void BufferOutputStream::Flush(bool bHard){
 	(void)bHard;
 }
+std::size_t BufferOutputStream::Reserve(void **ppData, std::size_t uMinSize){
+	return x_vBuffer.Reserve(ppData, uMinSize);
+}
+void BufferOutputStream::Commit(std::size_t uSize){
+	x_vBuffer.Commit(uSize);
+}
+void BufferOutputStream::PutChunks(const StreamBuffer &sbufData){
+	// 复制 StreamBuffer 只会共享其中的块。
+	x_vBuffer.Splice(StreamBuffer(sbufData));
+}
 
 }
@@ -24,6 +24,9 @@ public:
 	void Put(unsigned char byData) override;
 	void Put(const void *pData, std::size_t uSize) override;
 	void Flush(bool bHard) override;
+	std::size_t Reserve(void **ppData, std::size_t uMinSize) override;
+	void Commit(std::size_t uSize) override;
+	void PutChunks(const StreamBuffer &sbufData) override;
 
 	const StreamBuffer &GetBuffer() const noexcept {
 		return x_vBuffer;
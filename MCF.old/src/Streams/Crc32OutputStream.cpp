@@ -3,33 +3,85 @@
 // Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
 
 #include "Crc32OutputStream.hpp"
-#include "../Core/Array.hpp"
-#include "../Core/Endian.hpp"
+#include "_Crc32.hpp"
+#include <MCFCRT/env/cpu.h>
+#include <smmintrin.h>
+#include <wmmintrin.h>
 
 // http://www.relisoft.com/science/CrcOptim.html
 // 1. 原文提供的是正序（权较大位向权较小位方向）的 CRC 计算，而这里使用的是反序（权较小位向权较大位方向）。
 // 2. 原文的 CRC 余数的初始值是 0；此处以 -1 为初始值，计算完成后进行按位反。
+// https://www.intel.com/content/dam/www/public/us/en/documents/white-papers/fast-crc-computation-generic-polynomials-pclmulqdq-paper.pdf
+// 3. 支持 PCLMULQDQ 的处理器上，每次把 64 字节的数据折叠到 4 个 128 位的寄存器中，最后使用 Barrett 约简得到余数。
 
 // 按照 IEEE 802.3 描述的算法，除数为 0xEDB88320。
 
 namespace MCF {
 
 namespace {
-	template<unsigned kRoundT, std::uint32_t kRegT>
-	struct Generator
-		: std::integral_constant<std::uint32_t, Generator<kRoundT + 1, (kRegT >> 1) ^ ((kRegT & 1) ? 0xEDB88320 : 0)>::value>
-	{ };
-	template<std::uint32_t kRegT>
-	struct Generator<8, kRegT>
-		: std::integral_constant<std::uint32_t, kRegT>
-	{ };
-
-	template<std::uint32_t ...kIndices>
-	constexpr Array<std::uint32_t, sizeof...(kIndices)> GenerateTable(const std::integer_sequence<std::uint32_t, kIndices...> &) noexcept {
-		return { Generator<0, kIndices>::value... };
+	constexpr std::uint32_t kDivisor = 0xEDB88320;
+
+	constexpr auto kSlicingTables = Impl_Crc32::GenerateSlicingTables(kDivisor);
+
+	// 折叠常数取自上述文献，都是反序表示的。最后一组是 P 和 Barrett 约简使用的 floor(x^64 / P)。
+	alignas(16) constexpr std::uint64_t kFold4[2]  = { 0x0154442BD4, 0x01C6E41596 };
+	alignas(16) constexpr std::uint64_t kFold1[2]  = { 0x01751997D0, 0x00CCAA009E };
+	alignas(16) constexpr std::uint64_t kFold64[2] = { 0x0163CD6124, 0x0000000000 };
+	alignas(16) constexpr std::uint64_t kBarrett[2] = { 0x01DB710641, 0x01F7011641 };
+
+	__attribute__((__target__("pclmul,sse4.1")))
+	inline __m128i FoldInto(__m128i xmmAcc, __m128i xmmNext, __m128i xmmFold) noexcept {
+		const auto xmmLow = _mm_clmulepi64_si128(xmmAcc, xmmFold, 0x00);
+		const auto xmmHigh = _mm_clmulepi64_si128(xmmAcc, xmmFold, 0x11);
+		return _mm_xor_si128(_mm_xor_si128(xmmHigh, xmmLow), xmmNext);
 	}
 
-	constexpr auto kCrcTable = GenerateTable(std::make_integer_sequence<std::uint32_t, 256>());
+	// uSize 必须是 16 的倍数并且不小于 64。
+	__attribute__((__target__("pclmul,sse4.1")))
+	std::uint32_t UpdateByFolding(std::uint32_t u32Reg, const unsigned char *pbyData, std::size_t uSize) noexcept {
+		auto pbyRead = pbyData;
+		auto uBytesRemaining = uSize;
+
+		auto xmmFold = _mm_load_si128(reinterpret_cast<const __m128i *>(kFold4));
+		auto xmmAcc0 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pbyRead) + 0), _mm_cvtsi32_si128(static_cast<int>(u32Reg)));
+		auto xmmAcc1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pbyRead) + 1);
+		auto xmmAcc2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pbyRead) + 2);
+		auto xmmAcc3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pbyRead) + 3);
+		pbyRead += 64;
+		uBytesRemaining -= 64;
+		while(uBytesRemaining >= 64){
+			xmmAcc0 = FoldInto(xmmAcc0, _mm_loadu_si128(reinterpret_cast<const __m128i *>(pbyRead) + 0), xmmFold);
+			xmmAcc1 = FoldInto(xmmAcc1, _mm_loadu_si128(reinterpret_cast<const __m128i *>(pbyRead) + 1), xmmFold);
+			xmmAcc2 = FoldInto(xmmAcc2, _mm_loadu_si128(reinterpret_cast<const __m128i *>(pbyRead) + 2), xmmFold);
+			xmmAcc3 = FoldInto(xmmAcc3, _mm_loadu_si128(reinterpret_cast<const __m128i *>(pbyRead) + 3), xmmFold);
+			pbyRead += 64;
+			uBytesRemaining -= 64;
+		}
+
+		// 把 4 个寄存器折叠成 1 个，然后处理剩余的 16 字节的块。
+		xmmFold = _mm_load_si128(reinterpret_cast<const __m128i *>(kFold1));
+		xmmAcc0 = FoldInto(xmmAcc0, xmmAcc1, xmmFold);
+		xmmAcc0 = FoldInto(xmmAcc0, xmmAcc2, xmmFold);
+		xmmAcc0 = FoldInto(xmmAcc0, xmmAcc3, xmmFold);
+		while(uBytesRemaining >= 16){
+			xmmAcc0 = FoldInto(xmmAcc0, _mm_loadu_si128(reinterpret_cast<const __m128i *>(pbyRead)), xmmFold);
+			pbyRead += 16;
+			uBytesRemaining -= 16;
+		}
+
+		// 128 位折叠到 64 位。
+		const auto xmmMask32 = _mm_setr_epi32(-1, 0, -1, 0);
+		xmmAcc0 = _mm_xor_si128(_mm_srli_si128(xmmAcc0, 8), _mm_clmulepi64_si128(xmmAcc0, xmmFold, 0x10));
+		xmmFold = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(kFold64));
+		xmmAcc0 = _mm_xor_si128(_mm_srli_si128(xmmAcc0, 4), _mm_clmulepi64_si128(_mm_and_si128(xmmAcc0, xmmMask32), xmmFold, 0x00));
+
+		// Barrett 约简到 32 位。
+		xmmFold = _mm_load_si128(reinterpret_cast<const __m128i *>(kBarrett));
+		auto xmmQuotient = _mm_clmulepi64_si128(_mm_and_si128(xmmAcc0, xmmMask32), xmmFold, 0x10);
+		xmmQuotient = _mm_clmulepi64_si128(_mm_and_si128(xmmQuotient, xmmMask32), xmmFold, 0x00);
+		xmmAcc0 = _mm_xor_si128(xmmAcc0, xmmQuotient);
+		return static_cast<std::uint32_t>(_mm_extract_epi32(xmmAcc0, 1));
+	}
 }
 
 Crc32OutputStream::~Crc32OutputStream(){ }
@@ -37,19 +89,19 @@ Crc32OutputStream::~Crc32OutputStream(){ }
 void Crc32OutputStream::X_Initialize() noexcept {
 	x_u32Reg = static_cast<std::uint32_t>(-1);
 }
-void Crc32OutputStream::X_Update(const std::uint8_t (&abyChunk)[8]) noexcept {
-	auto u64Word = LoadLe(reinterpret_cast<const std::uint64_t *>(abyChunk)[0]);
-	for(unsigned uIndex = 0; uIndex < sizeof(u64Word); ++uIndex){
-		const unsigned uLow = static_cast<unsigned char>(u64Word);
-		u64Word >>= 8;
-		x_u32Reg = kCrcTable[(x_u32Reg ^ uLow) & 0xFF] ^ (x_u32Reg >> 8);
+void Crc32OutputStream::X_Update(const void *pData, std::size_t uSize) noexcept {
+	auto pbyRead = static_cast<const unsigned char *>(pData);
+	auto uBytesRemaining = uSize;
+	if((uBytesRemaining >= 64) && _MCFCRT_CpuHasFeature(_MCFCRT_kCpuFeaturePclmul) && _MCFCRT_CpuHasFeature(_MCFCRT_kCpuFeatureSse41)){
+		const auto uBytesToFold = uBytesRemaining / 16 * 16;
+		x_u32Reg = UpdateByFolding(x_u32Reg, pbyRead, uBytesToFold);
+		pbyRead += uBytesToFold;
+		uBytesRemaining -= uBytesToFold;
 	}
+	x_u32Reg = Impl_Crc32::UpdateBySlicing(kSlicingTables, x_u32Reg, pbyRead, uBytesRemaining);
 }
 void Crc32OutputStream::X_Finalize(std::uint8_t (&abyChunk)[8], unsigned uBytesInChunk) noexcept {
-	for(unsigned uIndex = 0; uIndex < uBytesInChunk; ++uIndex){
-		const unsigned uLow = abyChunk[uIndex];
-		x_u32Reg = kCrcTable[(x_u32Reg ^ uLow) & 0xFF] ^ (x_u32Reg >> 8);
-	}
+	x_u32Reg = Impl_Crc32::UpdateBySlicing(kSlicingTables, x_u32Reg, abyChunk, uBytesInChunk);
 	x_u32Reg = ~x_u32Reg;
 }
 
@@ -70,13 +122,15 @@ void Crc32OutputStream::Put(const void *pData, std::size_t uSize) noexcept {
 			std::memcpy(x_abyChunk + x_nChunkOffset, pbyRead, uChunkAvail);
 			pbyRead += uChunkAvail;
 			uBytesRemaining -= uChunkAvail;
-			X_Update(x_abyChunk);
+			X_Update(x_abyChunk, sizeof(x_abyChunk));
 			x_nChunkOffset = 0;
 		}
-		while(uBytesRemaining >= sizeof(x_abyChunk)){
-			X_Update(reinterpret_cast<const decltype(x_abyChunk) *>(pbyRead)[0]);
-			pbyRead += sizeof(x_abyChunk);
-			uBytesRemaining -= sizeof(x_abyChunk);
+		// 整块的数据一次性处理，不需要复制。
+		const auto uBytesToUpdate = uBytesRemaining / sizeof(x_abyChunk) * sizeof(x_abyChunk);
+		if(uBytesToUpdate != 0){
+			X_Update(pbyRead, uBytesToUpdate);
+			pbyRead += uBytesToUpdate;
+			uBytesRemaining -= uBytesToUpdate;
 		}
 	}
 	if(uBytesRemaining != 0){
@@ -103,4 +157,8 @@ std::uint32_t Crc32OutputStream::Finalize() noexcept {
 	return x_u32Reg;
 }
 
+std::uint32_t Crc32OutputStream::Combine(std::uint32_t u32Lhs, std::uint32_t u32Rhs, std::uint64_t u64RhsSize) noexcept {
+	return Impl_Crc32::Combine(kDivisor, u32Lhs, u32Rhs, u64RhsSize);
+}
+
 }
@@ -24,7 +24,7 @@ public:
 
 private:
 	void X_Initialize() noexcept;
-	void X_Update(const std::uint8_t (&abyChunk)[8]) noexcept;
+	void X_Update(const void *pData, std::size_t uSize) noexcept;
 	void X_Finalize(std::uint8_t (&abyChunk)[8], unsigned uBytesInChunk) noexcept;
 
 public:
@@ -34,6 +34,9 @@ public:
 
 	void Reset() noexcept;
 	std::uint32_t Finalize() noexcept;
+
+	// 根据两段数据各自的校验值计算它们连接之后的校验值，用于并行计算一个文件的不同部分。
+	static std::uint32_t Combine(std::uint32_t u32Lhs, std::uint32_t u32Rhs, std::uint64_t u64RhsSize) noexcept;
 };
 
 }
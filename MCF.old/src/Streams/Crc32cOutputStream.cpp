@@ -0,0 +1,175 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "Crc32cOutputStream.hpp"
+#include "_Crc32.hpp"
+#include "../Core/Endian.hpp"
+#include <MCFCRT/env/cpu.h>
+#include <nmmintrin.h>
+
+// https://stackoverflow.com/a/17646775
+// 1. 支持 SSE4.2 的处理器上使用 crc32 指令。这个指令的延迟是 3 个周期，但是每个周期可以发射一条，因此把数据分成三段交错计算。
+// 2. 三段的结果使用移位表合并：向寄存器中写入 n 个零字节相当于乘以 x^(8n) mod P，这个乘法对于寄存器的值是线性的，可以按字节查表。
+
+// 按照 RFC 3720（iSCSI）描述的 CRC-32C（Castagnoli）算法，除数为 0x82F63B78。
+
+namespace MCF {
+
+namespace {
+	constexpr std::uint32_t kDivisor = 0x82F63B78;
+
+	constexpr auto kSlicingTables = Impl_Crc32::GenerateSlicingTables(kDivisor);
+
+	// 交错计算时每一段的长度。长的用于大块数据，短的用于剩下的部分。
+	enum : std::size_t {
+		kLongStride  = 8192,
+		kShortStride = 256,
+	};
+
+	// au32Tables[k][b] 是 (b << 8k) * x^(8 * 段长) mod P。
+	struct ShiftTables {
+		std::uint32_t au32Tables[4][256];
+	};
+
+	constexpr ShiftTables GenerateShiftTables(std::uint64_t u64Bytes) noexcept {
+		ShiftTables vRet = { };
+		const auto u32Factor = Impl_Crc32::GetShiftFactor(kDivisor, u64Bytes);
+		for(unsigned uTable = 0; uTable < 4; ++uTable){
+			for(unsigned uByte = 0; uByte < 256; ++uByte){
+				vRet.au32Tables[uTable][uByte] = Impl_Crc32::MultiplyModulo(kDivisor, static_cast<std::uint32_t>(uByte) << (uTable * 8), u32Factor);
+			}
+		}
+		return vRet;
+	}
+
+	constexpr auto kLongShiftTables  = GenerateShiftTables(kLongStride);
+	constexpr auto kShortShiftTables = GenerateShiftTables(kShortStride);
+
+	inline std::uint32_t Shift(const ShiftTables &vTables, std::uint32_t u32Reg) noexcept {
+		return vTables.au32Tables[0][ u32Reg        & 0xFF] ^ vTables.au32Tables[1][(u32Reg >>  8) & 0xFF] ^
+		       vTables.au32Tables[2][(u32Reg >> 16) & 0xFF] ^ vTables.au32Tables[3][ u32Reg >> 24        ];
+	}
+
+	__attribute__((__target__("sse4.2")))
+	inline std::uint32_t UpdateWord(std::uint32_t u32Reg, const unsigned char *pbyData) noexcept {
+#ifdef _WIN64
+		return static_cast<std::uint32_t>(_mm_crc32_u64(u32Reg, LoadLe(reinterpret_cast<const std::uint64_t *>(pbyData)[0])));
+#else
+		u32Reg = _mm_crc32_u32(u32Reg, LoadLe(reinterpret_cast<const std::uint32_t *>(pbyData)[0]));
+		return _mm_crc32_u32(u32Reg, LoadLe(reinterpret_cast<const std::uint32_t *>(pbyData)[1]));
+#endif
+	}
+
+	__attribute__((__target__("sse4.2")))
+	std::uint32_t UpdateInterleaved(std::uint32_t u32Reg, const unsigned char *&pbyRead, std::size_t &uBytesRemaining, std::size_t uStride, const ShiftTables &vTables) noexcept {
+		while(uBytesRemaining >= uStride * 3){
+			auto u32Reg0 = u32Reg;
+			std::uint32_t u32Reg1 = 0;
+			std::uint32_t u32Reg2 = 0;
+			for(std::size_t uOffset = 0; uOffset < uStride; uOffset += 8){
+				u32Reg0 = UpdateWord(u32Reg0, pbyRead + uOffset);
+				u32Reg1 = UpdateWord(u32Reg1, pbyRead + uStride + uOffset);
+				u32Reg2 = UpdateWord(u32Reg2, pbyRead + uStride * 2 + uOffset);
+			}
+			u32Reg = Shift(vTables, Shift(vTables, u32Reg0) ^ u32Reg1) ^ u32Reg2;
+			pbyRead += uStride * 3;
+			uBytesRemaining -= uStride * 3;
+		}
+		return u32Reg;
+	}
+
+	__attribute__((__target__("sse4.2")))
+	std::uint32_t UpdateByInstruction(std::uint32_t u32Reg, const unsigned char *pbyData, std::size_t uSize) noexcept {
+		auto pbyRead = pbyData;
+		auto uBytesRemaining = uSize;
+		u32Reg = UpdateInterleaved(u32Reg, pbyRead, uBytesRemaining, kLongStride, kLongShiftTables);
+		u32Reg = UpdateInterleaved(u32Reg, pbyRead, uBytesRemaining, kShortStride, kShortShiftTables);
+		while(uBytesRemaining >= 8){
+			u32Reg = UpdateWord(u32Reg, pbyRead);
+			pbyRead += 8;
+			uBytesRemaining -= 8;
+		}
+		while(uBytesRemaining != 0){
+			u32Reg = _mm_crc32_u8(u32Reg, *pbyRead);
+			++pbyRead;
+			--uBytesRemaining;
+		}
+		return u32Reg;
+	}
+}
+
+Crc32cOutputStream::~Crc32cOutputStream(){ }
+
+void Crc32cOutputStream::X_Initialize() noexcept {
+	x_u32Reg = static_cast<std::uint32_t>(-1);
+}
+void Crc32cOutputStream::X_Update(const void *pData, std::size_t uSize) noexcept {
+	if(_MCFCRT_CpuHasFeature(_MCFCRT_kCpuFeatureSse42)){
+		x_u32Reg = UpdateByInstruction(x_u32Reg, static_cast<const unsigned char *>(pData), uSize);
+	} else {
+		x_u32Reg = Impl_Crc32::UpdateBySlicing(kSlicingTables, x_u32Reg, static_cast<const unsigned char *>(pData), uSize);
+	}
+}
+void Crc32cOutputStream::X_Finalize(std::uint8_t (&abyChunk)[8], unsigned uBytesInChunk) noexcept {
+	x_u32Reg = Impl_Crc32::UpdateBySlicing(kSlicingTables, x_u32Reg, abyChunk, uBytesInChunk);
+	x_u32Reg = ~x_u32Reg;
+}
+
+void Crc32cOutputStream::Put(unsigned char byData) noexcept {
+	Put(&byData, 1);
+}
+void Crc32cOutputStream::Put(const void *pData, std::size_t uSize) noexcept {
+	if(x_nChunkOffset < 0){
+		X_Initialize();
+		x_nChunkOffset = 0;
+	}
+
+	auto pbyRead = static_cast<const unsigned char *>(pData);
+	auto uBytesRemaining = uSize;
+	const auto uChunkAvail = sizeof(x_abyChunk) - static_cast<unsigned>(x_nChunkOffset);
+	if(uBytesRemaining >= uChunkAvail){
+		if(x_nChunkOffset != 0){
+			std::memcpy(x_abyChunk + x_nChunkOffset, pbyRead, uChunkAvail);
+			pbyRead += uChunkAvail;
+			uBytesRemaining -= uChunkAvail;
+			X_Update(x_abyChunk, sizeof(x_abyChunk));
+			x_nChunkOffset = 0;
+		}
+		// 整块的数据一次性处理，不需要复制。
+		const auto uBytesToUpdate = uBytesRemaining / sizeof(x_abyChunk) * sizeof(x_abyChunk);
+		if(uBytesToUpdate != 0){
+			X_Update(pbyRead, uBytesToUpdate);
+			pbyRead += uBytesToUpdate;
+			uBytesRemaining -= uBytesToUpdate;
+		}
+	}
+	if(uBytesRemaining != 0){
+		std::memcpy(x_abyChunk + x_nChunkOffset, pbyRead, uBytesRemaining);
+		x_nChunkOffset += static_cast<int>(uBytesRemaining);
+	}
+}
+void Crc32cOutputStream::Flush(bool bHard) noexcept {
+	(void)bHard;
+}
+
+void Crc32cOutputStream::Reset() noexcept {
+	x_nChunkOffset = -1;
+}
+std::uint32_t Crc32cOutputStream::Finalize() noexcept {
+	if(x_nChunkOffset >= 0){
+		X_Finalize(x_abyChunk, static_cast<unsigned>(x_nChunkOffset));
+	} else {
+		X_Initialize();
+		X_Finalize(x_abyChunk, 0);
+	}
+	x_nChunkOffset = -1;
+
+	return x_u32Reg;
+}
+
+std::uint32_t Crc32cOutputStream::Combine(std::uint32_t u32Lhs, std::uint32_t u32Rhs, std::uint64_t u64RhsSize) noexcept {
+	return Impl_Crc32::Combine(kDivisor, u32Lhs, u32Rhs, u64RhsSize);
+}
+
+}
@@ -0,0 +1,44 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_STREAMS_CRC32C_OUTPUT_STREAM_HPP_
+#define MCF_STREAMS_CRC32C_OUTPUT_STREAM_HPP_
+
+#include "AbstractOutputStream.hpp"
+#include <cstdint>
+
+namespace MCF {
+
+// 按照 RFC 3720（iSCSI）描述的 CRC-32C（Castagnoli）算法，除数为 0x82F63B78。
+
+class Crc32cOutputStream : public AbstractOutputStream {
+private:
+	int x_nChunkOffset = -1;
+	std::uint8_t x_abyChunk[8];
+	std::uint32_t x_u32Reg;
+
+public:
+	Crc32cOutputStream() noexcept = default;
+	~Crc32cOutputStream() override;
+
+private:
+	void X_Initialize() noexcept;
+	void X_Update(const void *pData, std::size_t uSize) noexcept;
+	void X_Finalize(std::uint8_t (&abyChunk)[8], unsigned uBytesInChunk) noexcept;
+
+public:
+	void Put(unsigned char byData) noexcept override;
+	void Put(const void *pData, std::size_t uSize) noexcept override;
+	void Flush(bool bHard) noexcept override;
+
+	void Reset() noexcept;
+	std::uint32_t Finalize() noexcept;
+
+	// 根据两段数据各自的校验值计算它们连接之后的校验值，用于并行计算一个文件的不同部分。
+	static std::uint32_t Combine(std::uint32_t u32Lhs, std::uint32_t u32Rhs, std::uint64_t u64RhsSize) noexcept;
+};
+
+}
+
+#endif
@@ -27,6 +27,13 @@ void FileOutputStream::Put(const void *pData, std::size_t uSize){
 	}
 	x_u64Offset += uBytesTotal;
 }
+void FileOutputStream::PutChunks(const StreamBuffer &sbufData){
+	const auto uBytesWritten = x_vFile.WriteGather(x_u64Offset, sbufData);
+	x_u64Offset += uBytesWritten;
+	if(uBytesWritten < sbufData.GetSize()){
+		MCF_THROW(Exception, ERROR_BROKEN_PIPE, Rcntws::View(L"FileOutputStream: 未能成功写入所有数据。"));
+	}
+}
 void FileOutputStream::Flush(bool bHard){
 	if(bHard){
 		x_vFile.Flush();
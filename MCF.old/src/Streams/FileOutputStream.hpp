@@ -30,6 +30,7 @@ public:
 	void Put(unsigned char byData) override;
 	void Put(const void *pData, std::size_t uSize) override;
 	void Flush(bool bHard) override;
+	void PutChunks(const StreamBuffer &sbufData) override;
 
 	const File &GetFile() const noexcept {
 		return x_vFile;
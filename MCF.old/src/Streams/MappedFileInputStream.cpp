@@ -0,0 +1,99 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "MappedFileInputStream.hpp"
+#include "../Core/MinMax.hpp"
+
+namespace MCF {
+
+MappedFileInputStream::~MappedFileInputStream(){ }
+
+void MappedFileInputStream::X_PrefetchAhead() noexcept {
+	if(x_vMappedFile.GetAccessHint() != MappedFile::kSequential){
+		return;
+	}
+	// 读到已预读部分的一半时预读下一段，使得预读总是领先于读取。
+	if(x_u64Offset + MappedFile::kSequentialPrefetchSize / 2 < x_u64PrefetchedUntil){
+		return;
+	}
+	const auto u64Begin = Max(x_u64Offset, x_u64PrefetchedUntil);
+	x_vMappedFile.Prefetch(u64Begin, MappedFile::kSequentialPrefetchSize);
+	x_u64PrefetchedUntil = u64Begin + MappedFile::kSequentialPrefetchSize;
+}
+
+int MappedFileInputStream::Peek(){
+	int nRet = -1;
+	unsigned char byData;
+	if(MappedFileInputStream::Peek(&byData, 1) >= 1){
+		nRet = byData;
+	}
+	return nRet;
+}
+int MappedFileInputStream::Get(){
+	int nRet = -1;
+	unsigned char byData;
+	if(MappedFileInputStream::Get(&byData, 1) >= 1){
+		nRet = byData;
+	}
+	return nRet;
+}
+bool MappedFileInputStream::Discard(){
+	bool bRet = false;
+	if(MappedFileInputStream::Discard(1) >= 1){
+		bRet = true;
+	}
+	return bRet;
+}
+std::size_t MappedFileInputStream::Peek(void *pData, std::size_t uSize){
+	std::size_t uBytesTotal = 0;
+	for(;;){
+		const auto uBytesToRead = uSize - uBytesTotal;
+		if(uBytesToRead == 0){
+			break;
+		}
+		std::size_t uBytesAvail;
+		const auto pbyWindow = static_cast<const unsigned char *>(x_vMappedFile.MapAvailable(x_u64Offset + uBytesTotal, &uBytesAvail));
+		if(uBytesAvail == 0){
+			break;
+		}
+		const auto uBytesCopied = Min(uBytesToRead, uBytesAvail);
+		std::memcpy(static_cast<unsigned char *>(pData) + uBytesTotal, pbyWindow, uBytesCopied);
+		uBytesTotal += uBytesCopied;
+	}
+	return uBytesTotal;
+}
+std::size_t MappedFileInputStream::Get(void *pData, std::size_t uSize){
+	const auto uBytesTotal = MappedFileInputStream::Peek(pData, uSize);
+	x_u64Offset += uBytesTotal;
+	X_PrefetchAhead();
+	return uBytesTotal;
+}
+std::size_t MappedFileInputStream::Discard(std::size_t uSize){
+	std::size_t uBytesTotal = 0;
+	const auto u64FileSize = x_vMappedFile.GetSize();
+	if(x_u64Offset < u64FileSize){
+		const auto uBytesDiscarded = static_cast<std::size_t>(Min(uSize, u64FileSize - x_u64Offset));
+		uBytesTotal += uBytesDiscarded;
+	}
+	x_u64Offset += uBytesTotal;
+	X_PrefetchAhead();
+	return uBytesTotal;
+}
+void MappedFileInputStream::Invalidate(){ }
+bool MappedFileInputStream::Borrow(const void **ppData, std::size_t *puSize){
+	std::size_t uBytesAvail;
+	const auto pbyWindow = x_vMappedFile.MapAvailable(x_u64Offset, &uBytesAvail);
+	if(uBytesAvail == 0){
+		return false;
+	}
+	X_PrefetchAhead();
+	*ppData = pbyWindow;
+	*puSize = uBytesAvail;
+	return true;
+}
+void MappedFileInputStream::Consume(std::size_t uSize){
+	MappedFileInputStream::Discard(uSize);
+}
+
+}
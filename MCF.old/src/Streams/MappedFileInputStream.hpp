@@ -0,0 +1,63 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_STREAMS_MAPPED_FILE_INPUT_STREAM_HPP_
+#define MCF_STREAMS_MAPPED_FILE_INPUT_STREAM_HPP_
+
+#include "AbstractInputStream.hpp"
+#include "../Core/MappedFile.hpp"
+
+namespace MCF {
+
+// 通过内存映射读取文件。Borrow() 直接返回映射的内存，不会复制。
+class MappedFileInputStream : public AbstractInputStream {
+private:
+	MappedFile x_vMappedFile;
+	std::uint64_t x_u64Offset;
+	std::uint64_t x_u64PrefetchedUntil;
+
+private:
+	void X_PrefetchAhead() noexcept;
+
+public:
+	explicit MappedFileInputStream(MappedFile vMappedFile = MappedFile(), std::uint64_t u64Offset = 0) noexcept
+		: x_vMappedFile(std::move(vMappedFile)), x_u64Offset(u64Offset), x_u64PrefetchedUntil(u64Offset)
+	{ }
+	~MappedFileInputStream() override;
+
+public:
+	int Peek() override;
+	int Get() override;
+	bool Discard() override;
+	std::size_t Peek(void *pData, std::size_t uSize) override;
+	std::size_t Get(void *pData, std::size_t uSize) override;
+	std::size_t Discard(std::size_t uSize) override;
+	void Invalidate() override;
+	bool Borrow(const void **ppData, std::size_t *puSize) override;
+	void Consume(std::size_t uSize) override;
+
+	const MappedFile &GetMappedFile() const noexcept {
+		return x_vMappedFile;
+	}
+	MappedFile &GetMappedFile() noexcept {
+		return x_vMappedFile;
+	}
+	void SetMappedFile(MappedFile vMappedFile, std::uint64_t u64Offset = 0) noexcept {
+		x_vMappedFile        = std::move(vMappedFile);
+		x_u64Offset          = u64Offset;
+		x_u64PrefetchedUntil = u64Offset;
+	}
+
+	std::uint64_t GetOffset() const noexcept {
+		return x_u64Offset;
+	}
+	void SetOffset(std::uint64_t u64Offset) noexcept {
+		x_u64Offset          = u64Offset;
+		x_u64PrefetchedUntil = u64Offset;
+	}
+};
+
+}
+
+#endif
@@ -5,11 +5,137 @@
 #include "Md5OutputStream.hpp"
 #include "../Core/Array.hpp"
 #include "../Core/Endian.hpp"
+#include "_MultiBuffer.hpp"
+#include <MCFCRT/env/cpu.h>
 
 namespace MCF {
 
 // https://en.wikipedia.org/wiki/MD5
 
+namespace {
+	constexpr std::uint32_t kInitialRegs[4] = {
+		0x67452301u, 0xEFCDAB89u, 0x98BADCFEu, 0x10325476u,
+	};
+	constexpr std::uint32_t kRoundConstants[64] = {
+		0xD76AA478u, 0xE8C7B756u, 0x242070DBu, 0xC1BDCEEEu, 0xF57C0FAFu, 0x4787C62Au, 0xA8304613u, 0xFD469501u,
+		0x698098D8u, 0x8B44F7AFu, 0xFFFF5BB1u, 0x895CD7BEu, 0x6B901122u, 0xFD987193u, 0xA679438Eu, 0x49B40821u,
+		0xF61E2562u, 0xC040B340u, 0x265E5A51u, 0xE9B6C7AAu, 0xD62F105Du, 0x02441453u, 0xD8A1E681u, 0xE7D3FBC8u,
+		0x21E1CDE6u, 0xC33707D6u, 0xF4D50D87u, 0x455A14EDu, 0xA9E3E905u, 0xFCEFA3F8u, 0x676F02D9u, 0x8D2A4C8Au,
+		0xFFFA3942u, 0x8771F681u, 0x6D9D6122u, 0xFDE5380Cu, 0xA4BEEA44u, 0x4BDECFA9u, 0xF6BB4B60u, 0xBEBFBC70u,
+		0x289B7EC6u, 0xEAA127FAu, 0xD4EF3085u, 0x04881D05u, 0xD9D4D039u, 0xE6DB99E5u, 0x1FA27CF8u, 0xC4AC5665u,
+		0xF4292244u, 0x432AFF97u, 0xAB9423A7u, 0xFC93A039u, 0x655B59C3u, 0x8F0CCC92u, 0xFFEFF47Du, 0x85845DD1u,
+		0x6FA87E4Fu, 0xFE2CE6E0u, 0xA3014314u, 0x4E0811A1u, 0xF7537E82u, 0xBD3AF235u, 0x2AD7D2BBu, 0xEB86D391u,
+	};
+	constexpr unsigned char kRotations[4][4] = {
+		{ 7, 12, 17, 22 }, { 5, 9, 14, 20 }, { 4, 11, 16, 23 }, { 6, 10, 15, 21 },
+	};
+
+	// 多缓冲区计算，SSE2 每次计算 4 个数据，AVX2 每次计算 8 个数据。
+	// MD5 的消息字是小端序的，载入时不需要交换字节序。
+	void UpdateBySse2(std::uint32_t (&aau32Regs)[4][4], const unsigned char *const (&apbyChunks)[4]) noexcept {
+		using Impl_MultiBuffer::RotateLeftSse2;
+
+		__m128i axmmWords[16];
+		for(unsigned uOffset = 0; uOffset < 64; uOffset += 16){
+			Impl_MultiBuffer::LoadTransposedSse2<false>(axmmWords + uOffset / 4, apbyChunks, uOffset);
+		}
+
+		__m128i axmmRegs[4];
+		for(unsigned uReg = 0; uReg < 4; ++uReg){
+			axmmRegs[uReg] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(aau32Regs[uReg]));
+		}
+		auto a = axmmRegs[0];
+		auto b = axmmRegs[1];
+		auto c = axmmRegs[2];
+		auto d = axmmRegs[3];
+		for(unsigned i = 0; i < 64; ++i){
+			__m128i f;
+			unsigned g;
+			switch(i / 16){
+			case 0:
+				f = _mm_xor_si128(d, _mm_and_si128(b, _mm_xor_si128(c, d)));
+				g = i;
+				break;
+			case 1:
+				f = _mm_xor_si128(c, _mm_and_si128(d, _mm_xor_si128(b, c)));
+				g = (5 * i + 1) % 16;
+				break;
+			case 2:
+				f = _mm_xor_si128(_mm_xor_si128(b, c), d);
+				g = (3 * i + 5) % 16;
+				break;
+			default:
+				f = _mm_xor_si128(c, _mm_or_si128(b, _mm_xor_si128(d, _mm_set1_epi32(-1))));
+				g = (7 * i) % 16;
+				break;
+			}
+			f = _mm_add_epi32(_mm_add_epi32(a, f), _mm_add_epi32(axmmWords[g], _mm_set1_epi32(static_cast<int>(kRoundConstants[i]))));
+			a = d;
+			d = c;
+			c = b;
+			b = _mm_add_epi32(b, RotateLeftSse2(f, kRotations[i / 16][i % 4]));
+		}
+		axmmRegs[0] = _mm_add_epi32(axmmRegs[0], a);
+		axmmRegs[1] = _mm_add_epi32(axmmRegs[1], b);
+		axmmRegs[2] = _mm_add_epi32(axmmRegs[2], c);
+		axmmRegs[3] = _mm_add_epi32(axmmRegs[3], d);
+		for(unsigned uReg = 0; uReg < 4; ++uReg){
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(aau32Regs[uReg]), axmmRegs[uReg]);
+		}
+	}
+	__attribute__((__target__("avx2")))
+	void UpdateByAvx2(std::uint32_t (&aau32Regs)[4][8], const unsigned char *const (&apbyChunks)[8]) noexcept {
+		using Impl_MultiBuffer::RotateLeftAvx2;
+
+		__m256i aymmWords[16];
+		Impl_MultiBuffer::LoadTransposedAvx2<false>(aymmWords + 0, apbyChunks, 0);
+		Impl_MultiBuffer::LoadTransposedAvx2<false>(aymmWords + 8, apbyChunks, 32);
+
+		__m256i aymmRegs[4];
+		for(unsigned uReg = 0; uReg < 4; ++uReg){
+			aymmRegs[uReg] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(aau32Regs[uReg]));
+		}
+		auto a = aymmRegs[0];
+		auto b = aymmRegs[1];
+		auto c = aymmRegs[2];
+		auto d = aymmRegs[3];
+		for(unsigned i = 0; i < 64; ++i){
+			__m256i f;
+			unsigned g;
+			switch(i / 16){
+			case 0:
+				f = _mm256_xor_si256(d, _mm256_and_si256(b, _mm256_xor_si256(c, d)));
+				g = i;
+				break;
+			case 1:
+				f = _mm256_xor_si256(c, _mm256_and_si256(d, _mm256_xor_si256(b, c)));
+				g = (5 * i + 1) % 16;
+				break;
+			case 2:
+				f = _mm256_xor_si256(_mm256_xor_si256(b, c), d);
+				g = (3 * i + 5) % 16;
+				break;
+			default:
+				f = _mm256_xor_si256(c, _mm256_or_si256(b, _mm256_xor_si256(d, _mm256_set1_epi32(-1))));
+				g = (7 * i) % 16;
+				break;
+			}
+			f = _mm256_add_epi32(_mm256_add_epi32(a, f), _mm256_add_epi32(aymmWords[g], _mm256_set1_epi32(static_cast<int>(kRoundConstants[i]))));
+			a = d;
+			d = c;
+			c = b;
+			b = _mm256_add_epi32(b, RotateLeftAvx2(f, kRotations[i / 16][i % 4]));
+		}
+		aymmRegs[0] = _mm256_add_epi32(aymmRegs[0], a);
+		aymmRegs[1] = _mm256_add_epi32(aymmRegs[1], b);
+		aymmRegs[2] = _mm256_add_epi32(aymmRegs[2], c);
+		aymmRegs[3] = _mm256_add_epi32(aymmRegs[3], d);
+		for(unsigned uReg = 0; uReg < 4; ++uReg){
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(aau32Regs[uReg]), aymmRegs[uReg]);
+		}
+	}
+}
+
 Md5OutputStream::~Md5OutputStream(){ }
 
 void Md5OutputStream::X_Initialize() noexcept {
@@ -423,4 +549,24 @@ Array<std::uint8_t, 16> Md5OutputStream::Finalize() noexcept {
 	return abyRet;
 }
 
+void Md5OutputStream::HashMultiple(Array<std::uint8_t, 16> *pabyResults, const void *const *ppData, const std::size_t *puSizes, std::size_t uCount) noexcept {
+	const auto fnUpdateOne = [](std::uint32_t (&au32Regs)[4], const unsigned char *pbyChunk){
+		Md5OutputStream vStream;
+		std::memcpy(vStream.x_au32Reg.m_a, au32Regs, sizeof(au32Regs));
+		vStream.X_Update(reinterpret_cast<const std::uint8_t (*)[64]>(pbyChunk)[0]);
+		std::memcpy(au32Regs, vStream.x_au32Reg.m_a, sizeof(au32Regs));
+	};
+	const auto fnStoreResult = [&](std::size_t uIndex, const std::uint32_t (&au32Regs)[4]){
+		const auto pu32RetWords = reinterpret_cast<std::uint32_t *>(pabyResults[uIndex].GetData());
+		for(unsigned uReg = 0; uReg < 4; ++uReg){
+			StoreLe(pu32RetWords[uReg], au32Regs[uReg]);
+		}
+	};
+	if(_MCFCRT_CpuHasFeature(_MCFCRT_kCpuFeatureAvx2)){
+		Impl_MultiBuffer::Scheduler<8, 4, false>::Run(kInitialRegs, ppData, puSizes, uCount, UpdateByAvx2, fnUpdateOne, fnStoreResult);
+	} else {
+		Impl_MultiBuffer::Scheduler<4, 4, false>::Run(kInitialRegs, ppData, puSizes, uCount, UpdateBySse2, fnUpdateOne, fnStoreResult);
+	}
+}
+
 }
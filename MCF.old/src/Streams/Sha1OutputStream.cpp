@@ -5,11 +5,126 @@
 #include "Sha1OutputStream.hpp"
 #include "../Core/Array.hpp"
 #include "../Core/Endian.hpp"
+#include "_MultiBuffer.hpp"
+#include <MCFCRT/env/cpu.h>
 
 namespace MCF {
 
 // https://en.wikipedia.org/wiki/SHA-1
 
+namespace {
+	constexpr std::uint32_t kInitialRegs[5] = {
+		0x67452301u, 0xEFCDAB89u, 0x98BADCFEu, 0x10325476u, 0xC3D2E1F0u,
+	};
+	constexpr std::uint32_t kRoundConstants[4] = {
+		0x5A827999u, 0x6ED9EBA1u, 0x8F1BBCDCu, 0xCA62C1D6u,
+	};
+
+	// 多缓冲区计算，SSE2 每次计算 4 个数据，AVX2 每次计算 8 个数据。
+	void UpdateBySse2(std::uint32_t (&aau32Regs)[5][4], const unsigned char *const (&apbyChunks)[4]) noexcept {
+		using Impl_MultiBuffer::RotateLeftSse2;
+
+		__m128i axmmWords[16];
+		for(unsigned uOffset = 0; uOffset < 64; uOffset += 16){
+			Impl_MultiBuffer::LoadTransposedSse2<true>(axmmWords + uOffset / 4, apbyChunks, uOffset);
+		}
+
+		__m128i axmmRegs[5];
+		for(unsigned uReg = 0; uReg < 5; ++uReg){
+			axmmRegs[uReg] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(aau32Regs[uReg]));
+		}
+		auto a = axmmRegs[0];
+		auto b = axmmRegs[1];
+		auto c = axmmRegs[2];
+		auto d = axmmRegs[3];
+		auto e = axmmRegs[4];
+		for(unsigned i = 0; i < 80; ++i){
+			auto &w = axmmWords[i % 16];
+			if(i >= 16){
+				w = _mm_xor_si128(_mm_xor_si128(w, axmmWords[(i - 14) % 16]), _mm_xor_si128(axmmWords[(i - 8) % 16], axmmWords[(i - 3) % 16]));
+				w = RotateLeftSse2(w, 1);
+			}
+			__m128i f;
+			switch(i / 20){
+			case 0:
+				f = _mm_xor_si128(d, _mm_and_si128(b, _mm_xor_si128(c, d)));
+				break;
+			case 2:
+				f = _mm_or_si128(_mm_and_si128(b, c), _mm_and_si128(d, _mm_or_si128(b, c)));
+				break;
+			default:
+				f = _mm_xor_si128(_mm_xor_si128(b, c), d);
+				break;
+			}
+			const auto t = _mm_add_epi32(_mm_add_epi32(RotateLeftSse2(a, 5), f), _mm_add_epi32(_mm_add_epi32(e, w), _mm_set1_epi32(static_cast<int>(kRoundConstants[i / 20]))));
+			e = d;
+			d = c;
+			c = RotateLeftSse2(b, 30);
+			b = a;
+			a = t;
+		}
+		axmmRegs[0] = _mm_add_epi32(axmmRegs[0], a);
+		axmmRegs[1] = _mm_add_epi32(axmmRegs[1], b);
+		axmmRegs[2] = _mm_add_epi32(axmmRegs[2], c);
+		axmmRegs[3] = _mm_add_epi32(axmmRegs[3], d);
+		axmmRegs[4] = _mm_add_epi32(axmmRegs[4], e);
+		for(unsigned uReg = 0; uReg < 5; ++uReg){
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(aau32Regs[uReg]), axmmRegs[uReg]);
+		}
+	}
+	__attribute__((__target__("avx2")))
+	void UpdateByAvx2(std::uint32_t (&aau32Regs)[5][8], const unsigned char *const (&apbyChunks)[8]) noexcept {
+		using Impl_MultiBuffer::RotateLeftAvx2;
+
+		__m256i aymmWords[16];
+		Impl_MultiBuffer::LoadTransposedAvx2<true>(aymmWords + 0, apbyChunks, 0);
+		Impl_MultiBuffer::LoadTransposedAvx2<true>(aymmWords + 8, apbyChunks, 32);
+
+		__m256i aymmRegs[5];
+		for(unsigned uReg = 0; uReg < 5; ++uReg){
+			aymmRegs[uReg] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(aau32Regs[uReg]));
+		}
+		auto a = aymmRegs[0];
+		auto b = aymmRegs[1];
+		auto c = aymmRegs[2];
+		auto d = aymmRegs[3];
+		auto e = aymmRegs[4];
+		for(unsigned i = 0; i < 80; ++i){
+			auto &w = aymmWords[i % 16];
+			if(i >= 16){
+				w = _mm256_xor_si256(_mm256_xor_si256(w, aymmWords[(i - 14) % 16]), _mm256_xor_si256(aymmWords[(i - 8) % 16], aymmWords[(i - 3) % 16]));
+				w = RotateLeftAvx2(w, 1);
+			}
+			__m256i f;
+			switch(i / 20){
+			case 0:
+				f = _mm256_xor_si256(d, _mm256_and_si256(b, _mm256_xor_si256(c, d)));
+				break;
+			case 2:
+				f = _mm256_or_si256(_mm256_and_si256(b, c), _mm256_and_si256(d, _mm256_or_si256(b, c)));
+				break;
+			default:
+				f = _mm256_xor_si256(_mm256_xor_si256(b, c), d);
+				break;
+			}
+			const auto t = _mm256_add_epi32(_mm256_add_epi32(RotateLeftAvx2(a, 5), f), _mm256_add_epi32(_mm256_add_epi32(e, w), _mm256_set1_epi32(static_cast<int>(kRoundConstants[i / 20]))));
+			e = d;
+			d = c;
+			c = RotateLeftAvx2(b, 30);
+			b = a;
+			a = t;
+		}
+		aymmRegs[0] = _mm256_add_epi32(aymmRegs[0], a);
+		aymmRegs[1] = _mm256_add_epi32(aymmRegs[1], b);
+		aymmRegs[2] = _mm256_add_epi32(aymmRegs[2], c);
+		aymmRegs[3] = _mm256_add_epi32(aymmRegs[3], d);
+		aymmRegs[4] = _mm256_add_epi32(aymmRegs[4], e);
+		for(unsigned uReg = 0; uReg < 5; ++uReg){
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(aau32Regs[uReg]), aymmRegs[uReg]);
+		}
+	}
+}
+
 Sha1OutputStream::~Sha1OutputStream(){ }
 
 void Sha1OutputStream::X_Initialize() noexcept {
@@ -362,4 +477,24 @@ Array<std::uint8_t, 20> Sha1OutputStream::Finalize() noexcept {
 	return abyRet;
 }
 
+void Sha1OutputStream::HashMultiple(Array<std::uint8_t, 20> *pabyResults, const void *const *ppData, const std::size_t *puSizes, std::size_t uCount) noexcept {
+	const auto fnUpdateOne = [](std::uint32_t (&au32Regs)[5], const unsigned char *pbyChunk){
+		Sha1OutputStream vStream;
+		std::memcpy(vStream.x_au32Reg.m_a, au32Regs, sizeof(au32Regs));
+		vStream.X_Update(reinterpret_cast<const std::uint8_t (*)[64]>(pbyChunk)[0]);
+		std::memcpy(au32Regs, vStream.x_au32Reg.m_a, sizeof(au32Regs));
+	};
+	const auto fnStoreResult = [&](std::size_t uIndex, const std::uint32_t (&au32Regs)[5]){
+		const auto pu32RetWords = reinterpret_cast<std::uint32_t *>(pabyResults[uIndex].GetData());
+		for(unsigned uReg = 0; uReg < 5; ++uReg){
+			StoreBe(pu32RetWords[uReg], au32Regs[uReg]);
+		}
+	};
+	if(_MCFCRT_CpuHasFeature(_MCFCRT_kCpuFeatureAvx2)){
+		Impl_MultiBuffer::Scheduler<8, 5, true>::Run(kInitialRegs, ppData, puSizes, uCount, UpdateByAvx2, fnUpdateOne, fnStoreResult);
+	} else {
+		Impl_MultiBuffer::Scheduler<4, 5, true>::Run(kInitialRegs, ppData, puSizes, uCount, UpdateBySse2, fnUpdateOne, fnStoreResult);
+	}
+}
+
 }
@@ -34,6 +34,10 @@ public:
 
 	void Reset() noexcept;
 	Array<std::uint8_t, 20> Finalize() noexcept;
+
+	// 计算多个互相独立的数据的校验值，pabyResults[i] 是 ppData[i] 开始的 puSizes[i] 个字节的校验值。
+	// 每次并行计算 4 个数据，支持 AVX2 的处理器上每次并行计算 8 个数据，适合大量的小数据。
+	static void HashMultiple(Array<std::uint8_t, 20> *pabyResults, const void *const *ppData, const std::size_t *puSizes, std::size_t uCount) noexcept;
 };
 
 }
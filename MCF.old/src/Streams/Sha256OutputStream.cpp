@@ -5,11 +5,152 @@
 #include "Sha256OutputStream.hpp"
 #include "../Core/Array.hpp"
 #include "../Core/Endian.hpp"
+#include "_MultiBuffer.hpp"
+#include <MCFCRT/env/cpu.h>
+#include <immintrin.h>
+#include <utility>
 
 namespace MCF {
 
 // https://en.wikipedia.org/wiki/SHA-2
 // http://download.intel.com/embedded/processor/whitepaper/327457.pdf
+// https://software.intel.com/en-us/articles/intel-sha-extensions
+// https://www.intel.com/content/dam/www/public/us/en/documents/white-papers/communications-ia-multi-buffer-paper.pdf
+
+namespace {
+	alignas(16) constexpr std::uint32_t kRoundConstants[64] = {
+		0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+		0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+		0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+		0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+		0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+		0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+		0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+		0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2,
+	};
+	constexpr std::uint32_t kInitialRegs[8] = {
+		0x6A09E667u, 0xBB67AE85u, 0x3C6EF372u, 0xA54FF53Au, 0x510E527Fu, 0x9B05688Cu, 0x1F83D9ABu, 0x5BE0CD19u,
+	};
+
+	bool IsShaNiSupported() noexcept {
+		return _MCFCRT_CpuHasFeature(_MCFCRT_kCpuFeatureSha) && _MCFCRT_CpuHasFeature(_MCFCRT_kCpuFeatureSse41);
+	}
+
+	// SHA 指令每次计算四轮。avxMsgs 中保存最近的 16 个消息字，每个寄存器 4 个。
+	template<unsigned kGroupT>
+	__attribute__((__target__("sha,sse4.1")))
+	inline void ShaNiRoundGroup(__m128i &xmmAbef, __m128i &xmmCdgh, __m128i (&axmmMsgs)[4], const unsigned char *pbyChunk) noexcept {
+		auto &xmmCur = axmmMsgs[kGroupT % 4];
+		if(kGroupT < 4){
+			const auto xmmByteSwap = _mm_set_epi64x(0x0C0D0E0F08090A0B, 0x0405060700010203);
+			xmmCur = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pbyChunk) + kGroupT), xmmByteSwap);
+		}
+		auto xmmWk = _mm_add_epi32(xmmCur, _mm_load_si128(reinterpret_cast<const __m128i *>(kRoundConstants) + kGroupT));
+		xmmCdgh = _mm_sha256rnds2_epu32(xmmCdgh, xmmAbef, xmmWk);
+		if((kGroupT >= 3) && (kGroupT < 15)){
+			auto &xmmNext = axmmMsgs[(kGroupT + 1) % 4];
+			xmmNext = _mm_add_epi32(xmmNext, _mm_alignr_epi8(xmmCur, axmmMsgs[(kGroupT + 3) % 4], 4));
+			xmmNext = _mm_sha256msg2_epu32(xmmNext, xmmCur);
+		}
+		xmmWk = _mm_shuffle_epi32(xmmWk, 0x0E);
+		xmmAbef = _mm_sha256rnds2_epu32(xmmAbef, xmmCdgh, xmmWk);
+		if((kGroupT >= 1) && (kGroupT < 13)){
+			auto &xmmPrev = axmmMsgs[(kGroupT + 3) % 4];
+			xmmPrev = _mm_sha256msg1_epu32(xmmPrev, xmmCur);
+		}
+	}
+	template<unsigned ...kGroupsT>
+	__attribute__((__target__("sha,sse4.1")))
+	inline void ShaNiRounds(__m128i &xmmAbef, __m128i &xmmCdgh, const unsigned char *pbyChunk, std::integer_sequence<unsigned, kGroupsT...>) noexcept {
+		__m128i axmmMsgs[4];
+		(ShaNiRoundGroup<kGroupsT>(xmmAbef, xmmCdgh, axmmMsgs, pbyChunk), ...);
+	}
+
+	__attribute__((__target__("sha,sse4.1")))
+	void UpdateByShaNi(std::uint32_t (&au32Regs)[8], const unsigned char *pbyData, std::size_t uChunkCount) noexcept {
+		// 寄存器的排列顺序是 ABEF 和 CDGH。
+		const auto xmmDcba = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(au32Regs) + 0), 0xB1);
+		const auto xmmHgfe = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(au32Regs) + 1), 0x1B);
+		auto xmmAbef = _mm_alignr_epi8(xmmDcba, xmmHgfe, 8);
+		auto xmmCdgh = _mm_blend_epi16(xmmHgfe, xmmDcba, 0xF0);
+		for(std::size_t uIndex = 0; uIndex < uChunkCount; ++uIndex){
+			const auto xmmAbefSaved = xmmAbef;
+			const auto xmmCdghSaved = xmmCdgh;
+			ShaNiRounds(xmmAbef, xmmCdgh, pbyData + uIndex * 64, std::make_integer_sequence<unsigned, 16>());
+			xmmAbef = _mm_add_epi32(xmmAbef, xmmAbefSaved);
+			xmmCdgh = _mm_add_epi32(xmmCdgh, xmmCdghSaved);
+		}
+		const auto xmmFeba = _mm_shuffle_epi32(xmmAbef, 0x1B);
+		const auto xmmDchg = _mm_shuffle_epi32(xmmCdgh, 0xB1);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(au32Regs) + 0, _mm_blend_epi16(xmmFeba, xmmDchg, 0xF0));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(au32Regs) + 1, _mm_alignr_epi8(xmmDchg, xmmFeba, 8));
+	}
+
+	// 多缓冲区计算。每个 YMM 寄存器的 8 个元素分别属于 8 个互相独立的数据。
+	enum : unsigned {
+		kLaneCount = 8,
+	};
+
+	__attribute__((__target__("avx2")))
+	inline __m256i RotateRight(__m256i ymmValue, int nBits) noexcept {
+		return _mm256_or_si256(_mm256_srli_epi32(ymmValue, nBits), _mm256_slli_epi32(ymmValue, 32 - nBits));
+	}
+	// aau32Regs[i][j] 是第 j 个数据的第 i 个寄存器。
+	__attribute__((__target__("avx2")))
+	void UpdateByAvx2(std::uint32_t (&aau32Regs)[8][kLaneCount], const unsigned char *const (&apbyChunks)[kLaneCount]) noexcept {
+		__m256i aymmWords[16];
+		Impl_MultiBuffer::LoadTransposedAvx2<true>(aymmWords + 0, apbyChunks, 0);
+		Impl_MultiBuffer::LoadTransposedAvx2<true>(aymmWords + 8, apbyChunks, 32);
+
+		__m256i aymmRegs[8];
+		for(unsigned uReg = 0; uReg < 8; ++uReg){
+			aymmRegs[uReg] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(aau32Regs[uReg]));
+		}
+		auto a = aymmRegs[0];
+		auto b = aymmRegs[1];
+		auto c = aymmRegs[2];
+		auto d = aymmRegs[3];
+		auto e = aymmRegs[4];
+		auto f = aymmRegs[5];
+		auto g = aymmRegs[6];
+		auto h = aymmRegs[7];
+		for(unsigned i = 0; i < 64; ++i){
+			auto &w = aymmWords[i % 16];
+			if(i >= 16){
+				const auto &w15 = aymmWords[(i - 15) % 16];
+				const auto &w2 = aymmWords[(i - 2) % 16];
+				const auto s0 = _mm256_xor_si256(_mm256_xor_si256(RotateRight(w15, 7), RotateRight(w15, 18)), _mm256_srli_epi32(w15, 3));
+				const auto s1 = _mm256_xor_si256(_mm256_xor_si256(RotateRight(w2, 17), RotateRight(w2, 19)), _mm256_srli_epi32(w2, 10));
+				w = _mm256_add_epi32(_mm256_add_epi32(w, aymmWords[(i - 7) % 16]), _mm256_add_epi32(s0, s1));
+			}
+			const auto S0 = _mm256_xor_si256(_mm256_xor_si256(RotateRight(a, 2), RotateRight(a, 13)), RotateRight(a, 22));
+			const auto maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_xor_si256(a, b)));
+			const auto t2 = _mm256_add_epi32(S0, maj);
+			const auto S1 = _mm256_xor_si256(_mm256_xor_si256(RotateRight(e, 6), RotateRight(e, 11)), RotateRight(e, 25));
+			const auto ch = _mm256_xor_si256(g, _mm256_and_si256(e, _mm256_xor_si256(f, g)));
+			const auto t1 = _mm256_add_epi32(_mm256_add_epi32(_mm256_add_epi32(h, S1), _mm256_add_epi32(ch, w)), _mm256_set1_epi32(static_cast<int>(kRoundConstants[i])));
+			h = g;
+			g = f;
+			f = e;
+			e = _mm256_add_epi32(d, t1);
+			d = c;
+			c = b;
+			b = a;
+			a = _mm256_add_epi32(t1, t2);
+		}
+		aymmRegs[0] = _mm256_add_epi32(aymmRegs[0], a);
+		aymmRegs[1] = _mm256_add_epi32(aymmRegs[1], b);
+		aymmRegs[2] = _mm256_add_epi32(aymmRegs[2], c);
+		aymmRegs[3] = _mm256_add_epi32(aymmRegs[3], d);
+		aymmRegs[4] = _mm256_add_epi32(aymmRegs[4], e);
+		aymmRegs[5] = _mm256_add_epi32(aymmRegs[5], f);
+		aymmRegs[6] = _mm256_add_epi32(aymmRegs[6], g);
+		aymmRegs[7] = _mm256_add_epi32(aymmRegs[7], h);
+		for(unsigned uReg = 0; uReg < 8; ++uReg){
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(aau32Regs[uReg]), aymmRegs[uReg]);
+		}
+	}
+}
 
 Sha256OutputStream::~Sha256OutputStream(){ }
 
@@ -19,6 +160,11 @@ void Sha256OutputStream::X_Initialize() noexcept {
 	x_u64BytesTotal = 0;
 }
 void Sha256OutputStream::X_Update(const std::uint8_t (&abyChunk)[64]) noexcept {
+	if(IsShaNiSupported()){
+		UpdateByShaNi(x_au32Reg.m_a, abyChunk, 1);
+		return;
+	}
+
 /*
 	static const std::uint32_t KVEC[64] = {
 		0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
@@ -938,6 +1084,12 @@ void Sha256OutputStream::Put(const void *pData, std::size_t uSize) noexcept {
 			X_Update(x_abyChunk);
 			x_nChunkOffset = 0;
 		}
+		if((uBytesRemaining >= sizeof(x_abyChunk)) && IsShaNiSupported()){
+			const auto uChunkCount = uBytesRemaining / sizeof(x_abyChunk);
+			UpdateByShaNi(x_au32Reg.m_a, pbyRead, uChunkCount);
+			pbyRead += uChunkCount * sizeof(x_abyChunk);
+			uBytesRemaining -= uChunkCount * sizeof(x_abyChunk);
+		}
 		while(uBytesRemaining >= sizeof(x_abyChunk)){
 			X_Update(reinterpret_cast<const decltype(x_abyChunk) *>(pbyRead)[0]);
 			pbyRead += sizeof(x_abyChunk);
@@ -974,4 +1126,28 @@ Array<std::uint8_t, 32> Sha256OutputStream::Finalize() noexcept {
 	return abyRet;
 }
 
+void Sha256OutputStream::HashMultiple(Array<std::uint8_t, 32> *pabyResults, const void *const *ppData, const std::size_t *puSizes, std::size_t uCount) noexcept {
+	if(!IsShaNiSupported() && _MCFCRT_CpuHasFeature(_MCFCRT_kCpuFeatureAvx2)){
+		Impl_MultiBuffer::Scheduler<kLaneCount, 8, true>::Run(kInitialRegs, ppData, puSizes, uCount, UpdateByAvx2,
+			[](std::uint32_t (&au32Regs)[8], const unsigned char *pbyChunk){
+				Sha256OutputStream vStream;
+				std::memcpy(vStream.x_au32Reg.m_a, au32Regs, sizeof(au32Regs));
+				vStream.X_Update(reinterpret_cast<const std::uint8_t (*)[64]>(pbyChunk)[0]);
+				std::memcpy(au32Regs, vStream.x_au32Reg.m_a, sizeof(au32Regs));
+			},
+			[&](std::size_t uIndex, const std::uint32_t (&au32Regs)[8]){
+				const auto pu32RetWords = reinterpret_cast<std::uint32_t *>(pabyResults[uIndex].GetData());
+				for(unsigned uReg = 0; uReg < 8; ++uReg){
+					StoreBe(pu32RetWords[uReg], au32Regs[uReg]);
+				}
+			});
+		return;
+	}
+	for(std::size_t uIndex = 0; uIndex < uCount; ++uIndex){
+		Sha256OutputStream vStream;
+		vStream.Put(ppData[uIndex], puSizes[uIndex]);
+		pabyResults[uIndex] = vStream.Finalize();
+	}
+}
+
 }
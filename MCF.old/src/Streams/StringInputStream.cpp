@@ -58,5 +58,17 @@ std::size_t StringInputStream::Discard(std::size_t uSize){
 	return uBytesTotal;
 }
 void StringInputStream::Invalidate(){ }
+bool StringInputStream::Borrow(const void **ppData, std::size_t *puSize){
+	const auto uStringSize = x_vString.GetSize();
+	if(x_uOffset >= uStringSize){
+		return false;
+	}
+	*ppData = x_vString.GetData() + x_uOffset;
+	*puSize = uStringSize - x_uOffset;
+	return true;
+}
+void StringInputStream::Consume(std::size_t uSize){
+	StringInputStream::Discard(uSize);
+}
 
 }
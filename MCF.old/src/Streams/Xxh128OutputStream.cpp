@@ -0,0 +1,44 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "Xxh128OutputStream.hpp"
+#include "../Core/Endian.hpp"
+
+namespace MCF {
+
+namespace {
+	Array<std::uint8_t, 16> ToBytes(const Impl_Xxh3::Result128 &vHash) noexcept {
+		Array<std::uint8_t, 16> abyRet;
+		StoreBe(reinterpret_cast<std::uint64_t *>(abyRet.GetData())[0], vHash.u64High);
+		StoreBe(reinterpret_cast<std::uint64_t *>(abyRet.GetData())[1], vHash.u64Low);
+		return abyRet;
+	}
+}
+
+Xxh128OutputStream::~Xxh128OutputStream(){ }
+
+void Xxh128OutputStream::Put(unsigned char byData) noexcept {
+	Put(&byData, 1);
+}
+void Xxh128OutputStream::Put(const void *pData, std::size_t uSize) noexcept {
+	x_vHasher.Update(pData, uSize);
+}
+void Xxh128OutputStream::Flush(bool bHard) noexcept {
+	(void)bHard;
+}
+
+void Xxh128OutputStream::Reset() noexcept {
+	x_vHasher.Reset(x_u64Seed);
+}
+Array<std::uint8_t, 16> Xxh128OutputStream::Finalize() noexcept {
+	const auto vHash = x_vHasher.Finalize128();
+	x_vHasher.Reset(x_u64Seed);
+	return ToBytes(vHash);
+}
+
+Array<std::uint8_t, 16> Xxh128OutputStream::Hash(const void *pData, std::size_t uSize, std::uint64_t u64Seed) noexcept {
+	return ToBytes(Impl_Xxh3::Xxh3::Hash128(pData, uSize, u64Seed));
+}
+
+}
@@ -0,0 +1,57 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_STREAMS_XXH128_OUTPUT_STREAM_HPP_
+#define MCF_STREAMS_XXH128_OUTPUT_STREAM_HPP_
+
+#include "AbstractOutputStream.hpp"
+#include "../Core/_Xxh3.hpp"
+#include "../Core/Array.hpp"
+#include "../Core/ArrayView.hpp"
+#include "../Core/StringView.hpp"
+#include <cstdint>
+
+namespace MCF {
+
+// https://github.com/Cyan4973/xxHash
+// 非加密的散列算法，碰撞的概率比 64 位的版本低得多。结果与 XXH3_128bits_withSeed() 相同，按照大端序保存（与 XXH128_canonicalFromHash() 相同）。
+
+class Xxh128OutputStream : public AbstractOutputStream {
+private:
+	std::uint64_t x_u64Seed;
+	Impl_Xxh3::Xxh3 x_vHasher;
+
+public:
+	explicit Xxh128OutputStream(std::uint64_t u64Seed = 0) noexcept
+		: x_u64Seed(u64Seed), x_vHasher(u64Seed)
+	{ }
+	~Xxh128OutputStream() override;
+
+public:
+	void Put(unsigned char byData) noexcept override;
+	void Put(const void *pData, std::size_t uSize) noexcept override;
+	void Flush(bool bHard) noexcept override;
+
+	std::uint64_t GetSeed() const noexcept {
+		return x_u64Seed;
+	}
+
+	void Reset() noexcept;
+	Array<std::uint8_t, 16> Finalize() noexcept;
+
+	// 一次性计算整块数据的散列值，比使用流更快。
+	static Array<std::uint8_t, 16> Hash(const void *pData, std::size_t uSize, std::uint64_t u64Seed = 0) noexcept;
+	template<typename ElementT>
+	static Array<std::uint8_t, 16> Hash(const ArrayView<ElementT> &avData, std::uint64_t u64Seed = 0) noexcept {
+		return Hash(avData.GetData(), avData.GetSize() * sizeof(ElementT), u64Seed);
+	}
+	template<Impl_StringTraits::Type kTypeT>
+	static Array<std::uint8_t, 16> Hash(const StringView<kTypeT> &svData, std::uint64_t u64Seed = 0) noexcept {
+		return Hash(svData.GetBegin(), svData.GetSize() * sizeof(typename StringView<kTypeT>::Char), u64Seed);
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,30 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "Xxh3OutputStream.hpp"
+
+namespace MCF {
+
+Xxh3OutputStream::~Xxh3OutputStream(){ }
+
+void Xxh3OutputStream::Put(unsigned char byData) noexcept {
+	Put(&byData, 1);
+}
+void Xxh3OutputStream::Put(const void *pData, std::size_t uSize) noexcept {
+	x_vHasher.Update(pData, uSize);
+}
+void Xxh3OutputStream::Flush(bool bHard) noexcept {
+	(void)bHard;
+}
+
+void Xxh3OutputStream::Reset() noexcept {
+	x_vHasher.Reset(x_u64Seed);
+}
+std::uint64_t Xxh3OutputStream::Finalize() noexcept {
+	const auto u64Hash = x_vHasher.Finalize64();
+	x_vHasher.Reset(x_u64Seed);
+	return u64Hash;
+}
+
+}
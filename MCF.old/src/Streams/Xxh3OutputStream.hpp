@@ -0,0 +1,58 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_STREAMS_XXH3_OUTPUT_STREAM_HPP_
+#define MCF_STREAMS_XXH3_OUTPUT_STREAM_HPP_
+
+#include "AbstractOutputStream.hpp"
+#include "../Core/_Xxh3.hpp"
+#include "../Core/ArrayView.hpp"
+#include "../Core/StringView.hpp"
+#include <cstdint>
+
+namespace MCF {
+
+// https://github.com/Cyan4973/xxHash
+// 非加密的散列算法，适用于散列表、去重和缓存键。结果与 XXH3_64bits_withSeed() 相同。
+
+class Xxh3OutputStream : public AbstractOutputStream {
+private:
+	std::uint64_t x_u64Seed;
+	Impl_Xxh3::Xxh3 x_vHasher;
+
+public:
+	explicit Xxh3OutputStream(std::uint64_t u64Seed = 0) noexcept
+		: x_u64Seed(u64Seed), x_vHasher(u64Seed)
+	{ }
+	~Xxh3OutputStream() override;
+
+public:
+	void Put(unsigned char byData) noexcept override;
+	void Put(const void *pData, std::size_t uSize) noexcept override;
+	void Flush(bool bHard) noexcept override;
+
+	std::uint64_t GetSeed() const noexcept {
+		return x_u64Seed;
+	}
+
+	void Reset() noexcept;
+	std::uint64_t Finalize() noexcept;
+
+	// 一次性计算整块数据的散列值，比使用流更快。
+	static std::uint64_t Hash(const void *pData, std::size_t uSize, std::uint64_t u64Seed = 0) noexcept {
+		return Impl_Xxh3::Xxh3::Hash64(pData, uSize, u64Seed);
+	}
+	template<typename ElementT>
+	static std::uint64_t Hash(const ArrayView<ElementT> &avData, std::uint64_t u64Seed = 0) noexcept {
+		return Hash(avData.GetData(), avData.GetSize() * sizeof(ElementT), u64Seed);
+	}
+	template<Impl_StringTraits::Type kTypeT>
+	static std::uint64_t Hash(const StringView<kTypeT> &svData, std::uint64_t u64Seed = 0) noexcept {
+		return Hash(svData.GetBegin(), svData.GetSize() * sizeof(typename StringView<kTypeT>::Char), u64Seed);
+	}
+};
+
+}
+
+#endif
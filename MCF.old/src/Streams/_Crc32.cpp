@@ -0,0 +1,42 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "_Crc32.hpp"
+#include "../Core/Endian.hpp"
+
+// https://create.stephan-brumme.com/crc32/#slicing-by-16-overview
+
+namespace MCF {
+
+namespace Impl_Crc32 {
+	std::uint32_t UpdateBySlicing(const SlicingTables &vTables, std::uint32_t u32Reg, const unsigned char *pbyData, std::size_t uSize) noexcept {
+		const auto &aau32Tables = vTables.au32Tables;
+		auto pbyRead = pbyData;
+		auto uBytesRemaining = uSize;
+		while(uBytesRemaining >= 16){
+			const auto u32Word0 = LoadLe(reinterpret_cast<const std::uint32_t *>(pbyRead)[0]) ^ u32Reg;
+			const auto u32Word1 = LoadLe(reinterpret_cast<const std::uint32_t *>(pbyRead)[1]);
+			const auto u32Word2 = LoadLe(reinterpret_cast<const std::uint32_t *>(pbyRead)[2]);
+			const auto u32Word3 = LoadLe(reinterpret_cast<const std::uint32_t *>(pbyRead)[3]);
+			u32Reg = aau32Tables[15][ u32Word0        & 0xFF] ^ aau32Tables[14][(u32Word0 >>  8) & 0xFF] ^
+			         aau32Tables[13][(u32Word0 >> 16) & 0xFF] ^ aau32Tables[12][ u32Word0 >> 24        ] ^
+			         aau32Tables[11][ u32Word1        & 0xFF] ^ aau32Tables[10][(u32Word1 >>  8) & 0xFF] ^
+			         aau32Tables[ 9][(u32Word1 >> 16) & 0xFF] ^ aau32Tables[ 8][ u32Word1 >> 24        ] ^
+			         aau32Tables[ 7][ u32Word2        & 0xFF] ^ aau32Tables[ 6][(u32Word2 >>  8) & 0xFF] ^
+			         aau32Tables[ 5][(u32Word2 >> 16) & 0xFF] ^ aau32Tables[ 4][ u32Word2 >> 24        ] ^
+			         aau32Tables[ 3][ u32Word3        & 0xFF] ^ aau32Tables[ 2][(u32Word3 >>  8) & 0xFF] ^
+			         aau32Tables[ 1][(u32Word3 >> 16) & 0xFF] ^ aau32Tables[ 0][ u32Word3 >> 24        ];
+			pbyRead += 16;
+			uBytesRemaining -= 16;
+		}
+		while(uBytesRemaining != 0){
+			u32Reg = aau32Tables[0][(u32Reg ^ *pbyRead) & 0xFF] ^ (u32Reg >> 8);
+			++pbyRead;
+			--uBytesRemaining;
+		}
+		return u32Reg;
+	}
+}
+
+}
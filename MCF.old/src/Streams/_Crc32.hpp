@@ -0,0 +1,73 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_STREAMS_CRC32_HPP_
+#define MCF_STREAMS_CRC32_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace MCF {
+
+namespace Impl_Crc32 {
+	// 这里的多项式都是反序表示的，最高位是 x^0 的系数，最低位是 x^31 的系数。
+
+	// 计算 u32Lhs * u32Rhs mod P。
+	constexpr std::uint32_t MultiplyModulo(std::uint32_t u32Divisor, std::uint32_t u32Lhs, std::uint32_t u32Rhs) noexcept {
+		std::uint32_t u32Product = 0;
+		for(unsigned uBit = 0; uBit < 32; ++uBit){
+			if(((u32Lhs << uBit) & 0x80000000u) != 0){
+				u32Product ^= u32Rhs;
+			}
+			u32Rhs = (u32Rhs >> 1) ^ (((u32Rhs & 1) != 0) ? u32Divisor : 0);
+		}
+		return u32Product;
+	}
+	// 计算 x^(8 * u64Bytes) mod P，用它乘以寄存器的值相当于向寄存器中写入 u64Bytes 个零字节。
+	constexpr std::uint32_t GetShiftFactor(std::uint32_t u32Divisor, std::uint64_t u64Bytes) noexcept {
+		std::uint32_t u32Factor = 0x80000000u;
+		std::uint32_t u32Power = 0x00800000u;
+		for(auto u64Remaining = u64Bytes; u64Remaining != 0; u64Remaining >>= 1){
+			if((u64Remaining & 1) != 0){
+				u32Factor = MultiplyModulo(u32Divisor, u32Factor, u32Power);
+			}
+			u32Power = MultiplyModulo(u32Divisor, u32Power, u32Power);
+		}
+		return u32Factor;
+	}
+	// 根据 A 和 B 的校验值计算 A 和 B 连接之后的校验值。初始值和结果的按位反不影响这个计算。
+	constexpr std::uint32_t Combine(std::uint32_t u32Divisor, std::uint32_t u32Lhs, std::uint32_t u32Rhs, std::uint64_t u64RhsSize) noexcept {
+		return MultiplyModulo(u32Divisor, u32Lhs, GetShiftFactor(u32Divisor, u64RhsSize)) ^ u32Rhs;
+	}
+
+	// au32Tables[k][b] 是字节 b 之后跟着 k 个零字节时寄存器的值（初始值为零）。
+	struct SlicingTables {
+		std::uint32_t au32Tables[16][256];
+	};
+
+	constexpr SlicingTables GenerateSlicingTables(std::uint32_t u32Divisor) noexcept {
+		SlicingTables vRet = { };
+		for(unsigned uByte = 0; uByte < 256; ++uByte){
+			std::uint32_t u32Reg = uByte;
+			for(unsigned uBit = 0; uBit < 8; ++uBit){
+				u32Reg = (u32Reg >> 1) ^ (((u32Reg & 1) != 0) ? u32Divisor : 0);
+			}
+			vRet.au32Tables[0][uByte] = u32Reg;
+		}
+		for(unsigned uTable = 1; uTable < 16; ++uTable){
+			for(unsigned uByte = 0; uByte < 256; ++uByte){
+				const auto u32Prev = vRet.au32Tables[uTable - 1][uByte];
+				vRet.au32Tables[uTable][uByte] = (u32Prev >> 8) ^ vRet.au32Tables[0][u32Prev & 0xFF];
+			}
+		}
+		return vRet;
+	}
+
+	// 每次处理 16 个字节。
+	extern std::uint32_t UpdateBySlicing(const SlicingTables &vTables, std::uint32_t u32Reg, const unsigned char *pbyData, std::size_t uSize) noexcept;
+}
+
+}
+
+#endif
@@ -0,0 +1,226 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_STREAMS_MULTI_BUFFER_HPP_
+#define MCF_STREAMS_MULTI_BUFFER_HPP_
+
+#include "../Core/Endian.hpp"
+#include <immintrin.h>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+namespace MCF {
+
+namespace Impl_MultiBuffer {
+	// https://www.intel.com/content/dam/www/public/us/en/documents/white-papers/communications-ia-multi-buffer-paper.pdf
+	// MD5、SHA-1 和 SHA-256 使用相同的填充方式，区别只有长度的字节序。
+	// 每个 SIMD 寄存器的每个元素属于一个互相独立的数据，称为通道。一个通道上的数据计算完成之后，立即把下一个数据放到这个通道上。
+
+	template<unsigned kLaneCountT, unsigned kRegCountT, bool kBigEndianLengthT>
+	class Scheduler {
+	public:
+		// aau32Regs[i][j] 是第 j 个通道的第 i 个寄存器。
+		using LaneRegs = std::uint32_t [kRegCountT][kLaneCountT];
+		using Regs = std::uint32_t [kRegCountT];
+
+	private:
+		struct X_Lane {
+			bool bActive;
+			std::size_t uIndex;
+			const unsigned char *pbyRead;
+			std::size_t uChunksRemaining;
+			// 最后一个不完整的块和填充，有一个或者两个块。
+			unsigned uTailChunks;
+			unsigned uTailOffset;
+			unsigned char abyTail[128];
+		};
+
+	public:
+		// fnUpdateLanes(aau32Regs, apbyChunks) 在每个通道上各处理一个块，fnUpdateOne(au32Regs, pbyChunk) 处理一个数据的一个块。
+		// fnStoreResult(uIndex, au32Regs) 保存 ppData[uIndex] 的计算结果。
+		// 剩下的数据不超过 kLaneCountT / 4 个时，并行计算就不划算了，这些数据被逐个完成。
+		template<typename UpdateLanesT, typename UpdateOneT, typename StoreResultT>
+		static void Run(const Regs &au32InitialRegs, const void *const *ppData, const std::size_t *puSizes, std::size_t uCount,
+			UpdateLanesT &&fnUpdateLanes, UpdateOneT &&fnUpdateOne, StoreResultT &&fnStoreResult) noexcept
+		{
+			X_Lane aLanes[kLaneCountT];
+			alignas(32) LaneRegs aau32Regs;
+			alignas(32) static constexpr unsigned char kIdleChunk[64] = { };
+			std::size_t uNext = 0;
+			unsigned uActiveCount = 0;
+
+			const auto fnStartLane = [&](unsigned uLane){
+				auto &vLane = aLanes[uLane];
+				vLane.bActive = true;
+				vLane.uIndex = uNext++;
+				vLane.pbyRead = static_cast<const unsigned char *>(ppData[vLane.uIndex]);
+				const auto uSize = puSizes[vLane.uIndex];
+				vLane.uChunksRemaining = uSize / 64;
+				const auto uTailSize = static_cast<unsigned>(uSize % 64);
+				vLane.uTailChunks = (uTailSize < 56) ? 1 : 2;
+				vLane.uTailOffset = 0;
+				if(uTailSize != 0){
+					std::memcpy(vLane.abyTail, vLane.pbyRead + uSize - uTailSize, uTailSize);
+				}
+				vLane.abyTail[uTailSize] = 0x80;
+				std::memset(vLane.abyTail + uTailSize + 1, 0, vLane.uTailChunks * 64 - 8 - (uTailSize + 1));
+				std::uint64_t u64BitsTotal;
+				if(kBigEndianLengthT){
+					StoreBe(u64BitsTotal, static_cast<std::uint64_t>(uSize) * 8);
+				} else {
+					StoreLe(u64BitsTotal, static_cast<std::uint64_t>(uSize) * 8);
+				}
+				std::memcpy(vLane.abyTail + vLane.uTailChunks * 64 - 8, &u64BitsTotal, 8);
+				for(unsigned uReg = 0; uReg < kRegCountT; ++uReg){
+					aau32Regs[uReg][uLane] = au32InitialRegs[uReg];
+				}
+				++uActiveCount;
+			};
+			const auto fnFinishLane = [&](unsigned uLane){
+				auto &vLane = aLanes[uLane];
+				Regs au32Regs;
+				for(unsigned uReg = 0; uReg < kRegCountT; ++uReg){
+					au32Regs[uReg] = aau32Regs[uReg][uLane];
+				}
+				fnStoreResult(vLane.uIndex, au32Regs);
+				vLane.bActive = false;
+				--uActiveCount;
+			};
+
+			for(unsigned uLane = 0; uLane < kLaneCountT; ++uLane){
+				if(uNext < uCount){
+					fnStartLane(uLane);
+				} else {
+					aLanes[uLane].bActive = false;
+				}
+			}
+			while((uActiveCount > kLaneCountT / 4) || ((uActiveCount != 0) && (uNext < uCount))){
+				const unsigned char *apbyChunks[kLaneCountT];
+				for(unsigned uLane = 0; uLane < kLaneCountT; ++uLane){
+					const auto &vLane = aLanes[uLane];
+					if(!vLane.bActive){
+						apbyChunks[uLane] = kIdleChunk;
+					} else if(vLane.uChunksRemaining != 0){
+						apbyChunks[uLane] = vLane.pbyRead;
+					} else {
+						apbyChunks[uLane] = vLane.abyTail + vLane.uTailOffset;
+					}
+				}
+				fnUpdateLanes(aau32Regs, apbyChunks);
+				for(unsigned uLane = 0; uLane < kLaneCountT; ++uLane){
+					auto &vLane = aLanes[uLane];
+					if(!vLane.bActive){
+						continue;
+					}
+					if(vLane.uChunksRemaining != 0){
+						vLane.pbyRead += 64;
+						--vLane.uChunksRemaining;
+						continue;
+					}
+					vLane.uTailOffset += 64;
+					if(vLane.uTailOffset < vLane.uTailChunks * 64){
+						continue;
+					}
+					fnFinishLane(uLane);
+					if(uNext < uCount){
+						fnStartLane(uLane);
+					}
+				}
+			}
+			// 逐个完成剩下的数据。
+			for(unsigned uLane = 0; uLane < kLaneCountT; ++uLane){
+				auto &vLane = aLanes[uLane];
+				if(!vLane.bActive){
+					continue;
+				}
+				Regs au32Regs;
+				for(unsigned uReg = 0; uReg < kRegCountT; ++uReg){
+					au32Regs[uReg] = aau32Regs[uReg][uLane];
+				}
+				while(vLane.uChunksRemaining != 0){
+					fnUpdateOne(au32Regs, vLane.pbyRead);
+					vLane.pbyRead += 64;
+					--vLane.uChunksRemaining;
+				}
+				while(vLane.uTailOffset < vLane.uTailChunks * 64){
+					fnUpdateOne(au32Regs, vLane.abyTail + vLane.uTailOffset);
+					vLane.uTailOffset += 64;
+				}
+				for(unsigned uReg = 0; uReg < kRegCountT; ++uReg){
+					aau32Regs[uReg][uLane] = au32Regs[uReg];
+				}
+				fnFinishLane(uLane);
+			}
+		}
+	};
+
+	// 读取 4 个数据块中偏移量为 uOffset 的 4 个字，转置之后每个寄存器保存所有数据块的同一个字。
+	template<bool kByteSwapT>
+	inline void LoadTransposedSse2(__m128i *pxmmWords, const unsigned char *const (&apbyChunks)[4], std::size_t uOffset) noexcept {
+		__m128i axmmRows[4];
+		for(unsigned uLane = 0; uLane < 4; ++uLane){
+			axmmRows[uLane] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(apbyChunks[uLane] + uOffset));
+			if(kByteSwapT){
+				axmmRows[uLane] = _mm_shuffle_epi8(axmmRows[uLane], _mm_set_epi64x(0x0C0D0E0F08090A0B, 0x0405060700010203));
+			}
+		}
+		const auto xmmT0 = _mm_unpacklo_epi32(axmmRows[0], axmmRows[1]);
+		const auto xmmT1 = _mm_unpackhi_epi32(axmmRows[0], axmmRows[1]);
+		const auto xmmT2 = _mm_unpacklo_epi32(axmmRows[2], axmmRows[3]);
+		const auto xmmT3 = _mm_unpackhi_epi32(axmmRows[2], axmmRows[3]);
+		pxmmWords[0] = _mm_unpacklo_epi64(xmmT0, xmmT2);
+		pxmmWords[1] = _mm_unpackhi_epi64(xmmT0, xmmT2);
+		pxmmWords[2] = _mm_unpacklo_epi64(xmmT1, xmmT3);
+		pxmmWords[3] = _mm_unpackhi_epi64(xmmT1, xmmT3);
+	}
+	// 同上，但是一次处理 8 个数据块中的 8 个字。
+	template<bool kByteSwapT>
+	__attribute__((__target__("avx2")))
+	inline void LoadTransposedAvx2(__m256i *pymmWords, const unsigned char *const (&apbyChunks)[8], std::size_t uOffset) noexcept {
+		__m256i aymmRows[8];
+		for(unsigned uLane = 0; uLane < 8; ++uLane){
+			aymmRows[uLane] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(apbyChunks[uLane] + uOffset));
+			if(kByteSwapT){
+				aymmRows[uLane] = _mm256_shuffle_epi8(aymmRows[uLane], _mm256_set_epi64x(0x0C0D0E0F08090A0B, 0x0405060700010203, 0x0C0D0E0F08090A0B, 0x0405060700010203));
+			}
+		}
+		const auto ymmT0 = _mm256_unpacklo_epi32(aymmRows[0], aymmRows[1]);
+		const auto ymmT1 = _mm256_unpackhi_epi32(aymmRows[0], aymmRows[1]);
+		const auto ymmT2 = _mm256_unpacklo_epi32(aymmRows[2], aymmRows[3]);
+		const auto ymmT3 = _mm256_unpackhi_epi32(aymmRows[2], aymmRows[3]);
+		const auto ymmT4 = _mm256_unpacklo_epi32(aymmRows[4], aymmRows[5]);
+		const auto ymmT5 = _mm256_unpackhi_epi32(aymmRows[4], aymmRows[5]);
+		const auto ymmT6 = _mm256_unpacklo_epi32(aymmRows[6], aymmRows[7]);
+		const auto ymmT7 = _mm256_unpackhi_epi32(aymmRows[6], aymmRows[7]);
+		const auto ymmU0 = _mm256_unpacklo_epi64(ymmT0, ymmT2);
+		const auto ymmU1 = _mm256_unpackhi_epi64(ymmT0, ymmT2);
+		const auto ymmU2 = _mm256_unpacklo_epi64(ymmT1, ymmT3);
+		const auto ymmU3 = _mm256_unpackhi_epi64(ymmT1, ymmT3);
+		const auto ymmU4 = _mm256_unpacklo_epi64(ymmT4, ymmT6);
+		const auto ymmU5 = _mm256_unpackhi_epi64(ymmT4, ymmT6);
+		const auto ymmU6 = _mm256_unpacklo_epi64(ymmT5, ymmT7);
+		const auto ymmU7 = _mm256_unpackhi_epi64(ymmT5, ymmT7);
+		pymmWords[0] = _mm256_permute2x128_si256(ymmU0, ymmU4, 0x20);
+		pymmWords[1] = _mm256_permute2x128_si256(ymmU1, ymmU5, 0x20);
+		pymmWords[2] = _mm256_permute2x128_si256(ymmU2, ymmU6, 0x20);
+		pymmWords[3] = _mm256_permute2x128_si256(ymmU3, ymmU7, 0x20);
+		pymmWords[4] = _mm256_permute2x128_si256(ymmU0, ymmU4, 0x31);
+		pymmWords[5] = _mm256_permute2x128_si256(ymmU1, ymmU5, 0x31);
+		pymmWords[6] = _mm256_permute2x128_si256(ymmU2, ymmU6, 0x31);
+		pymmWords[7] = _mm256_permute2x128_si256(ymmU3, ymmU7, 0x31);
+	}
+
+	inline __m128i RotateLeftSse2(__m128i xmmValue, int nBits) noexcept {
+		return _mm_or_si128(_mm_slli_epi32(xmmValue, nBits), _mm_srli_epi32(xmmValue, 32 - nBits));
+	}
+	__attribute__((__target__("avx2")))
+	inline __m256i RotateLeftAvx2(__m256i ymmValue, int nBits) noexcept {
+		return _mm256_or_si256(_mm256_slli_epi32(ymmValue, nBits), _mm256_srli_epi32(ymmValue, 32 - nBits));
+	}
+}
+
+}
+
+#endif
@@ -0,0 +1,213 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "IoCompletionQueue.hpp"
+#include "../Core/Exception.hpp"
+#include "../Core/Defer.hpp"
+#include "../Core/Assert.hpp"
+#include <MCFCRT/env/_nt_timeout.h>
+#include <ntdef.h>
+#include <ntstatus.h>
+
+extern "C" {
+
+typedef struct _IO_STATUS_BLOCK {
+	union {
+		NTSTATUS Status;
+		PVOID Pointer;
+	};
+	ULONG_PTR Information;
+} IO_STATUS_BLOCK, *PIO_STATUS_BLOCK;
+
+typedef struct _FILE_COMPLETION_INFORMATION {
+	HANDLE Port;
+	PVOID Key;
+} FILE_COMPLETION_INFORMATION, *PFILE_COMPLETION_INFORMATION;
+
+enum {
+	FileCompletionInformation = 30,
+};
+
+#ifndef IO_COMPLETION_ALL_ACCESS
+#	define IO_COMPLETION_ALL_ACCESS  (STANDARD_RIGHTS_REQUIRED | SYNCHRONIZE | 0x0003)
+#endif
+
+__attribute__((__dllimport__, __stdcall__))
+extern NTSTATUS NtCreateIoCompletion(HANDLE *pHandle, ACCESS_MASK dwDesiredAccess, const OBJECT_ATTRIBUTES *pObjectAttributes, ULONG ulNumberOfConcurrentThreads) noexcept;
+__attribute__((__dllimport__, __stdcall__))
+extern NTSTATUS NtSetIoCompletion(HANDLE hPort, void *pKeyContext, void *pApcContext, NTSTATUS lIoStatus, ULONG_PTR uIoStatusInformation) noexcept;
+__attribute__((__dllimport__, __stdcall__))
+extern NTSTATUS NtRemoveIoCompletion(HANDLE hPort, void **ppKeyContext, void **ppApcContext, IO_STATUS_BLOCK *pIoStatus, const LARGE_INTEGER *pliTimeout) noexcept;
+__attribute__((__dllimport__, __stdcall__))
+extern NTSTATUS NtSetInformationFile(HANDLE hFile, IO_STATUS_BLOCK *pIoStatus, const void *pFileInformation, ULONG pInformationLength, ULONG eFileInformationClass) noexcept;
+
+__attribute__((__dllimport__, __stdcall__))
+extern ULONG WINAPI RtlNtStatusToDosError(NTSTATUS lStatus) noexcept;
+
+}
+
+namespace MCF {
+
+namespace {
+	// 关联到队列的文件句柄使用的键是空指针，Stop() 投递的通知使用这个键。
+	void *const kStopKey = reinterpret_cast<void *>(static_cast<std::uintptr_t>(1));
+}
+
+IoCompletionQueue::Operation::~Operation(){ }
+
+IoCompletionQueue::IoCompletionQueue(std::size_t uConcurrency){
+	ULONG ulConcurrency;
+	if(uConcurrency <= ULONG_MAX){
+		ulConcurrency = static_cast<ULONG>(uConcurrency);
+	} else {
+		ulConcurrency = ULONG_MAX;
+	}
+
+	HANDLE hTemp;
+	const auto lStatus = ::NtCreateIoCompletion(&hTemp, IO_COMPLETION_ALL_ACCESS, nullptr, ulConcurrency);
+	if(!NT_SUCCESS(lStatus)){
+		MCF_THROW(Exception, ::RtlNtStatusToDosError(lStatus), Rcntws::View(L"IoCompletionQueue: NtCreateIoCompletion() 失败。"));
+	}
+	x_hPort.Reset(hTemp);
+}
+IoCompletionQueue::~IoCompletionQueue(){
+	StopWorkers();
+	// 队列被销毁时仍未完成的操作无法再被通知，它们所占用的内存会泄漏。
+	MCF_ASSERT_MSG(x_uPendingCount.Load(kAtomicRelaxed) == 0, L"IoCompletionQueue 被销毁时仍有未完成的操作。");
+}
+
+IoCompletionQueue::DispatchResult IoCompletionQueue::X_Dispatch(std::uint64_t u64UntilFastMonoClock){
+	for(;;){
+		::LARGE_INTEGER liTimeout;
+		const ::LARGE_INTEGER *pliTimeout = nullptr;
+		if(u64UntilFastMonoClock != UINT64_MAX){
+			::__MCFCRT_InitializeNtTimeout(&liTimeout, u64UntilFastMonoClock);
+			pliTimeout = &liTimeout;
+		}
+
+		void *pKey;
+		void *pContext;
+		::IO_STATUS_BLOCK vIoStatus;
+		const auto lStatus = ::NtRemoveIoCompletion(x_hPort.Get(), &pKey, &pContext, &vIoStatus, pliTimeout);
+		if(lStatus == STATUS_TIMEOUT){
+			return kDispatchTimedOut;
+		}
+		if(!NT_SUCCESS(lStatus)){
+			MCF_THROW(Exception, ::RtlNtStatusToDosError(lStatus), Rcntws::View(L"IoCompletionQueue: NtRemoveIoCompletion() 失败。"));
+		}
+		if(pKey == kStopKey){
+			return kDispatchStopped;
+		}
+		if(!pContext){
+			// 不是由 BeginOperation() 发起的请求，忽略。
+			continue;
+		}
+
+		const auto vDecrement = Defer([&]{ x_uPendingCount.Decrement(kAtomicRelaxed); });
+		const UniquePtr<Operation> pOperation(static_cast<Operation *>(pContext));
+		unsigned long ulErrorCode;
+		if(vIoStatus.Status == STATUS_END_OF_FILE){
+			// 读取到文件末尾不是错误。
+			ulErrorCode = 0;
+		} else if(NT_SUCCESS(vIoStatus.Status)){
+			ulErrorCode = 0;
+		} else {
+			ulErrorCode = ::RtlNtStatusToDosError(vIoStatus.Status);
+		}
+		pOperation->X_Complete(ulErrorCode, vIoStatus.Information);
+		return kDispatchCompleted;
+	}
+}
+
+void IoCompletionQueue::Associate(Handle hFile){
+	::FILE_COMPLETION_INFORMATION vCompletionInfo;
+	vCompletionInfo.Port = x_hPort.Get();
+	vCompletionInfo.Key  = nullptr;
+	::IO_STATUS_BLOCK vIoStatus;
+	const auto lStatus = ::NtSetInformationFile(hFile, &vIoStatus, &vCompletionInfo, sizeof(vCompletionInfo), FileCompletionInformation);
+	if(!NT_SUCCESS(lStatus)){
+		MCF_THROW(Exception, ::RtlNtStatusToDosError(lStatus), Rcntws::View(L"IoCompletionQueue: NtSetInformationFile() 失败。"));
+	}
+}
+
+void *IoCompletionQueue::BeginOperation(UniquePtr<Operation> pOperation) noexcept {
+	MCF_ASSERT(pOperation);
+
+	x_uPendingCount.Increment(kAtomicRelaxed);
+	return pOperation.Release();
+}
+UniquePtr<IoCompletionQueue::Operation> IoCompletionQueue::AbandonOperation(void *pContext) noexcept {
+	MCF_ASSERT(pContext);
+
+	x_uPendingCount.Decrement(kAtomicRelaxed);
+	return UniquePtr<Operation>(static_cast<Operation *>(pContext));
+}
+
+void IoCompletionQueue::PostOperation(UniquePtr<Operation> pOperation, unsigned long ulErrorCode, std::size_t uBytesTransferred){
+	// 错误码被编码为 Win32 错误对应的 NTSTATUS，X_Dispatch() 会把它转换回来。
+	NTSTATUS lStatus;
+	if(ulErrorCode == 0){
+		lStatus = STATUS_SUCCESS;
+	} else {
+		lStatus = static_cast<NTSTATUS>(0xC0070000u | (ulErrorCode & 0xFFFFu));
+	}
+	const auto pContext = BeginOperation(std::move(pOperation));
+	const auto lResult = ::NtSetIoCompletion(x_hPort.Get(), nullptr, pContext, lStatus, uBytesTransferred);
+	if(!NT_SUCCESS(lResult)){
+		AbandonOperation(pContext);
+		MCF_THROW(Exception, ::RtlNtStatusToDosError(lResult), Rcntws::View(L"IoCompletionQueue: NtSetIoCompletion() 失败。"));
+	}
+}
+
+std::size_t IoCompletionQueue::Poll(std::uint64_t u64UntilFastMonoClock){
+	std::size_t uCount = 0;
+	for(;;){
+		const auto eResult = X_Dispatch(u64UntilFastMonoClock);
+		if(eResult == kDispatchTimedOut){
+			break;
+		}
+		if(eResult == kDispatchStopped){
+			// 这个通知是给某个 Run() 的，把它放回去。
+			Stop();
+			break;
+		}
+		++uCount;
+	}
+	return uCount;
+}
+void IoCompletionQueue::Run(){
+	for(;;){
+		const auto eResult = X_Dispatch(UINT64_MAX);
+		if(eResult == kDispatchStopped){
+			break;
+		}
+	}
+}
+void IoCompletionQueue::Stop(){
+	const auto lStatus = ::NtSetIoCompletion(x_hPort.Get(), kStopKey, nullptr, STATUS_SUCCESS, 0);
+	if(!NT_SUCCESS(lStatus)){
+		MCF_THROW(Exception, ::RtlNtStatusToDosError(lStatus), Rcntws::View(L"IoCompletionQueue: NtSetIoCompletion() 失败。"));
+	}
+}
+
+void IoCompletionQueue::StartWorkers(std::size_t uCount){
+	const auto vLock = x_mtxWorkers.GetLock();
+	x_vecWorkers.Reserve(x_vecWorkers.GetSize() + uCount);
+	for(std::size_t i = 0; i < uCount; ++i){
+		x_vecWorkers.UncheckedPush(MakeThread([this]{ Run(); }));
+	}
+}
+void IoCompletionQueue::StopWorkers() noexcept {
+	const auto vLock = x_mtxWorkers.GetLock();
+	for(std::size_t i = 0; i < x_vecWorkers.GetSize(); ++i){
+		const auto lStatus = ::NtSetIoCompletion(x_hPort.Get(), kStopKey, nullptr, STATUS_SUCCESS, 0);
+		MCF_ASSERT_MSG(NT_SUCCESS(lStatus), L"NtSetIoCompletion() 失败。");
+	}
+	for(std::size_t i = 0; i < x_vecWorkers.GetSize(); ++i){
+		x_vecWorkers[i]->Wait();
+	}
+	x_vecWorkers.Clear();
+}
+
+}
@@ -0,0 +1,146 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_THREAD_IO_COMPLETION_QUEUE_HPP_
+#define MCF_THREAD_IO_COMPLETION_QUEUE_HPP_
+
+#include "../Core/_KernelObjectBase.hpp"
+#include "../Core/Atomic.hpp"
+#include "../SmartPointers/UniquePtr.hpp"
+#include "../SmartPointers/IntrusivePtr.hpp"
+#include "../Containers/Vector.hpp"
+#include "Mutex.hpp"
+#include "Thread.hpp"
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace MCF {
+
+// 基于 I/O 完成端口的事件循环。异步操作完成之后，它的回调函数在调用 Poll() 或 Run() 的线程中执行。
+// 可以有多个线程同时调用 Run()，也可以用 StartWorkers() 创建一组工作线程。
+class IoCompletionQueue : public Impl_KernelObjectBase::KernelObjectBase {
+public:
+	// 一个被提交的操作。在操作完成时 X_Complete() 被调用，之后它被删除。
+	class Operation {
+		friend IoCompletionQueue;
+
+	private:
+		// 这里的空间用作 IO_STATUS_BLOCK。
+		alignas(void *) unsigned char x_abyIoStatus[sizeof(void *) * 2];
+
+	public:
+		constexpr Operation() noexcept
+			: x_abyIoStatus()
+		{ }
+		virtual ~Operation();
+
+		Operation(const Operation &) = delete;
+		Operation &operator=(const Operation &) = delete;
+
+	public:
+		void *GetIoStatusBlock() noexcept {
+			return x_abyIoStatus;
+		}
+
+	protected:
+		// ulErrorCode 是 Win32 错误码，0 表示成功。
+		virtual void X_Complete(unsigned long ulErrorCode, std::size_t uBytesTransferred) = 0;
+	};
+
+private:
+	Impl_UniqueNtHandle::UniqueNtHandle x_hPort;
+	Atomic<std::size_t> x_uPendingCount;
+
+	Mutex x_mtxWorkers;
+	Vector<IntrusivePtr<Thread>> x_vecWorkers;
+
+private:
+	enum DispatchResult {
+		kDispatchTimedOut,
+		kDispatchStopped,
+		kDispatchCompleted,
+	};
+
+	DispatchResult X_Dispatch(std::uint64_t u64UntilFastMonoClock);
+
+public:
+	// uConcurrency 是同时处理完成通知的线程数的上限，0 表示处理器的数目。
+	explicit IoCompletionQueue(std::size_t uConcurrency = 0);
+	~IoCompletionQueue();
+
+	IoCompletionQueue(const IoCompletionQueue &) = delete;
+	IoCompletionQueue &operator=(const IoCompletionQueue &) = delete;
+
+public:
+	Handle GetHandle() const noexcept {
+		return x_hPort.Get();
+	}
+	// 已经提交但是回调函数还没有执行完的操作的数目。
+	std::size_t GetPendingCount() const noexcept {
+		return x_uPendingCount.Load(kAtomicRelaxed);
+	}
+
+	// 把一个以 File::kOverlapped 打开的文件句柄关联到这个队列。一个句柄只能关联一次。
+	void Associate(Handle hFile);
+
+	// 这两个函数由发起异步 I/O 的一方使用。BeginOperation() 返回的指针用作 I/O 请求的完成上下文。
+	// 如果请求没能提交，完成通知不会到来，这时应当调用 AbandonOperation() 取回这个操作。
+	void *BeginOperation(UniquePtr<Operation> pOperation) noexcept;
+	UniquePtr<Operation> AbandonOperation(void *pContext) noexcept;
+
+	// 直接把一个操作放入队列，它会像一个已完成的 I/O 请求一样被处理。
+	void PostOperation(UniquePtr<Operation> pOperation, unsigned long ulErrorCode = 0, std::size_t uBytesTransferred = 0);
+	// 在处理完成通知的线程中调用 vFunction()。
+	template<typename FunctionT>
+	void Post(FunctionT &&vFunction);
+
+	// 处理完成通知，直到队列为空或者到达指定时刻。返回处理的数目。
+	std::size_t Poll(std::uint64_t u64UntilFastMonoClock);
+	// 处理完成通知，直到 Stop() 被调用。
+	void Run();
+	// 使一个正在 Run() 的线程返回。
+	void Stop();
+
+	void StartWorkers(std::size_t uCount);
+	void StopWorkers() noexcept;
+};
+
+namespace Impl_IoCompletionQueue {
+	template<typename FunctionT>
+	class ConcreteOperation final : public IoCompletionQueue::Operation {
+	private:
+		std::decay_t<FunctionT> x_vFunction;
+
+	public:
+		explicit ConcreteOperation(FunctionT &vFunction)
+			: x_vFunction(std::forward<FunctionT>(vFunction))
+		{ }
+		~ConcreteOperation() override;
+
+	protected:
+		void X_Complete(unsigned long ulErrorCode, std::size_t uBytesTransferred) override {
+			x_vFunction(ulErrorCode, uBytesTransferred);
+		}
+	};
+
+	template<typename FunctionT>
+	ConcreteOperation<FunctionT>::~ConcreteOperation(){ }
+
+	// 回调函数的参数是 (unsigned long ulErrorCode, std::size_t uBytesTransferred)。
+	template<typename FunctionT>
+	UniquePtr<IoCompletionQueue::Operation> MakeOperation(FunctionT &&vFunction){
+		return MakeUnique<ConcreteOperation<FunctionT>>(vFunction);
+	}
+}
+
+template<typename FunctionT>
+void IoCompletionQueue::Post(FunctionT &&vFunction){
+	PostOperation(Impl_IoCompletionQueue::MakeOperation([vFunction = std::forward<FunctionT>(vFunction)](unsigned long, std::size_t) mutable { vFunction(); }));
+}
+
+}
+
+#endif
@@ -68,8 +68,11 @@ public:
 public:
 	ElementT *Get() const noexcept {
 		void *pContainerRaw;
+		// 这个线程还没有线程局部存储，或者已经在退出的过程中销毁了它。
 		const bool bResult = ::_MCFCRT_TlsGet(x_hTlsKey.Get(), &pContainerRaw);
-		MCF_ASSERT_MSG(bResult, L"_MCFCRT_TlsGet() 失败。");
+		if(!bResult){
+			return nullptr;
+		}
 		const auto pContainer = static_cast<X_TlsContainer *>(pContainerRaw);
 		if(!pContainer){
 			return nullptr;
@@ -0,0 +1,293 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "MultiStringSearcher.hpp"
+#include "../Core/Exception.hpp"
+#include "../Core/MinMax.hpp"
+#include <MCFCRT/env/expect.h>
+#include <algorithm>
+#include <cstring>
+#include <tmmintrin.h>
+
+namespace MCF {
+
+namespace Impl_MultiStringSearcher {
+	namespace {
+		constexpr std::uint32_t kNoState = UINT32_MAX;
+	}
+
+	Engine::Engine(const PatternRef *pPatterns, std::size_t uPatternCount){
+		if(uPatternCount >= kNoState){
+			MCF_THROW(Exception, ERROR_NOT_ENOUGH_MEMORY, Rcntws::View(L"MultiStringSearcher: 模式串太多。"));
+		}
+		x_vecPatternOffsets.Reserve(uPatternCount + 1);
+		x_vecPatternOffsets.Push(0u);
+		for(std::size_t uIndex = 0; uIndex < uPatternCount; ++uIndex){
+			const auto &vPattern = pPatterns[uIndex];
+			if(vPattern.uSize == 0){
+				MCF_THROW(Exception, ERROR_INVALID_PARAMETER, Rcntws::View(L"MultiStringSearcher: 模式串不能为空。"));
+			}
+			x_vecPatternBytes.Append(static_cast<const unsigned char *>(vPattern.pData), vPattern.uSize);
+			x_vecPatternOffsets.UncheckedPush(x_vecPatternBytes.GetSize());
+		}
+		X_BuildAutomaton();
+		X_BuildTeddy();
+	}
+
+	void Engine::X_BuildAutomaton(){
+		// 没有出现在任何模式串中的字节属于同一个等价类，它们总是转移到根状态的某个后继。
+		bool abUsed[256] = { };
+		for(auto pbyCur = x_vecPatternBytes.GetBegin(); pbyCur != x_vecPatternBytes.GetEnd(); ++pbyCur){
+			abUsed[*pbyCur] = true;
+		}
+		std::uint32_t u32ClassCount = std::all_of(abUsed, abUsed + 256, [](bool bUsed){ return bUsed; }) ? 0 : 1;
+		for(unsigned uByte = 0; uByte < 256; ++uByte){
+			if(abUsed[uByte]){
+				x_abyByteClasses[uByte] = static_cast<unsigned char>(u32ClassCount++);
+			} else {
+				x_abyByteClasses[uByte] = 0;
+			}
+		}
+		x_u32ClassCount = u32ClassCount;
+
+		// 建立 trie。
+		const auto uPatternCount = GetPatternCount();
+		Vector<std::uint32_t> vecTerminalStates;
+		vecTerminalStates.Reserve(uPatternCount);
+		x_vecTransitions.Clear();
+		x_vecTransitions.Append(u32ClassCount, kNoState);
+		std::uint32_t u32StateCount = 1;
+		for(std::size_t uIndex = 0; uIndex < uPatternCount; ++uIndex){
+			std::uint32_t u32State = 0;
+			const auto pbyPattern = X_GetPatternBegin(uIndex);
+			for(std::size_t uOffset = 0; uOffset < X_GetPatternSize(uIndex); ++uOffset){
+				auto &u32Next = x_vecTransitions[u32State * u32ClassCount + x_abyByteClasses[pbyPattern[uOffset]]];
+				if(u32Next == kNoState){
+					// 表项的偏移量左移一位之后仍然要能放进 32 位整数。
+					if(u32StateCount >= 0x7FFFFFFFu / u32ClassCount){
+						MCF_THROW(Exception, ERROR_NOT_ENOUGH_MEMORY, Rcntws::View(L"MultiStringSearcher: 状态数太多。"));
+					}
+					u32Next = u32StateCount++;
+					u32State = u32Next;
+					x_vecTransitions.Append(u32ClassCount, kNoState);
+				} else {
+					u32State = u32Next;
+				}
+			}
+			vecTerminalStates.UncheckedPush(u32State);
+		}
+
+		// 按照终止状态对模式串排序（计数排序，保持原有顺序）。
+		x_vecOwnOutputOffsets.Clear();
+		x_vecOwnOutputOffsets.Append(u32StateCount + 1, 0u);
+		for(std::size_t uIndex = 0; uIndex < uPatternCount; ++uIndex){
+			++x_vecOwnOutputOffsets[vecTerminalStates[uIndex] + 1];
+		}
+		for(std::uint32_t u32State = 0; u32State < u32StateCount; ++u32State){
+			x_vecOwnOutputOffsets[u32State + 1] += x_vecOwnOutputOffsets[u32State];
+		}
+		x_vecOwnOutputs.Clear();
+		x_vecOwnOutputs.Append(uPatternCount, 0u);
+		{
+			Vector<std::uint32_t> vecCursors(x_vecOwnOutputOffsets.GetBegin(), x_vecOwnOutputOffsets.GetEnd() - 1);
+			for(std::size_t uIndex = 0; uIndex < uPatternCount; ++uIndex){
+				x_vecOwnOutputs[vecCursors[vecTerminalStates[uIndex]]++] = static_cast<std::uint32_t>(uIndex);
+			}
+		}
+		const auto fnHasOwnOutputs = [&](std::uint32_t u32State){
+			return x_vecOwnOutputOffsets[u32State] != x_vecOwnOutputOffsets[u32State + 1];
+		};
+
+		// 按广度优先的顺序计算失败链接，同时把失败转移合并到状态转移表中。
+		// 字典链接指向失败链上第一个有输出的状态。
+		Vector<std::uint32_t> vecFailureLinks(u32StateCount, 0u);
+		x_vecDictionaryLinks.Clear();
+		x_vecDictionaryLinks.Append(u32StateCount, kNoState);
+		Vector<std::uint32_t> vecQueue;
+		vecQueue.Reserve(u32StateCount);
+		for(std::uint32_t u32Class = 0; u32Class < u32ClassCount; ++u32Class){
+			auto &u32Next = x_vecTransitions[u32Class];
+			if(u32Next == kNoState){
+				u32Next = 0;
+			} else {
+				vecQueue.UncheckedPush(u32Next);
+			}
+		}
+		for(std::size_t uQueueIndex = 0; uQueueIndex < vecQueue.GetSize(); ++uQueueIndex){
+			const auto u32State = vecQueue[uQueueIndex];
+			const auto u32Failure = vecFailureLinks[u32State];
+			x_vecDictionaryLinks[u32State] = fnHasOwnOutputs(u32Failure) ? u32Failure : x_vecDictionaryLinks[u32Failure];
+			for(std::uint32_t u32Class = 0; u32Class < u32ClassCount; ++u32Class){
+				auto &u32Next = x_vecTransitions[u32State * u32ClassCount + u32Class];
+				const auto u32FailureNext = x_vecTransitions[u32Failure * u32ClassCount + u32Class];
+				if(u32Next == kNoState){
+					u32Next = u32FailureNext;
+				} else {
+					vecFailureLinks[u32Next] = u32FailureNext;
+					vecQueue.UncheckedPush(u32Next);
+				}
+			}
+		}
+
+		// 把状态编号替换为表项。
+		for(auto pu32Cur = x_vecTransitions.GetBegin(); pu32Cur != x_vecTransitions.GetEnd(); ++pu32Cur){
+			const auto u32Next = *pu32Cur;
+			const bool bHasOutputs = fnHasOwnOutputs(u32Next) || (x_vecDictionaryLinks[u32Next] != kNoState);
+			*pu32Cur = ((u32Next * u32ClassCount) << 1) | bHasOutputs;
+		}
+	}
+	void Engine::X_BuildTeddy(){
+		x_bTeddy = false;
+
+		const auto uPatternCount = GetPatternCount();
+		if((uPatternCount == 0) || (uPatternCount > kTeddyPatternCountMax)){
+			return;
+		}
+		std::size_t uFingerprintLength = kTeddyFingerprintMax;
+		for(std::size_t uIndex = 0; uIndex < uPatternCount; ++uIndex){
+			uFingerprintLength = Min(uFingerprintLength, X_GetPatternSize(uIndex));
+		}
+		x_uTeddyFingerprintLength = uFingerprintLength;
+
+		// 前缀相同的模式串放进同一个桶，这样假阳性更少。
+		x_vecTeddyBucketPatterns.Clear();
+		for(std::size_t uIndex = 0; uIndex < uPatternCount; ++uIndex){
+			x_vecTeddyBucketPatterns.Push(static_cast<std::uint32_t>(uIndex));
+		}
+		std::stable_sort(x_vecTeddyBucketPatterns.GetBegin(), x_vecTeddyBucketPatterns.GetEnd(),
+			[&](std::uint32_t u32Lhs, std::uint32_t u32Rhs){ return std::memcmp(X_GetPatternBegin(u32Lhs), X_GetPatternBegin(u32Rhs), uFingerprintLength) < 0; });
+
+		std::memset(x_aabyTeddyLowTables, 0, sizeof(x_aabyTeddyLowTables));
+		std::memset(x_aabyTeddyHighTables, 0, sizeof(x_aabyTeddyHighTables));
+		std::size_t uBucket = 0;
+		x_auTeddyBucketOffsets[0] = 0;
+		for(std::size_t uSortedIndex = 0; uSortedIndex < uPatternCount; ++uSortedIndex){
+			while(uSortedIndex * kTeddyBucketCount >= (uBucket + 1) * uPatternCount){
+				x_auTeddyBucketOffsets[++uBucket] = uSortedIndex;
+			}
+			const auto pbyPattern = X_GetPatternBegin(x_vecTeddyBucketPatterns[uSortedIndex]);
+			for(std::size_t uOffset = 0; uOffset < uFingerprintLength; ++uOffset){
+				x_aabyTeddyLowTables[uOffset][pbyPattern[uOffset] & 0x0F] |= static_cast<unsigned char>(1u << uBucket);
+				x_aabyTeddyHighTables[uOffset][pbyPattern[uOffset] >> 4] |= static_cast<unsigned char>(1u << uBucket);
+			}
+		}
+		while(uBucket < kTeddyBucketCount){
+			x_auTeddyBucketOffsets[++uBucket] = uPatternCount;
+		}
+
+		x_bTeddy = true;
+	}
+
+	void Engine::X_ReportMatches(std::uint32_t u32Cursor, std::uint64_t u64End, const Callback &fnCallback) const {
+		auto u32State = (u32Cursor >> 1) / x_u32ClassCount;
+		if(x_vecOwnOutputOffsets[u32State] == x_vecOwnOutputOffsets[u32State + 1]){
+			u32State = x_vecDictionaryLinks[u32State];
+		}
+		while(u32State != kNoState){
+			for(auto u32Output = x_vecOwnOutputOffsets[u32State]; u32Output < x_vecOwnOutputOffsets[u32State + 1]; ++u32Output){
+				const auto uPatternIndex = x_vecOwnOutputs[u32Output];
+				fnCallback(uPatternIndex, u64End - X_GetPatternSize(uPatternIndex));
+			}
+			u32State = x_vecDictionaryLinks[u32State];
+		}
+	}
+	void Engine::X_SearchTeddy(const unsigned char *pbyText, std::size_t uSize, const Callback &fnCallback) const {
+		const auto uFingerprintLength = x_uTeddyFingerprintLength;
+		const auto fnVerify = [&](std::size_t uPosition, unsigned uBuckets){
+			do {
+				const auto uBucket = static_cast<unsigned>(__builtin_ctz(uBuckets));
+				for(auto uSortedIndex = x_auTeddyBucketOffsets[uBucket]; uSortedIndex < x_auTeddyBucketOffsets[uBucket + 1]; ++uSortedIndex){
+					const auto uPatternIndex = x_vecTeddyBucketPatterns[uSortedIndex];
+					const auto uPatternSize = X_GetPatternSize(uPatternIndex);
+					if((uSize - uPosition >= uPatternSize) && (std::memcmp(pbyText + uPosition, X_GetPatternBegin(uPatternIndex), uPatternSize) == 0)){
+						fnCallback(uPatternIndex, uPosition);
+					}
+				}
+				uBuckets &= uBuckets - 1;
+			} while(uBuckets != 0);
+		};
+
+		std::size_t uOffset = 0;
+		if(uSize >= 16 + uFingerprintLength - 1){
+			const auto xmmNibbleMask = _mm_set1_epi8(0x0F);
+			__m128i axmmLowTables[kTeddyFingerprintMax], axmmHighTables[kTeddyFingerprintMax];
+			for(std::size_t uIndex = 0; uIndex < uFingerprintLength; ++uIndex){
+				axmmLowTables[uIndex] = _mm_load_si128(reinterpret_cast<const __m128i *>(x_aabyTeddyLowTables[uIndex]));
+				axmmHighTables[uIndex] = _mm_load_si128(reinterpret_cast<const __m128i *>(x_aabyTeddyHighTables[uIndex]));
+			}
+			do {
+				auto xmmBuckets = _mm_set1_epi8(-1);
+				for(std::size_t uIndex = 0; uIndex < uFingerprintLength; ++uIndex){
+					const auto xmmText = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pbyText + uOffset + uIndex));
+					const auto xmmLow = _mm_shuffle_epi8(axmmLowTables[uIndex], _mm_and_si128(xmmText, xmmNibbleMask));
+					const auto xmmHigh = _mm_shuffle_epi8(axmmHighTables[uIndex], _mm_and_si128(_mm_srli_epi16(xmmText, 4), xmmNibbleMask));
+					xmmBuckets = _mm_and_si128(xmmBuckets, _mm_and_si128(xmmLow, xmmHigh));
+				}
+				auto u32Mask = ~static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(xmmBuckets, _mm_setzero_si128()))) & 0xFFFF;
+				if(_MCFCRT_EXPECT_NOT(u32Mask != 0)){
+					__attribute__((__aligned__(16))) unsigned char abyBuckets[16];
+					_mm_store_si128(reinterpret_cast<__m128i *>(abyBuckets), xmmBuckets);
+					do {
+						const auto uIndex = static_cast<unsigned>(__builtin_ctz(u32Mask));
+						fnVerify(uOffset + uIndex, abyBuckets[uIndex]);
+						u32Mask &= u32Mask - 1;
+					} while(u32Mask != 0);
+				}
+				uOffset += 16;
+			} while(uSize - uOffset >= 16 + uFingerprintLength - 1);
+		}
+		for(; uSize - uOffset >= uFingerprintLength; ++uOffset){
+			unsigned uBuckets = 0xFF;
+			for(std::size_t uIndex = 0; uIndex < uFingerprintLength; ++uIndex){
+				const unsigned uByte = pbyText[uOffset + uIndex];
+				uBuckets &= static_cast<unsigned>(x_aabyTeddyLowTables[uIndex][uByte & 0x0F] & x_aabyTeddyHighTables[uIndex][uByte >> 4]);
+			}
+			if(uBuckets != 0){
+				fnVerify(uOffset, uBuckets);
+			}
+		}
+	}
+
+	void Engine::Search(const void *pText, std::size_t uSize, const Callback &fnCallback) const {
+		if(x_bTeddy){
+			X_SearchTeddy(static_cast<const unsigned char *>(pText), uSize, fnCallback);
+			return;
+		}
+		Progress vProgress;
+		SearchPartial(vProgress, pText, uSize, fnCallback);
+	}
+	void Engine::SearchPartial(Progress &vProgress, const void *pChunk, std::size_t uSize, const Callback &fnCallback) const {
+		const auto pbyChunk = static_cast<const unsigned char *>(pChunk);
+		const auto pu32Transitions = x_vecTransitions.GetData();
+		auto u32Cursor = vProgress.u32Cursor;
+		for(std::size_t uOffset = 0; uOffset < uSize; ++uOffset){
+			u32Cursor = pu32Transitions[(u32Cursor >> 1) + x_abyByteClasses[pbyChunk[uOffset]]];
+			if(_MCFCRT_EXPECT_NOT(u32Cursor & 1)){
+				X_ReportMatches(u32Cursor, vProgress.u64Offset + uOffset + 1, fnCallback);
+			}
+		}
+		vProgress.u32Cursor = u32Cursor;
+		vProgress.u64Offset += uSize;
+	}
+	void Engine::SearchStream(AbstractInputStream &vStream, const Callback &fnCallback) const {
+		Progress vProgress;
+		const void *pChunk;
+		std::size_t uSize;
+		while(vStream.Borrow(&pChunk, &uSize)){
+			SearchPartial(vProgress, pChunk, uSize, fnCallback);
+			vStream.Consume(uSize);
+		}
+	}
+}
+
+template class MultiStringSearcher<Impl_StringTraits::Type::kUtf8>;
+template class MultiStringSearcher<Impl_StringTraits::Type::kUtf16>;
+template class MultiStringSearcher<Impl_StringTraits::Type::kUtf32>;
+template class MultiStringSearcher<Impl_StringTraits::Type::kCesu8>;
+template class MultiStringSearcher<Impl_StringTraits::Type::kAnsi>;
+template class MultiStringSearcher<Impl_StringTraits::Type::kModifiedUtf8>;
+template class MultiStringSearcher<Impl_StringTraits::Type::kNarrow>;
+template class MultiStringSearcher<Impl_StringTraits::Type::kWide>;
+
+}
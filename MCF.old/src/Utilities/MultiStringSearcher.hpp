@@ -0,0 +1,177 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_UTILITIES_MULTI_STRING_SEARCHER_HPP_
+#define MCF_UTILITIES_MULTI_STRING_SEARCHER_HPP_
+
+#include "../Core/StringView.hpp"
+#include "../Containers/Vector.hpp"
+#include "../Function/FunctionView.hpp"
+#include "../Streams/AbstractInputStream.hpp"
+#include <initializer_list>
+#include <cstddef>
+#include <cstdint>
+
+namespace MCF {
+
+namespace Impl_MultiStringSearcher {
+	struct PatternRef {
+		const void *pData;
+		std::size_t uSize;
+	};
+
+	// 以字节为单位的 Aho-Corasick 自动机。
+	// 状态转移表是完全展开的 DFA，每个状态一行，列是字节的等价类，因此查找时不需要沿着失败链回溯。
+	// 表项的最低位表示目标状态是否有输出，其余的位是目标状态所在行的偏移量。
+	// 模式串不多的时候，整块查找使用 Teddy 算法：用 PSHUFB 把每个字节的高低四位分别映射到一组桶，三个字节的结果取交集之后，只有非空的位置才需要逐个比较。
+	class Engine {
+	public:
+		// 第二个参数是匹配的起始位置，以字节为单位。
+		using Callback = FunctionView<void (std::size_t uPatternIndex, std::uint64_t u64Offset)>;
+
+		// 增量查找的状态。
+		struct Progress {
+			std::uint32_t u32Cursor;
+			std::uint64_t u64Offset;
+
+			constexpr Progress() noexcept
+				: u32Cursor(0), u64Offset(0)
+			{ }
+		};
+
+		enum : std::size_t {
+			kTeddyPatternCountMax = 32,
+			kTeddyBucketCount     = 8,
+			kTeddyFingerprintMax  = 3,
+		};
+
+	private:
+		Vector<unsigned char> x_vecPatternBytes;
+		Vector<std::size_t> x_vecPatternOffsets; // x_vecPatternOffsets[i] 到 x_vecPatternOffsets[i + 1] 是第 i 个模式串。
+
+		unsigned char x_abyByteClasses[256];
+		std::uint32_t x_u32ClassCount;
+		Vector<std::uint32_t> x_vecTransitions;
+		Vector<std::uint32_t> x_vecOwnOutputOffsets; // 同上，以状态为下标。
+		Vector<std::uint32_t> x_vecOwnOutputs;
+		Vector<std::uint32_t> x_vecDictionaryLinks;
+
+		bool x_bTeddy;
+		std::size_t x_uTeddyFingerprintLength;
+		__attribute__((__aligned__(16))) unsigned char x_aabyTeddyLowTables[kTeddyFingerprintMax][16];
+		__attribute__((__aligned__(16))) unsigned char x_aabyTeddyHighTables[kTeddyFingerprintMax][16];
+		std::size_t x_auTeddyBucketOffsets[kTeddyBucketCount + 1];
+		Vector<std::uint32_t> x_vecTeddyBucketPatterns;
+
+	public:
+		Engine(const PatternRef *pPatterns, std::size_t uPatternCount);
+
+	private:
+		void X_BuildAutomaton();
+		void X_BuildTeddy();
+
+		const unsigned char *X_GetPatternBegin(std::size_t uPatternIndex) const noexcept {
+			return x_vecPatternBytes.GetData() + x_vecPatternOffsets[uPatternIndex];
+		}
+		std::size_t X_GetPatternSize(std::size_t uPatternIndex) const noexcept {
+			return x_vecPatternOffsets[uPatternIndex + 1] - x_vecPatternOffsets[uPatternIndex];
+		}
+		void X_ReportMatches(std::uint32_t u32Cursor, std::uint64_t u64End, const Callback &fnCallback) const;
+		void X_SearchTeddy(const unsigned char *pbyText, std::size_t uSize, const Callback &fnCallback) const;
+
+	public:
+		std::size_t GetPatternCount() const noexcept {
+			return x_vecPatternOffsets.GetSize() - 1;
+		}
+
+		// 匹配的报告顺序是未指定的，但是每个匹配恰好报告一次。
+		void Search(const void *pText, std::size_t uSize, const Callback &fnCallback) const;
+		// 跨越多个块的匹配也会被报告。
+		void SearchPartial(Progress &vProgress, const void *pChunk, std::size_t uSize, const Callback &fnCallback) const;
+		void SearchStream(AbstractInputStream &vStream, const Callback &fnCallback) const;
+	};
+}
+
+// 在文本中同时查找多个模式串。
+// 模式串在构造时被复制，不能为空。
+// 回调函数的参数是模式串的序号和匹配的起始位置，后者以字符为单位。
+template<Impl_StringTraits::Type kTypeT>
+class MultiStringSearcher {
+public:
+	using Char     = typename StringView<kTypeT>::Char;
+	using Callback = FunctionView<void (std::size_t uPatternIndex, std::uint64_t u64Offset)>;
+	using Progress = Impl_MultiStringSearcher::Engine::Progress;
+
+private:
+	static Impl_MultiStringSearcher::Engine X_CreateEngine(const StringView<kTypeT> *psvPatterns, std::size_t uPatternCount){
+		Vector<Impl_MultiStringSearcher::PatternRef> vecPatterns;
+		vecPatterns.Reserve(uPatternCount);
+		for(std::size_t uIndex = 0; uIndex < uPatternCount; ++uIndex){
+			vecPatterns.UncheckedPush(Impl_MultiStringSearcher::PatternRef{ psvPatterns[uIndex].GetBegin(), psvPatterns[uIndex].GetSize() * sizeof(Char) });
+		}
+		return Impl_MultiStringSearcher::Engine(vecPatterns.GetData(), vecPatterns.GetSize());
+	}
+
+	// 自动机是按字节匹配的，对于多字节的字符，需要丢弃没有对齐到字符的匹配。
+	template<typename FunctionT>
+	static void X_ForwardAligned(const Callback &fnCallback, FunctionT &&fnSearch){
+		const auto fnByteCallback = [&](std::size_t uPatternIndex, std::uint64_t u64Offset){
+			if(u64Offset % sizeof(Char) != 0){
+				return;
+			}
+			fnCallback(uPatternIndex, u64Offset / sizeof(Char));
+		};
+		std::forward<FunctionT>(fnSearch)(Impl_MultiStringSearcher::Engine::Callback(fnByteCallback));
+	}
+
+private:
+	Impl_MultiStringSearcher::Engine x_vEngine;
+
+public:
+	MultiStringSearcher(const StringView<kTypeT> *psvPatterns, std::size_t uPatternCount)
+		: x_vEngine(X_CreateEngine(psvPatterns, uPatternCount))
+	{ }
+	MultiStringSearcher(std::initializer_list<StringView<kTypeT>> ilPatterns)
+		: MultiStringSearcher(ilPatterns.begin(), ilPatterns.size())
+	{ }
+
+public:
+	std::size_t GetPatternCount() const noexcept {
+		return x_vEngine.GetPatternCount();
+	}
+
+	void Search(const StringView<kTypeT> &svText, const Callback &fnCallback) const {
+		X_ForwardAligned(fnCallback, [&](const auto &fnByteCallback){ x_vEngine.Search(svText.GetBegin(), svText.GetSize() * sizeof(Char), fnByteCallback); });
+	}
+	// 依次传入文本的各个部分。vProgress 在第一次调用之前应当被默认初始化。
+	void SearchPartial(Progress &vProgress, const StringView<kTypeT> &svChunk, const Callback &fnCallback) const {
+		X_ForwardAligned(fnCallback, [&](const auto &fnByteCallback){ x_vEngine.SearchPartial(vProgress, svChunk.GetBegin(), svChunk.GetSize() * sizeof(Char), fnByteCallback); });
+	}
+	// 读取流直到结束。
+	void SearchStream(AbstractInputStream &vStream, const Callback &fnCallback) const {
+		X_ForwardAligned(fnCallback, [&](const auto &fnByteCallback){ x_vEngine.SearchStream(vStream, fnByteCallback); });
+	}
+};
+
+extern template class MultiStringSearcher<Impl_StringTraits::Type::kUtf8>;
+extern template class MultiStringSearcher<Impl_StringTraits::Type::kUtf16>;
+extern template class MultiStringSearcher<Impl_StringTraits::Type::kUtf32>;
+extern template class MultiStringSearcher<Impl_StringTraits::Type::kCesu8>;
+extern template class MultiStringSearcher<Impl_StringTraits::Type::kAnsi>;
+extern template class MultiStringSearcher<Impl_StringTraits::Type::kModifiedUtf8>;
+extern template class MultiStringSearcher<Impl_StringTraits::Type::kNarrow>;
+extern template class MultiStringSearcher<Impl_StringTraits::Type::kWide>;
+
+using Utf8MultiStringSearcher         = MultiStringSearcher<Impl_StringTraits::Type::kUtf8>;
+using Utf16MultiStringSearcher        = MultiStringSearcher<Impl_StringTraits::Type::kUtf16>;
+using Utf32MultiStringSearcher        = MultiStringSearcher<Impl_StringTraits::Type::kUtf32>;
+using Cesu8MultiStringSearcher        = MultiStringSearcher<Impl_StringTraits::Type::kCesu8>;
+using AnsiMultiStringSearcher         = MultiStringSearcher<Impl_StringTraits::Type::kAnsi>;
+using ModifiedUtf8MultiStringSearcher = MultiStringSearcher<Impl_StringTraits::Type::kModifiedUtf8>;
+using NarrowMultiStringSearcher       = MultiStringSearcher<Impl_StringTraits::Type::kNarrow>;
+using WideMultiStringSearcher         = MultiStringSearcher<Impl_StringTraits::Type::kWide>;
+
+}
+
+#endif
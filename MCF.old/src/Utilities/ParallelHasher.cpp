@@ -0,0 +1,142 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "ParallelHasher.hpp"
+#include "../Core/File.hpp"
+#include "../Core/MappedFile.hpp"
+#include "../Core/Atomic.hpp"
+#include "../Core/MinMax.hpp"
+#include "../Streams/Md5OutputStream.hpp"
+#include "../Streams/Sha1OutputStream.hpp"
+#include "../Streams/Sha256OutputStream.hpp"
+#include "../Thread/Thread.hpp"
+#include <cstring>
+
+namespace MCF {
+
+namespace {
+	template<std::size_t kSizeT>
+	ParallelHasher::Digest MakeDigest(const Array<std::uint8_t, kSizeT> &abyResult) noexcept {
+		ParallelHasher::Digest abyDigest = { };
+		std::memcpy(abyDigest.GetData(), abyResult.GetData(), kSizeT);
+		return abyDigest;
+	}
+
+	template<typename StreamT, std::size_t kSizeT>
+	void HashBatch(Optional<ParallelHasher::Digest> *pResults, const WideStringView *pwsvPaths, std::size_t uCount){
+		MappedFile amfFiles[ParallelHasher::kBatchSize];
+		const void *apData[ParallelHasher::kBatchSize];
+		std::size_t auSizes[ParallelHasher::kBatchSize];
+		std::size_t auIndices[ParallelHasher::kBatchSize];
+		std::size_t uBatched = 0;
+
+		for(std::size_t uIndex = 0; uIndex < uCount; ++uIndex){
+			try {
+				const File vFile(pwsvPaths[uIndex], File::kToRead);
+				const auto u64Size = vFile.GetSize();
+				if(u64Size == 0){
+					// 长度为零的文件无法映射。
+					auSizes[uBatched] = 0;
+					apData[uBatched] = nullptr;
+					auIndices[uBatched] = uIndex;
+					++uBatched;
+					continue;
+				}
+				MappedFile vMapped(vFile, FileMapping::kReadOnly, MappedFile::kSequential);
+				if(u64Size > ParallelHasher::kMaxBatchedFileSize){
+					StreamT vStream;
+					std::uint64_t u64Offset = 0;
+					while(u64Offset < u64Size){
+						std::size_t uSize;
+						const auto pData = vMapped.MapAvailable(u64Offset, &uSize);
+						vStream.Put(pData, uSize);
+						u64Offset += uSize;
+					}
+					pResults[uIndex].Reset(MakeDigest(vStream.Finalize()));
+					continue;
+				}
+				auto uSize = static_cast<std::size_t>(u64Size);
+				apData[uBatched] = vMapped.Map(0, &uSize);
+				auSizes[uBatched] = uSize;
+				auIndices[uBatched] = uIndex;
+				amfFiles[uBatched].Swap(vMapped);
+				++uBatched;
+			} catch(...){
+				pResults[uIndex].Reset(std::current_exception());
+			}
+		}
+
+		Array<std::uint8_t, kSizeT> aabyResults[ParallelHasher::kBatchSize];
+		StreamT::HashMultiple(aabyResults, apData, auSizes, uBatched);
+		for(std::size_t uSlot = 0; uSlot < uBatched; ++uSlot){
+			pResults[auIndices[uSlot]].Reset(MakeDigest(aabyResults[uSlot]));
+		}
+	}
+}
+
+std::size_t ParallelHasher::GetDigestSize(Algorithm eAlgorithm) noexcept {
+	switch(eAlgorithm){
+	case kMd5:
+		return 16;
+	case kSha1:
+		return 20;
+	default:
+		return 32;
+	}
+}
+
+Vector<Optional<ParallelHasher::Digest>> ParallelHasher::HashFiles(const WideStringView *pwsvPaths, std::size_t uCount) const {
+	Vector<Optional<Digest>> vecResults(uCount);
+
+	Atomic<std::size_t> uNextBatch(0);
+	const auto uBatchCount = uCount / kBatchSize + (uCount % kBatchSize != 0);
+	const auto fnWorker = [&]{
+		for(;;){
+			const auto uBatch = uNextBatch.FetchAdd(1, kAtomicRelaxed);
+			if(uBatch >= uBatchCount){
+				break;
+			}
+			const auto uBegin = uBatch * kBatchSize;
+			const auto uSize = Min(uCount - uBegin, static_cast<std::size_t>(kBatchSize));
+			const auto pResults = vecResults.GetData() + uBegin;
+			switch(x_eAlgorithm){
+			case kMd5:
+				HashBatch<Md5OutputStream, 16>(pResults, pwsvPaths + uBegin, uSize);
+				break;
+			case kSha1:
+				HashBatch<Sha1OutputStream, 20>(pResults, pwsvPaths + uBegin, uSize);
+				break;
+			default:
+				HashBatch<Sha256OutputStream, 32>(pResults, pwsvPaths + uBegin, uSize);
+				break;
+			}
+		}
+	};
+
+	std::size_t uThreadCount = x_uThreadCount;
+	if(uThreadCount == 0){
+		::SYSTEM_INFO vSystemInfo;
+		::GetSystemInfo(&vSystemInfo);
+		uThreadCount = vSystemInfo.dwNumberOfProcessors;
+	}
+	uThreadCount = Min(uThreadCount, uBatchCount);
+
+	// 当前线程也参与计算，所以只需要创建 uThreadCount - 1 个线程。
+	Vector<IntrusivePtr<Thread>> vecThreads;
+	try {
+		vecThreads.Reserve(uThreadCount);
+		for(std::size_t uThread = 1; uThread < uThreadCount; ++uThread){
+			vecThreads.UncheckedPush(MakeThread(fnWorker));
+		}
+	} catch(...){
+		// 无法创建更多线程时，使用已经创建的线程完成计算。
+	}
+	fnWorker();
+	for(std::size_t uThread = 0; uThread < vecThreads.GetSize(); ++uThread){
+		vecThreads[uThread]->Wait();
+	}
+	return vecResults;
+}
+
+}
@@ -0,0 +1,64 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_UTILITIES_PARALLEL_HASHER_HPP_
+#define MCF_UTILITIES_PARALLEL_HASHER_HPP_
+
+#include "../Core/Array.hpp"
+#include "../Core/Optional.hpp"
+#include "../Core/StringView.hpp"
+#include "../Containers/Vector.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace MCF {
+
+// 使用多个线程计算大量文件的校验值。
+// 文件被分成若干批，每个线程每次取出一批，把其中的小文件映射到内存之后使用 HashMultiple() 并行计算。
+// 大文件不参与并行计算，而是在取出它的线程中按顺序单独计算。
+class ParallelHasher {
+public:
+	enum Algorithm : unsigned {
+		kMd5    = 0,
+		kSha1   = 1,
+		kSha256 = 2,
+	};
+
+	enum : std::size_t {
+		kBatchSize          = 16,
+		// 在 32 位平台上，每个线程同时映射的内存不超过 kBatchSize * kMaxBatchedFileSize 字节。
+		kMaxBatchedFileSize = 0x100000, // 1 MiB
+	};
+
+	// 只有前 GetDigestSize() 个字节有效，其余部分为零。
+	using Digest = Array<std::uint8_t, 32>;
+
+public:
+	static std::size_t GetDigestSize(Algorithm eAlgorithm) noexcept;
+
+private:
+	Algorithm x_eAlgorithm;
+	unsigned x_uThreadCount;
+
+public:
+	// uThreadCount 为零表示使用和处理器数目相同的线程。
+	explicit ParallelHasher(Algorithm eAlgorithm, unsigned uThreadCount = 0) noexcept
+		: x_eAlgorithm(eAlgorithm), x_uThreadCount(uThreadCount)
+	{ }
+
+public:
+	Algorithm GetAlgorithm() const noexcept {
+		return x_eAlgorithm;
+	}
+	unsigned GetThreadCount() const noexcept {
+		return x_uThreadCount;
+	}
+
+	// 返回值的第 i 个元素是 pwsvPaths[i] 指定的文件的校验值。无法读取的文件对应的元素中保存的是异常。
+	Vector<Optional<Digest>> HashFiles(const WideStringView *pwsvPaths, std::size_t uCount) const;
+};
+
+}
+
+#endif
@@ -0,0 +1,23 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#include "RcntsPool.hpp"
+#include "../Core/Atomic.hpp"
+
+namespace MCF {
+
+namespace Impl_RcntsPool {
+	std::size_t AllocatePoolId() noexcept {
+		static Atomic<std::size_t> s_uLastPoolId;
+
+		return s_uLastPoolId.Increment(kAtomicRelaxed);
+	}
+}
+
+template class RcntsPool<char>;
+template class RcntsPool<wchar_t>;
+template class RcntsPool<char16_t>;
+template class RcntsPool<char32_t>;
+
+}
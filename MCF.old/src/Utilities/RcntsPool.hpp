@@ -0,0 +1,222 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef MCF_UTILITIES_RCNTS_POOL_HPP_
+#define MCF_UTILITIES_RCNTS_POOL_HPP_
+
+#include "../Core/Rcnts.hpp"
+#include "../Core/Atomic.hpp"
+#include "../Core/MinMax.hpp"
+#include "../Containers/Vector.hpp"
+#include "../Thread/Mutex.hpp"
+#include <utility>
+#include <cstddef>
+
+namespace MCF {
+
+namespace Impl_RcntsPool {
+	// 返回一个非零的值，每次调用都不同。
+	extern std::size_t AllocatePoolId() noexcept;
+}
+
+// 字符串驻留池。对于每个不同的值，池中只保存一个副本。
+// 从同一个池中得到的字符串可以通过指针判断是否相等，它们的散列值也是预先计算好的。
+// 池被分成若干个分片，每个分片有自己的锁，可以被多个线程同时使用。
+// 池持有其中的字符串的引用，Purge() 释放不再被其他地方引用的字符串。
+template<typename CharT>
+class RcntsPool {
+public:
+	using Char = CharT;
+
+	enum : std::size_t {
+		kShardCount = 64,
+		kShardShift = sizeof(std::size_t) * 8 - 6,
+		kMinSlotCount = 16,
+	};
+
+private:
+	// 每个分片独占缓存行，不同线程锁定相邻的分片时不会发生伪共享。
+	struct alignas(_MCFCRT_CACHE_LINE_SIZE) X_Shard {
+		Mutex mtxGuard;
+		Vector<Rcnts<Char>> vecSlots; // 线性探测的散列表，大小是 2 的幂。空的 Rcnts 表示空槽。
+		std::size_t uCount = 0;
+	};
+
+	static std::size_t X_TruncateAtNull(const Char *pchBegin, std::size_t uLength) noexcept {
+		for(std::size_t uIndex = 0; uIndex < uLength; ++uIndex){
+			if(pchBegin[uIndex] == Char()){
+				return uIndex;
+			}
+		}
+		return uLength;
+	}
+	static bool X_Matches(const Rcnts<Char> &rcsSlot, std::size_t uHash, const Char *pchBegin, std::size_t uLength) noexcept {
+		if(rcsSlot.x_pHeader->uHash != uHash){
+			return false;
+		}
+		// 输入中没有空字符，所以遇到槽中字符串的结尾就会停下。
+		const auto pszSlot = rcsSlot.x_pszStr;
+		for(std::size_t uIndex = 0; uIndex < uLength; ++uIndex){
+			if(pszSlot[uIndex] != pchBegin[uIndex]){
+				return false;
+			}
+		}
+		return pszSlot[uLength] == Char();
+	}
+	static void X_Rehash(X_Shard &vShard, std::size_t uNewSlotCount){
+		Vector<Rcnts<Char>> vecNewSlots(uNewSlotCount);
+		const auto uMask = uNewSlotCount - 1;
+		for(std::size_t uOldIndex = 0; uOldIndex < vShard.vecSlots.GetSize(); ++uOldIndex){
+			auto &rcsSlot = vShard.vecSlots[uOldIndex];
+			if(!rcsSlot.x_pHeader){
+				continue;
+			}
+			auto uIndex = rcsSlot.x_pHeader->uHash & uMask;
+			while(vecNewSlots[uIndex].x_pHeader){
+				uIndex = (uIndex + 1) & uMask;
+			}
+			vecNewSlots[uIndex] = std::move(rcsSlot);
+		}
+		vShard.vecSlots.Swap(vecNewSlots);
+	}
+	// 删除一个槽，然后把后面的元素前移，使得探测序列不会中断。
+	static void X_EraseSlot(X_Shard &vShard, std::size_t uHole) noexcept {
+		const auto uMask = vShard.vecSlots.GetSize() - 1;
+		vShard.vecSlots[uHole].Clear();
+		--vShard.uCount;
+		auto uIndex = uHole;
+		for(;;){
+			uIndex = (uIndex + 1) & uMask;
+			auto &rcsSlot = vShard.vecSlots[uIndex];
+			if(!rcsSlot.x_pHeader){
+				break;
+			}
+			const auto uHome = rcsSlot.x_pHeader->uHash & uMask;
+			// 如果 uHome 在 (uHole, uIndex] 之间，这个元素不能移到空槽中。
+			const bool bStays = (uHole <= uIndex) ? ((uHole < uHome) && (uHome <= uIndex)) : ((uHole < uHome) || (uHome <= uIndex));
+			if(bStays){
+				continue;
+			}
+			vShard.vecSlots[uHole] = std::move(rcsSlot);
+			uHole = uIndex;
+		}
+	}
+
+private:
+	// Clear() 之后池得到一个新的标识，之前驻留的字符串与之后驻留的相等的字符串可以同时存在。
+	Atomic<std::size_t> x_uPoolId;
+	mutable X_Shard x_aShards[kShardCount];
+
+public:
+	RcntsPool() noexcept
+		: x_uPoolId(Impl_RcntsPool::AllocatePoolId())
+	{ }
+
+	RcntsPool(const RcntsPool &) = delete;
+	RcntsPool &operator=(const RcntsPool &) = delete;
+
+public:
+	// 嵌入的空字符之后的部分被忽略，这与 Rcnts 的比较语义一致。
+	Rcnts<Char> Intern(const Char *pchBegin, std::size_t uLength){
+		uLength = X_TruncateAtNull(pchBegin, uLength);
+		const auto uHash = Rcnts<Char>::X_Hash(pchBegin, uLength);
+		auto &vShard = x_aShards[uHash >> kShardShift];
+		const auto vLock = vShard.mtxGuard.GetLock();
+
+		if(vShard.vecSlots.GetSize() != 0){
+			const auto uMask = vShard.vecSlots.GetSize() - 1;
+			auto uIndex = uHash & uMask;
+			for(;;){
+				const auto &rcsSlot = vShard.vecSlots[uIndex];
+				if(!rcsSlot.x_pHeader){
+					break;
+				}
+				if(X_Matches(rcsSlot, uHash, pchBegin, uLength)){
+					return rcsSlot;
+				}
+				uIndex = (uIndex + 1) & uMask;
+			}
+		}
+
+		// 装载因子不超过 3/4。
+		if((vShard.uCount + 1) * 4 > vShard.vecSlots.GetSize() * 3){
+			X_Rehash(vShard, Max(vShard.vecSlots.GetSize() * 2, static_cast<std::size_t>(kMinSlotCount)));
+		}
+		auto rcsNew = Rcnts<Char>::X_Allocate(pchBegin, uLength, uHash, x_uPoolId.Load(kAtomicRelaxed));
+		const auto uMask = vShard.vecSlots.GetSize() - 1;
+		auto uIndex = uHash & uMask;
+		while(vShard.vecSlots[uIndex].x_pHeader){
+			uIndex = (uIndex + 1) & uMask;
+		}
+		vShard.vecSlots[uIndex] = rcsNew;
+		++vShard.uCount;
+		return rcsNew;
+	}
+	Rcnts<Char> Intern(const Char *pszBegin){
+		return Intern(pszBegin, Rcnts<Char>::X_Define(pszBegin));
+	}
+	Rcnts<Char> Intern(const Rcnts<Char> &rcsOther){
+		const auto pHeader = rcsOther.x_pHeader;
+		if(pHeader && (pHeader->uPoolId == x_uPoolId.Load(kAtomicRelaxed))){
+			return rcsOther;
+		}
+		return Intern(rcsOther.GetStr());
+	}
+
+	std::size_t GetSize() const noexcept {
+		std::size_t uSize = 0;
+		for(auto &vShard : x_aShards){
+			const auto vLock = vShard.mtxGuard.GetLock();
+			uSize += vShard.uCount;
+		}
+		return uSize;
+	}
+	// 释放只被池引用的字符串，返回释放的数目。
+	std::size_t Purge() noexcept {
+		std::size_t uPurged = 0;
+		for(auto &vShard : x_aShards){
+			const auto vLock = vShard.mtxGuard.GetLock();
+			std::size_t uIndex = 0;
+			while(uIndex < vShard.vecSlots.GetSize()){
+				const auto &rcsSlot = vShard.vecSlots[uIndex];
+				// 持有锁的时候，其他线程无法从池中得到新的引用，所以这里的判断是可靠的。
+				if(rcsSlot.x_pHeader && (rcsSlot.x_pHeader->uRef.Load(kAtomicAcquire) == 1)){
+					X_EraseSlot(vShard, uIndex);
+					++uPurged;
+					// 后面的元素可能被移到了这个槽中，需要再检查一次。
+					continue;
+				}
+				++uIndex;
+			}
+		}
+		return uPurged;
+	}
+	void Clear() noexcept {
+		// 必须同时锁定所有的分片，否则在更换标识的过程中，其他线程可能用同一个标识驻留两个相等的字符串。
+		for(auto &vShard : x_aShards){
+			vShard.mtxGuard.Lock();
+		}
+		x_uPoolId.Store(Impl_RcntsPool::AllocatePoolId(), kAtomicRelaxed);
+		for(auto &vShard : x_aShards){
+			vShard.vecSlots.Clear();
+			vShard.uCount = 0;
+			vShard.mtxGuard.Unlock();
+		}
+	}
+};
+
+extern template class RcntsPool<char>;
+extern template class RcntsPool<wchar_t>;
+extern template class RcntsPool<char16_t>;
+extern template class RcntsPool<char32_t>;
+
+using RcntnsPool   = RcntsPool<char>;
+using RcntwsPool   = RcntsPool<wchar_t>;
+using Rcntu8sPool  = RcntsPool<char>;
+using Rcntu16sPool = RcntsPool<char16_t>;
+using Rcntu32sPool = RcntsPool<char32_t>;
+
+}
+
+#endif
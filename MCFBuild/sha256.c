@@ -6,8 +6,123 @@
 #include "endian.h"
 #include <x86intrin.h> // __rord
 #include <intrin.h> // __stosb, __movsb
+#include <immintrin.h>
+#include <cpuid.h>
 
 // https://en.wikipedia.org/wiki/SHA-2
+// https://software.intel.com/en-us/articles/intel-sha-extensions
+// https://www.intel.com/content/dam/www/public/us/en/documents/white-papers/communications-ia-multi-buffer-paper.pdf
+
+static const uint32_t g_au32RoundConstants[64] __attribute__((__aligned__(16))) = {
+	0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+	0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+	0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+	0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+	0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+	0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+	0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+	0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2,
+};
+static const uint32_t g_au32InitialRegs[8] = {
+	0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19,
+};
+
+// CPU feature detection. The result is cached. Races are harmless since every thread computes the same value.
+#define SHA256_CPU_DETECTED   1u
+#define SHA256_CPU_SHA        2u
+#define SHA256_CPU_AVX2       4u
+
+static unsigned sha256_get_cpu_features(void){
+	static volatile unsigned s_uFeatures;
+	unsigned uFeatures = s_uFeatures;
+	if(uFeatures != 0){
+		return uFeatures;
+	}
+	uFeatures = SHA256_CPU_DETECTED;
+	unsigned eax, ebx, ecx, edx;
+	__cpuid(0, eax, ebx, ecx, edx);
+	const unsigned uMaxLeaf = eax;
+	__cpuid(1, eax, ebx, ecx, edx);
+	const bool bSse41 = (ecx >> 19) & 1;
+	bool bYmmEnabled = false;
+	if(((ecx >> 27) & 1) && ((ecx >> 28) & 1)){
+		// OSXSAVE and AVX are both set. Check whether the OS saves YMM registers.
+		unsigned uXcr0Lo, uXcr0Hi;
+		__asm__ volatile ("xgetbv" : "=a"(uXcr0Lo), "=d"(uXcr0Hi) : "c"(0));
+		(void)uXcr0Hi;
+		bYmmEnabled = (uXcr0Lo & 6) == 6;
+	}
+	if(uMaxLeaf >= 7){
+		__cpuid_count(7, 0, eax, ebx, ecx, edx);
+		if(bSse41 && ((ebx >> 29) & 1)){
+			uFeatures |= SHA256_CPU_SHA;
+		}
+		if(bYmmEnabled && ((ebx >> 5) & 1)){
+			uFeatures |= SHA256_CPU_AVX2;
+		}
+	}
+	s_uFeatures = uFeatures;
+	return uFeatures;
+}
+
+// SHA-NI implementation. Each pair of `sha256rnds2` instructions performs four rounds.
+// `m0` is the group of four message words being consumed. `*pm1` and `*pm3` are the groups after and before it,
+// which are updated in place to produce the message words of later groups.
+__attribute__((__target__("sha,sse4.1"), __always_inline__))
+static inline void sha256_shani_round_group(__m128i *restrict pxmmAbef, __m128i *restrict pxmmCdgh, unsigned uGroup, __m128i m0, __m128i *restrict pm1, __m128i *restrict pm3){
+	__m128i xmmWk = _mm_add_epi32(m0, _mm_load_si128((const __m128i *)g_au32RoundConstants + uGroup));
+	*pxmmCdgh = _mm_sha256rnds2_epu32(*pxmmCdgh, *pxmmAbef, xmmWk);
+	if((uGroup >= 3) && (uGroup < 15)){
+		*pm1 = _mm_add_epi32(*pm1, _mm_alignr_epi8(m0, *pm3, 4));
+		*pm1 = _mm_sha256msg2_epu32(*pm1, m0);
+	}
+	xmmWk = _mm_shuffle_epi32(xmmWk, 0x0E);
+	*pxmmAbef = _mm_sha256rnds2_epu32(*pxmmAbef, *pxmmCdgh, xmmWk);
+	if((uGroup >= 1) && (uGroup < 13)){
+		*pm3 = _mm_sha256msg1_epu32(*pm3, m0);
+	}
+}
+
+__attribute__((__target__("sha,sse4.1")))
+static void sha256_chunks_shani(uint32_t *restrict regs, const unsigned char *restrict chunks, size_t count){
+	const __m128i xmmByteSwap = _mm_set_epi64x(0x0C0D0E0F08090A0B, 0x0405060700010203);
+	// The SHA instructions take registers in the order of ABEF and CDGH.
+	const __m128i xmmDcba = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)regs + 0), 0xB1);
+	const __m128i xmmHgfe = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)regs + 1), 0x1B);
+	__m128i xmmAbef = _mm_alignr_epi8(xmmDcba, xmmHgfe, 8);
+	__m128i xmmCdgh = _mm_blend_epi16(xmmHgfe, xmmDcba, 0xF0);
+	for(size_t i = 0; i < count; ++i){
+		const __m128i xmmAbefSaved = xmmAbef;
+		const __m128i xmmCdghSaved = xmmCdgh;
+		const __m128i *pxmmChunk = (const __m128i *)(chunks + i * 64);
+		__m128i m0 = _mm_shuffle_epi8(_mm_loadu_si128(pxmmChunk + 0), xmmByteSwap);
+		__m128i m1 = _mm_shuffle_epi8(_mm_loadu_si128(pxmmChunk + 1), xmmByteSwap);
+		__m128i m2 = _mm_shuffle_epi8(_mm_loadu_si128(pxmmChunk + 2), xmmByteSwap);
+		__m128i m3 = _mm_shuffle_epi8(_mm_loadu_si128(pxmmChunk + 3), xmmByteSwap);
+		sha256_shani_round_group(&xmmAbef, &xmmCdgh, 0, m0, &m1, &m3);
+		sha256_shani_round_group(&xmmAbef, &xmmCdgh, 1, m1, &m2, &m0);
+		sha256_shani_round_group(&xmmAbef, &xmmCdgh, 2, m2, &m3, &m1);
+		sha256_shani_round_group(&xmmAbef, &xmmCdgh, 3, m3, &m0, &m2);
+		sha256_shani_round_group(&xmmAbef, &xmmCdgh, 4, m0, &m1, &m3);
+		sha256_shani_round_group(&xmmAbef, &xmmCdgh, 5, m1, &m2, &m0);
+		sha256_shani_round_group(&xmmAbef, &xmmCdgh, 6, m2, &m3, &m1);
+		sha256_shani_round_group(&xmmAbef, &xmmCdgh, 7, m3, &m0, &m2);
+		sha256_shani_round_group(&xmmAbef, &xmmCdgh, 8, m0, &m1, &m3);
+		sha256_shani_round_group(&xmmAbef, &xmmCdgh, 9, m1, &m2, &m0);
+		sha256_shani_round_group(&xmmAbef, &xmmCdgh, 10, m2, &m3, &m1);
+		sha256_shani_round_group(&xmmAbef, &xmmCdgh, 11, m3, &m0, &m2);
+		sha256_shani_round_group(&xmmAbef, &xmmCdgh, 12, m0, &m1, &m3);
+		sha256_shani_round_group(&xmmAbef, &xmmCdgh, 13, m1, &m2, &m0);
+		sha256_shani_round_group(&xmmAbef, &xmmCdgh, 14, m2, &m3, &m1);
+		sha256_shani_round_group(&xmmAbef, &xmmCdgh, 15, m3, &m0, &m2);
+		xmmAbef = _mm_add_epi32(xmmAbef, xmmAbefSaved);
+		xmmCdgh = _mm_add_epi32(xmmCdgh, xmmCdghSaved);
+	}
+	const __m128i xmmFeba = _mm_shuffle_epi32(xmmAbef, 0x1B);
+	const __m128i xmmDchg = _mm_shuffle_epi32(xmmCdgh, 0xB1);
+	_mm_storeu_si128((__m128i *)regs + 0, _mm_blend_epi16(xmmFeba, xmmDchg, 0xF0));
+	_mm_storeu_si128((__m128i *)regs + 1, _mm_alignr_epi8(xmmDchg, xmmFeba, 8));
+}
 
 static inline void sha256_round(uint32_t *restrict r, size_t a, size_t b, size_t c, size_t d, size_t e, size_t f, size_t g, size_t h, uint32_t k, uint32_t x){
 	uint32_t S0 = __rord(r[a], 2) ^ __rord(r[a], 13) ^ __rord(r[a], 22);
@@ -112,6 +227,137 @@ static void sha256_chunk(uint32_t *restrict regs, const unsigned char *restrict
 	}
 }
 
+// Multi-buffer AVX2 implementation, which hashes eight independent chunks at once.
+// `regs[i][j]` is the i-th register of the j-th lane.
+__attribute__((__target__("avx2")))
+static inline __m256i sha256_ror_avx2(__m256i x, int n){
+	return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));
+}
+__attribute__((__target__("avx2")))
+static void sha256_load_transposed_avx2(__m256i *restrict w, const unsigned char *const *restrict chunks, size_t offset){
+	const __m256i ymmByteSwap = _mm256_set_epi64x(0x0C0D0E0F08090A0B, 0x0405060700010203, 0x0C0D0E0F08090A0B, 0x0405060700010203);
+	__m256i rows[8];
+	for(unsigned i = 0; i < 8; ++i){
+		rows[i] = _mm256_loadu_si256((const __m256i *)(chunks[i] + offset));
+	}
+	// This is an ordinary 8x8 transposition of 32-bit words.
+	const __m256i t0 = _mm256_unpacklo_epi32(rows[0], rows[1]);
+	const __m256i t1 = _mm256_unpackhi_epi32(rows[0], rows[1]);
+	const __m256i t2 = _mm256_unpacklo_epi32(rows[2], rows[3]);
+	const __m256i t3 = _mm256_unpackhi_epi32(rows[2], rows[3]);
+	const __m256i t4 = _mm256_unpacklo_epi32(rows[4], rows[5]);
+	const __m256i t5 = _mm256_unpackhi_epi32(rows[4], rows[5]);
+	const __m256i t6 = _mm256_unpacklo_epi32(rows[6], rows[7]);
+	const __m256i t7 = _mm256_unpackhi_epi32(rows[6], rows[7]);
+	const __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+	const __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+	const __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+	const __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+	const __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+	const __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+	const __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+	const __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+	w[0] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u0, u4, 0x20), ymmByteSwap);
+	w[1] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u1, u5, 0x20), ymmByteSwap);
+	w[2] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u2, u6, 0x20), ymmByteSwap);
+	w[3] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u3, u7, 0x20), ymmByteSwap);
+	w[4] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u0, u4, 0x31), ymmByteSwap);
+	w[5] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u1, u5, 0x31), ymmByteSwap);
+	w[6] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u2, u6, 0x31), ymmByteSwap);
+	w[7] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u3, u7, 0x31), ymmByteSwap);
+}
+__attribute__((__target__("avx2")))
+static void sha256_chunks_avx2(uint32_t (*restrict regs)[8], const unsigned char *const *restrict chunks){
+	__m256i w[16];
+	sha256_load_transposed_avx2(w + 0, chunks,  0);
+	sha256_load_transposed_avx2(w + 8, chunks, 32);
+
+	__m256i r[8];
+	for(unsigned i = 0; i < 8; ++i){
+		r[i] = _mm256_loadu_si256((const __m256i *)regs[i]);
+	}
+	__m256i a = r[0], b = r[1], c = r[2], d = r[3], e = r[4], f = r[5], g = r[6], h = r[7];
+	for(unsigned i = 0; i < 64; ++i){
+		if(i >= 16){
+			const __m256i w15 = w[(i - 15) % 16];
+			const __m256i w2 = w[(i - 2) % 16];
+			const __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(sha256_ror_avx2(w15, 7), sha256_ror_avx2(w15, 18)), _mm256_srli_epi32(w15, 3));
+			const __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(sha256_ror_avx2(w2, 17), sha256_ror_avx2(w2, 19)), _mm256_srli_epi32(w2, 10));
+			w[i % 16] = _mm256_add_epi32(_mm256_add_epi32(w[i % 16], w[(i - 7) % 16]), _mm256_add_epi32(s0, s1));
+		}
+		const __m256i S0 = _mm256_xor_si256(_mm256_xor_si256(sha256_ror_avx2(a, 2), sha256_ror_avx2(a, 13)), sha256_ror_avx2(a, 22));
+		const __m256i maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_xor_si256(a, b)));
+		const __m256i t2 = _mm256_add_epi32(S0, maj);
+		const __m256i S1 = _mm256_xor_si256(_mm256_xor_si256(sha256_ror_avx2(e, 6), sha256_ror_avx2(e, 11)), sha256_ror_avx2(e, 25));
+		const __m256i ch = _mm256_xor_si256(g, _mm256_and_si256(e, _mm256_xor_si256(f, g)));
+		const __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(_mm256_add_epi32(h, S1), _mm256_add_epi32(ch, w[i % 16])), _mm256_set1_epi32((int)g_au32RoundConstants[i]));
+		h = g;
+		g = f;
+		f = e;
+		e = _mm256_add_epi32(d, t1);
+		d = c;
+		c = b;
+		b = a;
+		a = _mm256_add_epi32(t1, t2);
+	}
+	_mm256_storeu_si256((__m256i *)regs[0], _mm256_add_epi32(r[0], a));
+	_mm256_storeu_si256((__m256i *)regs[1], _mm256_add_epi32(r[1], b));
+	_mm256_storeu_si256((__m256i *)regs[2], _mm256_add_epi32(r[2], c));
+	_mm256_storeu_si256((__m256i *)regs[3], _mm256_add_epi32(r[3], d));
+	_mm256_storeu_si256((__m256i *)regs[4], _mm256_add_epi32(r[4], e));
+	_mm256_storeu_si256((__m256i *)regs[5], _mm256_add_epi32(r[5], f));
+	_mm256_storeu_si256((__m256i *)regs[6], _mm256_add_epi32(r[6], g));
+	_mm256_storeu_si256((__m256i *)regs[7], _mm256_add_epi32(r[7], h));
+}
+
+// This is the state of a single lane of the multi-buffer implementation.
+typedef struct sha256_lane {
+	bool bActive;
+	size_t uIndex;
+	const unsigned char *pbyRead;
+	size_t uChunksRemaining;
+	// The last one or two chunks, which have been padded, are stored here.
+	unsigned char au8Tail[128];
+	size_t uTailOffset;
+	size_t uTailEnd;
+} sha256_lane;
+
+static void sha256_lane_start(sha256_lane *restrict pLane, size_t uIndex, const void *pData, size_t uSize){
+	const size_t uBytesInTail = uSize % 64;
+	pLane->bActive = true;
+	pLane->uIndex = uIndex;
+	pLane->pbyRead = pData;
+	pLane->uChunksRemaining = uSize / 64;
+	if(uBytesInTail != 0){
+		__movsb(pLane->au8Tail, (const unsigned char *)pData + uSize - uBytesInTail, uBytesInTail);
+	}
+	pLane->au8Tail[uBytesInTail] = 0x80;
+	pLane->uTailOffset = 0;
+	pLane->uTailEnd = (uBytesInTail < 56) ? 64 : 128;
+	__stosb(pLane->au8Tail + uBytesInTail + 1, 0, pLane->uTailEnd - 8 - uBytesInTail - 1);
+	MCFBUILD_store_be_uint64((uint64_t *)(pLane->au8Tail + pLane->uTailEnd) - 1, (uint64_t)uSize * 8);
+}
+static const unsigned char *sha256_lane_next_chunk(sha256_lane *restrict pLane){
+	const unsigned char *pbyChunk;
+	if(pLane->uChunksRemaining != 0){
+		pbyChunk = pLane->pbyRead;
+		pLane->pbyRead += 64;
+		--(pLane->uChunksRemaining);
+	} else {
+		pbyChunk = pLane->au8Tail + pLane->uTailOffset;
+		pLane->uTailOffset += 64;
+	}
+	return pbyChunk;
+}
+static inline bool sha256_lane_is_done(const sha256_lane *pLane){
+	return (pLane->uChunksRemaining == 0) && (pLane->uTailOffset == pLane->uTailEnd);
+}
+static void sha256_store_result(MCFBUILD_Sha256 *restrict pSha256, const uint32_t *restrict regs){
+	for(unsigned uIndex = 0; uIndex < 8; ++uIndex){
+		MCFBUILD_store_be_uint32((uint32_t *)pSha256 + uIndex, regs[uIndex]);
+	}
+}
+
 void MCFBUILD_Sha256Initialize(MCFBUILD_Sha256Context *pContext){
 	// Fill in hard-coded values.
 	pContext->au32Regs[0] = 0x6A09E667;
@@ -138,6 +384,10 @@ void MCFBUILD_Sha256Update(MCFBUILD_Sha256Context *restrict pContext, const void
 			sha256_chunk(pContext->au32Regs, pContext->au8Chunk);
 		}
 		// Avoid copying data to the internal chunk over and over by reading from the input area directly.
+		if((uRemaining >= 64) && (sha256_get_cpu_features() & SHA256_CPU_SHA)){
+			sha256_chunks_shani(pContext->au32Regs, (const unsigned char *)pData + uSize - uRemaining, uRemaining / 64);
+			uRemaining %= 64;
+		}
 		while(uRemaining >= 64){
 			sha256_chunk(pContext->au32Regs, (const unsigned char *)pData + uSize - uRemaining);
 			uRemaining -= 64;
@@ -173,9 +423,7 @@ void MCFBUILD_Sha256Finalize(MCFBUILD_Sha256 *restrict pSha256, MCFBUILD_Sha256C
 	MCFBUILD_store_be_uint64((uint64_t *)pContext->au8Chunk + 7, pContext->u64BitsTotal);
 	sha256_chunk(pContext->au32Regs, pContext->au8Chunk);
 	// Copy the hash out.
-	for(unsigned uIndex = 0; uIndex < 8; ++uIndex){
-		MCFBUILD_store_be_uint32((uint32_t *)pSha256 + uIndex, pContext->au32Regs[uIndex]);
-	}
+	sha256_store_result(pSha256, pContext->au32Regs);
 }
 
 void MCFBUILD_Sha256Simple(MCFBUILD_Sha256 *pSha256, const void *pData, size_t uSize){
@@ -185,6 +433,75 @@ void MCFBUILD_Sha256Simple(MCFBUILD_Sha256 *pSha256, const void *pData, size_t u
 	MCFBUILD_Sha256Finalize(pSha256, &vContext);
 }
 
+void MCFBUILD_Sha256SimpleMultiple(MCFBUILD_Sha256 *pSha256s, const void *const *ppData, const size_t *puSizes, size_t uCount){
+	size_t uNextIndex = 0;
+	// SHA-NI is faster than eight AVX2 lanes, so the multi-buffer implementation is only used when the former is unavailable.
+	const unsigned uFeatures = sha256_get_cpu_features();
+	if(!(uFeatures & SHA256_CPU_SHA) && (uFeatures & SHA256_CPU_AVX2) && (uCount >= 3)){
+		// Lanes that have nothing to do hash this chunk, and their results are discarded.
+		static const unsigned char s_au8IdleChunk[64];
+		sha256_lane vLanes[8];
+		uint32_t au32Regs[8][8];
+		const unsigned char *apbyChunks[8];
+		size_t uActiveCount = 0;
+		for(unsigned uLane = 0; uLane < 8; ++uLane){
+			vLanes[uLane].bActive = false;
+		}
+		for(;;){
+			// Assign pending messages to idle lanes.
+			for(unsigned uLane = 0; uLane < 8; ++uLane){
+				if(vLanes[uLane].bActive || (uNextIndex == uCount)){
+					continue;
+				}
+				sha256_lane_start(vLanes + uLane, uNextIndex, ppData[uNextIndex], puSizes[uNextIndex]);
+				for(unsigned uReg = 0; uReg < 8; ++uReg){
+					au32Regs[uReg][uLane] = g_au32InitialRegs[uReg];
+				}
+				++uNextIndex;
+				++uActiveCount;
+			}
+			// If only a few lanes remain, they are finished one by one, as running eight lanes at once is no longer worthwhile.
+			if(uActiveCount <= 2){
+				break;
+			}
+			for(unsigned uLane = 0; uLane < 8; ++uLane){
+				apbyChunks[uLane] = vLanes[uLane].bActive ? sha256_lane_next_chunk(vLanes + uLane) : s_au8IdleChunk;
+			}
+			sha256_chunks_avx2(au32Regs, apbyChunks);
+			for(unsigned uLane = 0; uLane < 8; ++uLane){
+				if(!vLanes[uLane].bActive || !sha256_lane_is_done(vLanes + uLane)){
+					continue;
+				}
+				uint32_t au32Result[8];
+				for(unsigned uReg = 0; uReg < 8; ++uReg){
+					au32Result[uReg] = au32Regs[uReg][uLane];
+				}
+				sha256_store_result(pSha256s + vLanes[uLane].uIndex, au32Result);
+				vLanes[uLane].bActive = false;
+				--uActiveCount;
+			}
+		}
+		for(unsigned uLane = 0; uLane < 8; ++uLane){
+			if(!vLanes[uLane].bActive){
+				continue;
+			}
+			uint32_t au32Result[8];
+			for(unsigned uReg = 0; uReg < 8; ++uReg){
+				au32Result[uReg] = au32Regs[uReg][uLane];
+			}
+			while(!sha256_lane_is_done(vLanes + uLane)){
+				sha256_chunk(au32Result, sha256_lane_next_chunk(vLanes + uLane));
+			}
+			sha256_store_result(pSha256s + vLanes[uLane].uIndex, au32Result);
+		}
+	}
+	// Hash everything else one by one.
+	while(uNextIndex < uCount){
+		MCFBUILD_Sha256Simple(pSha256s + uNextIndex, ppData[uNextIndex], puSizes[uNextIndex]);
+		++uNextIndex;
+	}
+}
+
 size_t MCFBUILD_Sha256Print(wchar_t *restrict pwcBuffer, size_t uBufferLength, const MCFBUILD_Sha256 *restrict pSha256, bool bUpperCase){
 	static const wchar_t kHexTable[] = L"00112233445566778899aAbBcCdDeEfF";
 	size_t uCharactersWritten = 0;
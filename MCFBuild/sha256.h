@@ -27,6 +27,9 @@ extern void MCFBUILD_Sha256Finalize(MCFBUILD_Sha256 *MCFBUILD_RESTRICT pau8Sha25
 
 // This function works everything out in a single call.
 extern void MCFBUILD_Sha256Simple(MCFBUILD_Sha256 *pau8Sha256, const void *pData, MCFBUILD_STD size_t uSize) MCFBUILD_NOEXCEPT;
+// This function calculates checksums of `uCount` independent messages, storing the checksum of the message `ppData[i]` of `puSizes[i]` bytes into `pSha256s[i]`.
+// It uses SHA extensions if available, otherwise it hashes up to eight messages at once using AVX2, which is much faster than hashing them one by one.
+extern void MCFBUILD_Sha256SimpleMultiple(MCFBUILD_Sha256 *pSha256s, const void *const *ppData, const MCFBUILD_STD size_t *puSizes, MCFBUILD_STD size_t uCount) MCFBUILD_NOEXCEPT;
 
 // This function converts an SHA-256 checksum to a hexadecimal string and returns the number of characters written, not including the null terminator, if any.
 // If the buffer is smaller than 64 characters, the string is truncated and no null terminator is appended.
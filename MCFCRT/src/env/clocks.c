@@ -7,7 +7,10 @@
 #include "mcfwin.h"
 #include "bail.h"
 #include "once_flag.h"
+#include "mutex.h"
+#include "expect.h"
 #include "xassert.h"
+#include <cpuid.h>
 
 static _MCFCRT_OnceFlag g_once;
 static uint64_t g_tz_bias;
@@ -74,3 +77,184 @@ double _MCFCRT_GetHiResMonoClock(void){
 	FetchParametersOnce();
 	return ((double)pc_cntr.QuadPart + MONO_CLOCK_OFFSET * 5) * g_pc_freq_recip;
 }
+
+// 纳秒时钟的参数由 seqlock 保护，读者不需要加锁。
+typedef struct tagNanoClockParams {
+	uint64_t tsc_base;
+	uint64_t ns_base;
+	uint64_t scale; // 每个 TSC 周期的纳秒数，32.32 定点数。
+	uint64_t tsc_limit; // 参数只用于小于这个值的 TSC，达到之后需要重新校准。
+} NanoClockParams;
+
+static _MCFCRT_OnceFlag g_nano_once;
+static bool g_nano_use_tsc;
+static uint64_t g_nano_pc_freq;
+
+static uint32_t g_nano_seq;
+static NanoClockParams g_nano_params;
+
+// 初次校准的时间很短，因此误差较大。此后每当距离初次校准的时间变为原来的八倍时，就重新校准一次，直到超过一分钟。
+// 旧的参数只用于 tsc_limit 之前的 TSC，新的参数从旧参数在 tsc_limit 处的值开始，因此无论比例变大还是变小，时钟都不会回退。
+static _MCFCRT_Mutex g_nano_refine_mutex;
+static uint64_t g_nano_calib_tsc;
+static uint64_t g_nano_calib_pc;
+
+static uint64_t QueryPerformanceCounterOrBail(void){
+	LARGE_INTEGER pc_cntr;
+	if(!QueryPerformanceCounter(&pc_cntr)){
+		_MCFCRT_Bail(L"QueryPerformanceCounter() 失败。");
+	}
+	return (uint64_t)pc_cntr.QuadPart;
+}
+static uint64_t PerformanceCounterToNanoseconds(uint64_t pc){
+	const uint64_t freq = g_nano_pc_freq;
+	return pc / freq * 1000000000u + pc % freq * 1000000000u / freq;
+}
+// 同时读取 TSC 和 QPC，返回 TSC 的中间值。
+// 读取 QPC 可能被中断或者发生缺页，因此尝试多次，选择 TSC 的间隔最短的一次。
+static uint64_t ReadTimeStampCounterAndPerformanceCounter(uint64_t *restrict pc_out){
+	uint64_t tsc_best = 0, width_best = UINT64_MAX;
+	for(unsigned i = 0; i < 5; ++i){
+		const uint64_t tsc_before = _MCFCRT_ReadTimeStampCounter64();
+		const uint64_t pc = QueryPerformanceCounterOrBail();
+		const uint64_t tsc_after = _MCFCRT_ReadTimeStampCounter64();
+		const uint64_t width = tsc_after - tsc_before;
+		if(width < width_best){
+			tsc_best = tsc_before + width / 2;
+			width_best = width;
+			*pc_out = pc;
+		}
+	}
+	return tsc_best;
+}
+static uint64_t CalculateScale(uint64_t tsc_delta, uint64_t ns_delta){
+	if(tsc_delta == 0){
+		return 0;
+	}
+	return (uint64_t)((long double)ns_delta * 0x1p32l / (long double)tsc_delta);
+}
+static inline uint64_t ScaleTimeStampCounterDelta(uint64_t tsc_delta, uint64_t scale){
+	// 等价于 (tsc_delta * scale) >> 32，但是中间结果不会溢出。
+	const uint64_t delta_hi = tsc_delta >> 32, delta_lo = tsc_delta & 0xFFFFFFFFu;
+	const uint64_t scale_hi = scale >> 32, scale_lo = scale & 0xFFFFFFFFu;
+	return tsc_delta * scale_hi + delta_hi * scale_lo + ((delta_lo * scale_lo) >> 32);
+}
+static void PublishNanoClockParams(const NanoClockParams *params){
+	const uint32_t seq = __atomic_load_n(&g_nano_seq, __ATOMIC_RELAXED);
+	__atomic_store_n(&g_nano_seq, seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	__atomic_store_n(&(g_nano_params.tsc_base), params->tsc_base, __ATOMIC_RELAXED);
+	__atomic_store_n(&(g_nano_params.ns_base),  params->ns_base,  __ATOMIC_RELAXED);
+	__atomic_store_n(&(g_nano_params.scale),    params->scale,    __ATOMIC_RELAXED);
+	__atomic_store_n(&(g_nano_params.tsc_limit), params->tsc_limit, __ATOMIC_RELAXED);
+	__atomic_store_n(&g_nano_seq, seq + 2, __ATOMIC_RELEASE);
+}
+static void LoadNanoClockParams(NanoClockParams *params){
+	uint32_t seq;
+	for(;;){
+		seq = __atomic_load_n(&g_nano_seq, __ATOMIC_ACQUIRE);
+		if(_MCFCRT_EXPECT_NOT(seq & 1)){
+			__builtin_ia32_pause();
+			continue;
+		}
+		params->tsc_base = __atomic_load_n(&(g_nano_params.tsc_base), __ATOMIC_RELAXED);
+		params->ns_base  = __atomic_load_n(&(g_nano_params.ns_base),  __ATOMIC_RELAXED);
+		params->scale    = __atomic_load_n(&(g_nano_params.scale),    __ATOMIC_RELAXED);
+		params->tsc_limit = __atomic_load_n(&(g_nano_params.tsc_limit), __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if(_MCFCRT_EXPECT(__atomic_load_n(&g_nano_seq, __ATOMIC_RELAXED) == seq)){
+			break;
+		}
+	}
+}
+static inline uint64_t CalculateNanoseconds(const NanoClockParams *params, uint64_t tsc){
+	// 不同 CPU 上的 TSC 可能有微小的差异。不要让结果回退到基准值之前。
+	// 超过 tsc_limit 的部分不能使用这组参数，否则结果可能大于下一组参数的结果。没有抢到校准的线程在这里停留片刻。
+	const uint64_t tsc_clamped = (tsc < params->tsc_limit) ? tsc : params->tsc_limit;
+	const uint64_t tsc_delta = (tsc_clamped > params->tsc_base) ? (tsc_clamped - params->tsc_base) : 0;
+	return params->ns_base + ScaleTimeStampCounterDelta(tsc_delta, params->scale);
+}
+
+static void FetchNanoClockParametersOnce(void){
+	const _MCFCRT_OnceResult result = _MCFCRT_WaitForOnceFlagForever(&g_nano_once);
+	if(result == _MCFCRT_kOnceResultFinished){
+		return;
+	}
+	_MCFCRT_ASSERT(result == _MCFCRT_kOnceResultInitial);
+
+	LARGE_INTEGER pc_freq;
+	if(!QueryPerformanceFrequency(&pc_freq)){
+		_MCFCRT_Bail(L"QueryPerformanceFrequency() 失败。");
+	}
+	g_nano_pc_freq = (uint64_t)pc_freq.QuadPart;
+
+	// Reference:
+	//   Intel® 64 and IA-32 Architectures Software Developer’s Manual, Volume 3B:
+	//     17.17.1 Invariant TSC
+	unsigned eax, ebx, ecx, edx;
+	if((__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) != 0) && (eax >= 0x80000007)){
+		__cpuid(0x80000007, eax, ebx, ecx, edx);
+		g_nano_use_tsc = (edx >> 8) & 1;
+	}
+	if(g_nano_use_tsc){
+		// 等待至少一毫秒，得到一个初始的比例。
+		uint64_t pc_begin, pc_end;
+		const uint64_t tsc_begin = ReadTimeStampCounterAndPerformanceCounter(&pc_begin);
+		uint64_t tsc_end;
+		do {
+			__builtin_ia32_pause();
+			tsc_end = ReadTimeStampCounterAndPerformanceCounter(&pc_end);
+		} while(pc_end - pc_begin < g_nano_pc_freq / 1000 + 1);
+
+		NanoClockParams params;
+		params.tsc_base = tsc_end;
+		params.ns_base = PerformanceCounterToNanoseconds(pc_end);
+		params.scale = CalculateScale(tsc_end - tsc_begin, PerformanceCounterToNanoseconds(pc_end) - PerformanceCounterToNanoseconds(pc_begin));
+		params.tsc_limit = tsc_begin + (tsc_end - tsc_begin) * 8;
+		g_nano_calib_tsc = tsc_begin;
+		g_nano_calib_pc = pc_begin;
+		PublishNanoClockParams(&params);
+	}
+
+	_MCFCRT_SignalOnceFlagAsFinished(&g_nano_once);
+}
+__attribute__((__noinline__)) static void RefineNanoClockParams(void){
+	// 只需要一个线程进行校准，其他线程继续使用旧的参数。
+	if(!_MCFCRT_WaitForMutex(&g_nano_refine_mutex, 0, 0)){
+		return;
+	}
+	NanoClockParams params;
+	LoadNanoClockParams(&params);
+	uint64_t pc_now;
+	const uint64_t tsc_now = ReadTimeStampCounterAndPerformanceCounter(&pc_now);
+	// 其他线程可能已经校准过了。
+	if(tsc_now >= params.tsc_limit){
+		// 新的参数从旧的参数在 tsc_limit 处的值开始。
+		// 使用旧参数的线程得到的结果都不超过这个值，而使用新参数的线程得到的结果都不小于这个值。
+		const uint64_t tsc_base = params.tsc_limit;
+		params.ns_base = CalculateNanoseconds(&params, tsc_base);
+		params.tsc_base = tsc_base;
+		params.scale = CalculateScale(tsc_now - g_nano_calib_tsc, PerformanceCounterToNanoseconds(pc_now) - PerformanceCounterToNanoseconds(g_nano_calib_pc));
+		params.tsc_limit = UINT64_MAX;
+		if(pc_now - g_nano_calib_pc < g_nano_pc_freq * 60){
+			params.tsc_limit = g_nano_calib_tsc + (tsc_now - g_nano_calib_tsc) * 8;
+		}
+		PublishNanoClockParams(&params);
+	}
+	_MCFCRT_SignalMutex(&g_nano_refine_mutex);
+}
+
+uint64_t _MCFCRT_GetMonoNanoClock(void){
+	FetchNanoClockParametersOnce();
+	if(_MCFCRT_EXPECT_NOT(!g_nano_use_tsc)){
+		return PerformanceCounterToNanoseconds(QueryPerformanceCounterOrBail()) + MONO_CLOCK_OFFSET * 7;
+	}
+	NanoClockParams params;
+	LoadNanoClockParams(&params);
+	const uint64_t tsc = _MCFCRT_ReadTimeStampCounter64();
+	if(_MCFCRT_EXPECT_NOT(tsc >= params.tsc_limit)){
+		RefineNanoClockParams();
+		LoadNanoClockParams(&params);
+	}
+	return CalculateNanoseconds(&params, tsc) + MONO_CLOCK_OFFSET * 7;
+}
@@ -28,6 +28,9 @@ extern _MCFCRT_STD uint64_t _MCFCRT_GetLocalClockFromUtc(_MCFCRT_STD uint64_t __
 
 extern _MCFCRT_STD uint64_t _MCFCRT_GetFastMonoClock(void) _MCFCRT_NOEXCEPT;
 extern double _MCFCRT_GetHiResMonoClock(void) _MCFCRT_NOEXCEPT;
+// 单位为纳秒。如果 CPU 支持不变 TSC，则直接读取 TSC，否则使用 QueryPerformanceCounter()。
+// 第一次调用时需要大约一毫秒进行校准。
+extern _MCFCRT_STD uint64_t _MCFCRT_GetMonoNanoClock(void) _MCFCRT_NOEXCEPT;
 
 _MCFCRT_EXTERN_C_END
 
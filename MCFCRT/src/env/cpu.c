@@ -40,6 +40,7 @@ void __MCFCRT_CpuResetFloatingPointEnvironment(void){
 
 static _MCFCRT_OnceFlag g_once;
 static unsigned g_cache_sizes[_MCFCRT_kCpuCacheLevelMax + 1];
+static bool g_features[_MCFCRT_kCpuFeatureMax];
 
 static void FetchCpuInfoOnce(void){
 	const _MCFCRT_OnceResult result = _MCFCRT_WaitForOnceFlagForever(&g_once);
@@ -70,6 +71,38 @@ static void FetchCpuInfoOnce(void){
 	g_cache_sizes[_MCFCRT_kCpuCacheLevelMin] = g_cache_sizes[_MCFCRT_kCpuCacheLevel1];
 	g_cache_sizes[_MCFCRT_kCpuCacheLevelMax] = g_cache_sizes[level - 1];
 
+	// Reference:
+	//   Intel® 64 and IA-32 Architectures Software Developer’s Manual, Volume 2 (2A, 2B & 2C):
+	//     Table 3-8. Information Returned by CPUID Instruction
+	//   Intel® 64 and IA-32 Architectures Software Developer’s Manual, Volume 1:
+	//     14.3 Detection of Intel® AVX Instructions
+	unsigned eax, ebx, ecx, edx;
+	__cpuid(0x00, eax, ebx, ecx, edx);
+	const unsigned max_leaf = eax;
+	__cpuid(0x01, eax, ebx, ecx, edx);
+	g_features[_MCFCRT_kCpuFeatureSse41]  = (ecx >> 19) & 1;
+	g_features[_MCFCRT_kCpuFeatureSse42]  = (ecx >> 20) & 1;
+	g_features[_MCFCRT_kCpuFeaturePclmul] = (ecx >>  1) & 1;
+	bool ymm_enabled = false;
+	if(((ecx >> 27) & 1) && ((ecx >> 28) & 1)){
+		// OSXSAVE and AVX are both set. Check whether XMM and YMM states are enabled in XCR0.
+		unsigned xcr0_lo, xcr0_hi;
+		__asm__ volatile (
+			"xgetbv \n"
+			: "=a"(xcr0_lo), "=d"(xcr0_hi)
+			: "c"(0)
+		);
+		(void)xcr0_hi;
+		ymm_enabled = (xcr0_lo & 0x06) == 0x06;
+	}
+	g_features[_MCFCRT_kCpuFeatureAvx]    = ymm_enabled;
+	if(max_leaf >= 0x07){
+		__cpuid_count(0x07, 0, eax, ebx, ecx, edx);
+		g_features[_MCFCRT_kCpuFeatureAvx2] = ymm_enabled && ((ebx >> 5) & 1);
+		g_features[_MCFCRT_kCpuFeatureBmi2] = (ebx >>  8) & 1;
+		g_features[_MCFCRT_kCpuFeatureSha]  = (ebx >> 29) & 1;
+	}
+
 	_MCFCRT_SignalOnceFlagAsFinished(&g_once);
 }
 
@@ -80,3 +113,10 @@ size_t _MCFCRT_CpuGetCacheSize(_MCFCRT_CpuCacheLevel level){
 	FetchCpuInfoOnce();
 	return g_cache_sizes[level];
 }
+bool _MCFCRT_CpuHasFeature(_MCFCRT_CpuFeature feature){
+	if(_MCFCRT_EXPECT_NOT((unsigned)feature >= _MCFCRT_kCpuFeatureMax)){
+		return false;
+	}
+	FetchCpuInfoOnce();
+	return g_features[feature];
+}
@@ -24,6 +24,21 @@ typedef enum __MCFCRT_tagCpuCacheLevel {
 // For `_MCFCRT_kCpuCacheLevelMax` : Returns the size of the last level of cache.
 extern _MCFCRT_STD size_t _MCFCRT_CpuGetCacheSize(_MCFCRT_CpuCacheLevel __level) _MCFCRT_NOEXCEPT;
 
+typedef enum __MCFCRT_tagCpuFeature {
+	_MCFCRT_kCpuFeatureSse41  = 0,
+	_MCFCRT_kCpuFeatureSse42  = 1,
+	_MCFCRT_kCpuFeaturePclmul = 2,
+	_MCFCRT_kCpuFeatureAvx    = 3,
+	_MCFCRT_kCpuFeatureAvx2   = 4,
+	_MCFCRT_kCpuFeatureBmi2   = 5,
+	_MCFCRT_kCpuFeatureSha    = 6,
+	_MCFCRT_kCpuFeatureMax    = 7,
+} _MCFCRT_CpuFeature;
+
+// Returns whether the specified instruction set extension is supported by both the CPU and the OS.
+// AVX and AVX2 are reported only if the OS saves YMM registers across context switches.
+extern bool _MCFCRT_CpuHasFeature(_MCFCRT_CpuFeature __feature) _MCFCRT_NOEXCEPT;
+
 _MCFCRT_EXTERN_C_END
 
 #endif
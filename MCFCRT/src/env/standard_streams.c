@@ -130,13 +130,8 @@ static DWORD UnlockedConvertBinaryToText(Stream *restrict pStream, bool bExhaust
 		const char *pchRead = (void *)(pStream->pbyBuffer + pStream->uBinaryBegin);
 		const char *const pchReadEnd = (void *)(pStream->pbyBuffer + pStream->uBinaryEnd);
 		wchar_t *pwcWrite = (void *)(pStream->pbyBuffer + pStream->uTextEnd);
-		for(;;){
-			char32_t c32CodePoint = _MCFCRT_DecodeUtf8(&pchRead, pchReadEnd, true);
-			if(!_MCFCRT_UTF_SUCCESS(c32CodePoint)){
-				break;
-			}
-			_MCFCRT_UncheckedEncodeUtf16(&pwcWrite, c32CodePoint, true);
-		}
+		wchar_t *const pwcWriteEnd = (void *)(pStream->pbyBuffer + pStream->uTextEnd + uTextSizeAdd);
+		_MCFCRT_TranscodeUtf8ToUtf16(&pwcWrite, pwcWriteEnd, &pchRead, pchReadEnd, _MCFCRT_UTF_PERMISSIVE);
 		if(bExhaust){
 			while(pchRead != pchReadEnd){
 				_MCFCRT_UncheckedEncodeUtf16(&pwcWrite, (uint8_t)*(pchRead++), true);
@@ -162,13 +157,8 @@ static DWORD UnlockedConvertTextToBinary(Stream *restrict pStream, bool bExhaust
 		const wchar_t *pwcRead = (void *)(pStream->pbyBuffer + pStream->uTextBegin);
 		const wchar_t *const pwcReadEnd = (void *)(pStream->pbyBuffer + pStream->uTextEnd);
 		char *pchWrite = (void *)(pStream->pbyBuffer + pStream->uBinaryEnd);
-		for(;;){
-			char32_t c32CodePoint = _MCFCRT_DecodeUtf16(&pwcRead, pwcReadEnd, true);
-			if(!_MCFCRT_UTF_SUCCESS(c32CodePoint)){
-				break;
-			}
-			_MCFCRT_UncheckedEncodeUtf8(&pchWrite, c32CodePoint, true);
-		}
+		char *const pchWriteEnd = (void *)(pStream->pbyBuffer + pStream->uBinaryEnd + uBinarySizeAdd);
+		_MCFCRT_TranscodeUtf16ToUtf8(&pchWrite, pchWriteEnd, &pwcRead, pwcReadEnd, _MCFCRT_UTF_PERMISSIVE);
 		if(bExhaust){
 			while(pwcRead != pwcReadEnd){
 				_MCFCRT_UncheckedEncodeUtf8(&pchWrite, (uint16_t)*(pwcRead++), true);
@@ -0,0 +1,185 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef __MCFCRT_EXT_DIGITS_H_
+#define __MCFCRT_EXT_DIGITS_H_
+
+#include "../env/_crtdef.h"
+#include <tmmintrin.h>
+
+_MCFCRT_EXTERN_C_BEGIN
+
+__attribute__((__selectany__)) extern const char __MCFCRT_decimal_digit_pairs[200];
+__attribute__((__selectany__)) extern const _MCFCRT_STD uint64_t __MCFCRT_decimal_powers[20];
+
+const char __MCFCRT_decimal_digit_pairs[200] = {
+	'0','0', '0','1', '0','2', '0','3', '0','4', '0','5', '0','6', '0','7', '0','8', '0','9',
+	'1','0', '1','1', '1','2', '1','3', '1','4', '1','5', '1','6', '1','7', '1','8', '1','9',
+	'2','0', '2','1', '2','2', '2','3', '2','4', '2','5', '2','6', '2','7', '2','8', '2','9',
+	'3','0', '3','1', '3','2', '3','3', '3','4', '3','5', '3','6', '3','7', '3','8', '3','9',
+	'4','0', '4','1', '4','2', '4','3', '4','4', '4','5', '4','6', '4','7', '4','8', '4','9',
+	'5','0', '5','1', '5','2', '5','3', '5','4', '5','5', '5','6', '5','7', '5','8', '5','9',
+	'6','0', '6','1', '6','2', '6','3', '6','4', '6','5', '6','6', '6','7', '6','8', '6','9',
+	'7','0', '7','1', '7','2', '7','3', '7','4', '7','5', '7','6', '7','7', '7','8', '7','9',
+	'8','0', '8','1', '8','2', '8','3', '8','4', '8','5', '8','6', '8','7', '8','8', '8','9',
+	'9','0', '9','1', '9','2', '9','3', '9','4', '9','5', '9','6', '9','7', '9','8', '9','9',
+};
+const _MCFCRT_STD uint64_t __MCFCRT_decimal_powers[20] = {
+	1u,
+	10u,
+	100u,
+	1000u,
+	10000u,
+	100000u,
+	1000000u,
+	10000000u,
+	100000000u,
+	1000000000u,
+	10000000000u,
+	100000000000u,
+	1000000000000u,
+	10000000000000u,
+	100000000000000u,
+	1000000000000000u,
+	10000000000000000u,
+	100000000000000000u,
+	1000000000000000000u,
+	10000000000000000000u,
+};
+
+// 返回 __value 的十进制位数。0 被认为有一位。
+__attribute__((__always_inline__)) static inline unsigned __MCFCRT_CountDecimalDigits(_MCFCRT_STD uint64_t __value) _MCFCRT_NOEXCEPT {
+	// 1233 / 4096 是 log10(2) 的近似值，这里得到的结果可能比实际位数少一。
+	const unsigned __bits = 64 - (unsigned)__builtin_clzll(__value | 1);
+	const unsigned __approx = (__bits * 1233) >> 12;
+	return __approx + ((__value | 1) >= __MCFCRT_decimal_powers[__approx]);
+}
+// 返回 __value 的十六进制位数。0 被认为有一位。
+__attribute__((__always_inline__)) static inline unsigned __MCFCRT_CountHexadecimalDigits(_MCFCRT_STD uint64_t __value) _MCFCRT_NOEXCEPT {
+	const unsigned __bits = 64 - (unsigned)__builtin_clzll(__value | 1);
+	return (__bits + 3) / 4;
+}
+
+// 返回第一个不是十进制数字的字符的位置。
+__attribute__((__always_inline__)) static inline const char *__MCFCRT_SkipDecimalDigits(const char *__str) _MCFCRT_NOEXCEPT {
+	// 如果 __arp 是对齐到字的，就不用考虑越界的问题。
+	// 因为内存按页分配的，也自然对齐到页，并且也对齐到字。
+	// 每个字内的字节的权限必然一致。
+	const char *__arp = (const char *)((_MCFCRT_STD uintptr_t)__str & (_MCFCRT_STD uintptr_t)-16);
+	// 把 '0' 到 '9' 映射到 -128 到 -119，然后作有符号比较。
+	const __m128i __bias = _mm_set1_epi8((char)(0x80 - '0'));
+	const __m128i __limit = _mm_set1_epi8((char)(-128 + 10));
+	__m128i __word = _mm_load_si128((const __m128i *)__arp);
+	_MCFCRT_STD uint32_t __mask = ~(_MCFCRT_STD uint32_t)_mm_movemask_epi8(_mm_cmplt_epi8(_mm_add_epi8(__word, __bias), __limit)) & 0xFFFF;
+	__mask &= (_MCFCRT_STD uint32_t)-1 << (__str - __arp);
+	while(__mask == 0){
+		__arp += 16;
+		__word = _mm_load_si128((const __m128i *)__arp);
+		__mask = ~(_MCFCRT_STD uint32_t)_mm_movemask_epi8(_mm_cmplt_epi8(_mm_add_epi8(__word, __bias), __limit)) & 0xFFFF;
+	}
+	return __arp + (unsigned)__builtin_ctz(__mask);
+}
+__attribute__((__always_inline__)) static inline const wchar_t *__MCFCRT_SkipDecimalDigitsW(const wchar_t *__str) _MCFCRT_NOEXCEPT {
+	const char *__arp = (const char *)((_MCFCRT_STD uintptr_t)__str & (_MCFCRT_STD uintptr_t)-16);
+	// 把 L'0' 到 L'9' 映射到 -32768 到 -32759，然后作有符号比较。
+	const __m128i __bias = _mm_set1_epi16((short)(0x8000 - L'0'));
+	const __m128i __limit = _mm_set1_epi16((short)(-32768 + 10));
+	__m128i __word = _mm_load_si128((const __m128i *)__arp);
+	_MCFCRT_STD uint32_t __mask = ~(_MCFCRT_STD uint32_t)_mm_movemask_epi8(_mm_cmplt_epi16(_mm_add_epi16(__word, __bias), __limit)) & 0xFFFF;
+	__mask &= (_MCFCRT_STD uint32_t)-1 << ((const char *)__str - __arp);
+	while(__mask == 0){
+		__arp += 16;
+		__word = _mm_load_si128((const __m128i *)__arp);
+		__mask = ~(_MCFCRT_STD uint32_t)_mm_movemask_epi8(_mm_cmplt_epi16(_mm_add_epi16(__word, __bias), __limit)) & 0xFFFF;
+	}
+	return (const wchar_t *)(__arp + (unsigned)__builtin_ctz(__mask));
+}
+
+// 同上，但是最多检查 __max 个字符，不会读取 [__str, __str + __max) 以外的内存。
+// 先逐个检查直到对齐，然后只加载完全处于范围内的对齐的块，最后逐个检查剩下的字符。
+__attribute__((__always_inline__)) static inline const char *__MCFCRT_SkipDecimalDigitsN(const char *__str, _MCFCRT_STD size_t __max) _MCFCRT_NOEXCEPT {
+	const char *__rp = __str;
+	const char *const __end = __str + __max;
+	while(((_MCFCRT_STD uintptr_t)__rp & 15) != 0){
+		if((__rp == __end) || ((unsigned)(*__rp - '0') >= 10)){
+			return __rp;
+		}
+		++__rp;
+	}
+	const __m128i __bias = _mm_set1_epi8((char)(0x80 - '0'));
+	const __m128i __limit = _mm_set1_epi8((char)(-128 + 10));
+	while((_MCFCRT_STD size_t)(__end - __rp) >= 16){
+		const __m128i __word = _mm_load_si128((const __m128i *)__rp);
+		const _MCFCRT_STD uint32_t __mask = ~(_MCFCRT_STD uint32_t)_mm_movemask_epi8(_mm_cmplt_epi8(_mm_add_epi8(__word, __bias), __limit)) & 0xFFFF;
+		if(__mask != 0){
+			return __rp + (unsigned)__builtin_ctz(__mask);
+		}
+		__rp += 16;
+	}
+	while((__rp != __end) && ((unsigned)(*__rp - '0') < 10)){
+		++__rp;
+	}
+	return __rp;
+}
+__attribute__((__always_inline__)) static inline const wchar_t *__MCFCRT_SkipDecimalDigitsNW(const wchar_t *__str, _MCFCRT_STD size_t __max) _MCFCRT_NOEXCEPT {
+	const wchar_t *__rp = __str;
+	const wchar_t *const __end = __str + __max;
+	while(((_MCFCRT_STD uintptr_t)__rp & 15) != 0){
+		if((__rp == __end) || ((unsigned)(*__rp - L'0') >= 10)){
+			return __rp;
+		}
+		++__rp;
+	}
+	const __m128i __bias = _mm_set1_epi16((short)(0x8000 - L'0'));
+	const __m128i __limit = _mm_set1_epi16((short)(-32768 + 10));
+	while((_MCFCRT_STD size_t)(__end - __rp) >= 8){
+		const __m128i __word = _mm_load_si128((const __m128i *)__rp);
+		const _MCFCRT_STD uint32_t __mask = ~(_MCFCRT_STD uint32_t)_mm_movemask_epi8(_mm_cmplt_epi16(_mm_add_epi16(__word, __bias), __limit)) & 0xFFFF;
+		if(__mask != 0){
+			return __rp + (unsigned)__builtin_ctz(__mask) / 2;
+		}
+		__rp += 8;
+	}
+	while((__rp != __end) && ((unsigned)(*__rp - L'0') < 10)){
+		++__rp;
+	}
+	return __rp;
+}
+
+// 下面的函数要求所有输入的字符都是十进制数字。
+// 每个字节中存放一个 0 到 9 之间的值，最高位在前。
+__attribute__((__always_inline__)) static inline __m128i __MCFCRT_xmmdigits_to_4x32(__m128i __bytes) _MCFCRT_NOEXCEPT {
+	// 相邻的两个数字合并为一个 16 位整数，然后相邻的两个 16 位整数合并为一个 32 位整数。
+	__m128i __word = _mm_maddubs_epi16(__bytes, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+	__word = _mm_madd_epi16(__word, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+	return __word;
+}
+__attribute__((__always_inline__)) static inline _MCFCRT_STD uint32_t __MCFCRT_ConvertEightDecimalDigits(const char *__str) _MCFCRT_NOEXCEPT {
+	__m128i __word = _mm_loadl_epi64((const __m128i *)__str);
+	__word = __MCFCRT_xmmdigits_to_4x32(_mm_sub_epi8(__word, _mm_set1_epi8('0')));
+	__word = _mm_packs_epi32(__word, __word);
+	__word = _mm_madd_epi16(__word, _mm_setr_epi16(10000, 1, 0, 0, 0, 0, 0, 0));
+	return (_MCFCRT_STD uint32_t)_mm_cvtsi128_si32(__word);
+}
+__attribute__((__always_inline__)) static inline _MCFCRT_STD uint64_t __MCFCRT_ConvertSixteenDecimalDigits(const char *__str) _MCFCRT_NOEXCEPT {
+	__m128i __word = _mm_loadu_si128((const __m128i *)__str);
+	__word = __MCFCRT_xmmdigits_to_4x32(_mm_sub_epi8(__word, _mm_set1_epi8('0')));
+	__word = _mm_packs_epi32(__word, __word);
+	__word = _mm_madd_epi16(__word, _mm_setr_epi16(10000, 1, 10000, 1, 0, 0, 0, 0));
+	const _MCFCRT_STD uint32_t __hi = (_MCFCRT_STD uint32_t)_mm_cvtsi128_si32(__word);
+	const _MCFCRT_STD uint32_t __lo = (_MCFCRT_STD uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(__word, 4));
+	return (_MCFCRT_STD uint64_t)__hi * 100000000u + __lo;
+}
+__attribute__((__always_inline__)) static inline _MCFCRT_STD uint32_t __MCFCRT_ConvertEightDecimalDigitsW(const wchar_t *__str) _MCFCRT_NOEXCEPT {
+	__m128i __word = _mm_loadu_si128((const __m128i *)__str);
+	__word = _mm_sub_epi16(__word, _mm_set1_epi16(L'0'));
+	__word = __MCFCRT_xmmdigits_to_4x32(_mm_packus_epi16(__word, __word));
+	__word = _mm_packs_epi32(__word, __word);
+	__word = _mm_madd_epi16(__word, _mm_setr_epi16(10000, 1, 0, 0, 0, 0, 0, 0));
+	return (_MCFCRT_STD uint32_t)_mm_cvtsi128_si32(__word);
+}
+
+_MCFCRT_EXTERN_C_END
+
+#endif
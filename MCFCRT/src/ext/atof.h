@@ -0,0 +1,25 @@
+// 这个文件是 MCF 的一部分。
+// 有关具体授权说明，请参阅 MCFLicense.txt。
+// Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef __MCFCRT_EXT_ATOF_H_
+#define __MCFCRT_EXT_ATOF_H_
+
+#include "../env/_crtdef.h"
+
+_MCFCRT_EXTERN_C_BEGIN
+
+typedef enum __MCFCRT_tag_atof_result {
+	_MCFCRT_atof_result_success         = 0,
+	_MCFCRT_atof_result_no_digit        = 1,
+	_MCFCRT_atof_result_would_overflow  = 2, // 结果为正负无穷大。
+	_MCFCRT_atof_result_would_underflow = 3, // 结果为正负零。
+} _MCFCRT_atof_result;
+
+// 结果总是按照 IEEE 754 舍入到最近的双精度浮点数（四舍六入五凑双）。
+// 接受 `inf`、`infinity` 和 `nan`（不区分大小写）。
+extern char * _MCFCRT_atof_d(_MCFCRT_atof_result *_MCFCRT_RESTRICT __result_out, double *_MCFCRT_RESTRICT __value_out, const char *_MCFCRT_RESTRICT __buffer) _MCFCRT_NOEXCEPT;
+
+_MCFCRT_EXTERN_C_END
+
+#endif
@@ -3,28 +3,86 @@
 // Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
 
 #include "atoi.h"
-#include "rep_scas.h"
+#include "_digits.h"
 
-__attribute__((__always_inline__)) static inline char * Really_atoi_u(_MCFCRT_atoi_result *restrict result_out, uintptr_t *restrict value_out, const char *restrict buffer, unsigned max_digits, uintptr_t bound, const char *restrict dual_table, unsigned radix){
+// 这么多位十进制数字既不会使 uintptr_t 溢出，也不会使 intptr_t 溢出。
+#define SAFE_DECIMAL_DIGITS     ((sizeof(uintptr_t) >= 8) ? 18u : 9u)
+
+__attribute__((__always_inline__)) static inline char * Really_atoi_d(_MCFCRT_atoi_result *restrict result_out, uintptr_t *restrict value_out, const char *restrict buffer, unsigned max_digits, uintptr_t bound){
+	// Find the end of digits. Do not look beyond `max_digits` characters if it is specified.
+	size_t digits_total;
+	if(max_digits == UINT_MAX){
+		digits_total = (size_t)(__MCFCRT_SkipDecimalDigits(buffer) - buffer);
+	} else {
+		digits_total = (size_t)(__MCFCRT_SkipDecimalDigitsN(buffer, max_digits) - buffer);
+	}
+	_MCFCRT_atoi_result result = _MCFCRT_atoi_result_no_digit;
+	size_t digits_read = 0;
+	uintptr_t word = 0;
+	// Parse leading digits that cannot overflow, sixteen or eight at a time.
+	const size_t digits_safe = (digits_total < SAFE_DECIMAL_DIGITS) ? digits_total : SAFE_DECIMAL_DIGITS;
+	if((sizeof(uintptr_t) >= 8) && (digits_safe >= 16)){
+		word = (uintptr_t)__MCFCRT_ConvertSixteenDecimalDigits(buffer);
+		digits_read = 16;
+	}
+	while(digits_safe - digits_read >= 8){
+		word = word * 100000000 + __MCFCRT_ConvertEightDecimalDigits(buffer + digits_read);
+		digits_read += 8;
+	}
+	while(digits_read < digits_safe){
+		word = word * 10 + (unsigned)(buffer[digits_read] - '0');
+		++digits_read;
+	}
+	if(digits_read != 0){
+		result = _MCFCRT_atoi_result_success;
+	}
+	// Parse remaining digits one by one.
+	while(digits_read < digits_total){
+		const unsigned digit_value = (unsigned)(buffer[digits_read] - '0');
+		// Check for overflow.
+		const uintptr_t digit_bound = (bound - digit_value) / 10;
+		if(word > digit_bound){
+			result = _MCFCRT_atoi_result_would_overflow;
+			break;
+		}
+		word *= 10;
+		word += digit_value;
+		++digits_read;
+	}
+	*result_out = result;
+	*value_out = word;
+	return (char *)buffer + digits_read;
+}
+
+static inline unsigned GetHexDigitValue(char digit){
+	// Handle lower and upper cases universally.
+	unsigned digit_value = (unsigned char)(digit - '0');
+	if(digit_value < 10){
+		return digit_value;
+	}
+	digit_value = (unsigned char)((digit | 0x20) - 'a');
+	if(digit_value < 6){
+		return digit_value + 10;
+	}
+	return 16;
+}
+
+__attribute__((__always_inline__)) static inline char * Really_atoi_x(_MCFCRT_atoi_result *restrict result_out, uintptr_t *restrict value_out, const char *restrict buffer, unsigned max_digits){
 	unsigned digits_read = 0;
 	_MCFCRT_atoi_result result = _MCFCRT_atoi_result_no_digit;
 	// Parse digits.
 	uintptr_t word = 0;
 	while(digits_read + 1 <= max_digits){
-		const char digit = buffer[digits_read];
-		// Search for this digit in the table. Handle lower and upper cases universally.
-		uint8_t *digit_in_table;
-		if(_MCFCRT_repnz_scasb(&digit_in_table, (const uint8_t *)dual_table, (uint8_t)digit, radix * 2) != 0){
+		const unsigned digit_value = GetHexDigitValue(buffer[digits_read]);
+		if(digit_value >= 16){
 			break;
 		}
-		const unsigned digit_value = (unsigned)((const char *)digit_in_table - dual_table) / 2;
 		// Check for overflow.
-		const uintptr_t digit_bound = (bound - digit_value) / radix;
-		if(word > digit_bound){
+		if(word > UINTPTR_MAX / 16){
 			result = _MCFCRT_atoi_result_would_overflow;
 			break;
 		}
-		word *= radix;
+		word *= 16;
 		word += digit_value;
 		++digits_read;
 		result = _MCFCRT_atoi_result_success;
@@ -47,7 +105,7 @@ char * _MCFCRT_atoi0d(_MCFCRT_atoi_result *restrict result_out, intptr_t *restri
 		++begin;
 	}
 	uintptr_t abs;
-	char *end = Really_atoi_u(result_out, &abs, begin, max_digits, INTPTR_MAX ^ mask, "00112233445566778899", 10);
+	char *end = Really_atoi_d(result_out, &abs, begin, max_digits, INTPTR_MAX ^ mask);
 	*value_out = (intptr_t)((abs ^ mask) - mask);
 	return end;
 }
@@ -56,19 +114,62 @@ char * _MCFCRT_atoi_u(_MCFCRT_atoi_result *restrict result_out, uintptr_t *restr
 	return _MCFCRT_atoi0u(result_out, value_out, buffer, UINT_MAX);
 }
 char * _MCFCRT_atoi0u(_MCFCRT_atoi_result *restrict result_out, uintptr_t *restrict value_out, const char *restrict buffer, unsigned max_digits){
-	return Really_atoi_u(result_out, value_out, buffer, max_digits, UINTPTR_MAX, "00112233445566778899", 10);
+	return Really_atoi_d(result_out, value_out, buffer, max_digits, UINTPTR_MAX);
 }
 
 char * _MCFCRT_atoi_x(_MCFCRT_atoi_result *restrict result_out, uintptr_t *restrict value_out, const char *restrict buffer){
 	return _MCFCRT_atoi0x(result_out, value_out, buffer, UINT_MAX);
 }
 char * _MCFCRT_atoi0x(_MCFCRT_atoi_result *restrict result_out, uintptr_t *restrict value_out, const char *restrict buffer, unsigned max_digits){
-	return Really_atoi_u(result_out, value_out, buffer, max_digits, UINTPTR_MAX, "00112233445566778899aAbBcCdDeEfF", 16);
+	return Really_atoi_x(result_out, value_out, buffer, max_digits);
 }
 
 char * _MCFCRT_atoi_X(_MCFCRT_atoi_result *restrict result_out, uintptr_t *restrict value_out, const char *restrict buffer){
 	return _MCFCRT_atoi0X(result_out, value_out, buffer, UINT_MAX);
 }
 char * _MCFCRT_atoi0X(_MCFCRT_atoi_result *restrict result_out, uintptr_t *restrict value_out, const char *restrict buffer, unsigned max_digits){
-	return Really_atoi_u(result_out, value_out, buffer, max_digits, UINTPTR_MAX, "00112233445566778899aAbBcCdDeEfF", 16);
+	return Really_atoi_x(result_out, value_out, buffer, max_digits);
+}
+
+char * _MCFCRT_atoiN_d(_MCFCRT_atoi_result *restrict result_out, size_t *restrict count_out, intptr_t *restrict values_out, size_t max_count, const char *restrict buffer, char delimiter){
+	const char *rp = buffer;
+	_MCFCRT_atoi_result result = _MCFCRT_atoi_result_success;
+	size_t count = 0;
+	while(count < max_count){
+		if(count != 0){
+			if(*rp != delimiter){
+				break;
+			}
+			++rp;
+		}
+		rp = _MCFCRT_atoi0d(&result, values_out + count, rp, UINT_MAX);
+		if(result != _MCFCRT_atoi_result_success){
+			break;
+		}
+		++count;
+	}
+	*result_out = result;
+	*count_out = count;
+	return (char *)rp;
+}
+char * _MCFCRT_atoiN_u(_MCFCRT_atoi_result *restrict result_out, size_t *restrict count_out, uintptr_t *restrict values_out, size_t max_count, const char *restrict buffer, char delimiter){
+	const char *rp = buffer;
+	_MCFCRT_atoi_result result = _MCFCRT_atoi_result_success;
+	size_t count = 0;
+	while(count < max_count){
+		if(count != 0){
+			if(*rp != delimiter){
+				break;
+			}
+			++rp;
+		}
+		rp = Really_atoi_d(&result, values_out + count, rp, UINT_MAX, UINTPTR_MAX);
+		if(result != _MCFCRT_atoi_result_success){
+			break;
+		}
+		++count;
+	}
+	*result_out = result;
+	*count_out = count;
+	return (char *)rp;
 }
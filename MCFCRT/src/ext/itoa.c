@@ -3,30 +3,51 @@
 // Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
 
 #include "itoa.h"
-#include "rep_movs.h"
+#include "_digits.h"
 
-__attribute__((__always_inline__)) static inline char * Really_itoa_u(char *restrict buffer, uintptr_t value, unsigned min_digits, const char *restrict table, unsigned radix){
-	char temp[64];
-	char *const end = temp + 64;
-
-	unsigned digits_written = 0;
-	// Write digits in reverse order.
+__attribute__((__always_inline__)) static inline char * Really_itoa_d(char *restrict buffer, uintptr_t value, unsigned min_digits){
+	const unsigned digits = __MCFCRT_CountDecimalDigits(value);
+	// Pad it with zeroes unless it exceeds the minimum length.
+	unsigned padding = 0;
+	if(digits < min_digits){
+		padding = min_digits - digits;
+		__builtin_memset(buffer, '0', padding);
+	}
+	char *const end = buffer + padding + digits;
+	// Write digits in reverse order, two digits at a time.
+	char *wp = end;
 	uintptr_t word = value;
-	do {
-		const unsigned digit_value = (unsigned)(word % radix);
-		word /= radix;
-		const char digit = table[digit_value];
-		++digits_written;
-		*(end - digits_written) = digit;
-	} while(word != 0);
+	while(word >= 100){
+		const unsigned pair = (unsigned)(word % 100);
+		word /= 100;
+		wp -= 2;
+		__builtin_memcpy(wp, __MCFCRT_decimal_digit_pairs + pair * 2, 2);
+	}
+	if(word >= 10){
+		wp -= 2;
+		__builtin_memcpy(wp, __MCFCRT_decimal_digit_pairs + word * 2, 2);
+	} else {
+		*(wp - 1) = (char)('0' + word);
+	}
+	return end;
+}
+__attribute__((__always_inline__)) static inline char * Really_itoa_x(char *restrict buffer, uintptr_t value, unsigned min_digits, const char *restrict table){
+	const unsigned digits = __MCFCRT_CountHexadecimalDigits(value);
 	// Pad it with zeroes unless it exceeds the minimum length.
-	while(digits_written < min_digits){
-		const char digit = table[0];
-		++digits_written;
-		*(end - digits_written) = digit;
+	unsigned padding = 0;
+	if(digits < min_digits){
+		padding = min_digits - digits;
+		__builtin_memset(buffer, '0', padding);
 	}
-	// Copy it to the correct location.
-	return (char *)_MCFCRT_rep_movsb(_MCFCRT_NULLPTR, (uint8_t *)buffer, (const uint8_t *)end - digits_written, digits_written);
+	char *const end = buffer + padding + digits;
+	// Write digits in reverse order.
+	char *wp = end;
+	uintptr_t word = value;
+	for(unsigned i = 0; i < digits; ++i){
+		*(--wp) = table[word % 16];
+		word /= 16;
+	}
+	return end;
 }
 
 char * _MCFCRT_itoa_d(char *buffer, intptr_t value){
@@ -39,7 +60,7 @@ char * _MCFCRT_itoa0d(char *buffer, intptr_t value, unsigned min_digits){
 		*(begin++) = '-';
 		mask = ~mask;
 	}
-	return Really_itoa_u(begin, ((uintptr_t)value ^ mask) - mask, min_digits, "0123456789", 10);
+	return Really_itoa_d(begin, ((uintptr_t)value ^ mask) - mask, min_digits);
 }
 
 char * _MCFCRT_itoaS_d(char *buffer, intptr_t value){
@@ -54,26 +75,53 @@ char * _MCFCRT_itoaS0d(char *buffer, intptr_t value, unsigned min_digits){
 	} else {
 		*(begin++) = '+';
 	}
-	return Really_itoa_u(begin, ((uintptr_t)value ^ mask) - mask, min_digits, "0123456789", 10);
+	return Really_itoa_d(begin, ((uintptr_t)value ^ mask) - mask, min_digits);
 }
 
 char * _MCFCRT_itoa_u(char *buffer, uintptr_t value){
 	return _MCFCRT_itoa0u(buffer, value, 0);
 }
 char * _MCFCRT_itoa0u(char *buffer, uintptr_t value, unsigned min_digits){
-	return Really_itoa_u(buffer, value, min_digits, "0123456789", 10);
+	return Really_itoa_d(buffer, value, min_digits);
 }
 
 char * _MCFCRT_itoa_x(char *buffer, uintptr_t value){
 	return _MCFCRT_itoa0x(buffer, value, 0);
 }
 char * _MCFCRT_itoa0x(char *buffer, uintptr_t value, unsigned min_digits){
-	return Really_itoa_u(buffer, value, min_digits, "0123456789abcdef", 16);
+	return Really_itoa_x(buffer, value, min_digits, "0123456789abcdef");
 }
 
 char * _MCFCRT_itoa_X(char *buffer, uintptr_t value){
 	return _MCFCRT_itoa0X(buffer, value, 0);
 }
 char * _MCFCRT_itoa0X(char *buffer, uintptr_t value, unsigned min_digits){
-	return Really_itoa_u(buffer, value, min_digits, "0123456789ABCDEF", 16);
+	return Really_itoa_x(buffer, value, min_digits, "0123456789ABCDEF");
+}
+
+char * _MCFCRT_itoaN_d(char *buffer, const intptr_t *values, size_t count, char delimiter){
+	char *wp = buffer;
+	for(size_t i = 0; i < count; ++i){
+		if(i != 0){
+			*(wp++) = delimiter;
+		}
+		const intptr_t value = values[i];
+		uintptr_t mask = 0;
+		if(value < 0){
+			*(wp++) = '-';
+			mask = ~mask;
+		}
+		wp = Really_itoa_d(wp, ((uintptr_t)value ^ mask) - mask, 0);
+	}
+	return wp;
+}
+char * _MCFCRT_itoaN_u(char *buffer, const uintptr_t *values, size_t count, char delimiter){
+	char *wp = buffer;
+	for(size_t i = 0; i < count; ++i){
+		if(i != 0){
+			*(wp++) = delimiter;
+		}
+		wp = Really_itoa_d(wp, values[i], 0);
+	}
+	return wp;
 }
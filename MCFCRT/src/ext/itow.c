@@ -3,30 +3,57 @@
 // Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
 
 #include "itow.h"
-#include "rep_movs.h"
+#include "_digits.h"
 
-__attribute__((__always_inline__)) static inline wchar_t * Really_itow_u(wchar_t *restrict buffer, uintptr_t value, unsigned min_digits, const wchar_t *restrict table, unsigned radix){
-	wchar_t temp[64];
-	wchar_t *const end = temp + 64;
-
-	unsigned digits_written = 0;
-	// Write digits in reverse order.
+__attribute__((__always_inline__)) static inline wchar_t * Really_itow_d(wchar_t *restrict buffer, uintptr_t value, unsigned min_digits){
+	const unsigned digits = __MCFCRT_CountDecimalDigits(value);
+	// Pad it with zeroes unless it exceeds the minimum length.
+	unsigned padding = 0;
+	if(digits < min_digits){
+		padding = min_digits - digits;
+		for(unsigned i = 0; i < padding; ++i){
+			buffer[i] = L'0';
+		}
+	}
+	wchar_t *const end = buffer + padding + digits;
+	// Write digits in reverse order, two digits at a time.
+	wchar_t *wp = end;
 	uintptr_t word = value;
-	do {
-		const unsigned digit_value = (unsigned)(word % radix);
-		word /= radix;
-		const wchar_t digit = table[digit_value];
-		++digits_written;
-		*(end - digits_written) = digit;
-	} while(word != 0);
+	while(word >= 100){
+		const unsigned pair = (unsigned)(word % 100);
+		word /= 100;
+		wp -= 2;
+		wp[0] = (wchar_t)__MCFCRT_decimal_digit_pairs[pair * 2];
+		wp[1] = (wchar_t)__MCFCRT_decimal_digit_pairs[pair * 2 + 1];
+	}
+	if(word >= 10){
+		wp -= 2;
+		wp[0] = (wchar_t)__MCFCRT_decimal_digit_pairs[word * 2];
+		wp[1] = (wchar_t)__MCFCRT_decimal_digit_pairs[word * 2 + 1];
+	} else {
+		*(wp - 1) = (wchar_t)(L'0' + word);
+	}
+	return end;
+}
+__attribute__((__always_inline__)) static inline wchar_t * Really_itow_x(wchar_t *restrict buffer, uintptr_t value, unsigned min_digits, const wchar_t *restrict table){
+	const unsigned digits = __MCFCRT_CountHexadecimalDigits(value);
 	// Pad it with zeroes unless it exceeds the minimum length.
-	while(digits_written < min_digits){
-		const wchar_t digit = table[0];
-		++digits_written;
-		*(end - digits_written) = digit;
+	unsigned padding = 0;
+	if(digits < min_digits){
+		padding = min_digits - digits;
+		for(unsigned i = 0; i < padding; ++i){
+			buffer[i] = L'0';
+		}
 	}
-	// Copy it to the correct location.
-	return (wchar_t *)_MCFCRT_rep_movsw(_MCFCRT_NULLPTR, (uint16_t *)buffer, (const uint16_t *)end - digits_written, digits_written);
+	wchar_t *const end = buffer + padding + digits;
+	// Write digits in reverse order.
+	wchar_t *wp = end;
+	uintptr_t word = value;
+	for(unsigned i = 0; i < digits; ++i){
+		*(--wp) = table[word % 16];
+		word /= 16;
+	}
+	return end;
 }
 
 wchar_t * _MCFCRT_itow_d(wchar_t *buffer, intptr_t value){
@@ -39,7 +66,7 @@ wchar_t * _MCFCRT_itow0d(wchar_t *buffer, intptr_t value, unsigned min_digits){
 		*(begin++) = L'-';
 		mask = ~mask;
 	}
-	return Really_itow_u(begin, ((uintptr_t)value ^ mask) - mask, min_digits, L"0123456789", 10);
+	return Really_itow_d(begin, ((uintptr_t)value ^ mask) - mask, min_digits);
 }
 
 wchar_t * _MCFCRT_itowS_d(wchar_t *buffer, intptr_t value){
@@ -54,26 +81,53 @@ wchar_t * _MCFCRT_itowS0d(wchar_t *buffer, intptr_t value, unsigned min_digits){
 	} else {
 		*(begin++) = L'+';
 	}
-	return Really_itow_u(begin, ((uintptr_t)value ^ mask) - mask, min_digits, L"0123456789", 10);
+	return Really_itow_d(begin, ((uintptr_t)value ^ mask) - mask, min_digits);
 }
 
 wchar_t * _MCFCRT_itow_u(wchar_t *buffer, uintptr_t value){
 	return _MCFCRT_itow0u(buffer, value, 0);
 }
 wchar_t * _MCFCRT_itow0u(wchar_t *buffer, uintptr_t value, unsigned min_digits){
-	return Really_itow_u(buffer, value, min_digits, L"0123456789", 10);
+	return Really_itow_d(buffer, value, min_digits);
 }
 
 wchar_t * _MCFCRT_itow_x(wchar_t *buffer, uintptr_t value){
 	return _MCFCRT_itow0x(buffer, value, 0);
 }
 wchar_t * _MCFCRT_itow0x(wchar_t *buffer, uintptr_t value, unsigned min_digits){
-	return Really_itow_u(buffer, value, min_digits, L"0123456789abcdef", 16);
+	return Really_itow_x(buffer, value, min_digits, L"0123456789abcdef");
 }
 
 wchar_t * _MCFCRT_itow_X(wchar_t *buffer, uintptr_t value){
 	return _MCFCRT_itow0X(buffer, value, 0);
 }
 wchar_t * _MCFCRT_itow0X(wchar_t *buffer, uintptr_t value, unsigned min_digits){
-	return Really_itow_u(buffer, value, min_digits, L"0123456789ABCDEF", 16);
+	return Really_itow_x(buffer, value, min_digits, L"0123456789ABCDEF");
+}
+
+wchar_t * _MCFCRT_itowN_d(wchar_t *buffer, const intptr_t *values, size_t count, wchar_t delimiter){
+	wchar_t *wp = buffer;
+	for(size_t i = 0; i < count; ++i){
+		if(i != 0){
+			*(wp++) = delimiter;
+		}
+		const intptr_t value = values[i];
+		uintptr_t mask = 0;
+		if(value < 0){
+			*(wp++) = L'-';
+			mask = ~mask;
+		}
+		wp = Really_itow_d(wp, ((uintptr_t)value ^ mask) - mask, 0);
+	}
+	return wp;
+}
+wchar_t * _MCFCRT_itowN_u(wchar_t *buffer, const uintptr_t *values, size_t count, wchar_t delimiter){
+	wchar_t *wp = buffer;
+	for(size_t i = 0; i < count; ++i){
+		if(i != 0){
+			*(wp++) = delimiter;
+		}
+		wp = Really_itow_d(wp, values[i], 0);
+	}
+	return wp;
 }
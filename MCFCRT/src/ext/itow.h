@@ -24,6 +24,10 @@ extern wchar_t * _MCFCRT_itow0x(wchar_t *__buffer, _MCFCRT_STD uintptr_t __value
 extern wchar_t * _MCFCRT_itow_X(wchar_t *__buffer, _MCFCRT_STD uintptr_t __value) _MCFCRT_NOEXCEPT;
 extern wchar_t * _MCFCRT_itow0X(wchar_t *__buffer, _MCFCRT_STD uintptr_t __value, unsigned __min_digits) _MCFCRT_NOEXCEPT;
 
+// 依次写入 __count 个整数，相邻两个整数之间用 __delimiter 分隔。返回值和单个整数的版本一样，指向最后写入的字符之后。
+extern wchar_t * _MCFCRT_itowN_d(wchar_t *__buffer, const _MCFCRT_STD intptr_t *__values, _MCFCRT_STD size_t __count, wchar_t __delimiter) _MCFCRT_NOEXCEPT;
+extern wchar_t * _MCFCRT_itowN_u(wchar_t *__buffer, const _MCFCRT_STD uintptr_t *__values, _MCFCRT_STD size_t __count, wchar_t __delimiter) _MCFCRT_NOEXCEPT;
+
 _MCFCRT_EXTERN_C_END
 
 #endif
@@ -4,28 +4,195 @@
 
 #include "random.h"
 #include "../env/clocks.h"
+#include "../env/mutex.h"
+#include "../env/thread.h"
+#include "../env/expect.h"
+#include <emmintrin.h>
 
-uint32_t _MCFCRT_GetRandom_uint32(void){
-	static volatile uint64_t s_seed;
-
-	uint64_t old_seed, new_seed;
-	{
-		old_seed = __atomic_load_n(&s_seed, __ATOMIC_RELAXED);
-		do {
-			new_seed = old_seed;
-			new_seed ^= _MCFCRT_ReadTimeStampCounter32();
-			new_seed *= 6364136223846793005u;
-			new_seed += 1442695040888963407u;
-		} while(!__atomic_compare_exchange_n(&s_seed, &old_seed, new_seed, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+// http://prng.di.unimi.it/xoshiro256starstar.c
+// http://prng.di.unimi.it/splitmix64.c
+
+// 这个文件被编译进 CRT 的 DLL，而 _MCFCRT_TlsGet() 和 _MCFCRT_TlsRequire() 位于静态链接到每个模块的 pre 库中，
+// CRT 自己没有每线程的存储可用（_MCFCRT_TlsAllocKey() 只分配键）。因此按照线程 ID 把调用者分散到若干个生成器上。
+// 每个生成器独占一个缓存行并且由一个互斥体保护。线程 ID 被散列到同一个生成器上的线程共享同一个随机数序列，并且会争用同一个锁。
+#define SHARD_COUNT_LOG2    6
+
+typedef struct tagGenerator {
+	_MCFCRT_Mutex mutex;
+	bool seeded;
+	uint64_t state[4];
+} Generator;
+
+static_assert(sizeof(Generator) <= _MCFCRT_CACHE_LINE_SIZE, "??");
+
+static __attribute__((__aligned__(_MCFCRT_CACHE_LINE_SIZE))) union {
+	Generator generator;
+	unsigned char padding[_MCFCRT_CACHE_LINE_SIZE];
+} g_shards[1u << SHARD_COUNT_LOG2];
+
+static inline uint64_t RotateLeft(uint64_t value, unsigned bits){
+	return (value << bits) | (value >> (64 - bits));
+}
+static inline uint64_t SplitMix64(uint64_t *seed){
+	uint64_t word = (*seed += 0x9E3779B97F4A7C15u);
+	word = (word ^ (word >> 30)) * 0xBF58476D1CE4E5B9u;
+	word = (word ^ (word >> 27)) * 0x94D049BB133111EBu;
+	return word ^ (word >> 31);
+}
+static inline uint64_t Xoshiro256StarStar(uint64_t *state){
+	const uint64_t result = RotateLeft(state[1] * 5, 7) * 9;
+	const uint64_t temp = state[1] << 17;
+	state[2] ^= state[0];
+	state[3] ^= state[1];
+	state[1] ^= state[2];
+	state[0] ^= state[3];
+	state[2] ^= temp;
+	state[3] = RotateLeft(state[3], 45);
+	return result;
+}
+
+static Generator *LockGenerator(void){
+	const uintptr_t tid = _MCFCRT_GetCurrentThreadId();
+	// Fibonacci hashing. Windows 上的线程 ID 总是 4 的倍数，而且往往是连续分配的。
+	const unsigned index = (uint32_t)((uint32_t)tid * 0x9E3779B9u) >> (32 - SHARD_COUNT_LOG2);
+	Generator *const generator = &(g_shards[index].generator);
+	_MCFCRT_WaitForMutexForever(&(generator->mutex), _MCFCRT_MUTEX_SUGGESTED_SPIN_COUNT);
+	if(_MCFCRT_EXPECT_NOT(!generator->seeded)){
+		uint64_t seed = _MCFCRT_ReadTimeStampCounter64() ^ ((uint64_t)tid << 32) ^ index;
+		for(unsigned i = 0; i < 4; ++i){
+			generator->state[i] = SplitMix64(&seed);
+		}
+		generator->seeded = true;
 	}
-	return (uint32_t)(new_seed >> 32);
+	return generator;
+}
+static void UnlockGenerator(Generator *generator){
+	_MCFCRT_SignalMutex(&(generator->mutex));
+}
+
+uint32_t _MCFCRT_GetRandom_uint32(void){
+	return (uint32_t)(_MCFCRT_GetRandom_uint64() >> 32);
 }
 uint64_t _MCFCRT_GetRandom_uint64(void){
-	return ((uint64_t)_MCFCRT_GetRandom_uint32() << 32) + _MCFCRT_GetRandom_uint32();
+	Generator *const generator = LockGenerator();
+	const uint64_t value = Xoshiro256StarStar(generator->state);
+	UnlockGenerator(generator);
+	return value;
 }
 double _MCFCRT_GetRandom_double(void){
-	return (double)(int64_t)(_MCFCRT_GetRandom_uint64() >> 1) / 0x1p63;
+	// 只使用 53 位，这样转换是精确的，结果不会被舍入到 1.0。
+	return (double)(int64_t)(_MCFCRT_GetRandom_uint64() >> 11) * 0x1p-53;
 }
 long double _MCFCRT_GetRandom_long_double(void){
 	return (long double)(int64_t)(_MCFCRT_GetRandom_uint64() >> 1) / 0x1p63;
 }
+
+// Daniel Lemire, Fast Random Integer Generation in an Interval, ACM Transactions on Modeling and Computer Simulation 29 (1), 2019.
+uint32_t _MCFCRT_GetRandomRange_uint32(uint32_t bound){
+	uint64_t product = (uint64_t)_MCFCRT_GetRandom_uint32() * bound;
+	if(_MCFCRT_EXPECT_NOT((uint32_t)product < bound)){
+		// 拒绝落在不完整区间中的值。
+		const uint32_t threshold = -bound % bound;
+		while((uint32_t)product < threshold){
+			product = (uint64_t)_MCFCRT_GetRandom_uint32() * bound;
+		}
+	}
+	return (uint32_t)(product >> 32);
+}
+static inline uint64_t MultiplyFull(uint64_t *restrict hi_out, uint64_t lhs, uint64_t rhs){
+#ifdef __SIZEOF_INT128__
+	__extension__ const unsigned __int128 product = (unsigned __int128)lhs * rhs;
+	*hi_out = (uint64_t)(product >> 64);
+	return (uint64_t)product;
+#else
+	const uint64_t ll = (uint64_t)(uint32_t)lhs * (uint32_t)rhs;
+	const uint64_t lh = (uint64_t)(uint32_t)lhs * (uint32_t)(rhs >> 32);
+	const uint64_t hl = (uint64_t)(uint32_t)(lhs >> 32) * (uint32_t)rhs;
+	const uint64_t hh = (uint64_t)(uint32_t)(lhs >> 32) * (uint32_t)(rhs >> 32);
+	const uint64_t mid = (ll >> 32) + (uint32_t)lh + (uint32_t)hl;
+	*hi_out = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+	return (mid << 32) | (uint32_t)ll;
+#endif
+}
+uint64_t _MCFCRT_GetRandomRange_uint64(uint64_t bound){
+	uint64_t hi;
+	uint64_t lo = MultiplyFull(&hi, _MCFCRT_GetRandom_uint64(), bound);
+	if(_MCFCRT_EXPECT_NOT(lo < bound)){
+		// 拒绝落在不完整区间中的值。
+		const uint64_t threshold = -bound % bound;
+		while(lo < threshold){
+			lo = MultiplyFull(&hi, _MCFCRT_GetRandom_uint64(), bound);
+		}
+	}
+	return hi;
+}
+
+// 四路并行的 xoshiro256**，每个 XMM 寄存器中存放两路的一个状态字。
+// SSE2 没有 64 位乘法，但是乘以 5 和 9 都可以用移位和加法代替。
+typedef struct tagXmmGenerator {
+	__m128i state[2][4];
+} XmmGenerator;
+
+__attribute__((__always_inline__)) static inline __m128i XmmRotateLeft(__m128i value, int bits){
+	return _mm_or_si128(_mm_slli_epi64(value, bits), _mm_srli_epi64(value, 64 - bits));
+}
+__attribute__((__always_inline__)) static inline __m128i XmmXoshiro256StarStar(__m128i *state){
+	__m128i word = _mm_add_epi64(_mm_slli_epi64(state[1], 2), state[1]);
+	word = XmmRotateLeft(word, 7);
+	const __m128i result = _mm_add_epi64(_mm_slli_epi64(word, 3), word);
+	const __m128i temp = _mm_slli_epi64(state[1], 17);
+	state[2] = _mm_xor_si128(state[2], state[0]);
+	state[3] = _mm_xor_si128(state[3], state[1]);
+	state[1] = _mm_xor_si128(state[1], state[2]);
+	state[0] = _mm_xor_si128(state[0], state[3]);
+	state[2] = _mm_xor_si128(state[2], temp);
+	state[3] = XmmRotateLeft(state[3], 45);
+	return result;
+}
+
+void _MCFCRT_FillRandom(void *data, size_t size){
+	unsigned char *wp = data;
+	unsigned char *const end = wp + size;
+	// 每次调用只锁定一次，用当前线程的生成器为四路并行的生成器提供种子。
+	Generator *const generator = LockGenerator();
+	uint64_t seed = Xoshiro256StarStar(generator->state);
+	if(size >= 32){
+		uint64_t words[4][4];
+		for(unsigned i = 0; i < 4; ++i){
+			for(unsigned j = 0; j < 4; ++j){
+				words[i][j] = SplitMix64(&seed);
+			}
+		}
+		UnlockGenerator(generator);
+
+		XmmGenerator xgen;
+		for(unsigned i = 0; i < 2; ++i){
+			for(unsigned j = 0; j < 4; ++j){
+				xgen.state[i][j] = _mm_set_epi64x((int64_t)words[i * 2 + 1][j], (int64_t)words[i * 2][j]);
+			}
+		}
+		while(end - wp >= 32){
+			_mm_storeu_si128((__m128i *)wp + 0, XmmXoshiro256StarStar(xgen.state[0]));
+			_mm_storeu_si128((__m128i *)wp + 1, XmmXoshiro256StarStar(xgen.state[1]));
+			wp += 32;
+		}
+		// 剩余的字节由同一组生成器产生。
+		if(wp != end){
+			unsigned char temp[32];
+			_mm_storeu_si128((__m128i *)temp + 0, XmmXoshiro256StarStar(xgen.state[0]));
+			_mm_storeu_si128((__m128i *)temp + 1, XmmXoshiro256StarStar(xgen.state[1]));
+			__builtin_memcpy(wp, temp, (size_t)(end - wp));
+		}
+		return;
+	}
+	while(end - wp >= 8){
+		const uint64_t word = Xoshiro256StarStar(generator->state);
+		__builtin_memcpy(wp, &word, 8);
+		wp += 8;
+	}
+	if(wp != end){
+		const uint64_t word = Xoshiro256StarStar(generator->state);
+		__builtin_memcpy(wp, &word, (size_t)(end - wp));
+	}
+	UnlockGenerator(generator);
+}
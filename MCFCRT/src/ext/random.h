@@ -9,6 +9,10 @@
 
 _MCFCRT_EXTERN_C_BEGIN
 
+// 这些函数是线程安全的。调用者按照线程 ID 被分散到 64 个生成器上，线程较少时它们很少相互争用；
+// 但是被分到同一个生成器上的线程共享同一个随机数序列，因此不能假定每个线程的序列是独立的。
+// 这些函数不能用于密码学用途。
+
 // [0, UINT32_MAX]
 extern _MCFCRT_STD uint32_t _MCFCRT_GetRandom_uint32(void) _MCFCRT_NOEXCEPT;
 // [0, UINT64_MAX]
@@ -18,6 +22,13 @@ extern double _MCFCRT_GetRandom_double(void) _MCFCRT_NOEXCEPT;
 // [0.0, 1.0l)
 extern long double _MCFCRT_GetRandom_long_double(void) _MCFCRT_NOEXCEPT;
 
+// [0, __bound)，无偏。如果 __bound 为零，返回零。
+extern _MCFCRT_STD uint32_t _MCFCRT_GetRandomRange_uint32(_MCFCRT_STD uint32_t __bound) _MCFCRT_NOEXCEPT;
+extern _MCFCRT_STD uint64_t _MCFCRT_GetRandomRange_uint64(_MCFCRT_STD uint64_t __bound) _MCFCRT_NOEXCEPT;
+
+// 用随机字节填充 [__data, __data + __size)。
+extern void _MCFCRT_FillRandom(void *__data, _MCFCRT_STD size_t __size) _MCFCRT_NOEXCEPT;
+
 _MCFCRT_EXTERN_C_END
 
 #endif
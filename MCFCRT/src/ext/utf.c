@@ -4,3 +4,446 @@
 
 #define __MCFCRT_UTF_INLINE_OR_EXTERN     extern inline
 #include "utf.h"
+#include "../env/expect.h"
+#include <tmmintrin.h>
+
+// 快速路径。
+// 这些函数复制一段不需要重新编码的码元，并在第一个需要解码的码元处停止：
+//   8 位的编码中的 ASCII 字符（Modified UTF-8 中的空字符除外）；
+//   16 位的编码中不在代理区间中的码元；
+//   32 位的编码中合法的码点。
+// 如果输出缓冲区中有足够的空间，可能会写入超过返回的输出指针的位置。
+
+static inline bool IsAsciiUnit(uint32_t u32Unit, bool bNoNul){
+	return u32Unit - bNoNul < 0x80u - bNoNul;
+}
+static inline bool IsNonSurrogateUnit(uint32_t u32Unit){
+	return u32Unit - 0xD800 >= 0x800;
+}
+static inline bool IsScalarUnit(uint32_t u32Unit){
+	return (u32Unit < 0x110000) && IsNonSurrogateUnit(u32Unit);
+}
+
+static inline void CopyRun_8_8(char **restrict ppchWrite, char *pchWriteEnd, const char **restrict ppchRead, const char *pchReadEnd, bool bNoNul){
+	char *pchWrite = *ppchWrite;
+	const char *pchRead = *ppchRead;
+	while((pchReadEnd - pchRead >= 16) && (pchWriteEnd - pchWrite >= 16)){
+		const __m128i xmmWord = _mm_loadu_si128((const __m128i *)pchRead);
+		uint32_t u32Mask = (uint32_t)_mm_movemask_epi8(xmmWord);
+		if(bNoNul){
+			u32Mask |= (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(xmmWord, _mm_setzero_si128()));
+		}
+		_mm_storeu_si128((__m128i *)pchWrite, xmmWord);
+		if(u32Mask != 0){
+			const unsigned uCount = (unsigned)__builtin_ctz(u32Mask);
+			pchRead += uCount;
+			pchWrite += uCount;
+			goto jDone;
+		}
+		pchRead += 16;
+		pchWrite += 16;
+	}
+	while((pchRead != pchReadEnd) && (pchWrite != pchWriteEnd) && IsAsciiUnit((uint8_t)*pchRead, bNoNul)){
+		*(pchWrite++) = *(pchRead++);
+	}
+jDone:
+	*ppchWrite = pchWrite;
+	*ppchRead = pchRead;
+}
+static inline void CopyRun_8_16(char16_t **restrict ppc16Write, char16_t *pc16WriteEnd, const char **restrict ppchRead, const char *pchReadEnd, bool bNoNul){
+	char16_t *pc16Write = *ppc16Write;
+	const char *pchRead = *ppchRead;
+	while((pchReadEnd - pchRead >= 16) && (pc16WriteEnd - pc16Write >= 16)){
+		const __m128i xmmWord = _mm_loadu_si128((const __m128i *)pchRead);
+		uint32_t u32Mask = (uint32_t)_mm_movemask_epi8(xmmWord);
+		if(bNoNul){
+			u32Mask |= (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(xmmWord, _mm_setzero_si128()));
+		}
+		_mm_storeu_si128((__m128i *)pc16Write + 0, _mm_unpacklo_epi8(xmmWord, _mm_setzero_si128()));
+		_mm_storeu_si128((__m128i *)pc16Write + 1, _mm_unpackhi_epi8(xmmWord, _mm_setzero_si128()));
+		if(u32Mask != 0){
+			const unsigned uCount = (unsigned)__builtin_ctz(u32Mask);
+			pchRead += uCount;
+			pc16Write += uCount;
+			goto jDone;
+		}
+		pchRead += 16;
+		pc16Write += 16;
+	}
+	while((pchRead != pchReadEnd) && (pc16Write != pc16WriteEnd) && IsAsciiUnit((uint8_t)*pchRead, bNoNul)){
+		*(pc16Write++) = (uint8_t)*(pchRead++);
+	}
+jDone:
+	*ppc16Write = pc16Write;
+	*ppchRead = pchRead;
+}
+static inline void CopyRun_8_32(char32_t **restrict ppc32Write, char32_t *pc32WriteEnd, const char **restrict ppchRead, const char *pchReadEnd, bool bNoNul){
+	char32_t *pc32Write = *ppc32Write;
+	const char *pchRead = *ppchRead;
+	while((pchReadEnd - pchRead >= 16) && (pc32WriteEnd - pc32Write >= 16)){
+		const __m128i xmmWord = _mm_loadu_si128((const __m128i *)pchRead);
+		uint32_t u32Mask = (uint32_t)_mm_movemask_epi8(xmmWord);
+		if(bNoNul){
+			u32Mask |= (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(xmmWord, _mm_setzero_si128()));
+		}
+		const __m128i xmmLo = _mm_unpacklo_epi8(xmmWord, _mm_setzero_si128());
+		const __m128i xmmHi = _mm_unpackhi_epi8(xmmWord, _mm_setzero_si128());
+		_mm_storeu_si128((__m128i *)pc32Write + 0, _mm_unpacklo_epi16(xmmLo, _mm_setzero_si128()));
+		_mm_storeu_si128((__m128i *)pc32Write + 1, _mm_unpackhi_epi16(xmmLo, _mm_setzero_si128()));
+		_mm_storeu_si128((__m128i *)pc32Write + 2, _mm_unpacklo_epi16(xmmHi, _mm_setzero_si128()));
+		_mm_storeu_si128((__m128i *)pc32Write + 3, _mm_unpackhi_epi16(xmmHi, _mm_setzero_si128()));
+		if(u32Mask != 0){
+			const unsigned uCount = (unsigned)__builtin_ctz(u32Mask);
+			pchRead += uCount;
+			pc32Write += uCount;
+			goto jDone;
+		}
+		pchRead += 16;
+		pc32Write += 16;
+	}
+	while((pchRead != pchReadEnd) && (pc32Write != pc32WriteEnd) && IsAsciiUnit((uint8_t)*pchRead, bNoNul)){
+		*(pc32Write++) = (uint8_t)*(pchRead++);
+	}
+jDone:
+	*ppc32Write = pc32Write;
+	*ppchRead = pchRead;
+}
+
+static inline void CopyRun_16_8(char **restrict ppchWrite, char *pchWriteEnd, const char16_t **restrict ppc16Read, const char16_t *pc16ReadEnd, bool bNoNul){
+	char *pchWrite = *ppchWrite;
+	const char16_t *pc16Read = *ppc16Read;
+	while((pc16ReadEnd - pc16Read >= 16) && (pchWriteEnd - pchWrite >= 16)){
+		const __m128i xmmWord0 = _mm_loadu_si128((const __m128i *)pc16Read + 0);
+		const __m128i xmmWord1 = _mm_loadu_si128((const __m128i *)pc16Read + 1);
+		const __m128i xmmHighBits = _mm_set1_epi16((short)0xFF80);
+		__m128i xmmAscii0 = _mm_cmpeq_epi16(_mm_and_si128(xmmWord0, xmmHighBits), _mm_setzero_si128());
+		__m128i xmmAscii1 = _mm_cmpeq_epi16(_mm_and_si128(xmmWord1, xmmHighBits), _mm_setzero_si128());
+		if(bNoNul){
+			xmmAscii0 = _mm_andnot_si128(_mm_cmpeq_epi16(xmmWord0, _mm_setzero_si128()), xmmAscii0);
+			xmmAscii1 = _mm_andnot_si128(_mm_cmpeq_epi16(xmmWord1, _mm_setzero_si128()), xmmAscii1);
+		}
+		const uint32_t u32Mask = ~(uint32_t)_mm_movemask_epi8(_mm_packs_epi16(xmmAscii0, xmmAscii1)) & 0xFFFF;
+		// 只有 ASCII 字符的结果是有意义的。
+		_mm_storeu_si128((__m128i *)pchWrite, _mm_packus_epi16(xmmWord0, xmmWord1));
+		if(u32Mask != 0){
+			const unsigned uCount = (unsigned)__builtin_ctz(u32Mask);
+			pc16Read += uCount;
+			pchWrite += uCount;
+			goto jDone;
+		}
+		pc16Read += 16;
+		pchWrite += 16;
+	}
+	while((pc16Read != pc16ReadEnd) && (pchWrite != pchWriteEnd) && IsAsciiUnit((uint16_t)*pc16Read, bNoNul)){
+		*(pchWrite++) = (char)*(pc16Read++);
+	}
+jDone:
+	*ppchWrite = pchWrite;
+	*ppc16Read = pc16Read;
+}
+static inline void CopyRun_16_16(char16_t **restrict ppc16Write, char16_t *pc16WriteEnd, const char16_t **restrict ppc16Read, const char16_t *pc16ReadEnd, bool bNoNul){
+	(void)bNoNul;
+
+	char16_t *pc16Write = *ppc16Write;
+	const char16_t *pc16Read = *ppc16Read;
+	while((pc16ReadEnd - pc16Read >= 8) && (pc16WriteEnd - pc16Write >= 8)){
+		const __m128i xmmWord = _mm_loadu_si128((const __m128i *)pc16Read);
+		const __m128i xmmSurrogate = _mm_cmpeq_epi16(_mm_and_si128(xmmWord, _mm_set1_epi16((short)0xF800)), _mm_set1_epi16((short)0xD800));
+		const uint32_t u32Mask = (uint32_t)_mm_movemask_epi8(xmmSurrogate);
+		_mm_storeu_si128((__m128i *)pc16Write, xmmWord);
+		if(u32Mask != 0){
+			const unsigned uCount = (unsigned)__builtin_ctz(u32Mask) / 2;
+			pc16Read += uCount;
+			pc16Write += uCount;
+			goto jDone;
+		}
+		pc16Read += 8;
+		pc16Write += 8;
+	}
+	while((pc16Read != pc16ReadEnd) && (pc16Write != pc16WriteEnd) && IsNonSurrogateUnit((uint16_t)*pc16Read)){
+		*(pc16Write++) = *(pc16Read++);
+	}
+jDone:
+	*ppc16Write = pc16Write;
+	*ppc16Read = pc16Read;
+}
+static inline void CopyRun_16_32(char32_t **restrict ppc32Write, char32_t *pc32WriteEnd, const char16_t **restrict ppc16Read, const char16_t *pc16ReadEnd, bool bNoNul){
+	(void)bNoNul;
+
+	char32_t *pc32Write = *ppc32Write;
+	const char16_t *pc16Read = *ppc16Read;
+	while((pc16ReadEnd - pc16Read >= 8) && (pc32WriteEnd - pc32Write >= 8)){
+		const __m128i xmmWord = _mm_loadu_si128((const __m128i *)pc16Read);
+		const __m128i xmmSurrogate = _mm_cmpeq_epi16(_mm_and_si128(xmmWord, _mm_set1_epi16((short)0xF800)), _mm_set1_epi16((short)0xD800));
+		const uint32_t u32Mask = (uint32_t)_mm_movemask_epi8(xmmSurrogate);
+		_mm_storeu_si128((__m128i *)pc32Write + 0, _mm_unpacklo_epi16(xmmWord, _mm_setzero_si128()));
+		_mm_storeu_si128((__m128i *)pc32Write + 1, _mm_unpackhi_epi16(xmmWord, _mm_setzero_si128()));
+		if(u32Mask != 0){
+			const unsigned uCount = (unsigned)__builtin_ctz(u32Mask) / 2;
+			pc16Read += uCount;
+			pc32Write += uCount;
+			goto jDone;
+		}
+		pc16Read += 8;
+		pc32Write += 8;
+	}
+	while((pc16Read != pc16ReadEnd) && (pc32Write != pc32WriteEnd) && IsNonSurrogateUnit((uint16_t)*pc16Read)){
+		*(pc32Write++) = (uint16_t)*(pc16Read++);
+	}
+jDone:
+	*ppc32Write = pc32Write;
+	*ppc16Read = pc16Read;
+}
+
+static inline void CopyRun_32_8(char **restrict ppchWrite, char *pchWriteEnd, const char32_t **restrict ppc32Read, const char32_t *pc32ReadEnd, bool bNoNul){
+	char *pchWrite = *ppchWrite;
+	const char32_t *pc32Read = *ppc32Read;
+	while((pc32ReadEnd - pc32Read >= 16) && (pchWriteEnd - pchWrite >= 16)){
+		__m128i axmmWords[4], axmmAscii[4];
+		for(unsigned i = 0; i < 4; ++i){
+			axmmWords[i] = _mm_loadu_si128((const __m128i *)pc32Read + i);
+			axmmAscii[i] = _mm_cmpeq_epi32(_mm_and_si128(axmmWords[i], _mm_set1_epi32(-0x80)), _mm_setzero_si128());
+			if(bNoNul){
+				axmmAscii[i] = _mm_andnot_si128(_mm_cmpeq_epi32(axmmWords[i], _mm_setzero_si128()), axmmAscii[i]);
+			}
+		}
+		const __m128i xmmAscii = _mm_packs_epi16(_mm_packs_epi32(axmmAscii[0], axmmAscii[1]), _mm_packs_epi32(axmmAscii[2], axmmAscii[3]));
+		const uint32_t u32Mask = ~(uint32_t)_mm_movemask_epi8(xmmAscii) & 0xFFFF;
+		// 只有 ASCII 字符的结果是有意义的。
+		const __m128i xmmLo = _mm_packs_epi32(_mm_and_si128(axmmWords[0], _mm_set1_epi32(0x7F)), _mm_and_si128(axmmWords[1], _mm_set1_epi32(0x7F)));
+		const __m128i xmmHi = _mm_packs_epi32(_mm_and_si128(axmmWords[2], _mm_set1_epi32(0x7F)), _mm_and_si128(axmmWords[3], _mm_set1_epi32(0x7F)));
+		_mm_storeu_si128((__m128i *)pchWrite, _mm_packus_epi16(xmmLo, xmmHi));
+		if(u32Mask != 0){
+			const unsigned uCount = (unsigned)__builtin_ctz(u32Mask);
+			pc32Read += uCount;
+			pchWrite += uCount;
+			goto jDone;
+		}
+		pc32Read += 16;
+		pchWrite += 16;
+	}
+	while((pc32Read != pc32ReadEnd) && (pchWrite != pchWriteEnd) && IsAsciiUnit((uint32_t)*pc32Read, bNoNul)){
+		*(pchWrite++) = (char)*(pc32Read++);
+	}
+jDone:
+	*ppchWrite = pchWrite;
+	*ppc32Read = pc32Read;
+}
+static inline void CopyRun_32_16(char16_t **restrict ppc16Write, char16_t *pc16WriteEnd, const char32_t **restrict ppc32Read, const char32_t *pc32ReadEnd, bool bNoNul){
+	(void)bNoNul;
+
+	char16_t *pc16Write = *ppc16Write;
+	const char32_t *pc32Read = *ppc32Read;
+	const __m128i xmmGatherLow = _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+	while((pc32ReadEnd - pc32Read >= 8) && (pc16WriteEnd - pc16Write >= 8)){
+		const __m128i xmmWord0 = _mm_loadu_si128((const __m128i *)pc32Read + 0);
+		const __m128i xmmWord1 = _mm_loadu_si128((const __m128i *)pc32Read + 1);
+		// 在基本多文种平面中并且不是代理的码点可以直接截断为 16 位。
+		const __m128i xmmHighBits = _mm_set1_epi32((int)0xFFFF0000);
+		const __m128i xmmSurrogateMask = _mm_set1_epi32(0xF800);
+		const __m128i xmmSurrogateBits = _mm_set1_epi32(0xD800);
+		const __m128i xmmBmp0 = _mm_andnot_si128(_mm_cmpeq_epi32(_mm_and_si128(xmmWord0, xmmSurrogateMask), xmmSurrogateBits),
+			_mm_cmpeq_epi32(_mm_and_si128(xmmWord0, xmmHighBits), _mm_setzero_si128()));
+		const __m128i xmmBmp1 = _mm_andnot_si128(_mm_cmpeq_epi32(_mm_and_si128(xmmWord1, xmmSurrogateMask), xmmSurrogateBits),
+			_mm_cmpeq_epi32(_mm_and_si128(xmmWord1, xmmHighBits), _mm_setzero_si128()));
+		const uint32_t u32Mask = ~(uint32_t)_mm_movemask_epi8(_mm_packs_epi32(xmmBmp0, xmmBmp1)) & 0xFFFF;
+		_mm_storeu_si128((__m128i *)pc16Write, _mm_unpacklo_epi64(_mm_shuffle_epi8(xmmWord0, xmmGatherLow), _mm_shuffle_epi8(xmmWord1, xmmGatherLow)));
+		if(u32Mask != 0){
+			const unsigned uCount = (unsigned)__builtin_ctz(u32Mask) / 2;
+			pc32Read += uCount;
+			pc16Write += uCount;
+			goto jDone;
+		}
+		pc32Read += 8;
+		pc16Write += 8;
+	}
+	while((pc32Read != pc32ReadEnd) && (pc16Write != pc16WriteEnd) && ((uint32_t)*pc32Read < 0x10000) && IsNonSurrogateUnit((uint32_t)*pc32Read)){
+		*(pc16Write++) = (char16_t)*(pc32Read++);
+	}
+jDone:
+	*ppc16Write = pc16Write;
+	*ppc32Read = pc32Read;
+}
+static inline void CopyRun_32_32(char32_t **restrict ppc32Write, char32_t *pc32WriteEnd, const char32_t **restrict ppc32Read, const char32_t *pc32ReadEnd, bool bNoNul){
+	(void)bNoNul;
+
+	char32_t *pc32Write = *ppc32Write;
+	const char32_t *pc32Read = *ppc32Read;
+	while((pc32ReadEnd - pc32Read >= 4) && (pc32WriteEnd - pc32Write >= 4)){
+		const __m128i xmmWord = _mm_loadu_si128((const __m128i *)pc32Read);
+		const __m128i xmmTooLarge = _mm_cmpgt_epi32(_mm_srli_epi32(xmmWord, 16), _mm_set1_epi32(0x10));
+		const __m128i xmmSurrogate = _mm_cmpeq_epi32(_mm_and_si128(xmmWord, _mm_set1_epi32((int)0xFFFFF800)), _mm_set1_epi32(0xD800));
+		const uint32_t u32Mask = (uint32_t)_mm_movemask_epi8(_mm_or_si128(xmmTooLarge, xmmSurrogate));
+		_mm_storeu_si128((__m128i *)pc32Write, xmmWord);
+		if(u32Mask != 0){
+			const unsigned uCount = (unsigned)__builtin_ctz(u32Mask) / 4;
+			pc32Read += uCount;
+			pc32Write += uCount;
+			goto jDone;
+		}
+		pc32Read += 4;
+		pc32Write += 4;
+	}
+	while((pc32Read != pc32ReadEnd) && (pc32Write != pc32WriteEnd) && IsScalarUnit((uint32_t)*pc32Read)){
+		*(pc32Write++) = *(pc32Read++);
+	}
+jDone:
+	*ppc32Write = pc32Write;
+	*ppc32Read = pc32Read;
+}
+
+// 慢速路径，每次转换一个码点。
+#define DEFINE_TRANSCODER(from_, from_char_, from_bits_, from_no_nul_, to_, to_char_, to_bits_, to_no_nul_)	\
+	char32_t _MCFCRT_Transcode##from_##To##to_(to_char_ **ppWrite, to_char_ *pWriteEnd, const from_char_ **ppRead, const from_char_ *pReadEnd, unsigned uFlags){	\
+		const bool bPermissive = uFlags & _MCFCRT_UTF_PERMISSIVE;	\
+		to_char_ *pWrite = *ppWrite;	\
+		const from_char_ *pRead = *ppRead;	\
+		char32_t c32Status;	\
+		for(;;){	\
+			CopyRun_##from_bits_##_##to_bits_(&pWrite, pWriteEnd, &pRead, pReadEnd, (from_no_nul_) || (to_no_nul_));	\
+			const from_char_ *const pReadSaved = pRead;	\
+			char32_t c32CodePoint = _MCFCRT_Decode##from_(&pRead, pReadEnd, bPermissive);	\
+			if(!_MCFCRT_UTF_SUCCESS(c32CodePoint)){	\
+				c32Status = c32CodePoint;	\
+				break;	\
+			}	\
+			c32CodePoint = _MCFCRT_Encode##to_(&pWrite, pWriteEnd, c32CodePoint, true);	\
+			if(!_MCFCRT_UTF_SUCCESS(c32CodePoint)){	\
+				pRead = pReadSaved;	\
+				c32Status = c32CodePoint;	\
+				break;	\
+			}	\
+		}	\
+		*ppWrite = pWrite;	\
+		*ppRead = pRead;	\
+		return c32Status;	\
+	}
+#define DEFINE_TRANSCODERS_FROM(from_, from_char_, from_bits_, from_no_nul_)	\
+	DEFINE_TRANSCODER(from_, from_char_, from_bits_, from_no_nul_, Utf8,         char,      8, false)	\
+	DEFINE_TRANSCODER(from_, from_char_, from_bits_, from_no_nul_, Utf16,        char16_t, 16, false)	\
+	DEFINE_TRANSCODER(from_, from_char_, from_bits_, from_no_nul_, Utf32,        char32_t, 32, false)	\
+	DEFINE_TRANSCODER(from_, from_char_, from_bits_, from_no_nul_, Cesu8,        char,      8, false)	\
+	DEFINE_TRANSCODER(from_, from_char_, from_bits_, from_no_nul_, ModifiedUtf8, char,      8, true )
+
+DEFINE_TRANSCODERS_FROM(Utf8,         char,      8, false)
+DEFINE_TRANSCODERS_FROM(Utf16,        char16_t, 16, false)
+DEFINE_TRANSCODERS_FROM(Utf32,        char32_t, 32, false)
+DEFINE_TRANSCODERS_FROM(Cesu8,        char,      8, false)
+DEFINE_TRANSCODERS_FROM(ModifiedUtf8, char,      8, true )
+
+#undef DEFINE_TRANSCODERS_FROM
+#undef DEFINE_TRANSCODER
+
+// John Keiser, Daniel Lemire, Validating UTF-8 In Less Than One Instruction Per Byte, Software: Practice and Experience 51 (5), 2021.
+// 每个字节的高四位和低四位，以及前一个字节的高四位，分别通过 PSHUFB 查表，得到可能出现的错误的集合，三者之交即为实际的错误。
+#define TOO_SHORT        (1 << 0)   // 首字节之后没有足够的后续字节。
+#define TOO_LONG         (1 << 1)   // ASCII 字符之后出现了后续字节。
+#define OVERLONG_3       (1 << 2)
+#define TOO_LARGE        (1 << 3)
+#define SURROGATE        (1 << 4)
+#define OVERLONG_2       (1 << 5)
+#define TOO_LARGE_1000   (1 << 6)
+#define OVERLONG_4       (1 << 6)
+#define TWO_CONTS        (1 << 7)   // 两个连续的后续字节，如果不属于三字节或四字节的序列，就是错误。
+#define CARRY            (TOO_SHORT | TOO_LONG | TWO_CONTS)
+
+static inline __m128i CheckUtf8Block(__m128i xmmInput, __m128i xmmPrevInput){
+	const __m128i xmmByte1HighTable = _mm_setr_epi8(
+		(char)(TOO_LONG), (char)(TOO_LONG), (char)(TOO_LONG), (char)(TOO_LONG),
+		(char)(TOO_LONG), (char)(TOO_LONG), (char)(TOO_LONG), (char)(TOO_LONG),
+		(char)(TWO_CONTS), (char)(TWO_CONTS), (char)(TWO_CONTS), (char)(TWO_CONTS),
+		(char)(TOO_SHORT | OVERLONG_2),
+		(char)(TOO_SHORT),
+		(char)(TOO_SHORT | OVERLONG_3 | SURROGATE),
+		(char)(TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4));
+	const __m128i xmmByte1LowTable = _mm_setr_epi8(
+		(char)(CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4),
+		(char)(CARRY | OVERLONG_2),
+		(char)(CARRY),
+		(char)(CARRY),
+		(char)(CARRY | TOO_LARGE),
+		(char)(CARRY | TOO_LARGE | TOO_LARGE_1000),
+		(char)(CARRY | TOO_LARGE | TOO_LARGE_1000),
+		(char)(CARRY | TOO_LARGE | TOO_LARGE_1000),
+		(char)(CARRY | TOO_LARGE | TOO_LARGE_1000),
+		(char)(CARRY | TOO_LARGE | TOO_LARGE_1000),
+		(char)(CARRY | TOO_LARGE | TOO_LARGE_1000),
+		(char)(CARRY | TOO_LARGE | TOO_LARGE_1000),
+		(char)(CARRY | TOO_LARGE | TOO_LARGE_1000),
+		(char)(CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE),
+		(char)(CARRY | TOO_LARGE | TOO_LARGE_1000),
+		(char)(CARRY | TOO_LARGE | TOO_LARGE_1000));
+	const __m128i xmmByte2HighTable = _mm_setr_epi8(
+		(char)(TOO_SHORT), (char)(TOO_SHORT), (char)(TOO_SHORT), (char)(TOO_SHORT),
+		(char)(TOO_SHORT), (char)(TOO_SHORT), (char)(TOO_SHORT), (char)(TOO_SHORT),
+		(char)(TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4),
+		(char)(TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE),
+		(char)(TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE  | TOO_LARGE),
+		(char)(TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE  | TOO_LARGE),
+		(char)(TOO_SHORT), (char)(TOO_SHORT), (char)(TOO_SHORT), (char)(TOO_SHORT));
+	const __m128i xmmNibbleMask = _mm_set1_epi8(0x0F);
+
+	const __m128i xmmPrev1 = _mm_alignr_epi8(xmmInput, xmmPrevInput, 15);
+	const __m128i xmmByte1High = _mm_shuffle_epi8(xmmByte1HighTable, _mm_and_si128(_mm_srli_epi16(xmmPrev1, 4), xmmNibbleMask));
+	const __m128i xmmByte1Low = _mm_shuffle_epi8(xmmByte1LowTable, _mm_and_si128(xmmPrev1, xmmNibbleMask));
+	const __m128i xmmByte2High = _mm_shuffle_epi8(xmmByte2HighTable, _mm_and_si128(_mm_srli_epi16(xmmInput, 4), xmmNibbleMask));
+	const __m128i xmmSpecialCases = _mm_and_si128(_mm_and_si128(xmmByte1High, xmmByte1Low), xmmByte2High);
+	// 三字节序列的第三个字节和四字节序列的第三、四个字节必须是后续字节。
+	const __m128i xmmPrev2 = _mm_alignr_epi8(xmmInput, xmmPrevInput, 14);
+	const __m128i xmmPrev3 = _mm_alignr_epi8(xmmInput, xmmPrevInput, 13);
+	const __m128i xmmIsThirdByte = _mm_subs_epu8(xmmPrev2, _mm_set1_epi8((char)(0xE0 - 0x80)));
+	const __m128i xmmIsFourthByte = _mm_subs_epu8(xmmPrev3, _mm_set1_epi8((char)(0xF0 - 0x80)));
+	const __m128i xmmMust23 = _mm_and_si128(_mm_or_si128(xmmIsThirdByte, xmmIsFourthByte), _mm_set1_epi8((char)0x80));
+	return _mm_xor_si128(xmmMust23, xmmSpecialCases);
+}
+
+#undef CARRY
+#undef TWO_CONTS
+#undef OVERLONG_4
+#undef TOO_LARGE_1000
+#undef OVERLONG_2
+#undef SURROGATE
+#undef TOO_LARGE
+#undef OVERLONG_3
+#undef TOO_LONG
+#undef TOO_SHORT
+
+static const char *ValidateUtf8Slowly(const char *pchBegin, const char *pchRead, const char *pchReadEnd){
+	// 之前的块中只可能有一个跨越边界的序列，它的首字节一定在最后三个字节中。
+	const char *const pchBlock = pchRead;
+	pchRead -= (pchRead - pchBegin < 3) ? (pchRead - pchBegin) : 3;
+	while((pchRead != pchBlock) && (((uint8_t)*pchRead & 0xC0) == 0x80)){
+		++pchRead;
+	}
+	for(;;){
+		const char32_t c32CodePoint = _MCFCRT_DecodeUtf8(&pchRead, pchReadEnd, false);
+		if(!_MCFCRT_UTF_SUCCESS(c32CodePoint)){
+			break;
+		}
+	}
+	return pchRead;
+}
+
+const char *_MCFCRT_ValidateUtf8(const char *pchRead, const char *pchReadEnd){
+	const char *const pchBegin = pchRead;
+	// 如果上一个块末尾有不完整的序列，其首字节一定在最后三个字节中。
+	const __m128i xmmIncompleteLimits = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, (char)(0xF0 - 1), (char)(0xE0 - 1), (char)(0xC0 - 1));
+	__m128i xmmPrevInput = _mm_setzero_si128();
+	__m128i xmmPrevIncomplete = _mm_setzero_si128();
+	while(pchReadEnd - pchRead >= 16){
+		const __m128i xmmInput = _mm_loadu_si128((const __m128i *)pchRead);
+		__m128i xmmError;
+		if(_mm_movemask_epi8(xmmInput) == 0){
+			xmmError = xmmPrevIncomplete;
+		} else {
+			xmmError = CheckUtf8Block(xmmInput, xmmPrevInput);
+			xmmPrevIncomplete = _mm_subs_epu8(xmmInput, xmmIncompleteLimits);
+		}
+		if(_MCFCRT_EXPECT_NOT(_mm_movemask_epi8(_mm_cmpeq_epi8(xmmError, _mm_setzero_si128())) != 0xFFFF)){
+			return ValidateUtf8Slowly(pchBegin, pchRead, pchReadEnd);
+		}
+		xmmPrevInput = xmmInput;
+		pchRead += 16;
+	}
+	return ValidateUtf8Slowly(pchBegin, pchRead, pchReadEnd);
+}
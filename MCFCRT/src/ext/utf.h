@@ -214,6 +214,32 @@ __jDone:
 	return (char32_t)__u32CodePoint;
 }
 
+// Modified UTF-8 与 CESU-8 的区别在于，U+0000 被编码为 C0 80，并且输入中不能出现 00 字节。
+__MCFCRT_UTF_INLINE_OR_EXTERN char32_t _MCFCRT_DecodeModifiedUtf8(const char **__ppchRead, const char *__pchReadEnd, bool __bPermissive) _MCFCRT_NOEXCEPT {
+	const char *__pchRead = *__ppchRead;
+	if(__pchRead == __pchReadEnd){
+		return _MCFCRT_UTF_NO_DATA;
+	}
+	const _MCFCRT_STD uint_fast32_t __u32Unit = (_MCFCRT_STD uint8_t)*__pchRead;
+	if(__u32Unit == 0x00){
+		if(!__bPermissive){
+			return _MCFCRT_UTF_INVALID_INPUT;
+		}
+		*__ppchRead = __pchRead + 1;
+		return 0xFFFD;
+	}
+	if(__u32Unit == 0xC0){
+		if(__pchReadEnd - __pchRead < 2){
+			return _MCFCRT_UTF_PARTIAL_DATA;
+		}
+		if((_MCFCRT_STD uint8_t)__pchRead[1] == 0x80){
+			*__ppchRead = __pchRead + 2;
+			return 0;
+		}
+	}
+	return _MCFCRT_DecodeCesu8(__ppchRead, __pchReadEnd, __bPermissive);
+}
+
 __MCFCRT_UTF_INLINE_OR_EXTERN char32_t _MCFCRT_EncodeUtf8(char **__ppchWrite, char *__pchWriteEnd, char32_t __c32Char, bool __bPermissive) _MCFCRT_NOEXCEPT {
 	char *__pchWrite = *__ppchWrite;
 	_MCFCRT_STD uint_fast32_t __u32CodePoint = __c32Char;
@@ -345,6 +371,20 @@ __jReplace:
 	return __u32CodePoint;
 }
 
+__MCFCRT_UTF_INLINE_OR_EXTERN char32_t _MCFCRT_EncodeModifiedUtf8(char **__ppchWrite, char *__pchWriteEnd, char32_t __c32Char, bool __bPermissive) _MCFCRT_NOEXCEPT {
+	char *__pchWrite = *__ppchWrite;
+	if(__c32Char == 0){
+		if(__pchWriteEnd - __pchWrite < 2){
+			return _MCFCRT_UTF_BUFFER_TOO_SMALL;
+		}
+		*(__pchWrite++) = (char)0xC0;
+		*(__pchWrite++) = (char)0x80;
+		*__ppchWrite = __pchWrite;
+		return 0;
+	}
+	return _MCFCRT_EncodeCesu8(__ppchWrite, __pchWriteEnd, __c32Char, __bPermissive);
+}
+
 __MCFCRT_UTF_INLINE_OR_EXTERN char32_t _MCFCRT_UncheckedEncodeUtf8(char **__ppchWrite, char32_t __c32Char, bool __bPermissive) _MCFCRT_NOEXCEPT {
 	char *__pchWrite = *__ppchWrite;
 	_MCFCRT_STD uint_fast32_t __u32CodePoint = __c32Char;
@@ -442,9 +482,58 @@ __jReplace:
 	// _MCFCRT_ASSERT((__u32CodePoint < 0x110000) && (__u32CodePoint - 0xD800 >= 0x800));
 	return __u32CodePoint;
 }
+__MCFCRT_UTF_INLINE_OR_EXTERN char32_t _MCFCRT_UncheckedEncodeModifiedUtf8(char **__ppchWrite, char32_t __c32Char, bool __bPermissive) _MCFCRT_NOEXCEPT {
+	char *__pchWrite = *__ppchWrite;
+	if(__c32Char == 0){
+		*(__pchWrite++) = (char)0xC0;
+		*(__pchWrite++) = (char)0x80;
+		*__ppchWrite = __pchWrite;
+		return 0;
+	}
+	return _MCFCRT_UncheckedEncodeCesu8(__ppchWrite, __c32Char, __bPermissive);
+}
 
 #undef __MCFCRT_UTF_HANDLE_INVALID_INPUT_
 
+// 批量转换。
+// 从输入中解码尽可能多的码点并编码到输出中，然后更新输入和输出指针。
+// 如果全部输入都被转换，返回 _MCFCRT_UTF_NO_DATA。否则返回其他错误码，输入指针指向第一个没有被转换的码点。
+// 如果 __uFlags 包含 _MCFCRT_UTF_PERMISSIVE，不合法的输入被替换为 U+FFFD，此时不会返回 _MCFCRT_UTF_INVALID_INPUT。
+#define _MCFCRT_UTF_PERMISSIVE           0x0001u
+
+extern char32_t _MCFCRT_TranscodeUtf8ToUtf8(char **__ppchWrite, char *__pchWriteEnd, const char **__ppchRead, const char *__pchReadEnd, unsigned __uFlags) _MCFCRT_NOEXCEPT;
+extern char32_t _MCFCRT_TranscodeUtf8ToUtf16(char16_t **__ppc16Write, char16_t *__pc16WriteEnd, const char **__ppchRead, const char *__pchReadEnd, unsigned __uFlags) _MCFCRT_NOEXCEPT;
+extern char32_t _MCFCRT_TranscodeUtf8ToUtf32(char32_t **__ppc32Write, char32_t *__pc32WriteEnd, const char **__ppchRead, const char *__pchReadEnd, unsigned __uFlags) _MCFCRT_NOEXCEPT;
+extern char32_t _MCFCRT_TranscodeUtf8ToCesu8(char **__ppchWrite, char *__pchWriteEnd, const char **__ppchRead, const char *__pchReadEnd, unsigned __uFlags) _MCFCRT_NOEXCEPT;
+extern char32_t _MCFCRT_TranscodeUtf8ToModifiedUtf8(char **__ppchWrite, char *__pchWriteEnd, const char **__ppchRead, const char *__pchReadEnd, unsigned __uFlags) _MCFCRT_NOEXCEPT;
+
+extern char32_t _MCFCRT_TranscodeUtf16ToUtf8(char **__ppchWrite, char *__pchWriteEnd, const char16_t **__ppc16Read, const char16_t *__pc16ReadEnd, unsigned __uFlags) _MCFCRT_NOEXCEPT;
+extern char32_t _MCFCRT_TranscodeUtf16ToUtf16(char16_t **__ppc16Write, char16_t *__pc16WriteEnd, const char16_t **__ppc16Read, const char16_t *__pc16ReadEnd, unsigned __uFlags) _MCFCRT_NOEXCEPT;
+extern char32_t _MCFCRT_TranscodeUtf16ToUtf32(char32_t **__ppc32Write, char32_t *__pc32WriteEnd, const char16_t **__ppc16Read, const char16_t *__pc16ReadEnd, unsigned __uFlags) _MCFCRT_NOEXCEPT;
+extern char32_t _MCFCRT_TranscodeUtf16ToCesu8(char **__ppchWrite, char *__pchWriteEnd, const char16_t **__ppc16Read, const char16_t *__pc16ReadEnd, unsigned __uFlags) _MCFCRT_NOEXCEPT;
+extern char32_t _MCFCRT_TranscodeUtf16ToModifiedUtf8(char **__ppchWrite, char *__pchWriteEnd, const char16_t **__ppc16Read, const char16_t *__pc16ReadEnd, unsigned __uFlags) _MCFCRT_NOEXCEPT;
+
+extern char32_t _MCFCRT_TranscodeUtf32ToUtf8(char **__ppchWrite, char *__pchWriteEnd, const char32_t **__ppc32Read, const char32_t *__pc32ReadEnd, unsigned __uFlags) _MCFCRT_NOEXCEPT;
+extern char32_t _MCFCRT_TranscodeUtf32ToUtf16(char16_t **__ppc16Write, char16_t *__pc16WriteEnd, const char32_t **__ppc32Read, const char32_t *__pc32ReadEnd, unsigned __uFlags) _MCFCRT_NOEXCEPT;
+extern char32_t _MCFCRT_TranscodeUtf32ToUtf32(char32_t **__ppc32Write, char32_t *__pc32WriteEnd, const char32_t **__ppc32Read, const char32_t *__pc32ReadEnd, unsigned __uFlags) _MCFCRT_NOEXCEPT;
+extern char32_t _MCFCRT_TranscodeUtf32ToCesu8(char **__ppchWrite, char *__pchWriteEnd, const char32_t **__ppc32Read, const char32_t *__pc32ReadEnd, unsigned __uFlags) _MCFCRT_NOEXCEPT;
+extern char32_t _MCFCRT_TranscodeUtf32ToModifiedUtf8(char **__ppchWrite, char *__pchWriteEnd, const char32_t **__ppc32Read, const char32_t *__pc32ReadEnd, unsigned __uFlags) _MCFCRT_NOEXCEPT;
+
+extern char32_t _MCFCRT_TranscodeCesu8ToUtf8(char **__ppchWrite, char *__pchWriteEnd, const char **__ppchRead, const char *__pchReadEnd, unsigned __uFlags) _MCFCRT_NOEXCEPT;
+extern char32_t _MCFCRT_TranscodeCesu8ToUtf16(char16_t **__ppc16Write, char16_t *__pc16WriteEnd, const char **__ppchRead, const char *__pchReadEnd, unsigned __uFlags) _MCFCRT_NOEXCEPT;
+extern char32_t _MCFCRT_TranscodeCesu8ToUtf32(char32_t **__ppc32Write, char32_t *__pc32WriteEnd, const char **__ppchRead, const char *__pchReadEnd, unsigned __uFlags) _MCFCRT_NOEXCEPT;
+extern char32_t _MCFCRT_TranscodeCesu8ToCesu8(char **__ppchWrite, char *__pchWriteEnd, const char **__ppchRead, const char *__pchReadEnd, unsigned __uFlags) _MCFCRT_NOEXCEPT;
+extern char32_t _MCFCRT_TranscodeCesu8ToModifiedUtf8(char **__ppchWrite, char *__pchWriteEnd, const char **__ppchRead, const char *__pchReadEnd, unsigned __uFlags) _MCFCRT_NOEXCEPT;
+
+extern char32_t _MCFCRT_TranscodeModifiedUtf8ToUtf8(char **__ppchWrite, char *__pchWriteEnd, const char **__ppchRead, const char *__pchReadEnd, unsigned __uFlags) _MCFCRT_NOEXCEPT;
+extern char32_t _MCFCRT_TranscodeModifiedUtf8ToUtf16(char16_t **__ppc16Write, char16_t *__pc16WriteEnd, const char **__ppchRead, const char *__pchReadEnd, unsigned __uFlags) _MCFCRT_NOEXCEPT;
+extern char32_t _MCFCRT_TranscodeModifiedUtf8ToUtf32(char32_t **__ppc32Write, char32_t *__pc32WriteEnd, const char **__ppchRead, const char *__pchReadEnd, unsigned __uFlags) _MCFCRT_NOEXCEPT;
+extern char32_t _MCFCRT_TranscodeModifiedUtf8ToCesu8(char **__ppchWrite, char *__pchWriteEnd, const char **__ppchRead, const char *__pchReadEnd, unsigned __uFlags) _MCFCRT_NOEXCEPT;
+extern char32_t _MCFCRT_TranscodeModifiedUtf8ToModifiedUtf8(char **__ppchWrite, char *__pchWriteEnd, const char **__ppchRead, const char *__pchReadEnd, unsigned __uFlags) _MCFCRT_NOEXCEPT;
+
+// 返回第一个不合法或者不完整的 UTF-8 序列的起始位置。如果输入是合法的 UTF-8 字符串，返回 __pchReadEnd。
+extern const char *_MCFCRT_ValidateUtf8(const char *__pchRead, const char *__pchReadEnd) _MCFCRT_NOEXCEPT;
+
 _MCFCRT_EXTERN_C_END
 
 #endif
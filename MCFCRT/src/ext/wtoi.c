@@ -3,28 +3,82 @@
 // Copyleft 2013 - 2018, LH_Mouse. All wrongs reserved.
 
 #include "wtoi.h"
-#include "rep_scas.h"
+#include "_digits.h"
 
-__attribute__((__always_inline__)) static inline wchar_t * Really_wtoi_u(_MCFCRT_wtoi_result *restrict result_out, uintptr_t *restrict value_out, const wchar_t *restrict buffer, unsigned max_digits, uintptr_t bound, const wchar_t *restrict dual_table, unsigned radix){
+// 这么多位十进制数字既不会使 uintptr_t 溢出，也不会使 intptr_t 溢出。
+#define SAFE_DECIMAL_DIGITS     ((sizeof(uintptr_t) >= 8) ? 18u : 9u)
+
+__attribute__((__always_inline__)) static inline wchar_t * Really_wtoi_d(_MCFCRT_wtoi_result *restrict result_out, uintptr_t *restrict value_out, const wchar_t *restrict buffer, unsigned max_digits, uintptr_t bound){
+	// Find the end of digits. Do not look beyond `max_digits` characters if it is specified.
+	size_t digits_total;
+	if(max_digits == UINT_MAX){
+		digits_total = (size_t)(__MCFCRT_SkipDecimalDigitsW(buffer) - buffer);
+	} else {
+		digits_total = (size_t)(__MCFCRT_SkipDecimalDigitsNW(buffer, max_digits) - buffer);
+	}
+	_MCFCRT_wtoi_result result = _MCFCRT_wtoi_result_no_digit;
+	size_t digits_read = 0;
+	uintptr_t word = 0;
+	// Parse leading digits that cannot overflow, eight at a time.
+	const size_t digits_safe = (digits_total < SAFE_DECIMAL_DIGITS) ? digits_total : SAFE_DECIMAL_DIGITS;
+	while(digits_safe - digits_read >= 8){
+		word = word * 100000000 + __MCFCRT_ConvertEightDecimalDigitsW(buffer + digits_read);
+		digits_read += 8;
+	}
+	while(digits_read < digits_safe){
+		word = word * 10 + (unsigned)(buffer[digits_read] - L'0');
+		++digits_read;
+	}
+	if(digits_read != 0){
+		result = _MCFCRT_wtoi_result_success;
+	}
+	// Parse remaining digits one by one.
+	while(digits_read < digits_total){
+		const unsigned digit_value = (unsigned)(buffer[digits_read] - L'0');
+		// Check for overflow.
+		const uintptr_t digit_bound = (bound - digit_value) / 10;
+		if(word > digit_bound){
+			result = _MCFCRT_wtoi_result_would_overflow;
+			break;
+		}
+		word *= 10;
+		word += digit_value;
+		++digits_read;
+	}
+	*result_out = result;
+	*value_out = word;
+	return (wchar_t *)buffer + digits_read;
+}
+
+static inline unsigned GetHexDigitValue(wchar_t digit){
+	// Handle lower and upper cases universally.
+	unsigned digit_value = (uint16_t)(digit - L'0');
+	if(digit_value < 10){
+		return digit_value;
+	}
+	digit_value = (uint16_t)((digit | 0x20) - L'a');
+	if(digit_value < 6){
+		return digit_value + 10;
+	}
+	return 16;
+}
+
+__attribute__((__always_inline__)) static inline wchar_t * Really_wtoi_x(_MCFCRT_wtoi_result *restrict result_out, uintptr_t *restrict value_out, const wchar_t *restrict buffer, unsigned max_digits){
 	unsigned digits_read = 0;
 	_MCFCRT_wtoi_result result = _MCFCRT_wtoi_result_no_digit;
 	// Parse digits.
 	uintptr_t word = 0;
 	while(digits_read + 1 <= max_digits){
-		const wchar_t digit = buffer[digits_read];
-		// Search for this digit in the table. Handle lower and upper cases universally.
-		uint16_t *digit_in_table;
-		if(_MCFCRT_repnz_scasw(&digit_in_table, (const uint16_t *)dual_table, (uint16_t)digit, radix * 2) != 0){
+		const unsigned digit_value = GetHexDigitValue(buffer[digits_read]);
+		if(digit_value >= 16){
 			break;
 		}
-		const unsigned digit_value = (unsigned)((const wchar_t *)digit_in_table - dual_table) / 2;
 		// Check for overflow.
-		const uintptr_t digit_bound = (bound - digit_value) / radix;
-		if(word > digit_bound){
+		if(word > UINTPTR_MAX / 16){
 			result = _MCFCRT_wtoi_result_would_overflow;
 			break;
 		}
-		word *= radix;
+		word *= 16;
 		word += digit_value;
 		++digits_read;
 		result = _MCFCRT_wtoi_result_success;
@@ -47,7 +101,7 @@ wchar_t * _MCFCRT_wtoi0d(_MCFCRT_wtoi_result *restrict result_out, intptr_t *res
 		++begin;
 	}
 	uintptr_t abs;
-	wchar_t *end = Really_wtoi_u(result_out, &abs, begin, max_digits, INTPTR_MAX ^ mask, L"00112233445566778899", 10);
+	wchar_t *end = Really_wtoi_d(result_out, &abs, begin, max_digits, INTPTR_MAX ^ mask);
 	*value_out = (intptr_t)((abs ^ mask) - mask);
 	return end;
 }
@@ -56,19 +110,62 @@ wchar_t * _MCFCRT_wtoi_u(_MCFCRT_wtoi_result *restrict result_out, uintptr_t *re
 	return _MCFCRT_wtoi0u(result_out, value_out, buffer, UINT_MAX);
 }
 wchar_t * _MCFCRT_wtoi0u(_MCFCRT_wtoi_result *restrict result_out, uintptr_t *restrict value_out, const wchar_t *restrict buffer, unsigned max_digits){
-	return Really_wtoi_u(result_out, value_out, buffer, max_digits, UINTPTR_MAX, L"00112233445566778899", 10);
+	return Really_wtoi_d(result_out, value_out, buffer, max_digits, UINTPTR_MAX);
 }
 
 wchar_t * _MCFCRT_wtoi_x(_MCFCRT_wtoi_result *restrict result_out, uintptr_t *restrict value_out, const wchar_t *restrict buffer){
 	return _MCFCRT_wtoi0x(result_out, value_out, buffer, UINT_MAX);
 }
 wchar_t * _MCFCRT_wtoi0x(_MCFCRT_wtoi_result *restrict result_out, uintptr_t *restrict value_out, const wchar_t *restrict buffer, unsigned max_digits){
-	return Really_wtoi_u(result_out, value_out, buffer, max_digits, UINTPTR_MAX, L"00112233445566778899aAbBcCdDeEfF", 16);
+	return Really_wtoi_x(result_out, value_out, buffer, max_digits);
 }
 
 wchar_t * _MCFCRT_wtoi_X(_MCFCRT_wtoi_result *restrict result_out, uintptr_t *restrict value_out, const wchar_t *restrict buffer){
 	return _MCFCRT_wtoi0X(result_out, value_out, buffer, UINT_MAX);
 }
 wchar_t * _MCFCRT_wtoi0X(_MCFCRT_wtoi_result *restrict result_out, uintptr_t *restrict value_out, const wchar_t *restrict buffer, unsigned max_digits){
-	return Really_wtoi_u(result_out, value_out, buffer, max_digits, UINTPTR_MAX, L"00112233445566778899aAbBcCdDeEfF", 16);
+	return Really_wtoi_x(result_out, value_out, buffer, max_digits);
+}
+
+wchar_t * _MCFCRT_wtoiN_d(_MCFCRT_wtoi_result *restrict result_out, size_t *restrict count_out, intptr_t *restrict values_out, size_t max_count, const wchar_t *restrict buffer, wchar_t delimiter){
+	const wchar_t *rp = buffer;
+	_MCFCRT_wtoi_result result = _MCFCRT_wtoi_result_success;
+	size_t count = 0;
+	while(count < max_count){
+		if(count != 0){
+			if(*rp != delimiter){
+				break;
+			}
+			++rp;
+		}
+		rp = _MCFCRT_wtoi0d(&result, values_out + count, rp, UINT_MAX);
+		if(result != _MCFCRT_wtoi_result_success){
+			break;
+		}
+		++count;
+	}
+	*result_out = result;
+	*count_out = count;
+	return (wchar_t *)rp;
+}
+wchar_t * _MCFCRT_wtoiN_u(_MCFCRT_wtoi_result *restrict result_out, size_t *restrict count_out, uintptr_t *restrict values_out, size_t max_count, const wchar_t *restrict buffer, wchar_t delimiter){
+	const wchar_t *rp = buffer;
+	_MCFCRT_wtoi_result result = _MCFCRT_wtoi_result_success;
+	size_t count = 0;
+	while(count < max_count){
+		if(count != 0){
+			if(*rp != delimiter){
+				break;
+			}
+			++rp;
+		}
+		rp = Really_wtoi_d(&result, values_out + count, rp, UINT_MAX, UINTPTR_MAX);
+		if(result != _MCFCRT_wtoi_result_success){
+			break;
+		}
+		++count;
+	}
+	*result_out = result;
+	*count_out = count;
+	return (wchar_t *)rp;
 }
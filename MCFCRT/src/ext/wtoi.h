@@ -27,6 +27,11 @@ extern wchar_t * _MCFCRT_wtoi0x(_MCFCRT_wtoi_result *_MCFCRT_RESTRICT __result_o
 extern wchar_t * _MCFCRT_wtoi_X(_MCFCRT_wtoi_result *_MCFCRT_RESTRICT __result_out, _MCFCRT_STD uintptr_t *_MCFCRT_RESTRICT __value_out, const wchar_t *_MCFCRT_RESTRICT __buffer) _MCFCRT_NOEXCEPT;
 extern wchar_t * _MCFCRT_wtoi0X(_MCFCRT_wtoi_result *_MCFCRT_RESTRICT __result_out, _MCFCRT_STD uintptr_t *_MCFCRT_RESTRICT __value_out, const wchar_t *_MCFCRT_RESTRICT __buffer, unsigned __max_digits) _MCFCRT_NOEXCEPT;
 
+// 依次读取至多 __max_count 个以 __delimiter 分隔的整数，遇到错误或者整数之后不是 __delimiter 时停止。
+// *__count_out 返回成功读取的整数的个数，*__result_out 返回最后一次读取的结果。
+extern wchar_t * _MCFCRT_wtoiN_d(_MCFCRT_wtoi_result *_MCFCRT_RESTRICT __result_out, _MCFCRT_STD size_t *_MCFCRT_RESTRICT __count_out, _MCFCRT_STD intptr_t *_MCFCRT_RESTRICT __values_out, _MCFCRT_STD size_t __max_count, const wchar_t *_MCFCRT_RESTRICT __buffer, wchar_t __delimiter) _MCFCRT_NOEXCEPT;
+extern wchar_t * _MCFCRT_wtoiN_u(_MCFCRT_wtoi_result *_MCFCRT_RESTRICT __result_out, _MCFCRT_STD size_t *_MCFCRT_RESTRICT __count_out, _MCFCRT_STD uintptr_t *_MCFCRT_RESTRICT __values_out, _MCFCRT_STD size_t __max_count, const wchar_t *_MCFCRT_RESTRICT __buffer, wchar_t __delimiter) _MCFCRT_NOEXCEPT;
+
 _MCFCRT_EXTERN_C_END
 
 #endif
@@ -29,6 +29,7 @@
 // ------------------------------ ext ------------------------------
 #  include "ext/alloca.h"
 #  include "ext/atoi.h"
+#  include "ext/atof.h"
 #  include "ext/wtoi.h"
 #  include "ext/itoa.h"
 #  include "ext/itow.h"
@@ -6,6 +6,11 @@
 #include <MCF/Core/LastError.hpp>
 #include <MCF/Core/CopyMoveFill.hpp>
 #include <MCF/Core/MinMax.hpp>
+#include <MCF/Core/AsyncFile.hpp>
+#include <MCF/Core/Atomic.hpp>
+#include <MCF/Containers/Vector.hpp>
+#include <MCF/Thread/IoCompletionQueue.hpp>
+#include <MCF/Thread/Event.hpp>
 
 using namespace MCF;
 
@@ -22,7 +27,93 @@ using Char = char;
 
 constexpr std::size_t size = 0x100;
 
+// 在临时文件上往返测试 AsyncFile 和 IoCompletionQueue：多个重叠的写入和读取，读到文件末尾，然后停止工作线程。
+bool test_async_file(){
+	constexpr std::size_t block_size = 0x1000;
+	constexpr std::size_t block_count = 16;
+	constexpr std::size_t total = block_size * block_count;
+
+	wchar_t temp_dir[MAX_PATH + 1];
+	const auto temp_len = ::GetTempPathW(MAX_PATH + 1, temp_dir);
+	if((temp_len == 0) || (temp_len > MAX_PATH)){
+		std::printf("async_file : GetTempPathW() failed\n");
+		return false;
+	}
+	WideString path(temp_dir, temp_len);
+	path.Append(L"MCF_AsyncFileTest.tmp");
+
+	IoCompletionQueue queue;
+	AsyncFile file(File(path, File::kToRead | File::kToWrite | File::kDeleteOnClose | File::kOverlapped), queue);
+	queue.StartWorkers(2);
+
+	Vector<unsigned char> out(total), in(total + block_size);
+	for(std::size_t i = 0; i < total; ++i){
+		out[i] = (unsigned char)(i * 7 + i / block_size);
+	}
+
+	Atomic<std::size_t> remaining(0), failures(0);
+	Event done(false);
+	const auto submitted = [&](std::size_t count){
+		remaining.Store(count, kAtomicRelaxed);
+		done.Reset();
+	};
+	const auto completed = [&](bool ok){
+		if(!ok){
+			failures.Increment(kAtomicRelaxed);
+		}
+		if(remaining.Decrement(kAtomicAcqRel) == 0){
+			done.Set();
+		}
+	};
+
+	// 所有的块同时写入，倒序提交，这样完成的顺序和偏移量无关。
+	submitted(block_count);
+	for(std::size_t i = block_count; i != 0; --i){
+		const auto offset = (i - 1) * block_size;
+		file.Write(offset, out.GetData() + offset, block_size, [&](unsigned long err, std::size_t bytes){ completed((err == 0) && (bytes == block_size)); });
+	}
+	done.Wait();
+	if(file.GetFile().GetSize() != total){
+		failures.Increment(kAtomicRelaxed);
+	}
+
+	// 读回所有的块。最后一个请求越过文件末尾，应当只读到一个块；从文件末尾开始的读取应当读到零字节。
+	submitted(block_count + 1);
+	for(std::size_t i = 0; i < block_count - 1; ++i){
+		const auto offset = i * block_size;
+		file.Read(in.GetData() + offset, block_size, offset, [&](unsigned long err, std::size_t bytes){ completed((err == 0) && (bytes == block_size)); });
+	}
+	file.Read(in.GetData() + total - block_size, block_size * 2, total - block_size, [&](unsigned long err, std::size_t bytes){ completed((err == 0) && (bytes == block_size)); });
+	unsigned char eof_byte;
+	file.Read(&eof_byte, 1, total, [&](unsigned long err, std::size_t bytes){ completed((err == 0) && (bytes == 0)); });
+	done.Wait();
+	if(std::memcmp(in.GetData(), out.GetData(), total) != 0){
+		failures.Increment(kAtomicRelaxed);
+	}
+
+	// Post() 的函数也在工作线程中执行。停止工作线程之后不应当有未完成的操作。
+	submitted(1);
+	queue.Post([&]{ completed(true); });
+	done.Wait();
+	queue.StopWorkers();
+	if(queue.GetPendingCount() != 0){
+		failures.Increment(kAtomicRelaxed);
+	}
+
+	const auto failed = failures.Load(kAtomicRelaxed);
+	std::printf("async_file : %s (%zu failure(s))\n", (failed == 0) ? "passed" : "FAILED", failed);
+	return failed == 0;
+}
+
 extern "C" unsigned _MCFCRT_Main(void) noexcept {
+	try {
+		if(!test_async_file()){
+			return 1;
+		}
+	} catch(Exception &e){
+		std::printf("async_file : error %lu : %s\n", e.GetErrorCode(), AnsiString(GetWin32ErrorDescription(e.GetErrorCode())).GetStr());
+		return 1;
+	}
 
 	const UniquePtr<void, PageDeleter> p1(::VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
 	const UniquePtr<void, PageDeleter> p2(::VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));